@@ -60,7 +60,9 @@ extern "C" {
  *    "X"       - Enable 3D acceleration, using X where X is one of the valid rendering drivers.  (e.g. "direct3d", "opengl", etc.)
  *
  *  By default SDL tries to make a best guess for each platform whether
- *  to use acceleration or not.
+ *  to use acceleration or not. The KMSDRM video driver uses OpenGL ES when
+ *  it could open a GBM device for the GPU, and dumb buffers otherwise; set
+ *  this to "0" to use dumb buffers anyway.
  */
 #define SDL_HINT_FRAMEBUFFER_ACCELERATION   "SDL_FRAMEBUFFER_ACCELERATION"
 
@@ -152,6 +154,26 @@ extern "C" {
  */
 #define SDL_HINT_RENDER_VSYNC               "SDL_RENDER_VSYNC"
 
+/**
+ *  \brief  A variable controlling how many upload buffers streaming textures rotate through.
+ *
+ *  This variable is checked when a streaming texture is created, and affects
+ *  the OpenGL and OpenGL ES 2 renderers.
+ *
+ *  This variable can be set to the following values:
+ *    "0" or "1"  - Lock a single CPU copy of the texture and upload it on unlock
+ *    "2" to "4"  - Rotate between that many buffers, so an upload doesn't wait
+ *                  for drawing that still uses the previous contents. OpenGL
+ *                  hands out mapped pixel buffer objects to write into directly,
+ *                  and OpenGL ES 2 rotates between textures.
+ *
+ *  With OpenGL and more than one buffer, the pixels returned by
+ *  SDL_LockTexture() don't hold the previous texture contents.
+ *
+ *  By default a single CPU copy is used.
+ */
+#define SDL_HINT_RENDER_STREAMING_BUFFERS   "SDL_RENDER_STREAMING_BUFFERS"
+
 /**
  *  \brief  A variable controlling whether the screensaver is enabled. 
  *
@@ -210,6 +232,38 @@ extern "C" {
  */
 #define SDL_HINT_VIDEO_X11_NET_WM_PING      "SDL_VIDEO_X11_NET_WM_PING"
 
+/**
+ *  \brief  A variable controlling how many MIT-SHM segments the X11 window framebuffer presents from.
+ *
+ *  This variable can be set to the following values:
+ *    "1"       - The window surface is the shared segment, and every update waits for the X server to read it
+ *    "2" or "3" - The window surface is copied into a free segment, and updates don't wait for the X server
+ *
+ *  By default SDL uses 2 segments. The hint is checked when the window surface is created.
+ */
+#define SDL_HINT_VIDEO_X11_SHM_SEGMENTS     "SDL_VIDEO_X11_SHM_SEGMENTS"
+
+/**
+ *  \brief  A variable controlling where the "dummy" video driver sends the frames of window surfaces.
+ *
+ *  This variable can be set to the following values:
+ *    "file:PATH"   - Frames are written to the file PATH, which may be a named pipe
+ *    "shm:PATH"    - Frames are written to a ring in the memory-mapped file PATH-<window id>
+ *
+ *  Each frame is a header of six Uint32 (magic 0x46534453, window id, pixel format,
+ *  width, height, pitch) and two Uint64 (frame number, timestamp in nanoseconds),
+ *  followed by the pixels. All values are in native byte order.
+ *
+ *  The ring starts with four Uint32 (magic 0x52534453, slot count, slot size, latest
+ *  frame number), followed by the slots 64 bytes in. Each slot has a frame header,
+ *  then the pixels 64 bytes in. Frame N is in slot N modulo the slot count, and is
+ *  complete if the frame number in its header is still N after it has been copied.
+ *
+ *  By default frames are not sent anywhere. The hint is checked when the window
+ *  surface is created. SDL_SetWindowFrameCallback() receives frames without copies.
+ */
+#define SDL_HINT_VIDEO_DUMMY_OUTPUT         "SDL_VIDEO_DUMMY_OUTPUT"
+
 /**
  *  \brief  A variable controlling whether the window frame and title bar are interactive when the cursor is hidden 
  *
@@ -497,6 +551,68 @@ extern "C" {
 */
 #define SDL_HINT_THREAD_STACK_SIZE              "SDL_THREAD_STACK_SIZE"
 
+/**
+ *  \brief  A variable controlling how many threads SDL uses to split up large pixel conversions
+ *
+ *  Pixel work like converting a YUV frame to RGB is split into bands of rows that are
+ *  processed by a pool of worker threads together with the calling thread.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Use one thread per CPU core (default)
+ *    "1"       - Do all the work on the calling thread
+ *    "2" - "16" - Use that many threads, including the calling thread
+ *
+ *  The worker threads are started the first time they are needed, so this hint should
+ *  be set before then.
+ */
+#define SDL_HINT_CPU_WORKER_THREADS             "SDL_CPU_WORKER_THREADS"
+
+/**
+ *  \brief  A variable controlling whether SDL_ConvertSurface() and SDL_ConvertPixels() use worker threads
+ *
+ *  Large conversions between RGB formats can be split into bands of rows that are
+ *  converted on the threads set up by SDL_HINT_CPU_WORKER_THREADS. The result is the
+ *  same either way, only the time it takes changes.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Convert on the calling thread (default)
+ *    "1"       - Split conversions of 256K pixels or more over the worker threads
+ *
+ *  The hint is checked on every conversion, so it can be changed at any time.
+ */
+#define SDL_HINT_CONVERT_THREADS                "SDL_CONVERT_THREADS"
+
+/**
+ *  \brief  A variable controlling whether SDL_FillRect() and SDL_FillRects() use worker threads
+ *
+ *  Large fills, like clearing a whole framebuffer, can be split into bands of rows that
+ *  are filled on the threads set up by SDL_HINT_CPU_WORKER_THREADS.
+ *
+ *  This variable can be set to the following values:
+ *    "0"       - Fill on the calling thread (default)
+ *    "1"       - Split fills of 2 MB or more over the worker threads
+ *
+ *  The hint is checked on every fill, so it can be changed at any time.
+ */
+#define SDL_HINT_FILLRECT_THREADS               "SDL_FILLRECT_THREADS"
+
+/**
+ *  \brief  A variable limiting the SIMD instructions used to convert YUV frames to RGB
+ *
+ *  Every YUV to RGB kernel gives the same pixels, so this is only useful to test and
+ *  benchmark the kernels against each other. If the CPU or the build lacks the requested
+ *  instructions, the next slower kernel is used.
+ *
+ *  This variable can be set to the following values:
+ *    "avx2"    - Use AVX2, SSE2 or NEON if available (default)
+ *    "sse2"    - Use SSE2 or NEON if available
+ *    "neon"    - Use NEON if available
+ *    "c"       - Use the portable C kernel
+ *
+ *  The hint is checked on every conversion, so it can be changed at any time.
+ */
+#define SDL_HINT_YUV_CONVERSION_SIMD            "SDL_YUV_CONVERSION_SIMD"
+
 /**
  *  \brief If set to 1, then do not allow high-DPI windows. ("Retina" on Mac and iOS)
  */
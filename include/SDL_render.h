@@ -85,6 +85,17 @@ typedef struct SDL_RendererInfo
     int max_texture_height;     /**< The maximum texture height */
 } SDL_RendererInfo;
 
+/**
+ *  \brief Counts of the work a renderer sent to its driver during one frame.
+ */
+typedef struct SDL_RendererStats
+{
+    Uint32 state_changes;       /**< Color, blend, viewport, clip and target changes */
+    Uint32 draw_calls;          /**< Clear, draw, fill and copy calls */
+    Uint32 texture_binds;       /**< Copies that used a different texture than the previous copy */
+    Uint32 upload_bytes;        /**< Texture pixel data passed to the driver by updates and locks */
+} SDL_RendererStats;
+
 /**
  *  \brief The access pattern allowed for a texture.
  */
@@ -127,6 +138,23 @@ typedef struct SDL_Renderer SDL_Renderer;
 struct SDL_Texture;
 typedef struct SDL_Texture SDL_Texture;
 
+/**
+ *  \brief A set of large textures that many small images are packed into
+ */
+struct SDL_TextureAtlas;
+typedef struct SDL_TextureAtlas SDL_TextureAtlas;
+
+/**
+ *  \brief A handle to an image packed into a texture atlas, 0 is invalid.
+ */
+typedef Uint32 SDL_AtlasEntryID;
+
+/**
+ *  \brief A read of render target pixels that completes asynchronously
+ */
+struct SDL_PixelReadback;
+typedef struct SDL_PixelReadback SDL_PixelReadback;
+
 
 /* Function prototypes */
 
@@ -855,11 +883,85 @@ extern DECLSPEC int SDLCALL SDL_RenderReadPixels(SDL_Renderer * renderer,
                                                  Uint32 format,
                                                  void *pixels, int pitch);
 
+/**
+ *  \brief Start reading pixels from the current rendering target without
+ *         waiting for rendering to finish.
+ *
+ *  \param renderer The renderer from which pixels should be read.
+ *  \param rect   A pointer to the rectangle to read, or NULL for the entire
+ *                render target.
+ *  \param format The desired format of the pixel data, or 0 to use the format
+ *                of the rendering target
+ *
+ *  \return A readback handle, or NULL on error.
+ *
+ *  The transfer uses a pixel buffer object with the OpenGL renderer. Other
+ *  renderers read the pixels in their native format right away. In both
+ *  cases any conversion to \c format happens on a worker thread.
+ *
+ *  The readback must be polled, waited on and freed on the thread that
+ *  uses the renderer.
+ *
+ *  \sa SDL_PollPixelReadback()
+ *  \sa SDL_WaitPixelReadback()
+ *  \sa SDL_FreePixelReadback()
+ */
+extern DECLSPEC SDL_PixelReadback * SDLCALL SDL_RenderReadPixelsAsync(SDL_Renderer * renderer,
+                                                                      const SDL_Rect * rect,
+                                                                      Uint32 format);
+
+/**
+ *  \brief Check whether an asynchronous pixel readback has completed.
+ *
+ *  \return SDL_TRUE if SDL_WaitPixelReadback() would return without blocking.
+ *
+ *  When the OpenGL driver doesn't support GL_ARB_sync there's no way to ask
+ *  whether the transfer has finished, so this returns SDL_FALSE until a
+ *  frame has been presented with SDL_RenderPresent() since the readback was
+ *  started. Use SDL_WaitPixelReadback() when not presenting frames.
+ */
+extern DECLSPEC SDL_bool SDLCALL SDL_PollPixelReadback(SDL_PixelReadback * readback);
+
+/**
+ *  \brief Wait for an asynchronous pixel readback to complete.
+ *
+ *  \param readback The readback returned by SDL_RenderReadPixelsAsync().
+ *  \param rect     A pointer filled in with the area that was read, which may
+ *                  be smaller than requested if it was clipped, or NULL.
+ *  \param pixels   A pointer filled in with the pixel data, which stays valid
+ *                  until the readback is freed.
+ *  \param pitch    A pointer filled in with the pitch of the pixel data.
+ *
+ *  \return 0 on success, or -1 if the pixels couldn't be read.
+ */
+extern DECLSPEC int SDLCALL SDL_WaitPixelReadback(SDL_PixelReadback * readback,
+                                                  SDL_Rect * rect,
+                                                  void **pixels, int *pitch);
+
+/**
+ *  \brief Free an asynchronous pixel readback, cancelling it if necessary.
+ */
+extern DECLSPEC void SDLCALL SDL_FreePixelReadback(SDL_PixelReadback * readback);
+
 /**
  *  \brief Update the screen with rendering performed.
  */
 extern DECLSPEC void SDLCALL SDL_RenderPresent(SDL_Renderer * renderer);
 
+/**
+ *  \brief Get the counters for the last frame shown with SDL_RenderPresent().
+ *
+ *  \param renderer The renderer to query.
+ *  \param stats    A pointer filled in with the counters for the last frame.
+ *
+ *  \return 0 on success, or -1 if the renderer is invalid.
+ *
+ *  Setting a color, blend mode, viewport or clip rectangle to the value it
+ *  already has is not counted, and is not passed on to the driver.
+ */
+extern DECLSPEC int SDLCALL SDL_GetRendererStats(SDL_Renderer * renderer,
+                                                 SDL_RendererStats * stats);
+
 /**
  *  \brief Destroy the specified texture.
  *
@@ -876,6 +978,76 @@ extern DECLSPEC void SDLCALL SDL_DestroyTexture(SDL_Texture * texture);
  */
 extern DECLSPEC void SDLCALL SDL_DestroyRenderer(SDL_Renderer * renderer);
 
+/**
+ *  \brief Create a texture atlas, which packs many small images into a few
+ *         large textures so they can be drawn without switching textures.
+ *
+ *  \param renderer  The renderer.
+ *  \param format    The format of the atlas pages, or 0 to use the first
+ *                   texture format with alpha supported by the renderer.
+ *  \param page_w    The width of each atlas page texture.
+ *  \param page_h    The height of each atlas page texture.
+ *  \param max_bytes The amount of texture memory the atlas may use, or 0 for
+ *                   no limit. At least one page is always allowed.
+ *
+ *  \return The created atlas, or NULL on error.
+ *
+ *  \note When the memory budget is reached, the least recently used page is
+ *        evicted, and the IDs of the entries on it become invalid.
+ *
+ *  \note The atlas must be destroyed before its renderer.
+ *
+ *  \sa SDL_TextureAtlasAdd()
+ *  \sa SDL_DestroyTextureAtlas()
+ */
+extern DECLSPEC SDL_TextureAtlas * SDLCALL SDL_CreateTextureAtlas(SDL_Renderer * renderer,
+                                                                 Uint32 format,
+                                                                 int page_w, int page_h,
+                                                                 size_t max_bytes);
+
+/**
+ *  \brief Copy a surface into a texture atlas.
+ *
+ *  The surface is converted to the atlas format, and its color key is
+ *  converted to alpha. The surface may be freed after this call.
+ *
+ *  \return The ID of the new atlas entry, or 0 on error.
+ *
+ *  \sa SDL_TextureAtlasGet()
+ */
+extern DECLSPEC SDL_AtlasEntryID SDLCALL SDL_TextureAtlasAdd(SDL_TextureAtlas * atlas,
+                                                             SDL_Surface * surface);
+
+/**
+ *  \brief Get the texture and source rectangle of an atlas entry, for use
+ *         with SDL_RenderCopy() or SDL_RenderCopyEx().
+ *
+ *  \param atlas   The texture atlas.
+ *  \param id      The ID returned by SDL_TextureAtlasAdd().
+ *  \param texture A pointer filled in with the atlas page texture, or NULL.
+ *  \param rect    A pointer filled in with the entry's rectangle within the
+ *                 texture, or NULL.
+ *
+ *  \return 0 on success, or -1 if the entry was removed or evicted.
+ */
+extern DECLSPEC int SDLCALL SDL_TextureAtlasGet(SDL_TextureAtlas * atlas,
+                                                SDL_AtlasEntryID id,
+                                                SDL_Texture ** texture,
+                                                SDL_Rect * rect);
+
+/**
+ *  \brief Remove an entry from a texture atlas.
+ *
+ *  The space is reused once every entry on the same page has been removed.
+ */
+extern DECLSPEC void SDLCALL SDL_TextureAtlasRemove(SDL_TextureAtlas * atlas,
+                                                    SDL_AtlasEntryID id);
+
+/**
+ *  \brief Destroy a texture atlas and all of its textures.
+ */
+extern DECLSPEC void SDLCALL SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas);
+
 
 /**
  *  \brief Bind the texture to the current OpenGL/ES/ES2 context for use with
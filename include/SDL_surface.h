@@ -53,12 +53,17 @@ extern "C" {
 #define SDL_PREALLOC        0x00000001  /**< Surface uses preallocated memory */
 #define SDL_RLEACCEL        0x00000002  /**< Surface is RLE encoded */
 #define SDL_DONTFREE        0x00000004  /**< Surface is referenced internally */
+#define SDL_SIMD_ALIGNED    0x00000008  /**< Surface uses aligned memory */
+#define SDL_SURFACEVIEW     0x00000010  /**< Surface shares the pixels of another surface */
 /* @} *//* Surface flags */
 
 /**
  *  Evaluates to true if the surface needs to be locked before access.
+ *
+ *  Views are always locked, since that locks the surface that owns their
+ *  pixels, which may be RLE accelerated.
  */
-#define SDL_MUSTLOCK(S) (((S)->flags & SDL_RLEACCEL) != 0)
+#define SDL_MUSTLOCK(S) (((S)->flags & (SDL_RLEACCEL | SDL_SURFACEVIEW)) != 0)
 
 /**
  * \brief A collection of pixels used in software blitting.
@@ -375,6 +380,31 @@ extern DECLSPEC void SDLCALL SDL_GetClipRect(SDL_Surface * surface,
  */
 extern DECLSPEC SDL_Surface *SDLCALL SDL_DuplicateSurface(SDL_Surface * surface);
 
+/**
+ *  Creates a surface that shares the pixels of part of an existing surface.
+ *
+ *  \param surface The surface to make a view of, which may itself be a view.
+ *  \param rect The area of \c surface the view covers, or NULL for all of it.
+ *
+ *  \return The new view, or NULL if there was an error.
+ *
+ *  Nothing is copied: drawing to the view draws to \c surface and the other
+ *  way around. The view uses the same pixel format and palette, and starts
+ *  out with the color key, blend mode and color and alpha modulation of
+ *  \c surface, which can then be changed independently.
+ *
+ *  The view holds a reference to the surface that owns the pixels, so that
+ *  surface stays valid until the view and the surface have both been freed
+ *  with SDL_FreeSurface(). Locking a view locks the owning surface, and
+ *  SDL_MUSTLOCK() is true for views, so lock the view before writing to its
+ *  pixels directly. Blits and fills into a view lock it by themselves.
+ *
+ *  The rectangle is clipped to \c surface, and its x coordinate must land on
+ *  a byte boundary for surfaces with less than 8 bits per pixel. Surfaces
+ *  that belong to SDL, like window surfaces, can't be viewed.
+ */
+extern DECLSPEC SDL_Surface *SDLCALL SDL_CreateSurfaceView(SDL_Surface * surface, const SDL_Rect * rect);
+
 /**
  *  Creates a new surface of the specified format, and then copies and maps
  *  the given surface to it so the blit of the converted surface will be as
@@ -502,6 +532,18 @@ extern DECLSPEC int SDLCALL SDL_SoftStretch(SDL_Surface * src,
                                             SDL_Surface * dst,
                                             const SDL_Rect * dstrect);
 
+/**
+ *  \brief Perform a bilinear filtered stretch blit between two surfaces of the
+ *         same 32-bit pixel format.
+ *
+ *  \note Formats with 8 bits per channel are supported, palettized formats and
+ *        ::SDL_PIXELFORMAT_ARGB2101010 are not.
+ */
+extern DECLSPEC int SDLCALL SDL_SoftStretchLinear(SDL_Surface * src,
+                                                  const SDL_Rect * srcrect,
+                                                  SDL_Surface * dst,
+                                                  const SDL_Rect * dstrect);
+
 #define SDL_BlitScaled SDL_UpperBlitScaled
 
 /**
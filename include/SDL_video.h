@@ -288,6 +288,33 @@ extern DECLSPEC void SDLCALL SDL_VideoQuit(void);
  */
 extern DECLSPEC const char *SDLCALL SDL_GetCurrentVideoDriver(void);
 
+/**
+ *  \brief Where the time went while the video subsystem was initialized.
+ *
+ *  Times are in SDL_GetPerformanceCounter() units. Drivers that don't
+ *  break down their own initialization leave displays and input at 0.
+ *
+ *  \sa SDL_GetVideoInitTimes()
+ */
+typedef struct SDL_VideoInitTimes
+{
+    Uint64 total;       /**< All of SDL_VideoInit() */
+    Uint64 events;      /**< Starting the event, keyboard, mouse and touch subsystems */
+    Uint64 connect;     /**< Creating the video driver, which connects to the display server */
+    Uint64 driver;      /**< The driver's own initialization, including displays and input */
+    Uint64 displays;    /**< Enumerating the displays and their current modes */
+    Uint64 input;       /**< Setting up keyboard, mouse and touch input in the driver */
+} SDL_VideoInitTimes;
+
+/**
+ *  \brief Get how long each stage of initializing the current video driver took.
+ *
+ *  \return 0 on success, or -1 if the video subsystem isn't initialized.
+ *
+ *  \sa SDL_VideoInit()
+ */
+extern DECLSPEC int SDLCALL SDL_GetVideoInitTimes(SDL_VideoInitTimes * times);
+
 /**
  *  \brief Returns the number of available video displays.
  *
@@ -837,6 +864,116 @@ extern DECLSPEC int SDLCALL SDL_UpdateWindowSurfaceRects(SDL_Window * window,
                                                          const SDL_Rect * rects,
                                                          int numrects);
 
+/**
+ *  \brief A frame presented with SDL_UpdateWindowSurface() or
+ *         SDL_UpdateWindowSurfaceRects()
+ *
+ *  \sa SDL_SetWindowFrameCallback()
+ */
+typedef struct SDL_WindowFrame
+{
+    SDL_Window *window;
+    SDL_Surface *surface;       /**< The window surface that was presented */
+    const SDL_Rect *rects;      /**< The rectangles that were updated */
+    int numrects;
+    Uint64 frame;               /**< Frames presented in the window so far, counting this one */
+    Uint64 timestamp;           /**< SDL_GetPerformanceCounter() when presenting started */
+    Uint64 present_duration;    /**< Performance counter ticks the video driver took to present */
+} SDL_WindowFrame;
+
+/**
+ *  \brief Callback run after a frame has been presented.
+ *
+ *  \sa SDL_SetWindowFrameCallback
+ */
+typedef void (SDLCALL *SDL_WindowFrameCallback)(void *userdata,
+                                               const SDL_WindowFrame *frame);
+
+/**
+ *  \brief Provide a callback that is given every frame presented in a window.
+ *
+ *  The callback runs in the thread that called SDL_UpdateWindowSurfaceRects(),
+ *  right after the video driver has presented the frame, and may read the
+ *  window surface but not change it. Together with the "dummy" video driver
+ *  this captures frames without a display, for tests and offline rendering.
+ *
+ *  \param window The window to capture frames from.
+ *  \param callback The callback to call with each frame, or NULL to stop.
+ *  \param userdata An app-defined void pointer passed to the callback.
+ *  \return 0 on success, -1 on error.
+ *
+ *  \sa SDL_UpdateWindowSurfaceRects()
+ */
+extern DECLSPEC int SDLCALL SDL_SetWindowFrameCallback(SDL_Window * window,
+                                                       SDL_WindowFrameCallback callback,
+                                                       void *userdata);
+
+/**
+ *  \brief Get the vertical blank at which a window's last frame reached the display.
+ *
+ *  Frames presented with SDL_GL_SwapWindow() or SDL_UpdateWindowSurface()
+ *  are shown at a vertical blank. Comparing the sequence numbers of
+ *  successive frames tells how many refreshes each one stayed on screen,
+ *  so a difference of more than one means a frame was missed.
+ *
+ *  \param window The window to query.
+ *  \param sequence Filled in with the display's vertical blank counter for
+ *                  the last displayed frame, may be NULL.
+ *  \param timestamp Filled in with the time of that vertical blank, in
+ *                   microseconds of the system's monotonic clock, may be NULL.
+ *  \return 0 on success, or -1 if no frame has been displayed yet or the
+ *          video driver doesn't report vertical blanks.
+ *
+ *  \note This is currently only supported by the KMSDRM video driver.
+ *
+ *  \sa SDL_GL_SwapWindow()
+ */
+extern DECLSPEC int SDLCALL SDL_GetWindowVBlank(SDL_Window * window,
+                                                Uint64 * sequence,
+                                                Uint64 * timestamp);
+
+/**
+ *  \brief Statistics for a frame presented in a window.
+ *
+ *  Times are in SDL_GetPerformanceCounter() units.
+ *
+ *  \sa SDL_GetWindowPresentStats()
+ */
+typedef struct SDL_PresentStats
+{
+    Uint64 frame;           /**< The frame, counting from 1 for the first one presented in the window */
+    Uint64 submit_time;     /**< When SDL_GL_SwapWindow() or SDL_UpdateWindowSurface() was called for it */
+    Uint64 return_time;     /**< When that call returned, so return_time - submit_time is how long it blocked */
+    Uint64 present_time;    /**< When the frame reached the display, or 0 if that isn't known */
+    Uint64 sequence;        /**< The display's vertical blank counter at present_time, or 0 if that isn't known */
+    Uint32 missed_vsyncs;   /**< Vertical blanks since the previous frame that didn't show a new one */
+    Uint32 upload_bytes;    /**< Bytes of the window surface uploaded to a texture for the frame, when the window surface is shown through one */
+} SDL_PresentStats;
+
+/**
+ *  \brief Get statistics for the last frame presented in a window.
+ *
+ *  Use this to schedule the start of rendering so frames are ready just
+ *  before they are needed, rather than a whole refresh early.
+ *
+ *  Video drivers that are told when a frame reaches the display fill in
+ *  present_time: KMSDRM on page flips, Wayland through the presentation
+ *  time protocol, X11 once the server has finished reading a MIT-SHM
+ *  window surface, and the dummy driver as soon as a frame is written.
+ *  KMSDRM and Wayland also provide the vertical blank sequence and so the
+ *  missed vsyncs. The statistics are for the most recent frame known to
+ *  have been displayed, or with other drivers for the last frame submitted.
+ *
+ *  \param window The window to query.
+ *  \param stats Filled in with the statistics.
+ *  \return 0 on success, or -1 if no frame has been presented in the window.
+ *
+ *  \sa SDL_GL_SwapWindow()
+ *  \sa SDL_UpdateWindowSurface()
+ */
+extern DECLSPEC int SDLCALL SDL_GetWindowPresentStats(SDL_Window * window,
+                                                      SDL_PresentStats * stats);
+
 /**
  *  \brief Set a window's input grab mode.
  *
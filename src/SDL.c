@@ -33,6 +33,8 @@
 #include "events/SDL_events_c.h"
 #include "haptic/SDL_haptic_c.h"
 #include "joystick/SDL_joystick_c.h"
+#include "thread/SDL_parallel_c.h"
+#include "video/SDL_pixelpool_c.h"
 
 /* Initialization/Cleanup routines */
 #if !SDL_TIMERS_DISABLED
@@ -353,6 +355,9 @@ SDL_Quit(void)
 #endif
     SDL_QuitSubSystem(SDL_INIT_EVERYTHING);
 
+    SDL_QuitParallel();
+    SDL_QuitPixelPool();
+
 #if !SDL_TIMERS_DISABLED
     SDL_TicksQuit();
 #endif
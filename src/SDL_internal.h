@@ -47,6 +47,25 @@
 
 #include "SDL_config.h"
 
+/* Code for instruction sets beyond the ones the compiler targets by default.
+   GCC and clang can build individual functions for them with SDL_TARGETING(),
+   and the caller picks them at runtime with SDL_HasSSE41(), SDL_HasAVX2()
+   and friends. */
+#if defined(__GNUC__) && ((__GNUC__ >= 5) || defined(__clang__)) && \
+    (defined(__i386__) || defined(__x86_64__))
+#define SDL_TARGETING(x) __attribute__((target(x)))
+#define HAVE_SSE41_INTRINSICS 1
+#define HAVE_AVX2_INTRINSICS 1
+#else
+#define SDL_TARGETING(x)
+#if defined(__SSE4_1__) || (defined(_MSC_VER) && (_MSC_VER >= 1700) && (defined(_M_IX86) || defined(_M_X64)))
+#define HAVE_SSE41_INTRINSICS 1
+#endif
+#if defined(__AVX2__) || (defined(_MSC_VER) && (_MSC_VER >= 1700) && (defined(_M_IX86) || defined(_M_X64)))
+#define HAVE_AVX2_INTRINSICS 1
+#endif
+#endif
+
 #endif /* SDL_internal_h_ */
 
 /* vi: set ts=4 sw=4 expandtab: */
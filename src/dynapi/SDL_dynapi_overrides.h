@@ -663,3 +663,19 @@
 #define SDL_SetYUVConversionMode SDL_SetYUVConversionMode_REAL
 #define SDL_GetYUVConversionMode SDL_GetYUVConversionMode_REAL
 #define SDL_GetYUVConversionModeForResolution SDL_GetYUVConversionModeForResolution_REAL
+#define SDL_CreateTextureAtlas SDL_CreateTextureAtlas_REAL
+#define SDL_TextureAtlasAdd SDL_TextureAtlasAdd_REAL
+#define SDL_TextureAtlasGet SDL_TextureAtlasGet_REAL
+#define SDL_TextureAtlasRemove SDL_TextureAtlasRemove_REAL
+#define SDL_DestroyTextureAtlas SDL_DestroyTextureAtlas_REAL
+#define SDL_RenderReadPixelsAsync SDL_RenderReadPixelsAsync_REAL
+#define SDL_PollPixelReadback SDL_PollPixelReadback_REAL
+#define SDL_WaitPixelReadback SDL_WaitPixelReadback_REAL
+#define SDL_FreePixelReadback SDL_FreePixelReadback_REAL
+#define SDL_GetRendererStats SDL_GetRendererStats_REAL
+#define SDL_SoftStretchLinear SDL_SoftStretchLinear_REAL
+#define SDL_CreateSurfaceView SDL_CreateSurfaceView_REAL
+#define SDL_SetWindowFrameCallback SDL_SetWindowFrameCallback_REAL
+#define SDL_GetWindowVBlank SDL_GetWindowVBlank_REAL
+#define SDL_GetWindowPresentStats SDL_GetWindowPresentStats_REAL
+#define SDL_GetVideoInitTimes SDL_GetVideoInitTimes_REAL
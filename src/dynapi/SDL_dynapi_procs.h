@@ -697,3 +697,19 @@ SDL_DYNAPI_PROC(float,SDL_fmodf,(float a, float b),(a,b),return)
 SDL_DYNAPI_PROC(void,SDL_SetYUVConversionMode,(SDL_YUV_CONVERSION_MODE a),(a),)
 SDL_DYNAPI_PROC(SDL_YUV_CONVERSION_MODE,SDL_GetYUVConversionMode,(void),(),return)
 SDL_DYNAPI_PROC(SDL_YUV_CONVERSION_MODE,SDL_GetYUVConversionModeForResolution,(int a, int b),(a,b),return)
+SDL_DYNAPI_PROC(SDL_TextureAtlas*,SDL_CreateTextureAtlas,(SDL_Renderer *a, Uint32 b, int c, int d, size_t e),(a,b,c,d,e),return)
+SDL_DYNAPI_PROC(SDL_AtlasEntryID,SDL_TextureAtlasAdd,(SDL_TextureAtlas *a, SDL_Surface *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_TextureAtlasGet,(SDL_TextureAtlas *a, SDL_AtlasEntryID b, SDL_Texture **c, SDL_Rect *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(void,SDL_TextureAtlasRemove,(SDL_TextureAtlas *a, SDL_AtlasEntryID b),(a,b),)
+SDL_DYNAPI_PROC(void,SDL_DestroyTextureAtlas,(SDL_TextureAtlas *a),(a),)
+SDL_DYNAPI_PROC(SDL_PixelReadback*,SDL_RenderReadPixelsAsync,(SDL_Renderer *a, const SDL_Rect *b, Uint32 c),(a,b,c),return)
+SDL_DYNAPI_PROC(SDL_bool,SDL_PollPixelReadback,(SDL_PixelReadback *a),(a),return)
+SDL_DYNAPI_PROC(int,SDL_WaitPixelReadback,(SDL_PixelReadback *a, SDL_Rect *b, void **c, int *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(void,SDL_FreePixelReadback,(SDL_PixelReadback *a),(a),)
+SDL_DYNAPI_PROC(int,SDL_GetRendererStats,(SDL_Renderer *a, SDL_RendererStats *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_SoftStretchLinear,(SDL_Surface *a, const SDL_Rect *b, SDL_Surface *c, const SDL_Rect *d),(a,b,c,d),return)
+SDL_DYNAPI_PROC(SDL_Surface*,SDL_CreateSurfaceView,(SDL_Surface *a, const SDL_Rect *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_SetWindowFrameCallback,(SDL_Window *a, SDL_WindowFrameCallback b, void *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_GetWindowVBlank,(SDL_Window *a, Uint64 *b, Uint64 *c),(a,b,c),return)
+SDL_DYNAPI_PROC(int,SDL_GetWindowPresentStats,(SDL_Window *a, SDL_PresentStats *b),(a,b),return)
+SDL_DYNAPI_PROC(int,SDL_GetVideoInitTimes,(SDL_VideoInitTimes *a),(a),return)
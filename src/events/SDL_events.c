@@ -669,6 +669,23 @@ SDL_WaitEvent(SDL_Event * event)
     return SDL_WaitEventTimeout(event, -1);
 }
 
+/* Sleep until the video driver has input, but never for long, since events
+   pushed from other threads don't wake it up */
+static void
+SDL_WaitEventSource(int timeout)
+{
+    SDL_VideoDevice *_this = SDL_GetVideoDevice();
+
+    if (timeout < 0 || timeout > 10) {
+        timeout = 10;
+    }
+    if (_this && _this->WaitEventTimeout) {
+        _this->WaitEventTimeout(_this, timeout);
+    } else {
+        SDL_Delay(timeout);
+    }
+}
+
 int
 SDL_WaitEventTimeout(SDL_Event * event, int timeout)
 {
@@ -691,7 +708,7 @@ SDL_WaitEventTimeout(SDL_Event * event, int timeout)
                 /* Timeout expired and no events */
                 return 0;
             }
-            SDL_Delay(10);
+            SDL_WaitEventSource(timeout > 0 ? (int)(expiration - SDL_GetTicks()) : -1);
             break;
         default:
             /* Has events */
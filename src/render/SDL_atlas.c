@@ -0,0 +1,555 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Texture atlas support, packing many small images into a few large
+   textures using a skyline bottom-left packer.
+ */
+
+#include "SDL_assert.h"
+#include "SDL_render.h"
+
+
+/* Empty pixels kept to the right and below each entry, so that linear
+   filtering doesn't pull in pixels from neighboring entries. */
+#define ATLAS_PADDING   1
+
+/* Entry IDs are a slot index plus a generation count, so stale IDs for
+   removed or evicted entries can be detected. */
+#define ATLAS_SLOT_BITS     20
+#define ATLAS_SLOT_MASK     ((1 << ATLAS_SLOT_BITS) - 1)
+#define ATLAS_MAX_SLOTS     (ATLAS_SLOT_MASK - 1)
+#define ATLAS_GENERATION(id)    ((id) >> ATLAS_SLOT_BITS)
+#define ATLAS_MAKE_ID(slot, generation) \
+    (((Uint32)(generation) << ATLAS_SLOT_BITS) | (Uint32)((slot) + 1))
+
+typedef struct
+{
+    int x;
+    int y;
+    int w;
+} SDL_AtlasSkylineNode;
+
+typedef struct
+{
+    SDL_Texture *texture;
+    SDL_AtlasSkylineNode *skyline;
+    int num_nodes;
+    int num_entries;
+    Uint32 last_used;
+} SDL_AtlasPage;
+
+typedef struct
+{
+    int page;               /**< Page index, or -1 if the slot is free */
+    Uint32 generation;
+    SDL_Rect rect;
+    int next_free;
+} SDL_AtlasEntry;
+
+struct SDL_TextureAtlas
+{
+    SDL_Renderer *renderer;
+    Uint32 format;
+    int page_w;
+    int page_h;
+    int max_pages;
+
+    SDL_AtlasPage *pages;
+    int num_pages;
+
+    SDL_AtlasEntry *entries;
+    int num_slots;
+    int max_slots;
+    int free_slot;
+
+    Uint32 clock;
+};
+
+
+static void
+SDL_ResetAtlasSkyline(SDL_TextureAtlas *atlas, SDL_AtlasPage *page)
+{
+    page->skyline[0].x = 0;
+    page->skyline[0].y = 0;
+    page->skyline[0].w = atlas->page_w;
+    page->num_nodes = 1;
+}
+
+static int
+SDL_ClearAtlasPage(SDL_TextureAtlas *atlas, SDL_AtlasPage *page)
+{
+    int pitch = atlas->page_w * SDL_BYTESPERPIXEL(atlas->format);
+    void *zero = SDL_calloc(atlas->page_h, pitch);
+    int retval;
+
+    if (!zero) {
+        return SDL_OutOfMemory();
+    }
+    retval = SDL_UpdateTexture(page->texture, NULL, zero, pitch);
+    SDL_free(zero);
+    return retval;
+}
+
+static int
+SDL_CreateAtlasPage(SDL_TextureAtlas *atlas)
+{
+    SDL_AtlasPage *pages;
+    SDL_AtlasPage *page;
+
+    pages = (SDL_AtlasPage *) SDL_realloc(atlas->pages, (atlas->num_pages + 1) * sizeof(*pages));
+    if (!pages) {
+        return SDL_OutOfMemory();
+    }
+    atlas->pages = pages;
+
+    page = &pages[atlas->num_pages];
+    SDL_zerop(page);
+
+    /* A skyline can't have more segments than the page has columns */
+    page->skyline = (SDL_AtlasSkylineNode *) SDL_malloc((atlas->page_w + 1) * sizeof(*page->skyline));
+    if (!page->skyline) {
+        return SDL_OutOfMemory();
+    }
+    page->texture = SDL_CreateTexture(atlas->renderer, atlas->format, SDL_TEXTUREACCESS_STATIC, atlas->page_w, atlas->page_h);
+    if (!page->texture) {
+        SDL_free(page->skyline);
+        return -1;
+    }
+    SDL_SetTextureBlendMode(page->texture, SDL_BLENDMODE_BLEND);
+    if (SDL_ClearAtlasPage(atlas, page) < 0) {
+        SDL_DestroyTexture(page->texture);
+        SDL_free(page->skyline);
+        return -1;
+    }
+    SDL_ResetAtlasSkyline(atlas, page);
+
+    return atlas->num_pages++;
+}
+
+/* Returns the y position the rectangle would rest at if placed at the
+   skyline node, or -1 if it doesn't fit there. */
+static int
+SDL_AtlasSkylineFit(SDL_TextureAtlas *atlas, SDL_AtlasPage *page, int index, int w, int h)
+{
+    const SDL_AtlasSkylineNode *node = &page->skyline[index];
+    int width_left = w;
+    int y;
+
+    if (node->x + w > atlas->page_w) {
+        return -1;
+    }
+
+    y = node->y;
+    while (width_left > 0) {
+        if (node->y > y) {
+            y = node->y;
+        }
+        if (y + h > atlas->page_h) {
+            return -1;
+        }
+        width_left -= node->w;
+        ++node;
+    }
+    return y;
+}
+
+static SDL_bool
+SDL_AtlasSkylineFindPosition(SDL_TextureAtlas *atlas, SDL_AtlasPage *page, int w, int h,
+                             int *best_index, int *best_x, int *best_y)
+{
+    int best_height = atlas->page_h + 1;
+    int best_width = atlas->page_w + 1;
+    int i, y;
+
+    *best_index = -1;
+    for (i = 0; i < page->num_nodes; ++i) {
+        y = SDL_AtlasSkylineFit(atlas, page, i, w, h);
+        if (y < 0) {
+            continue;
+        }
+        if ((y + h) < best_height ||
+            ((y + h) == best_height && page->skyline[i].w < best_width)) {
+            best_height = y + h;
+            best_width = page->skyline[i].w;
+            *best_index = i;
+            *best_x = page->skyline[i].x;
+            *best_y = y;
+        }
+    }
+    return (*best_index >= 0) ? SDL_TRUE : SDL_FALSE;
+}
+
+static void
+SDL_AtlasSkylineInsert(SDL_AtlasPage *page, int index, int x, int y, int w, int h)
+{
+    SDL_AtlasSkylineNode *skyline = page->skyline;
+    int i;
+
+    SDL_memmove(&skyline[index + 1], &skyline[index], (page->num_nodes - index) * sizeof(*skyline));
+    skyline[index].x = x;
+    skyline[index].y = y + h;
+    skyline[index].w = w;
+    ++page->num_nodes;
+
+    /* Trim or remove the segments now covered by the new one */
+    for (i = index + 1; i < page->num_nodes; ++i) {
+        const int end = skyline[i - 1].x + skyline[i - 1].w;
+        if (skyline[i].x >= end) {
+            break;
+        }
+        {
+            const int shrink = end - skyline[i].x;
+            skyline[i].x += shrink;
+            skyline[i].w -= shrink;
+            if (skyline[i].w > 0) {
+                break;
+            }
+            SDL_memmove(&skyline[i], &skyline[i + 1], (page->num_nodes - i - 1) * sizeof(*skyline));
+            --page->num_nodes;
+            --i;
+        }
+    }
+
+    /* Merge neighboring segments at the same height */
+    for (i = 0; i < page->num_nodes - 1; ++i) {
+        if (skyline[i].y == skyline[i + 1].y) {
+            skyline[i].w += skyline[i + 1].w;
+            SDL_memmove(&skyline[i + 1], &skyline[i + 2], (page->num_nodes - i - 2) * sizeof(*skyline));
+            --page->num_nodes;
+            --i;
+        }
+    }
+}
+
+static void
+SDL_FreeAtlasSlot(SDL_TextureAtlas *atlas, int slot)
+{
+    SDL_AtlasEntry *entry = &atlas->entries[slot];
+
+    entry->page = -1;
+    entry->generation = (entry->generation + 1) & (0xFFFFFFFF >> ATLAS_SLOT_BITS);
+    entry->next_free = atlas->free_slot;
+    atlas->free_slot = slot;
+}
+
+static int
+SDL_AllocAtlasSlot(SDL_TextureAtlas *atlas)
+{
+    int slot;
+
+    if (atlas->free_slot >= 0) {
+        slot = atlas->free_slot;
+        atlas->free_slot = atlas->entries[slot].next_free;
+        return slot;
+    }
+
+    if (atlas->num_slots == atlas->max_slots) {
+        int max_slots = atlas->max_slots ? atlas->max_slots * 2 : 64;
+        SDL_AtlasEntry *entries;
+
+        if (max_slots > ATLAS_MAX_SLOTS) {
+            max_slots = ATLAS_MAX_SLOTS;
+        }
+        if (max_slots == atlas->num_slots) {
+            return SDL_SetError("Too many texture atlas entries");
+        }
+        entries = (SDL_AtlasEntry *) SDL_realloc(atlas->entries, max_slots * sizeof(*entries));
+        if (!entries) {
+            return SDL_OutOfMemory();
+        }
+        atlas->entries = entries;
+        atlas->max_slots = max_slots;
+    }
+
+    slot = atlas->num_slots++;
+    SDL_zero(atlas->entries[slot]);
+    return slot;
+}
+
+/* Throw away the least recently used page, so it can be packed again */
+static int
+SDL_EvictAtlasPage(SDL_TextureAtlas *atlas)
+{
+    int i, lru = 0;
+    SDL_AtlasPage *page;
+
+    for (i = 1; i < atlas->num_pages; ++i) {
+        if ((Sint32)(atlas->pages[i].last_used - atlas->pages[lru].last_used) < 0) {
+            lru = i;
+        }
+    }
+    page = &atlas->pages[lru];
+
+    for (i = 0; i < atlas->num_slots; ++i) {
+        if (atlas->entries[i].page == lru) {
+            SDL_FreeAtlasSlot(atlas, i);
+        }
+    }
+    page->num_entries = 0;
+    SDL_ResetAtlasSkyline(atlas, page);
+    if (SDL_ClearAtlasPage(atlas, page) < 0) {
+        return -1;
+    }
+    return lru;
+}
+
+SDL_TextureAtlas *
+SDL_CreateTextureAtlas(SDL_Renderer * renderer, Uint32 format, int page_w, int page_h, size_t max_bytes)
+{
+    SDL_TextureAtlas *atlas;
+    SDL_RendererInfo info;
+    size_t page_bytes;
+
+    if (SDL_GetRendererInfo(renderer, &info) < 0) {
+        return NULL;
+    }
+
+    if (!format) {
+        Uint32 i;
+
+        for (i = 0; i < info.num_texture_formats; ++i) {
+            if (!SDL_ISPIXELFORMAT_FOURCC(info.texture_formats[i]) &&
+                SDL_ISPIXELFORMAT_ALPHA(info.texture_formats[i])) {
+                format = info.texture_formats[i];
+                break;
+            }
+        }
+        if (!format) {
+            format = SDL_PIXELFORMAT_ARGB8888;
+        }
+    }
+    if (SDL_ISPIXELFORMAT_FOURCC(format) || SDL_ISPIXELFORMAT_INDEXED(format)) {
+        SDL_SetError("Texture atlases need a packed pixel format");
+        return NULL;
+    }
+
+    if (page_w <= 0 || page_h <= 0) {
+        SDL_InvalidParamError("page_w/page_h");
+        return NULL;
+    }
+    if (info.max_texture_width && page_w > info.max_texture_width) {
+        page_w = info.max_texture_width;
+    }
+    if (info.max_texture_height && page_h > info.max_texture_height) {
+        page_h = info.max_texture_height;
+    }
+
+    atlas = (SDL_TextureAtlas *) SDL_calloc(1, sizeof(*atlas));
+    if (!atlas) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    atlas->renderer = renderer;
+    atlas->format = format;
+    atlas->page_w = page_w;
+    atlas->page_h = page_h;
+    atlas->free_slot = -1;
+
+    page_bytes = (size_t)page_w * page_h * SDL_BYTESPERPIXEL(format);
+    if (max_bytes) {
+        atlas->max_pages = (int)SDL_max(max_bytes / page_bytes, 1);
+    } else {
+        atlas->max_pages = SDL_MAX_SINT32;
+    }
+    return atlas;
+}
+
+SDL_AtlasEntryID
+SDL_TextureAtlasAdd(SDL_TextureAtlas * atlas, SDL_Surface * surface)
+{
+    SDL_Surface *converted = NULL;
+    SDL_AtlasEntry *entry;
+    SDL_AtlasPage *page;
+    int w, h, i, slot;
+    int page_index = -1, node = -1, x = 0, y = 0;
+    int status;
+
+    if (!atlas) {
+        SDL_InvalidParamError("atlas");
+        return 0;
+    }
+    if (!surface) {
+        SDL_InvalidParamError("surface");
+        return 0;
+    }
+
+    w = surface->w + ATLAS_PADDING;
+    h = surface->h + ATLAS_PADDING;
+    if (w > atlas->page_w) {
+        w = surface->w;
+    }
+    if (h > atlas->page_h) {
+        h = surface->h;
+    }
+    if (surface->w <= 0 || surface->h <= 0 || w > atlas->page_w || h > atlas->page_h) {
+        SDL_SetError("Surface doesn't fit in a %dx%d atlas page", atlas->page_w, atlas->page_h);
+        return 0;
+    }
+
+    for (i = 0; i < atlas->num_pages; ++i) {
+        if (SDL_AtlasSkylineFindPosition(atlas, &atlas->pages[i], w, h, &node, &x, &y)) {
+            page_index = i;
+            break;
+        }
+    }
+    if (page_index < 0) {
+        if (atlas->num_pages < atlas->max_pages) {
+            page_index = SDL_CreateAtlasPage(atlas);
+        } else {
+            page_index = SDL_EvictAtlasPage(atlas);
+        }
+        if (page_index < 0) {
+            return 0;
+        }
+        if (!SDL_AtlasSkylineFindPosition(atlas, &atlas->pages[page_index], w, h, &node, &x, &y)) {
+            SDL_SetError("Surface doesn't fit in an empty atlas page");
+            return 0;
+        }
+    }
+    page = &atlas->pages[page_index];
+
+    slot = SDL_AllocAtlasSlot(atlas);
+    if (slot < 0) {
+        return 0;
+    }
+
+    if (surface->format->format != atlas->format) {
+        converted = SDL_ConvertSurfaceFormat(surface, atlas->format, 0);
+        if (!converted) {
+            SDL_FreeAtlasSlot(atlas, slot);
+            return 0;
+        }
+        surface = converted;
+    }
+
+    entry = &atlas->entries[slot];
+    entry->rect.x = x;
+    entry->rect.y = y;
+    entry->rect.w = surface->w;
+    entry->rect.h = surface->h;
+
+    if (SDL_MUSTLOCK(surface)) {
+        SDL_LockSurface(surface);
+        status = SDL_UpdateTexture(page->texture, &entry->rect, surface->pixels, surface->pitch);
+        SDL_UnlockSurface(surface);
+    } else {
+        status = SDL_UpdateTexture(page->texture, &entry->rect, surface->pixels, surface->pitch);
+    }
+    SDL_FreeSurface(converted);
+
+    if (status < 0) {
+        SDL_FreeAtlasSlot(atlas, slot);
+        return 0;
+    }
+
+    SDL_AtlasSkylineInsert(page, node, x, y, w, h);
+    entry->page = page_index;
+    ++page->num_entries;
+    page->last_used = ++atlas->clock;
+
+    return ATLAS_MAKE_ID(slot, entry->generation);
+}
+
+static SDL_AtlasEntry *
+SDL_GetAtlasEntry(SDL_TextureAtlas * atlas, SDL_AtlasEntryID id)
+{
+    const int slot = (int)(id & ATLAS_SLOT_MASK) - 1;
+    SDL_AtlasEntry *entry;
+
+    if (!atlas) {
+        SDL_InvalidParamError("atlas");
+        return NULL;
+    }
+    if (slot < 0 || slot >= atlas->num_slots) {
+        SDL_SetError("Invalid texture atlas entry");
+        return NULL;
+    }
+    entry = &atlas->entries[slot];
+    if (entry->page < 0 || entry->generation != ATLAS_GENERATION(id)) {
+        SDL_SetError("Texture atlas entry was removed or evicted");
+        return NULL;
+    }
+    return entry;
+}
+
+int
+SDL_TextureAtlasGet(SDL_TextureAtlas * atlas, SDL_AtlasEntryID id,
+                    SDL_Texture ** texture, SDL_Rect * rect)
+{
+    SDL_AtlasEntry *entry = SDL_GetAtlasEntry(atlas, id);
+    SDL_AtlasPage *page;
+
+    if (!entry) {
+        return -1;
+    }
+
+    page = &atlas->pages[entry->page];
+    page->last_used = ++atlas->clock;
+    if (texture) {
+        *texture = page->texture;
+    }
+    if (rect) {
+        *rect = entry->rect;
+    }
+    return 0;
+}
+
+void
+SDL_TextureAtlasRemove(SDL_TextureAtlas * atlas, SDL_AtlasEntryID id)
+{
+    SDL_AtlasEntry *entry = SDL_GetAtlasEntry(atlas, id);
+    SDL_AtlasPage *page;
+
+    if (!entry) {
+        return;
+    }
+
+    page = &atlas->pages[entry->page];
+    SDL_FreeAtlasSlot(atlas, (int)(entry - atlas->entries));
+
+    /* The skyline can't reclaim space from the middle of the page, but
+       once a page is empty it can be packed from scratch. */
+    if (--page->num_entries == 0) {
+        SDL_ResetAtlasSkyline(atlas, page);
+        SDL_ClearAtlasPage(atlas, page);
+    }
+}
+
+void
+SDL_DestroyTextureAtlas(SDL_TextureAtlas * atlas)
+{
+    int i;
+
+    if (!atlas) {
+        return;
+    }
+
+    for (i = 0; i < atlas->num_pages; ++i) {
+        SDL_DestroyTexture(atlas->pages[i].texture);
+        SDL_free(atlas->pages[i].skyline);
+    }
+    SDL_free(atlas->pages);
+    SDL_free(atlas->entries);
+    SDL_free(atlas);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
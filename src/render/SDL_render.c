@@ -28,6 +28,7 @@
 #include "SDL_render.h"
 #include "SDL_sysrender.h"
 #include "software/SDL_render_sw_c.h"
+#include "../thread/SDL_systhread.h"
 
 
 #define SDL_WINDOWRENDERDATA    "_SDL_WindowRenderData"
@@ -46,6 +47,13 @@
         return retval; \
     }
 
+#define CHECK_READBACK_MAGIC(readback, retval) \
+    SDL_assert(readback && readback->magic == &readback_magic); \
+    if (!readback || readback->magic != &readback_magic) { \
+        SDL_SetError("Invalid pixel readback"); \
+        return retval; \
+    }
+
 /* Predefined blend modes */
 #define SDL_COMPOSE_BLENDMODE(srcColorFactor, dstColorFactor, colorOperation, \
                               srcAlphaFactor, dstAlphaFactor, alphaOperation) \
@@ -101,9 +109,69 @@ static const SDL_RenderDriver *render_drivers[] = {
 
 static char renderer_magic;
 static char texture_magic;
+static char readback_magic;
 
 static int UpdateLogicalSize(SDL_Renderer *renderer);
 
+/* Forget the viewport and clip state sent to the driver, so it's sent again */
+static void
+InvalidateRenderState(SDL_Renderer *renderer)
+{
+    renderer->applied.viewport_valid = SDL_FALSE;
+    renderer->applied.clip_valid = SDL_FALSE;
+}
+
+static int
+FlushViewport(SDL_Renderer *renderer)
+{
+    if (renderer->applied.viewport_valid &&
+        SDL_RectEquals(&renderer->applied.viewport, &renderer->viewport)) {
+        return 0;
+    }
+
+    renderer->applied.viewport_valid = SDL_FALSE;
+    if (renderer->UpdateViewport(renderer) < 0) {
+        return -1;
+    }
+    renderer->applied.viewport = renderer->viewport;
+    renderer->applied.viewport_valid = SDL_TRUE;
+    ++renderer->stats.state_changes;
+    return 0;
+}
+
+static int
+FlushClipRect(SDL_Renderer *renderer)
+{
+    /* Drivers place the clip rect relative to the viewport */
+    if (renderer->applied.clip_valid &&
+        renderer->applied.clipping_enabled == renderer->clipping_enabled &&
+        SDL_RectEquals(&renderer->applied.clip_rect, &renderer->clip_rect) &&
+        SDL_RectEquals(&renderer->applied.clip_viewport, &renderer->viewport)) {
+        return 0;
+    }
+
+    renderer->applied.clip_valid = SDL_FALSE;
+    if (renderer->UpdateClipRect(renderer) < 0) {
+        return -1;
+    }
+    renderer->applied.clipping_enabled = renderer->clipping_enabled;
+    renderer->applied.clip_rect = renderer->clip_rect;
+    renderer->applied.clip_viewport = renderer->viewport;
+    renderer->applied.clip_valid = SDL_TRUE;
+    ++renderer->stats.state_changes;
+    return 0;
+}
+
+static void
+CountTextureCopy(SDL_Renderer *renderer, SDL_Texture *texture)
+{
+    if (texture != renderer->applied.texture) {
+        renderer->applied.texture = texture;
+        ++renderer->stats.texture_binds;
+    }
+    ++renderer->stats.draw_calls;
+}
+
 int
 SDL_GetNumRenderDrivers(void)
 {
@@ -137,6 +205,9 @@ SDL_RendererEventWatch(void *userdata, SDL_Event *event)
     if (event->type == SDL_WINDOWEVENT) {
         SDL_Window *window = SDL_GetWindowFromID(event->window.windowID);
         if (window == renderer->window) {
+            /* The driver may lose its viewport and clip state here */
+            InvalidateRenderState(renderer);
+
             if (renderer->WindowEvent) {
                 renderer->WindowEvent(renderer, &event->window);
             }
@@ -170,7 +241,7 @@ SDL_RendererEventWatch(void *userdata, SDL_Event *event)
                         renderer->viewport.y = 0;
                         renderer->viewport.w = w;
                         renderer->viewport.h = h;
-                        renderer->UpdateViewport(renderer);
+                        FlushViewport(renderer);
                     }
                 }
 
@@ -700,7 +771,12 @@ SDL_SetTextureColorMod(SDL_Texture * texture, Uint8 r, Uint8 g, Uint8 b)
 
     CHECK_TEXTURE_MAGIC(texture, -1);
 
+    if (r == texture->r && g == texture->g && b == texture->b) {
+        return 0;
+    }
+
     renderer = texture->renderer;
+    ++renderer->stats.state_changes;
     if (r < 255 || g < 255 || b < 255) {
         texture->modMode |= SDL_TEXTUREMODULATE_COLOR;
     } else {
@@ -743,7 +819,12 @@ SDL_SetTextureAlphaMod(SDL_Texture * texture, Uint8 alpha)
 
     CHECK_TEXTURE_MAGIC(texture, -1);
 
+    if (alpha == texture->a) {
+        return 0;
+    }
+
     renderer = texture->renderer;
+    ++renderer->stats.state_changes;
     if (alpha < 255) {
         texture->modMode |= SDL_TEXTUREMODULATE_ALPHA;
     } else {
@@ -777,10 +858,15 @@ SDL_SetTextureBlendMode(SDL_Texture * texture, SDL_BlendMode blendMode)
 
     CHECK_TEXTURE_MAGIC(texture, -1);
 
+    if (blendMode == texture->blendMode) {
+        return 0;
+    }
+
     renderer = texture->renderer;
     if (!IsSupportedBlendMode(renderer, blendMode)) {
         return SDL_Unsupported();
     }
+    ++renderer->stats.state_changes;
     texture->blendMode = blendMode;
     if (texture->native) {
         return SDL_SetTextureBlendMode(texture->native, blendMode);
@@ -921,6 +1007,7 @@ SDL_UpdateTexture(SDL_Texture * texture, const SDL_Rect * rect,
         return SDL_UpdateTextureNative(texture, rect, pixels, pitch);
     } else {
         renderer = texture->renderer;
+        renderer->stats.upload_bytes += rect->w * rect->h * SDL_BYTESPERPIXEL(texture->format);
         return renderer->UpdateTexture(renderer, texture, rect, pixels, pitch);
     }
 }
@@ -1030,6 +1117,8 @@ int SDL_UpdateYUVTexture(SDL_Texture * texture, const SDL_Rect * rect,
         renderer = texture->renderer;
         SDL_assert(renderer->UpdateTextureYUV);
         if (renderer->UpdateTextureYUV) {
+            /* A full resolution Y plane, and U and V at a quarter of it */
+            renderer->stats.upload_bytes += rect->w * rect->h + 2 * ((rect->w + 1) / 2) * ((rect->h + 1) / 2);
             return renderer->UpdateTextureYUV(renderer, texture, rect, Yplane, Ypitch, Uplane, Upitch, Vplane, Vpitch);
         } else {
             return SDL_Unsupported();
@@ -1083,6 +1172,7 @@ SDL_LockTexture(SDL_Texture * texture, const SDL_Rect * rect,
         return SDL_LockTextureNative(texture, rect, pixels, pitch);
     } else {
         renderer = texture->renderer;
+        renderer->stats.upload_bytes += rect->w * rect->h * SDL_BYTESPERPIXEL(texture->format);
         return renderer->LockTexture(renderer, texture, rect, pixels, pitch);
     }
 }
@@ -1198,6 +1288,7 @@ SDL_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
     if (renderer->SetRenderTarget(renderer, texture) < 0) {
         return -1;
     }
+    ++renderer->stats.state_changes;
 
     if (texture) {
         renderer->viewport.x = 0;
@@ -1218,10 +1309,12 @@ SDL_SetRenderTarget(SDL_Renderer *renderer, SDL_Texture *texture)
         renderer->logical_w = renderer->logical_w_backup;
         renderer->logical_h = renderer->logical_h_backup;
     }
-    if (renderer->UpdateViewport(renderer) < 0) {
+    /* The driver needs the viewport and clip rect again for the new target */
+    InvalidateRenderState(renderer);
+    if (FlushViewport(renderer) < 0) {
         return -1;
     }
-    if (renderer->UpdateClipRect(renderer) < 0) {
+    if (FlushClipRect(renderer) < 0) {
         return -1;
     }
 
@@ -1411,7 +1504,7 @@ SDL_RenderSetViewport(SDL_Renderer * renderer, const SDL_Rect * rect)
             return -1;
         }
     }
-    return renderer->UpdateViewport(renderer);
+    return FlushViewport(renderer);
 }
 
 void
@@ -1442,7 +1535,7 @@ SDL_RenderSetClipRect(SDL_Renderer * renderer, const SDL_Rect * rect)
         renderer->clipping_enabled = SDL_FALSE;
         SDL_zero(renderer->clip_rect);
     }
-    return renderer->UpdateClipRect(renderer);
+    return FlushClipRect(renderer);
 }
 
 void
@@ -1494,6 +1587,10 @@ SDL_SetRenderDrawColor(SDL_Renderer * renderer,
 {
     CHECK_RENDERER_MAGIC(renderer, -1);
 
+    if (r == renderer->r && g == renderer->g && b == renderer->b && a == renderer->a) {
+        return 0;
+    }
+    ++renderer->stats.state_changes;
     renderer->r = r;
     renderer->g = g;
     renderer->b = b;
@@ -1527,9 +1624,13 @@ SDL_SetRenderDrawBlendMode(SDL_Renderer * renderer, SDL_BlendMode blendMode)
 {
     CHECK_RENDERER_MAGIC(renderer, -1);
 
+    if (blendMode == renderer->blendMode) {
+        return 0;
+    }
     if (!IsSupportedBlendMode(renderer, blendMode)) {
         return SDL_Unsupported();
     }
+    ++renderer->stats.state_changes;
     renderer->blendMode = blendMode;
     return 0;
 }
@@ -1552,6 +1653,7 @@ SDL_RenderClear(SDL_Renderer * renderer)
     if (renderer->hidden) {
         return 0;
     }
+    ++renderer->stats.draw_calls;
     return renderer->RenderClear(renderer);
 }
 
@@ -1584,6 +1686,7 @@ RenderDrawPointsWithRects(SDL_Renderer * renderer,
         frects[i].h = renderer->scale.y;
     }
 
+    ++renderer->stats.draw_calls;
     status = renderer->RenderFillRects(renderer, frects, count);
 
     SDL_stack_free(frects);
@@ -1626,6 +1729,7 @@ SDL_RenderDrawPoints(SDL_Renderer * renderer,
         fpoints[i].y = points[i].y * renderer->scale.y;
     }
 
+    ++renderer->stats.draw_calls;
     status = renderer->RenderDrawPoints(renderer, fpoints, count);
 
     SDL_stack_free(fpoints);
@@ -1687,10 +1791,12 @@ RenderDrawLinesWithRects(SDL_Renderer * renderer,
             fpoints[0].y = points[i].y * renderer->scale.y;
             fpoints[1].x = points[i+1].x * renderer->scale.x;
             fpoints[1].y = points[i+1].y * renderer->scale.y;
+            ++renderer->stats.draw_calls;
             status += renderer->RenderDrawLines(renderer, fpoints, 2);
         }
     }
 
+    ++renderer->stats.draw_calls;
     status += renderer->RenderFillRects(renderer, frects, nrects);
 
     SDL_stack_free(frects);
@@ -1736,6 +1842,7 @@ SDL_RenderDrawLines(SDL_Renderer * renderer,
         fpoints[i].y = points[i].y * renderer->scale.y;
     }
 
+    ++renderer->stats.draw_calls;
     status = renderer->RenderDrawLines(renderer, fpoints, count);
 
     SDL_stack_free(fpoints);
@@ -1850,6 +1957,7 @@ SDL_RenderFillRects(SDL_Renderer * renderer,
         frects[i].h = rects[i].h * renderer->scale.y;
     }
 
+    ++renderer->stats.draw_calls;
     status = renderer->RenderFillRects(renderer, frects, count);
 
     SDL_stack_free(frects);
@@ -1906,6 +2014,7 @@ SDL_RenderCopy(SDL_Renderer * renderer, SDL_Texture * texture,
     frect.w = real_dstrect.w * renderer->scale.x;
     frect.h = real_dstrect.h * renderer->scale.y;
 
+    CountTextureCopy(renderer, texture);
     return renderer->RenderCopy(renderer, texture, &real_srcrect, &frect);
 }
 
@@ -1978,6 +2087,7 @@ SDL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
     fcenter.x = real_center.x * renderer->scale.x;
     fcenter.y = real_center.y * renderer->scale.y;
 
+    CountTextureCopy(renderer, texture);
     return renderer->RenderCopyEx(renderer, texture, &real_srcrect, &frect, angle, &fcenter, flip);
 }
 
@@ -2018,11 +2128,334 @@ SDL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                       format, pixels, pitch);
 }
 
+static void
+SDL_ConvertReadbackPixels(SDL_PixelReadback *readback)
+{
+    readback->status = SDL_ConvertPixels(readback->rect.w, readback->rect.h,
+                                         readback->native_format,
+                                         readback->native_pixels,
+                                         readback->native_pitch,
+                                         readback->format,
+                                         readback->pixels, readback->pitch);
+    SDL_AtomicSet(&readback->converted, 1);
+}
+
+/* Converts queued readbacks until the renderer is destroyed */
+static int SDLCALL
+SDL_ReadbackWorker(void *data)
+{
+    SDL_Renderer *renderer = (SDL_Renderer *) data;
+
+    SDL_LockMutex(renderer->readback_lock);
+    for ( ; ; ) {
+        SDL_PixelReadback *readback;
+
+        while (!renderer->readback_queue && !renderer->readback_quit) {
+            SDL_CondWait(renderer->readback_cond, renderer->readback_lock);
+        }
+        /* Finish everything queued before quitting, nobody else will */
+        readback = renderer->readback_queue;
+        if (!readback) {
+            break;
+        }
+        renderer->readback_queue = readback->convert_next;
+        SDL_UnlockMutex(renderer->readback_lock);
+
+        SDL_ConvertReadbackPixels(readback);
+
+        SDL_LockMutex(renderer->readback_lock);
+        SDL_CondBroadcast(renderer->readback_cond);
+    }
+    SDL_UnlockMutex(renderer->readback_lock);
+
+    return 0;
+}
+
+static int
+SDL_QueueReadbackConversion(SDL_Renderer *renderer, SDL_PixelReadback *readback)
+{
+    SDL_PixelReadback **tail;
+
+    if (!renderer->readback_thread) {
+        if (!renderer->readback_lock) {
+            renderer->readback_lock = SDL_CreateMutex();
+        }
+        if (!renderer->readback_cond) {
+            renderer->readback_cond = SDL_CreateCond();
+        }
+        if (!renderer->readback_lock || !renderer->readback_cond) {
+            return -1;
+        }
+        renderer->readback_thread = SDL_CreateThreadInternal(SDL_ReadbackWorker,
+                                                             "SDLReadback", 0, renderer);
+        if (!renderer->readback_thread) {
+            return -1;
+        }
+    }
+
+    SDL_LockMutex(renderer->readback_lock);
+    for (tail = &renderer->readback_queue; *tail; tail = &(*tail)->convert_next) {
+        continue;
+    }
+    *tail = readback;
+    readback->converting = SDL_TRUE;
+    SDL_CondBroadcast(renderer->readback_cond);
+    SDL_UnlockMutex(renderer->readback_lock);
+    return 0;
+}
+
+/* Wait for the worker to finish converting a readback */
+static void
+SDL_WaitReadbackConversion(SDL_PixelReadback *readback)
+{
+    SDL_Renderer *renderer = readback->renderer;
+
+    if (!readback->converting) {
+        return;
+    }
+
+    /* Without a renderer the worker has already been stopped, after
+       converting everything in its queue */
+    if (renderer) {
+        SDL_LockMutex(renderer->readback_lock);
+        while (!SDL_AtomicGet(&readback->converted)) {
+            SDL_CondWait(renderer->readback_cond, renderer->readback_lock);
+        }
+        SDL_UnlockMutex(renderer->readback_lock);
+    }
+    readback->converting = SDL_FALSE;
+}
+
+/* Stop the readback worker once it has converted everything queued */
+static void
+SDL_StopReadbackWorker(SDL_Renderer *renderer)
+{
+    if (renderer->readback_thread) {
+        SDL_LockMutex(renderer->readback_lock);
+        renderer->readback_quit = SDL_TRUE;
+        SDL_CondBroadcast(renderer->readback_cond);
+        SDL_UnlockMutex(renderer->readback_lock);
+
+        SDL_WaitThread(renderer->readback_thread, NULL);
+        renderer->readback_thread = NULL;
+    }
+    if (renderer->readback_cond) {
+        SDL_DestroyCond(renderer->readback_cond);
+        renderer->readback_cond = NULL;
+    }
+    if (renderer->readback_lock) {
+        SDL_DestroyMutex(renderer->readback_lock);
+        renderer->readback_lock = NULL;
+    }
+}
+
+/* Called once the native pixels have arrived, to start the conversion */
+static void
+SDL_FinishReadbackTransfer(SDL_PixelReadback *readback, int status)
+{
+    readback->transferred = SDL_TRUE;
+    if (status < 0) {
+        readback->status = -1;
+        return;
+    }
+
+    if (readback->native_format == readback->format) {
+        readback->pixels = readback->native_pixels;
+        readback->pitch = readback->native_pitch;
+        return;
+    }
+
+    readback->pitch = readback->rect.w * SDL_BYTESPERPIXEL(readback->format);
+    readback->pixels = SDL_malloc(readback->rect.h * readback->pitch);
+    if (!readback->pixels) {
+        readback->status = SDL_OutOfMemory();
+        return;
+    }
+
+    if (SDL_QueueReadbackConversion(readback->renderer, readback) < 0) {
+        /* Do it the slow way */
+        SDL_ConvertReadbackPixels(readback);
+    }
+}
+
+static void
+SDL_UnlinkPixelReadback(SDL_PixelReadback *readback)
+{
+    SDL_Renderer *renderer = readback->renderer;
+
+    if (readback->next) {
+        readback->next->prev = readback->prev;
+    }
+    if (readback->prev) {
+        readback->prev->next = readback->next;
+    } else {
+        renderer->readbacks = readback->next;
+    }
+    readback->prev = readback->next = NULL;
+
+    if (!readback->transferred && renderer->DestroyReadPixels) {
+        renderer->DestroyReadPixels(renderer, readback);
+    }
+    readback->renderer = NULL;
+}
+
+SDL_PixelReadback *
+SDL_RenderReadPixelsAsync(SDL_Renderer * renderer, const SDL_Rect * rect,
+                          Uint32 format)
+{
+    SDL_PixelReadback *readback;
+
+    CHECK_RENDERER_MAGIC(renderer, NULL);
+
+    if (!renderer->RenderReadPixels && !renderer->QueueReadPixels) {
+        SDL_Unsupported();
+        return NULL;
+    }
+
+    if (!format) {
+        format = SDL_GetWindowPixelFormat(renderer->window);
+    }
+
+    readback = (SDL_PixelReadback *) SDL_calloc(1, sizeof(*readback));
+    if (!readback) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    readback->magic = &readback_magic;
+    readback->renderer = renderer;
+    readback->format = format;
+    readback->next = renderer->readbacks;
+    if (renderer->readbacks) {
+        renderer->readbacks->prev = readback;
+    }
+    renderer->readbacks = readback;
+
+    readback->rect = renderer->viewport;
+    if (rect && !SDL_IntersectRect(rect, &readback->rect, &readback->rect)) {
+        readback->rect.w = readback->rect.h = 0;
+    }
+    if (!readback->rect.w || !readback->rect.h) {
+        readback->transferred = SDL_TRUE;
+        return readback;
+    }
+
+    if (renderer->QueueReadPixels) {
+        if (renderer->QueueReadPixels(renderer, readback) < 0) {
+            readback->transferred = SDL_TRUE;
+            SDL_FreePixelReadback(readback);
+            return NULL;
+        }
+    } else {
+        /* Read the pixels now, in whatever format is cheapest */
+        readback->native_format = renderer->target ? renderer->target->format :
+                                  SDL_GetWindowPixelFormat(renderer->window);
+        if (readback->native_format == SDL_PIXELFORMAT_UNKNOWN) {
+            readback->native_format = format;
+        }
+    }
+
+    readback->native_pitch = readback->rect.w * SDL_BYTESPERPIXEL(readback->native_format);
+    readback->native_pixels = SDL_malloc(readback->rect.h * readback->native_pitch);
+    if (!readback->native_pixels) {
+        SDL_OutOfMemory();
+        SDL_FreePixelReadback(readback);
+        return NULL;
+    }
+
+    if (!renderer->QueueReadPixels) {
+        if (renderer->RenderReadPixels(renderer, &readback->rect,
+                                       readback->native_format,
+                                       readback->native_pixels,
+                                       readback->native_pitch) < 0) {
+            readback->transferred = SDL_TRUE;
+            SDL_FreePixelReadback(readback);
+            return NULL;
+        }
+        SDL_FinishReadbackTransfer(readback, 0);
+    }
+    return readback;
+}
+
+SDL_bool
+SDL_PollPixelReadback(SDL_PixelReadback * readback)
+{
+    CHECK_READBACK_MAGIC(readback, SDL_FALSE);
+
+    if (!readback->transferred && readback->renderer) {
+        SDL_Renderer *renderer = readback->renderer;
+        int status = renderer->FinishReadPixels(renderer, readback, SDL_FALSE);
+        if (status == 0) {
+            return SDL_FALSE;
+        }
+        SDL_FinishReadbackTransfer(readback, status);
+    }
+    if (readback->converting && !SDL_AtomicGet(&readback->converted)) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+int
+SDL_WaitPixelReadback(SDL_PixelReadback * readback, SDL_Rect * rect,
+                      void **pixels, int *pitch)
+{
+    CHECK_READBACK_MAGIC(readback, -1);
+
+    if (!readback->transferred) {
+        SDL_Renderer *renderer = readback->renderer;
+        if (!renderer) {
+            return SDL_SetError("Renderer was destroyed before the readback completed");
+        }
+        SDL_FinishReadbackTransfer(readback, renderer->FinishReadPixels(renderer, readback, SDL_TRUE));
+    }
+    if (readback->converting) {
+        SDL_WaitReadbackConversion(readback);
+        if (readback->status < 0) {
+            return SDL_SetError("Couldn't convert pixels to %s", SDL_GetPixelFormatName(readback->format));
+        }
+    }
+    if (readback->status < 0) {
+        return -1;
+    }
+
+    if (rect) {
+        *rect = readback->rect;
+    }
+    if (pixels) {
+        *pixels = readback->pixels;
+    }
+    if (pitch) {
+        *pitch = readback->pitch;
+    }
+    return 0;
+}
+
+void
+SDL_FreePixelReadback(SDL_PixelReadback * readback)
+{
+    CHECK_READBACK_MAGIC(readback, );
+
+    SDL_WaitReadbackConversion(readback);
+    if (readback->renderer) {
+        SDL_UnlinkPixelReadback(readback);
+    }
+
+    readback->magic = NULL;
+    if (readback->pixels != readback->native_pixels) {
+        SDL_free(readback->pixels);
+    }
+    SDL_free(readback->native_pixels);
+    SDL_free(readback);
+}
+
 void
 SDL_RenderPresent(SDL_Renderer * renderer)
 {
     CHECK_RENDERER_MAGIC(renderer, );
 
+    renderer->last_stats = renderer->stats;
+    SDL_zero(renderer->stats);
+
     /* Don't draw while we're hidden */
     if (renderer->hidden) {
         return;
@@ -2030,6 +2463,18 @@ SDL_RenderPresent(SDL_Renderer * renderer)
     renderer->RenderPresent(renderer);
 }
 
+int
+SDL_GetRendererStats(SDL_Renderer * renderer, SDL_RendererStats * stats)
+{
+    CHECK_RENDERER_MAGIC(renderer, -1);
+
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+    *stats = renderer->last_stats;
+    return 0;
+}
+
 void
 SDL_DestroyTexture(SDL_Texture * texture)
 {
@@ -2044,6 +2489,10 @@ SDL_DestroyTexture(SDL_Texture * texture)
 
     texture->magic = NULL;
 
+    if (texture == renderer->applied.texture) {
+        renderer->applied.texture = NULL;
+    }
+
     if (texture->next) {
         texture->next->prev = texture->prev;
     }
@@ -2072,6 +2521,12 @@ SDL_DestroyRenderer(SDL_Renderer * renderer)
 
     SDL_DelEventWatch(SDL_RendererEventWatch, renderer);
 
+    /* Cancel readbacks in flight, they'll fail when waited on */
+    while (renderer->readbacks) {
+        SDL_UnlinkPixelReadback(renderer->readbacks);
+    }
+    SDL_StopReadbackWorker(renderer);
+
     /* Free existing textures for this renderer */
     while (renderer->textures) {
         SDL_Texture *tex = renderer->textures; (void) tex;
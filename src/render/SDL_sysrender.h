@@ -25,6 +25,7 @@
 
 #include "SDL_render.h"
 #include "SDL_events.h"
+#include "SDL_thread.h"
 #include "SDL_yuv_sw_c.h"
 
 /* The SDL 2D rendering system */
@@ -72,6 +73,34 @@ struct SDL_Texture
     SDL_Texture *next;
 };
 
+/* Define the SDL pixel readback structure */
+struct SDL_PixelReadback
+{
+    const void *magic;
+    SDL_Renderer *renderer;     /**< NULL once the renderer is destroyed */
+    SDL_Rect rect;              /**< The area being read, in render target coordinates */
+
+    /* Pixels as read back from the driver, before conversion */
+    Uint32 native_format;
+    void *native_pixels;
+    int native_pitch;
+    SDL_bool transferred;
+
+    /* Pixels in the requested format, converted on a worker thread */
+    Uint32 format;
+    void *pixels;
+    int pitch;
+    SDL_bool converting;        /**< Queued on the renderer's readback worker */
+    SDL_atomic_t converted;
+    int status;
+    SDL_PixelReadback *convert_next;
+
+    void *driverdata;           /**< Driver specific transfer state */
+
+    SDL_PixelReadback *prev;
+    SDL_PixelReadback *next;
+};
+
 /* Define the SDL renderer structure */
 struct SDL_Renderer
 {
@@ -115,6 +144,10 @@ struct SDL_Renderer
                        const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip);
     int (*RenderReadPixels) (SDL_Renderer * renderer, const SDL_Rect * rect,
                              Uint32 format, void * pixels, int pitch);
+    int (*QueueReadPixels) (SDL_Renderer * renderer, SDL_PixelReadback * readback);
+    int (*FinishReadPixels) (SDL_Renderer * renderer, SDL_PixelReadback * readback,
+                             SDL_bool wait);
+    void (*DestroyReadPixels) (SDL_Renderer * renderer, SDL_PixelReadback * readback);
     void (*RenderPresent) (SDL_Renderer * renderer);
     void (*DestroyTexture) (SDL_Renderer * renderer, SDL_Texture * texture);
 
@@ -162,9 +195,34 @@ struct SDL_Renderer
     SDL_Texture *textures;
     SDL_Texture *target;
 
+    /* The list of pixel readbacks in flight */
+    SDL_PixelReadback *readbacks;
+
+    /* The worker thread converting readback pixels, and its queue */
+    SDL_Thread *readback_thread;
+    SDL_mutex *readback_lock;
+    SDL_cond *readback_cond;
+    SDL_PixelReadback *readback_queue;
+    SDL_bool readback_quit;
+
     Uint8 r, g, b, a;                   /**< Color for drawing operations values */
     SDL_BlendMode blendMode;            /**< The drawing blend mode */
 
+    /* The state last sent to the driver, so redundant updates can be skipped */
+    struct {
+        SDL_bool viewport_valid;
+        SDL_Rect viewport;
+        SDL_bool clip_valid;
+        SDL_bool clipping_enabled;
+        SDL_Rect clip_rect;
+        SDL_Rect clip_viewport;         /**< The viewport the clip rect was set in */
+        SDL_Texture *texture;           /**< The texture of the last copy */
+    } applied;
+
+    /* Counters for the frame being drawn and the last one presented */
+    SDL_RendererStats stats;
+    SDL_RendererStats last_stats;
+
     void *driverdata;
 };
 
@@ -51,6 +51,9 @@ extern int SDL_RecreateWindow(SDL_Window * window, Uint32 flags);
 
 static const float inv255f = 1.0f / 255.0f;
 
+/* The most pixel buffers a streaming texture rotates through */
+#define GL_MAX_STREAMING_BUFFERS    4
+
 static SDL_Renderer *GL_CreateRenderer(SDL_Window * window, Uint32 flags);
 static void GL_WindowEvent(SDL_Renderer * renderer,
                            const SDL_WindowEvent *event);
@@ -85,6 +88,10 @@ static int GL_RenderCopyEx(SDL_Renderer * renderer, SDL_Texture * texture,
                          const double angle, const SDL_FPoint *center, const SDL_RendererFlip flip);
 static int GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
                                Uint32 pixel_format, void * pixels, int pitch);
+static int GL_QueueReadPixels(SDL_Renderer * renderer, SDL_PixelReadback * readback);
+static int GL_FinishReadPixels(SDL_Renderer * renderer, SDL_PixelReadback * readback,
+                               SDL_bool wait);
+static void GL_DestroyReadPixels(SDL_Renderer * renderer, SDL_PixelReadback * readback);
 static void GL_RenderPresent(SDL_Renderer * renderer);
 static void GL_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture);
 static void GL_DestroyRenderer(SDL_Renderer * renderer);
@@ -128,6 +135,7 @@ typedef struct
         GL_Shader shader;
         Uint32 color;
         SDL_BlendMode blendMode;
+        SDL_Texture *texture;   /* bound for copying, NULL if unknown */
     } current;
 
     SDL_bool GL_EXT_framebuffer_object_supported;
@@ -149,11 +157,35 @@ typedef struct
     PFNGLBINDFRAMEBUFFEREXTPROC glBindFramebufferEXT;
     PFNGLCHECKFRAMEBUFFERSTATUSEXTPROC glCheckFramebufferStatusEXT;
 
+    /* Pixel buffer object support, used for asynchronous readback */
+    SDL_bool GL_ARB_pixel_buffer_object_supported;
+    PFNGLGENBUFFERSARBPROC glGenBuffersARB;
+    PFNGLDELETEBUFFERSARBPROC glDeleteBuffersARB;
+    PFNGLBINDBUFFERARBPROC glBindBufferARB;
+    PFNGLBUFFERDATAARBPROC glBufferDataARB;
+    PFNGLMAPBUFFERARBPROC glMapBufferARB;
+    PFNGLUNMAPBUFFERARBPROC glUnmapBufferARB;
+
+    /* Sync object support, used to poll asynchronous readback */
+    PFNGLFENCESYNCPROC glFenceSync;
+    PFNGLCLIENTWAITSYNCPROC glClientWaitSync;
+    PFNGLDELETESYNCPROC glDeleteSync;
+
+    /* Frames presented, to age readbacks when there are no fences */
+    Uint32 present_count;
+
     /* Shader support */
     GL_ShaderContext *shaders;
 
 } GL_RenderData;
 
+typedef struct
+{
+    GLuint pbo;
+    GLsync fence;
+    Uint32 present_count;   /* the renderer's present_count when it was queued */
+} GL_ReadbackData;
+
 typedef struct
 {
     GLuint texture;
@@ -166,6 +198,13 @@ typedef struct
     int pitch;
     SDL_Rect locked_rect;
 
+    /* Pixel buffer objects that streaming uploads rotate through */
+    GLuint pbos[GL_MAX_STREAMING_BUFFERS];
+    int num_pbos;
+    int current_pbo;
+    GLsizeiptrARB pbo_size;
+    void *mapped;
+
     /* YUV texture support */
     SDL_bool yuv;
     SDL_bool nv12;
@@ -323,6 +362,7 @@ GL_ResetState(SDL_Renderer *renderer)
     data->current.shader = SHADER_NONE;
     data->current.color = 0xffffffff;
     data->current.blendMode = SDL_BLENDMODE_INVALID;
+    data->current.texture = NULL;
 
     data->glDisable(GL_DEPTH_TEST);
     data->glDisable(GL_CULL_FACE);
@@ -563,6 +603,38 @@ GL_CreateRenderer(SDL_Window * window, Uint32 flags)
     }
     data->framebuffers = NULL;
 
+    if (SDL_GL_ExtensionSupported("GL_ARB_pixel_buffer_object") &&
+        SDL_GL_ExtensionSupported("GL_ARB_vertex_buffer_object")) {
+        data->glGenBuffersARB = (PFNGLGENBUFFERSARBPROC)
+            SDL_GL_GetProcAddress("glGenBuffersARB");
+        data->glDeleteBuffersARB = (PFNGLDELETEBUFFERSARBPROC)
+            SDL_GL_GetProcAddress("glDeleteBuffersARB");
+        data->glBindBufferARB = (PFNGLBINDBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glBindBufferARB");
+        data->glBufferDataARB = (PFNGLBUFFERDATAARBPROC)
+            SDL_GL_GetProcAddress("glBufferDataARB");
+        data->glMapBufferARB = (PFNGLMAPBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glMapBufferARB");
+        data->glUnmapBufferARB = (PFNGLUNMAPBUFFERARBPROC)
+            SDL_GL_GetProcAddress("glUnmapBufferARB");
+        if (data->glGenBuffersARB && data->glDeleteBuffersARB &&
+            data->glBindBufferARB && data->glBufferDataARB &&
+            data->glMapBufferARB && data->glUnmapBufferARB) {
+            data->GL_ARB_pixel_buffer_object_supported = SDL_TRUE;
+            renderer->QueueReadPixels = GL_QueueReadPixels;
+            renderer->FinishReadPixels = GL_FinishReadPixels;
+            renderer->DestroyReadPixels = GL_DestroyReadPixels;
+        }
+    }
+    if (SDL_GL_ExtensionSupported("GL_ARB_sync")) {
+        data->glFenceSync = (PFNGLFENCESYNCPROC) SDL_GL_GetProcAddress("glFenceSync");
+        data->glClientWaitSync = (PFNGLCLIENTWAITSYNCPROC) SDL_GL_GetProcAddress("glClientWaitSync");
+        data->glDeleteSync = (PFNGLDELETESYNCPROC) SDL_GL_GetProcAddress("glDeleteSync");
+        if (!data->glFenceSync || !data->glClientWaitSync || !data->glDeleteSync) {
+            data->glFenceSync = NULL;
+        }
+    }
+
     /* Set up parameters for rendering */
     GL_ResetState(renderer);
 
@@ -717,6 +789,15 @@ GetScaleQuality(void)
     }
 }
 
+static int
+GetStreamingBufferCount(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_RENDER_STREAMING_BUFFERS);
+    int count = hint ? SDL_atoi(hint) : 1;
+
+    return SDL_min(SDL_max(count, 1), GL_MAX_STREAMING_BUFFERS);
+}
+
 static int
 GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
@@ -759,10 +840,32 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
             /* Need to add size for the U/V plane */
             size += 2 * ((texture->h + 1) / 2) * ((data->pitch + 1) / 2);
         }
-        data->pixels = SDL_calloc(1, size);
-        if (!data->pixels) {
-            SDL_free(data);
-            return SDL_OutOfMemory();
+        if (renderdata->GL_ARB_pixel_buffer_object_supported) {
+            data->num_pbos = GetStreamingBufferCount();
+        }
+        if (data->num_pbos > 1) {
+            int i;
+
+            /* Lock hands out mapped buffers, so there's no CPU copy */
+            data->pbo_size = (GLsizeiptrARB) size;
+            renderdata->glGenBuffersARB(data->num_pbos, data->pbos);
+            for (i = 0; i < data->num_pbos; ++i) {
+                renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pbos[i]);
+                renderdata->glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pbo_size, NULL, GL_STREAM_DRAW_ARB);
+            }
+            renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+            if (GL_CheckError("glBufferDataARB()", renderer) < 0) {
+                renderdata->glDeleteBuffersARB(data->num_pbos, data->pbos);
+                SDL_free(data);
+                return -1;
+            }
+        } else {
+            data->num_pbos = 0;
+            data->pixels = SDL_calloc(1, size);
+            if (!data->pixels) {
+                SDL_free(data);
+                return SDL_OutOfMemory();
+            }
         }
     }
 
@@ -775,6 +878,9 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     GL_CheckError("", renderer);
     renderdata->glGenTextures(1, &data->texture);
     if (GL_CheckError("glGenTextures()", renderer) < 0) {
+        if (data->num_pbos) {
+            renderdata->glDeleteBuffersARB(data->num_pbos, data->pbos);
+        }
         if (data->pixels) {
             SDL_free(data->pixels);
         }
@@ -806,6 +912,7 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
     data->format = format;
     data->formattype = type;
     scaleMode = GetScaleQuality();
+    renderdata->current.texture = NULL;
     renderdata->glEnable(data->type);
     renderdata->glBindTexture(data->type, data->texture);
     renderdata->glTexParameteri(data->type, GL_TEXTURE_MIN_FILTER, scaleMode);
@@ -837,6 +944,7 @@ GL_CreateTexture(SDL_Renderer * renderer, SDL_Texture * texture)
                                     GL_STORAGE_CACHED_APPLE);
     }
     if (texture->access == SDL_TEXTUREACCESS_STREAMING
+        && data->pixels
         && texture->format == SDL_PIXELFORMAT_ARGB8888
         && (texture->w % 8) == 0) {
         renderdata->glPixelStorei(GL_UNPACK_CLIENT_STORAGE_APPLE, GL_TRUE);
@@ -929,6 +1037,7 @@ GL_UpdateTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 
     GL_ActivateRenderer(renderer);
 
+    renderdata->current.texture = NULL;
     renderdata->glEnable(data->type);
     renderdata->glBindTexture(data->type, data->texture);
     renderdata->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -989,6 +1098,7 @@ GL_UpdateTextureYUV(SDL_Renderer * renderer, SDL_Texture * texture,
 
     GL_ActivateRenderer(renderer);
 
+    renderdata->current.texture = NULL;
     renderdata->glEnable(data->type);
     renderdata->glBindTexture(data->type, data->texture);
     renderdata->glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -1017,11 +1127,27 @@ static int
 GL_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
                const SDL_Rect * rect, void **pixels, int *pitch)
 {
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
     GL_TextureData *data = (GL_TextureData *) texture->driverdata;
+    void *base = data->pixels;
+
+    if (data->num_pbos) {
+        GL_ActivateRenderer(renderer);
+
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pbos[data->current_pbo]);
+        /* Orphan the old storage, so we don't wait for draws still reading it */
+        renderdata->glBufferDataARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pbo_size, NULL, GL_STREAM_DRAW_ARB);
+        data->mapped = renderdata->glMapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, GL_WRITE_ONLY_ARB);
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+        if (!data->mapped) {
+            return SDL_SetError("Couldn't map pixel buffer");
+        }
+        base = data->mapped;
+    }
 
     data->locked_rect = *rect;
     *pixels =
-        (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
+        (void *) ((Uint8 *) base + rect->y * data->pitch +
                   rect->x * SDL_BYTESPERPIXEL(texture->format));
     *pitch = data->pitch;
     return 0;
@@ -1030,11 +1156,32 @@ GL_LockTexture(SDL_Renderer * renderer, SDL_Texture * texture,
 static void
 GL_UnlockTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 {
+    GL_RenderData *renderdata = (GL_RenderData *) renderer->driverdata;
     GL_TextureData *data = (GL_TextureData *) texture->driverdata;
     const SDL_Rect *rect;
     void *pixels;
 
     rect = &data->locked_rect;
+    if (data->num_pbos) {
+        if (!data->mapped) {
+            return;
+        }
+
+        GL_ActivateRenderer(renderer);
+
+        /* The upload sources from the bound buffer, at this offset */
+        pixels = (void *) (uintptr_t) (rect->y * data->pitch +
+                                       rect->x * SDL_BYTESPERPIXEL(texture->format));
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, data->pbos[data->current_pbo]);
+        renderdata->glUnmapBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB);
+        data->mapped = NULL;
+        GL_UpdateTexture(renderer, texture, rect, pixels, data->pitch);
+        renderdata->glBindBufferARB(GL_PIXEL_UNPACK_BUFFER_ARB, 0);
+
+        data->current_pbo = (data->current_pbo + 1) % data->num_pbos;
+        return;
+    }
+
     pixels =
         (void *) ((Uint8 *) data->pixels + rect->y * data->pitch +
                   rect->x * SDL_BYTESPERPIXEL(texture->format));
@@ -1324,22 +1471,25 @@ GL_SetupCopy(SDL_Renderer * renderer, SDL_Texture * texture)
     GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
 
     data->glEnable(texturedata->type);
-    if (texturedata->yuv) {
-        data->glActiveTextureARB(GL_TEXTURE2_ARB);
-        data->glBindTexture(texturedata->type, texturedata->vtexture);
+    if (texture != data->current.texture) {
+        if (texturedata->yuv) {
+            data->glActiveTextureARB(GL_TEXTURE2_ARB);
+            data->glBindTexture(texturedata->type, texturedata->vtexture);
 
-        data->glActiveTextureARB(GL_TEXTURE1_ARB);
-        data->glBindTexture(texturedata->type, texturedata->utexture);
+            data->glActiveTextureARB(GL_TEXTURE1_ARB);
+            data->glBindTexture(texturedata->type, texturedata->utexture);
 
-        data->glActiveTextureARB(GL_TEXTURE0_ARB);
-    }
-    if (texturedata->nv12) {
-        data->glActiveTextureARB(GL_TEXTURE1_ARB);
-        data->glBindTexture(texturedata->type, texturedata->utexture);
+            data->glActiveTextureARB(GL_TEXTURE0_ARB);
+        }
+        if (texturedata->nv12) {
+            data->glActiveTextureARB(GL_TEXTURE1_ARB);
+            data->glBindTexture(texturedata->type, texturedata->utexture);
 
-        data->glActiveTextureARB(GL_TEXTURE0_ARB);
+            data->glActiveTextureARB(GL_TEXTURE0_ARB);
+        }
+        data->glBindTexture(texturedata->type, texturedata->texture);
+        data->current.texture = texture;
     }
-    data->glBindTexture(texturedata->type, texturedata->texture);
 
     if (texture->modMode) {
         GL_SetColor(data, texture->r, texture->g, texture->b, texture->a);
@@ -1571,12 +1721,149 @@ GL_RenderReadPixels(SDL_Renderer * renderer, const SDL_Rect * rect,
     return status;
 }
 
+static int
+GL_QueueReadPixels(SDL_Renderer * renderer, SDL_PixelReadback * readback)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    const SDL_Rect *rect = &readback->rect;
+    Uint32 temp_format = renderer->target ? renderer->target->format : SDL_PIXELFORMAT_ARGB8888;
+    GL_ReadbackData *readbackdata;
+    GLint internalFormat;
+    GLenum format, type;
+    int w, h;
+
+    GL_ActivateRenderer(renderer);
+
+    if (!convert_format(data, temp_format, &internalFormat, &format, &type)) {
+        return SDL_SetError("Texture format %s not supported by OpenGL",
+                            SDL_GetPixelFormatName(temp_format));
+    }
+
+    readbackdata = (GL_ReadbackData *) SDL_calloc(1, sizeof(*readbackdata));
+    if (!readbackdata) {
+        return SDL_OutOfMemory();
+    }
+
+    SDL_GetRendererOutputSize(renderer, &w, &h);
+
+    data->glGenBuffersARB(1, &readbackdata->pbo);
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readbackdata->pbo);
+    data->glBufferDataARB(GL_PIXEL_PACK_BUFFER_ARB,
+                          rect->h * rect->w * SDL_BYTESPERPIXEL(temp_format),
+                          NULL, GL_STREAM_READ_ARB);
+
+    data->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    data->glPixelStorei(GL_PACK_ROW_LENGTH, rect->w);
+
+    /* This returns right away, the transfer completes in the background */
+    data->glReadPixels(rect->x, renderer->target ? rect->y : (h-rect->y)-rect->h,
+                       rect->w, rect->h, format, type, NULL);
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    if (GL_CheckError("glReadPixels()", renderer) < 0) {
+        data->glDeleteBuffersARB(1, &readbackdata->pbo);
+        SDL_free(readbackdata);
+        return -1;
+    }
+
+    if (data->glFenceSync) {
+        readbackdata->fence = data->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+    readbackdata->present_count = data->present_count;
+
+    readback->native_format = temp_format;
+    readback->driverdata = readbackdata;
+    return 0;
+}
+
+static int
+GL_FinishReadPixels(SDL_Renderer * renderer, SDL_PixelReadback * readback,
+                    SDL_bool wait)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *readbackdata = (GL_ReadbackData *) readback->driverdata;
+    const int length = readback->native_pitch;
+    const Uint8 *src;
+    Uint8 *dst;
+    int rows;
+    int status = 1;
+
+    GL_ActivateRenderer(renderer);
+
+    if (!wait) {
+        if (readbackdata->fence) {
+            GLenum result = data->glClientWaitSync(readbackdata->fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+            if (result == GL_TIMEOUT_EXPIRED) {
+                return 0;
+            }
+        } else if (readbackdata->present_count == data->present_count) {
+            /* Without a fence we can't tell, and mapping the buffer would
+               block. Once a frame has been presented since, the transfer
+               has almost certainly finished. */
+            return 0;
+        }
+    }
+
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, readbackdata->pbo);
+    src = (const Uint8 *) data->glMapBufferARB(GL_PIXEL_PACK_BUFFER_ARB, GL_READ_ONLY_ARB);
+    if (src) {
+        dst = (Uint8 *) readback->native_pixels;
+        rows = readback->rect.h;
+        if (renderer->target) {
+            SDL_memcpy(dst, src, rows * length);
+        } else {
+            /* Flip the rows to be top-down */
+            src += (rows - 1) * length;
+            while (rows--) {
+                SDL_memcpy(dst, src, length);
+                dst += readback->native_pitch;
+                src -= length;
+            }
+        }
+        data->glUnmapBufferARB(GL_PIXEL_PACK_BUFFER_ARB);
+    } else {
+        status = SDL_SetError("Couldn't map pixel buffer");
+    }
+    data->glBindBufferARB(GL_PIXEL_PACK_BUFFER_ARB, 0);
+
+    if (GL_CheckError("glMapBufferARB()", renderer) < 0) {
+        status = -1;
+    }
+
+    GL_DestroyReadPixels(renderer, readback);
+
+    return status;
+}
+
+static void
+GL_DestroyReadPixels(SDL_Renderer * renderer, SDL_PixelReadback * readback)
+{
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+    GL_ReadbackData *readbackdata = (GL_ReadbackData *) readback->driverdata;
+
+    if (!readbackdata) {
+        return;
+    }
+
+    GL_ActivateRenderer(renderer);
+
+    if (readbackdata->fence) {
+        data->glDeleteSync(readbackdata->fence);
+    }
+    data->glDeleteBuffersARB(1, &readbackdata->pbo);
+    SDL_free(readbackdata);
+    readback->driverdata = NULL;
+}
+
 static void
 GL_RenderPresent(SDL_Renderer * renderer)
 {
+    GL_RenderData *data = (GL_RenderData *) renderer->driverdata;
+
     GL_ActivateRenderer(renderer);
 
     SDL_GL_SwapWindow(renderer->window);
+    ++data->present_count;
 }
 
 static void
@@ -1587,6 +1874,9 @@ GL_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
 
     GL_ActivateRenderer(renderer);
 
+    if (texture == renderdata->current.texture) {
+        renderdata->current.texture = NULL;
+    }
     if (!data) {
         return;
     }
@@ -1597,6 +1887,9 @@ GL_DestroyTexture(SDL_Renderer * renderer, SDL_Texture * texture)
         renderdata->glDeleteTextures(1, &data->utexture);
         renderdata->glDeleteTextures(1, &data->vtexture);
     }
+    if (data->num_pbos) {
+        renderdata->glDeleteBuffersARB(data->num_pbos, data->pbos);
+    }
     SDL_free(data->pixels);
     SDL_free(data);
     texture->driverdata = NULL;
@@ -1647,6 +1940,8 @@ GL_BindTexture (SDL_Renderer * renderer, SDL_Texture *texture, float *texw, floa
     GL_TextureData *texturedata = (GL_TextureData *) texture->driverdata;
     GL_ActivateRenderer(renderer);
 
+    /* The application may bind other textures before we draw again */
+    data->current.texture = NULL;
     data->glEnable(texturedata->type);
     if (texturedata->yuv) {
         data->glActiveTextureARB(GL_TEXTURE2_ARB);
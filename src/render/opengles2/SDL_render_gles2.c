@@ -77,6 +77,9 @@ SDL_RenderDriver GLES2_RenderDriver = {
  * Context structures                                                                            *
  *************************************************************************************************/
 
+/* The most textures a streaming texture rotates through */
+#define GLES2_MAX_STREAMING_BUFFERS 4
+
 typedef struct GLES2_FBOList GLES2_FBOList;
 
 struct GLES2_FBOList
@@ -94,6 +97,13 @@ typedef struct GLES2_TextureData
     GLenum pixel_type;
     void *pixel_data;
     int pitch;
+    SDL_Rect locked_rect;
+    /* Textures that streaming uploads rotate through, and the area of each
+       that is older than pixel_data */
+    GLuint ring[GLES2_MAX_STREAMING_BUFFERS];
+    SDL_Rect ring_stale[GLES2_MAX_STREAMING_BUFFERS];
+    int num_ring;
+    int current_ring;
     /* YUV texture support */
     SDL_bool yuv;
     SDL_bool nv12;
@@ -565,6 +575,15 @@ GetScaleQuality(void)
     }
 }
 
+static int
+GetStreamingBufferCount(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_RENDER_STREAMING_BUFFERS);
+    int count = hint ? SDL_atoi(hint) : 1;
+
+    return SDL_min(SDL_max(count, 1), GLES2_MAX_STREAMING_BUFFERS);
+}
+
 static int
 GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
@@ -697,6 +716,28 @@ GLES2_CreateTexture(SDL_Renderer *renderer, SDL_Texture *texture)
         return -1;
     }
 
+    /* Uploads go to a texture that isn't being drawn from, to avoid stalls */
+    if (texture->access == SDL_TEXTUREACCESS_STREAMING && !data->yuv && !data->nv12 &&
+        GetStreamingBufferCount() > 1) {
+        int i;
+
+        data->num_ring = GetStreamingBufferCount();
+        data->ring[0] = data->texture;
+        renderdata->glGenTextures(data->num_ring - 1, &data->ring[1]);
+        for (i = 1; i < data->num_ring; ++i) {
+            renderdata->glBindTexture(data->texture_type, data->ring[i]);
+            renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_MIN_FILTER, scaleMode);
+            renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_MAG_FILTER, scaleMode);
+            renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            renderdata->glTexParameteri(data->texture_type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            renderdata->glTexImage2D(data->texture_type, 0, format, texture->w, texture->h, 0, format, type, NULL);
+        }
+        renderdata->glBindTexture(data->texture_type, data->texture);
+        if (GL_CheckError("glTexImage2D()", renderer) < 0) {
+            return -1;
+        }
+    }
+
     if (texture->access == SDL_TEXTUREACCESS_TARGET) {
        data->fbo = GLES2_GetFBO(renderer->driverdata, texture->w, texture->h);
     } else {
@@ -872,6 +913,8 @@ GLES2_LockTexture(SDL_Renderer *renderer, SDL_Texture *texture, const SDL_Rect *
 {
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
 
+    tdata->locked_rect = *rect;
+
     /* Retrieve the buffer/pitch for the specified region */
     *pixels = (Uint8 *)tdata->pixel_data +
               (tdata->pitch * rect->y) +
@@ -886,13 +929,45 @@ GLES2_UnlockTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 {
     GLES2_TextureData *tdata = (GLES2_TextureData *)texture->driverdata;
     SDL_Rect rect;
+    const void *pixels;
+
+    if (tdata->yuv || tdata->nv12) {
+        /* The planes follow each other, so update the whole texture */
+        rect.x = 0;
+        rect.y = 0;
+        rect.w = texture->w;
+        rect.h = texture->h;
+        GLES2_UpdateTexture(renderer, texture, &rect, tdata->pixel_data, tdata->pitch);
+        return;
+    }
+
+    rect = tdata->locked_rect;
+    if (tdata->num_ring > 1) {
+        const int next = (tdata->current_ring + 1) % tdata->num_ring;
+        int i;
+
+        /* Bring the next texture up to date, and note what the others miss */
+        if (!SDL_RectEmpty(&tdata->ring_stale[next])) {
+            SDL_UnionRect(&rect, &tdata->ring_stale[next], &rect);
+            SDL_zero(tdata->ring_stale[next]);
+        }
+        for (i = 0; i < tdata->num_ring; ++i) {
+            if (i == next) {
+                continue;
+            }
+            if (SDL_RectEmpty(&tdata->ring_stale[i])) {
+                tdata->ring_stale[i] = tdata->locked_rect;
+            } else {
+                SDL_UnionRect(&tdata->ring_stale[i], &tdata->locked_rect, &tdata->ring_stale[i]);
+            }
+        }
+        tdata->current_ring = next;
+        tdata->texture = tdata->ring[next];
+    }
 
-    /* We do whole texture updates, at least for now */
-    rect.x = 0;
-    rect.y = 0;
-    rect.w = texture->w;
-    rect.h = texture->h;
-    GLES2_UpdateTexture(renderer, texture, &rect, tdata->pixel_data, tdata->pitch);
+    pixels = (const Uint8 *)tdata->pixel_data + rect.y * tdata->pitch +
+             rect.x * SDL_BYTESPERPIXEL(texture->format);
+    GLES2_UpdateTexture(renderer, texture, &rect, pixels, tdata->pitch);
 }
 
 static int
@@ -928,7 +1003,11 @@ GLES2_DestroyTexture(SDL_Renderer *renderer, SDL_Texture *texture)
 
     /* Destroy the texture */
     if (tdata) {
-        data->glDeleteTextures(1, &tdata->texture);
+        if (tdata->num_ring > 1) {
+            data->glDeleteTextures(tdata->num_ring, tdata->ring);
+        } else {
+            data->glDeleteTextures(1, &tdata->texture);
+        }
         if (tdata->texture_v) {
             data->glDeleteTextures(1, &tdata->texture_v);
         }
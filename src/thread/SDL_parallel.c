@@ -0,0 +1,253 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Row band work splitting on a pool of worker threads */
+
+#include "SDL_atomic.h"
+#include "SDL_cpuinfo.h"
+#include "SDL_hints.h"
+#include "SDL_mutex.h"
+#include "SDL_thread.h"
+#include "SDL_parallel_c.h"
+#include "SDL_systhread.h"
+
+#define SDL_MAX_PARALLEL_THREADS    16
+
+typedef struct SDL_ParallelJob
+{
+    SDL_ParallelFunc func;
+    void *data;
+    int count;
+    int band_rows;
+    int num_bands;
+    SDL_atomic_t next_band;
+    SDL_atomic_t bands_done;
+    int active_workers;     /* protected by the pool mutex */
+} SDL_ParallelJob;
+
+static struct
+{
+    SDL_SpinLock lock;
+    SDL_bool initialized;
+    SDL_mutex *mutex;
+    SDL_cond *work_cond;
+    SDL_cond *done_cond;
+    SDL_Thread *threads[SDL_MAX_PARALLEL_THREADS - 1];
+    int num_threads;
+    SDL_ParallelJob *job;
+    Uint32 generation;
+    SDL_bool quit;
+} SDL_parallel;
+
+
+static void
+SDL_RunParallelBands(SDL_ParallelJob *job)
+{
+    int band;
+
+    while ((band = SDL_AtomicAdd(&job->next_band, 1)) < job->num_bands) {
+        const int start = band * job->band_rows;
+        const int end = SDL_min(start + job->band_rows, job->count);
+        job->func(job->data, start, end);
+        SDL_AtomicAdd(&job->bands_done, 1);
+    }
+}
+
+static int SDLCALL
+SDL_ParallelWorker(void *unused)
+{
+    Uint32 generation = 0;
+
+    SDL_LockMutex(SDL_parallel.mutex);
+    for ( ; ; ) {
+        SDL_ParallelJob *job;
+
+        while (!SDL_parallel.quit &&
+               (!SDL_parallel.job || SDL_parallel.generation == generation)) {
+            SDL_CondWait(SDL_parallel.work_cond, SDL_parallel.mutex);
+        }
+        if (SDL_parallel.quit) {
+            break;
+        }
+
+        generation = SDL_parallel.generation;
+        job = SDL_parallel.job;
+        ++job->active_workers;
+        SDL_UnlockMutex(SDL_parallel.mutex);
+
+        SDL_RunParallelBands(job);
+
+        SDL_LockMutex(SDL_parallel.mutex);
+        --job->active_workers;
+        SDL_CondSignal(SDL_parallel.done_cond);
+    }
+    SDL_UnlockMutex(SDL_parallel.mutex);
+
+    return 0;
+}
+
+static int
+SDL_GetRequestedThreadCount(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_CPU_WORKER_THREADS);
+    int count = 0;
+
+    if (hint) {
+        count = SDL_atoi(hint);
+    }
+    if (count <= 0) {
+        count = SDL_GetCPUCount();
+    }
+    return SDL_min(count, SDL_MAX_PARALLEL_THREADS);
+}
+
+/* Returns the number of worker threads, not counting the caller */
+static int
+SDL_InitParallel(void)
+{
+    int i, num_threads;
+
+    SDL_AtomicLock(&SDL_parallel.lock);
+    if (SDL_parallel.initialized) {
+        SDL_AtomicUnlock(&SDL_parallel.lock);
+        return SDL_parallel.num_threads;
+    }
+    SDL_parallel.initialized = SDL_TRUE;
+
+    num_threads = SDL_GetRequestedThreadCount() - 1;
+    if (num_threads > 0) {
+        SDL_parallel.mutex = SDL_CreateMutex();
+        SDL_parallel.work_cond = SDL_CreateCond();
+        SDL_parallel.done_cond = SDL_CreateCond();
+        if (!SDL_parallel.mutex || !SDL_parallel.work_cond || !SDL_parallel.done_cond) {
+            num_threads = 0;
+        }
+    }
+    for (i = 0; i < num_threads; ++i) {
+        SDL_Thread *thread = SDL_CreateThreadInternal(SDL_ParallelWorker, "SDLWorker", 0, NULL);
+        if (!thread) {
+            break;
+        }
+        SDL_parallel.threads[SDL_parallel.num_threads++] = thread;
+    }
+    SDL_AtomicUnlock(&SDL_parallel.lock);
+
+    return SDL_parallel.num_threads;
+}
+
+int
+SDL_GetParallelThreadCount(void)
+{
+    return SDL_InitParallel() + 1;
+}
+
+void
+SDL_ParallelFor(int count, int align, int min_rows, SDL_ParallelFunc func, void *data)
+{
+    SDL_ParallelJob job;
+    int num_threads, band_rows;
+
+    if (count <= 0) {
+        return;
+    }
+    if (align < 1) {
+        align = 1;
+    }
+
+    num_threads = SDL_InitParallel() + 1;
+    band_rows = SDL_max((count + num_threads - 1) / num_threads, min_rows);
+    band_rows = ((band_rows + align - 1) / align) * align;
+    if (num_threads == 1 || band_rows >= count) {
+        func(data, 0, count);
+        return;
+    }
+
+    SDL_zero(job);
+    job.func = func;
+    job.data = data;
+    job.count = count;
+    job.band_rows = band_rows;
+    job.num_bands = (count + band_rows - 1) / band_rows;
+
+    SDL_LockMutex(SDL_parallel.mutex);
+    if (SDL_parallel.job) {
+        /* Another thread is using the pool, or we're being called from a
+           worker. Either way there's nobody free to help, so do it here. */
+        SDL_UnlockMutex(SDL_parallel.mutex);
+        func(data, 0, count);
+        return;
+    }
+    SDL_parallel.job = &job;
+    ++SDL_parallel.generation;
+    SDL_CondBroadcast(SDL_parallel.work_cond);
+    SDL_UnlockMutex(SDL_parallel.mutex);
+
+    SDL_RunParallelBands(&job);
+
+    /* Wait for the workers to finish their bands and let go of the job */
+    SDL_LockMutex(SDL_parallel.mutex);
+    while (SDL_AtomicGet(&job.bands_done) < job.num_bands || job.active_workers > 0) {
+        SDL_CondWait(SDL_parallel.done_cond, SDL_parallel.mutex);
+    }
+    SDL_parallel.job = NULL;
+    SDL_UnlockMutex(SDL_parallel.mutex);
+}
+
+void
+SDL_QuitParallel(void)
+{
+    int i;
+
+    SDL_AtomicLock(&SDL_parallel.lock);
+    if (SDL_parallel.initialized) {
+        if (SDL_parallel.num_threads > 0) {
+            SDL_LockMutex(SDL_parallel.mutex);
+            SDL_parallel.quit = SDL_TRUE;
+            SDL_CondBroadcast(SDL_parallel.work_cond);
+            SDL_UnlockMutex(SDL_parallel.mutex);
+
+            for (i = 0; i < SDL_parallel.num_threads; ++i) {
+                SDL_WaitThread(SDL_parallel.threads[i], NULL);
+            }
+        }
+        if (SDL_parallel.done_cond) {
+            SDL_DestroyCond(SDL_parallel.done_cond);
+        }
+        if (SDL_parallel.work_cond) {
+            SDL_DestroyCond(SDL_parallel.work_cond);
+        }
+        if (SDL_parallel.mutex) {
+            SDL_DestroyMutex(SDL_parallel.mutex);
+        }
+        SDL_parallel.initialized = SDL_FALSE;
+        SDL_parallel.mutex = NULL;
+        SDL_parallel.work_cond = NULL;
+        SDL_parallel.done_cond = NULL;
+        SDL_parallel.num_threads = 0;
+        SDL_parallel.job = NULL;
+        SDL_parallel.generation = 0;
+        SDL_parallel.quit = SDL_FALSE;
+    }
+    SDL_AtomicUnlock(&SDL_parallel.lock);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -0,0 +1,52 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#ifndef SDL_parallel_c_h_
+#define SDL_parallel_c_h_
+
+/* A small pool of worker threads for splitting pixel work into row bands.
+
+   This is not a public API. Each band is processed exactly once with the same
+   [start, end) rows no matter how many threads are available, so callers that
+   only write to their own rows produce identical output serially or in
+   parallel.
+ */
+
+typedef void (*SDL_ParallelFunc)(void *data, int start, int end);
+
+/* Run func over the rows [0, count), splitting them into bands that start on
+   a multiple of 'align' rows and are at least 'min_rows' tall. The calling
+   thread works on bands too, and this returns once every band is done.
+   If the pool is unavailable or busy with another job, this just calls
+   func(data, 0, count) directly.
+ */
+extern void SDL_ParallelFor(int count, int align, int min_rows, SDL_ParallelFunc func, void *data);
+
+/* Returns the number of threads that will work on a job, including the caller */
+extern int SDL_GetParallelThreadCount(void);
+
+/* Stop and free the worker threads, they'll be recreated on demand */
+extern void SDL_QuitParallel(void);
+
+#endif /* SDL_parallel_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -90,12 +90,45 @@
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
 #ifndef MIN
 #define MIN(a, b) ((a) < (b) ? (a) : (b))
 #endif
 
+/*
+ * Most opaque runs are only a few dozen bytes long, too short to make up
+ * for the cost of calling SDL_memcpy(), so copy those inline.
+ */
+static SDL_INLINE void
+RLECopyRun(Uint8 * dst, const Uint8 * src, size_t len)
+{
+    if (len >= 256) {
+        SDL_memcpy(dst, src, len);
+        return;
+    }
+#if defined(__SSE2__)
+    for (; len >= 16; len -= 16) {
+        _mm_storeu_si128((__m128i *) dst, _mm_loadu_si128((const __m128i *) src));
+        src += 16;
+        dst += 16;
+    }
+#elif defined(__ARM_NEON)
+    for (; len >= 16; len -= 16) {
+        vst1q_u8(dst, vld1q_u8(src));
+        src += 16;
+        dst += 16;
+    }
+#endif
+    while (len--) {
+        *dst++ = *src++;
+    }
+}
+
 #define PIXEL_COPY(to, from, len, bpp)          \
-    SDL_memcpy(to, from, (size_t)(len) * (bpp))
+    RLECopyRun(to, from, (size_t)(len) * (bpp))
 
 /*
  * Various colorkey blit methods, for opaque and per-surface alpha
@@ -610,6 +643,135 @@ SDL_RLEBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
     dst = (Uint16)(d | d >> 16);            \
     } while(0)
 
+/*
+ * Blend a run of translucent pixels. The SIMD versions do exactly the same
+ * integer arithmetic as BLIT_TRANSL_888, so they give identical results.
+ */
+typedef void (*RLETranslRunFunc) (void *dst, const Uint32 * src, int n);
+
+static void
+BlitTranslRun565(void *dst, const Uint32 * src, int n)
+{
+    Uint16 *dstp = (Uint16 *) dst;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        BLIT_TRANSL_565(src[i], dstp[i]);
+    }
+}
+
+static void
+BlitTranslRun555(void *dst, const Uint32 * src, int n)
+{
+    Uint16 *dstp = (Uint16 *) dst;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        BLIT_TRANSL_555(src[i], dstp[i]);
+    }
+}
+
+static void
+BlitTranslRun888(void *dst, const Uint32 * src, int n)
+{
+    Uint32 *dstp = (Uint32 *) dst;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        BLIT_TRANSL_888(src[i], dstp[i]);
+    }
+}
+
+#ifdef __SSE2__
+/* The low 32 bits of x * a, where a < 65536 is in both halves of each lane */
+static SDL_INLINE __m128i
+MulLo32_SSE2(__m128i x, __m128i a)
+{
+    return _mm_add_epi32(_mm_mullo_epi16(x, a),
+                         _mm_slli_epi32(_mm_mulhi_epu16(x, a), 16));
+}
+
+static void
+BlitTranslRun888_SSE2(void *dst, const Uint32 * src, int n)
+{
+    const __m128i rb_mask = _mm_set1_epi32(0x00ff00ff);
+    const __m128i g_mask = _mm_set1_epi32(0x0000ff00);
+    const __m128i opaque = _mm_set1_epi32((int) 0xff000000);
+    Uint32 *dstp = (Uint32 *) dst;
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        const __m128i s = _mm_loadu_si128((const __m128i *) (src + i));
+        const __m128i dp = _mm_loadu_si128((const __m128i *) (dstp + i));
+        __m128i alpha = _mm_srli_epi32(s, 24);
+        __m128i s1, d1, s2, d2;
+
+        alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+        s1 = _mm_and_si128(s, rb_mask);
+        d1 = _mm_and_si128(dp, rb_mask);
+        d1 = _mm_add_epi32(d1, _mm_srli_epi32(MulLo32_SSE2(_mm_sub_epi32(s1, d1), alpha), 8));
+        s2 = _mm_and_si128(s, g_mask);
+        d2 = _mm_and_si128(dp, g_mask);
+        d2 = _mm_add_epi32(d2, _mm_srli_epi32(MulLo32_SSE2(_mm_sub_epi32(s2, d2), alpha), 8));
+        d1 = _mm_or_si128(_mm_and_si128(d1, rb_mask), _mm_and_si128(d2, g_mask));
+        _mm_storeu_si128((__m128i *) (dstp + i), _mm_or_si128(d1, opaque));
+    }
+    for (; i < n; i++) {
+        BLIT_TRANSL_888(src[i], dstp[i]);
+    }
+}
+#endif /* __SSE2__ */
+
+#ifdef __ARM_NEON
+static void
+BlitTranslRun888_NEON(void *dst, const Uint32 * src, int n)
+{
+    const uint32x4_t rb_mask = vdupq_n_u32(0x00ff00ff);
+    const uint32x4_t g_mask = vdupq_n_u32(0x0000ff00);
+    const uint32x4_t opaque = vdupq_n_u32(0xff000000);
+    Uint32 *dstp = (Uint32 *) dst;
+    int i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        const uint32x4_t s = vld1q_u32(src + i);
+        const uint32x4_t dp = vld1q_u32(dstp + i);
+        const uint32x4_t alpha = vshrq_n_u32(s, 24);
+        uint32x4_t s1, d1, s2, d2;
+
+        s1 = vandq_u32(s, rb_mask);
+        d1 = vandq_u32(dp, rb_mask);
+        d1 = vaddq_u32(d1, vshrq_n_u32(vmulq_u32(vsubq_u32(s1, d1), alpha), 8));
+        s2 = vandq_u32(s, g_mask);
+        d2 = vandq_u32(dp, g_mask);
+        d2 = vaddq_u32(d2, vshrq_n_u32(vmulq_u32(vsubq_u32(s2, d2), alpha), 8));
+        d1 = vorrq_u32(vandq_u32(d1, rb_mask), vandq_u32(d2, g_mask));
+        vst1q_u32(dstp + i, vorrq_u32(d1, opaque));
+    }
+    for (; i < n; i++) {
+        BLIT_TRANSL_888(src[i], dstp[i]);
+    }
+}
+#endif /* __ARM_NEON */
+
+static RLETranslRunFunc
+ChooseTranslRun888(void)
+{
+    const Uint32 features = SDL_GetBlitCPUFeatures();
+
+#ifdef __SSE2__
+    if (features & SDL_CPU_SSE2) {
+        return BlitTranslRun888_SSE2;
+    }
+#endif
+#ifdef __ARM_NEON
+    if (features & SDL_CPU_NEON) {
+        return BlitTranslRun888_NEON;
+    }
+#endif
+    (void) features;
+    return BlitTranslRun888;
+}
+
 /* used to save the destination format in the encoding. Designed to be
    macro-compatible with SDL_PixelFormat but without the unneeded fields */
 typedef struct
@@ -638,10 +800,10 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
     SDL_PixelFormat *df = surf_dst->format;
     /*
      * clipped blitter: Ptype is the destination pixel type,
-     * Ctype the translucent count type, and do_blend the macro
-     * to blend one pixel.
+     * Ctype the translucent count type, and blend_run the function
+     * to blend a run of pixels.
      */
-#define RLEALPHACLIPBLIT(Ptype, Ctype, do_blend)              \
+#define RLEALPHACLIPBLIT(Ptype, Ctype, blend_run)             \
     do {                                  \
     int linecount = srcrect->h;                   \
     int left = srcrect->x;                        \
@@ -694,13 +856,9 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
             }                             \
             if(crun > right - cofs)               \
             crun = right - cofs;                  \
-            if(crun > 0) {                    \
-            Ptype *dst = (Ptype *)dstbuf + cofs;          \
-            Uint32 *src = (Uint32 *)srcbuf + (cofs - ofs);    \
-            int i;                        \
-            for(i = 0; i < crun; i++)             \
-                do_blend(src[i], dst[i]);             \
-            }                             \
+            if(crun > 0)                      \
+            blend_run((Ptype *)dstbuf + cofs,             \
+                  (Uint32 *)srcbuf + (cofs - ofs), crun);     \
             srcbuf += run * 4;                    \
             ofs += run;                       \
         }                             \
@@ -712,12 +870,15 @@ RLEAlphaClipBlit(int w, Uint8 * srcbuf, SDL_Surface * surf_dst,
     switch (df->BytesPerPixel) {
     case 2:
         if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0)
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_565);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BlitTranslRun565);
         else
-            RLEALPHACLIPBLIT(Uint16, Uint8, BLIT_TRANSL_555);
+            RLEALPHACLIPBLIT(Uint16, Uint8, BlitTranslRun555);
         break;
     case 4:
-        RLEALPHACLIPBLIT(Uint32, Uint16, BLIT_TRANSL_888);
+        {
+            const RLETranslRunFunc blit_transl = ChooseTranslRun888();
+            RLEALPHACLIPBLIT(Uint32, Uint16, blit_transl);
+        }
         break;
     }
 }
@@ -807,10 +968,10 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
 
         /*
          * non-clipped blitter. Ptype is the destination pixel type,
-         * Ctype the translucent count type, and do_blend the
-         * macro to blend one pixel.
+         * Ctype the translucent count type, and blend_run the
+         * function to blend a run of pixels.
          */
-#define RLEALPHABLIT(Ptype, Ctype, do_blend)                 \
+#define RLEALPHABLIT(Ptype, Ctype, blend_run)                \
     do {                                 \
         int linecount = srcrect->h;                  \
         do {                             \
@@ -840,14 +1001,8 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
             run = ((Uint16 *)srcbuf)[1];             \
             srcbuf += 4;                     \
             if(run) {                        \
-            Ptype *dst = (Ptype *)dstbuf + ofs;      \
-            unsigned i;                  \
-            for(i = 0; i < run; i++) {           \
-                Uint32 src = *(Uint32 *)srcbuf;      \
-                do_blend(src, *dst);             \
-                srcbuf += 4;                 \
-                dst++;                   \
-            }                        \
+            blend_run((Ptype *)dstbuf + ofs, (Uint32 *)srcbuf, run); \
+            srcbuf += run * 4;               \
             ofs += run;                  \
             }                            \
         } while(ofs < w);                    \
@@ -859,12 +1014,15 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
         case 2:
             if (df->Gmask == 0x07e0 || df->Rmask == 0x07e0
                 || df->Bmask == 0x07e0)
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_565);
+                RLEALPHABLIT(Uint16, Uint8, BlitTranslRun565);
             else
-                RLEALPHABLIT(Uint16, Uint8, BLIT_TRANSL_555);
+                RLEALPHABLIT(Uint16, Uint8, BlitTranslRun555);
             break;
         case 4:
-            RLEALPHABLIT(Uint32, Uint16, BLIT_TRANSL_888);
+            {
+                const RLETranslRunFunc blit_transl = ChooseTranslRun888();
+                RLEALPHABLIT(Uint32, Uint16, blit_transl);
+            }
             break;
         }
     }
@@ -881,9 +1039,7 @@ SDL_RLEAlphaBlit(SDL_Surface * surf_src, SDL_Rect * srcrect,
  * Auxiliary functions:
  * The encoding functions take 32bpp rgb + a, and
  * return the number of bytes copied to the destination.
- * The decoding functions copy to 32bpp rgb + a, and
- * return the number of bytes copied from the source.
- * These are only used in the encoder and un-RLE code and are therefore not
+ * These are only used in the encoder and are therefore not
  * highly optimised.
  */
 
@@ -904,26 +1060,6 @@ copy_opaque_16(void *dst, Uint32 * src, int n,
     return n * 2;
 }
 
-/* decode opaque pixels from 16bpp to 32bpp rgb + a */
-static int
-uncopy_opaque_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint16 *s = src;
-    unsigned alpha = dfmt->Amask ? 255 : 0;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b;
-        RGB_FROM_PIXEL(*s, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, alpha);
-        s++;
-        dst++;
-    }
-    return n * 2;
-}
-
-
-
 /* encode 32bpp rgb + a into 32bpp G0RAB format for blitting into 565 */
 static int
 copy_transl_565(void *dst, Uint32 * src, int n,
@@ -962,25 +1098,6 @@ copy_transl_555(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode translucent pixels from 32bpp GORAB to 32bpp rgb + a */
-static int
-uncopy_transl_16(Uint32 * dst, void *src, int n,
-                 RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
-{
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pix = *s++;
-        a = (pix & 0x3e0) >> 2;
-        pix = (pix & ~0x3e0) | pix >> 16;
-        RGB_FROM_PIXEL(pix, sfmt, r, g, b);
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
-    }
-    return n * 4;
-}
-
 /* encode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
 static int
 copy_32(void *dst, Uint32 * src, int n,
@@ -998,28 +1115,328 @@ copy_32(void *dst, Uint32 * src, int n,
     return n * 4;
 }
 
-/* decode 32bpp rgba into 32bpp rgba, keeping alpha (dual purpose) */
+#define ISOPAQUE(pixel, fmt) ((((pixel) & fmt->Amask) >> fmt->Ashift) == 255)
+
+#define ISTRANSL(pixel, fmt)    \
+    ((unsigned)((((pixel) & fmt->Amask) >> fmt->Ashift) - 1U) < 254U)
+
+static Uint32
+getpix_8(Uint8 * srcbuf)
+{
+    return *srcbuf;
+}
+
+static Uint32
+getpix_16(Uint8 * srcbuf)
+{
+    return *(Uint16 *) srcbuf;
+}
+
+static Uint32
+getpix_24(Uint8 * srcbuf)
+{
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+    return srcbuf[0] + (srcbuf[1] << 8) + (srcbuf[2] << 16);
+#else
+    return (srcbuf[0] << 16) + (srcbuf[1] << 8) + srcbuf[2];
+#endif
+}
+
+static Uint32
+getpix_32(Uint8 * srcbuf)
+{
+    return *(Uint32 *) srcbuf;
+}
+
+typedef Uint32(*getpix_func) (Uint8 *);
+
+static const getpix_func getpixes[4] = {
+    getpix_8, getpix_16, getpix_24, getpix_32
+};
+
+/*
+ * RLE surfaces keep their pixels, so locking one doesn't have to decode
+ * anything. Each encoded scan line is cached along with a hash of the
+ * pixels it came from, and when the surface is encoded again after being
+ * unlocked, only the lines whose pixels changed are encoded again.
+ */
+typedef struct RLEEncoder RLEEncoder;
+
+/* Encode one scan line of pixels, returning the end of the output */
+typedef Uint8 *(*RLEEncodeLineFunc) (const RLEEncoder * enc, Uint8 * dst,
+                                     Uint8 * srcbuf);
+
+struct RLEEncoder
+{
+    /* what the encoding depends on, besides the pixels */
+    int flags;                  /* SDL_COPY_RLE_COLORKEY or SDL_COPY_RLE_ALPHAKEY */
+    Uint32 colorkey;
+    RLEDestFormat format;       /* zeroed for colorkey encodings */
+
+    size_t header_size;         /* size of the format saved at the start */
+    size_t max_line_size;       /* worst case size of an encoded line */
+    size_t count_size;          /* size of the <skip> <run> pair ending the data */
+    RLEEncodeLineFunc encode_line;
+    int w;
+
+    /* colorkey encoding */
+    int bpp;
+    int maxn;
+    getpix_func getpix;
+    Uint32 rgbmask;
+
+    /* per-pixel alpha encoding */
+    SDL_PixelFormat *sf;
+    SDL_PixelFormat *df;
+    int max_opaque_run;
+    int (*copy_opaque) (void *, Uint32 *, int,
+                        SDL_PixelFormat *, SDL_PixelFormat *);
+    int (*copy_transl) (void *, Uint32 *, int,
+                        SDL_PixelFormat *, SDL_PixelFormat *);
+};
+
+typedef struct
+{
+    Uint64 hash;                /* hash of the pixels the line was encoded from */
+    Uint32 offset;              /* start of the encoded line in the data */
+    Uint32 size;
+} RLELine;
+
+typedef struct
+{
+    int flags;
+    Uint32 colorkey;
+    RLEDestFormat format;
+    int h;
+    RLELine *lines;
+    Uint8 *data;                /* the encoding that surface->map->data points at */
+} RLECache;
+
+/*
+ * A quick hash of the pixels in a scan line, to tell which lines changed
+ * between two encodings. Four independent lanes keep the multiplier busy.
+ */
+static Uint64
+RLEHashLine(const Uint8 * src, size_t len)
+{
+    const Uint64 k = 0x9E3779B97F4A7C15ULL;
+    Uint64 h0 = len, h1 = ~len, h2 = k, h3 = ~k;
+
+#define RLE_HASH_MIX(h, v)  (h = (h ^ (v)) * k, h = (h << 31) | (h >> 33))
+
+    if (((uintptr_t) src & 3) == 0) {
+        const Uint32 *p = (const Uint32 *) src;
+        for (; len >= 32; len -= 32, p += 8) {
+            RLE_HASH_MIX(h0, p[0] | ((Uint64) p[1] << 32));
+            RLE_HASH_MIX(h1, p[2] | ((Uint64) p[3] << 32));
+            RLE_HASH_MIX(h2, p[4] | ((Uint64) p[5] << 32));
+            RLE_HASH_MIX(h3, p[6] | ((Uint64) p[7] << 32));
+        }
+        for (; len >= 4; len -= 4, ++p) {
+            RLE_HASH_MIX(h0, *p);
+        }
+        src = (const Uint8 *) p;
+    }
+    for (; len; --len) {
+        RLE_HASH_MIX(h1, *src++);
+    }
+
+    RLE_HASH_MIX(h0, h1);
+    RLE_HASH_MIX(h0, h2);
+    RLE_HASH_MIX(h0, h3);
+
+#undef RLE_HASH_MIX
+
+    return h0 ^ (h0 >> 29);
+}
+
+/*
+ * Encode the whole surface into a new buffer, reusing the cached lines
+ * of the previous encoding when their pixels haven't changed
+ */
 static int
-uncopy_32(Uint32 * dst, void *src, int n,
-          RLEDestFormat * sfmt, SDL_PixelFormat * dfmt)
+RLEEncodeSurface(SDL_Surface * surface, const RLEEncoder * enc)
 {
-    int i;
-    Uint32 *s = src;
-    for (i = 0; i < n; i++) {
-        unsigned r, g, b, a;
-        Uint32 pixel = *s++;
-        RGB_FROM_PIXEL(pixel, sfmt, r, g, b);
-        a = pixel >> 24;
-        PIXEL_FROM_RGBA(*dst, dfmt, r, g, b, a);
-        dst++;
+    SDL_BlitMap *map = surface->map;
+    RLECache *cache = (RLECache *) map->rle_cache;
+    const size_t line_bytes = (size_t) surface->w * surface->format->BytesPerPixel;
+    Uint8 *data, *dst, *srcbuf;
+    SDL_bool reuse;
+    int y;
+
+    if (!cache) {
+        cache = (RLECache *) SDL_calloc(1, sizeof(*cache));
+        if (!cache) {
+            return SDL_OutOfMemory();
+        }
+        map->rle_cache = cache;
     }
-    return n * 4;
+    if (!cache->lines || cache->h != surface->h) {
+        SDL_free(cache->lines);
+        SDL_free(cache->data);
+        cache->data = NULL;
+        cache->h = 0;
+        cache->lines = (RLELine *) SDL_malloc(surface->h * sizeof(RLELine));
+        if (!cache->lines) {
+            return SDL_OutOfMemory();
+        }
+        cache->h = surface->h;
+    }
+    reuse = (cache->data && cache->flags == enc->flags &&
+             cache->colorkey == enc->colorkey &&
+             SDL_memcmp(&cache->format, &enc->format, sizeof(enc->format)) == 0);
+
+    data = (Uint8 *) SDL_malloc(enc->header_size +
+                                surface->h * enc->max_line_size +
+                                enc->count_size);
+    if (!data) {
+        return SDL_OutOfMemory();
+    }
+
+    /* save the destination format so the blitter knows what it's getting */
+    SDL_memcpy(data, &enc->format, enc->header_size);
+    dst = data + enc->header_size;
+
+    srcbuf = (Uint8 *) surface->pixels;
+    for (y = 0; y < surface->h; ++y) {
+        RLELine *line = &cache->lines[y];
+        const Uint64 hash = RLEHashLine(srcbuf, line_bytes);
+        const Uint32 offset = (Uint32) (dst - data);
+
+        if (reuse && line->hash == hash) {
+            /* lines always start 32-bit aligned where that matters, so the
+               padding in the cached copy is still right */
+            SDL_memcpy(dst, cache->data + line->offset, line->size);
+            dst += line->size;
+        } else {
+            dst = enc->encode_line(enc, dst, srcbuf);
+        }
+        line->hash = hash;
+        line->offset = offset;
+        line->size = (Uint32) (dst - data) - offset;
+
+        srcbuf += surface->pitch;
+    }
+
+    /* mark the end of the sequence */
+    SDL_memset(dst, 0, enc->count_size);
+    dst += enc->count_size;
+
+    /* realloc the buffer to release unused memory */
+    {
+        /* If realloc returns NULL, the original block is left intact */
+        Uint8 *p = SDL_realloc(data, dst - data);
+        if (p) {
+            data = p;
+        }
+    }
+
+    SDL_free(cache->data);
+    cache->data = data;
+    cache->flags = enc->flags;
+    cache->colorkey = enc->colorkey;
+    cache->format = enc->format;
+
+    map->data = data;
+    return 0;
 }
 
-#define ISOPAQUE(pixel, fmt) ((((pixel) & fmt->Amask) >> fmt->Ashift) == 255)
+/* encode one scan line of a surface with per-pixel alpha */
+static Uint8 *
+RLEAlphaEncodeLine(const RLEEncoder * enc, Uint8 * dst, Uint8 * srcbuf)
+{
+    Uint32 *src = (Uint32 *) srcbuf;
+    SDL_PixelFormat *sf = enc->sf;
+    SDL_PixelFormat *df = enc->df;
+    const int w = enc->w;
+    const int max_opaque_run = enc->max_opaque_run;
+    const int max_transl_run = 65535;
+    int x, runstart, skipstart;
+
+    /* opaque counts are 8 or 16 bits, depending on target depth */
+#define ADD_OPAQUE_COUNTS(n, m)         \
+    if(df->BytesPerPixel == 4) {        \
+        ((Uint16 *)dst)[0] = n;     \
+        ((Uint16 *)dst)[1] = m;     \
+        dst += 4;               \
+    } else {                \
+        dst[0] = n;             \
+        dst[1] = m;             \
+        dst += 2;               \
+    }
 
-#define ISTRANSL(pixel, fmt)    \
-    ((unsigned)((((pixel) & fmt->Amask) >> fmt->Ashift) - 1U) < 254U)
+    /* translucent counts are always 16 bit */
+#define ADD_TRANSL_COUNTS(n, m)     \
+    (((Uint16 *)dst)[0] = n, ((Uint16 *)dst)[1] = m, dst += 4)
+
+    /* First encode all opaque pixels of a scan line */
+    x = 0;
+    do {
+        int run, skip, len;
+        skipstart = x;
+        while (x < w && !ISOPAQUE(src[x], sf))
+            x++;
+        runstart = x;
+        while (x < w && ISOPAQUE(src[x], sf))
+            x++;
+        skip = runstart - skipstart;
+        run = x - runstart;
+        while (skip > max_opaque_run) {
+            ADD_OPAQUE_COUNTS(max_opaque_run, 0);
+            skip -= max_opaque_run;
+        }
+        len = MIN(run, max_opaque_run);
+        ADD_OPAQUE_COUNTS(skip, len);
+        dst += enc->copy_opaque(dst, src + runstart, len, sf, df);
+        runstart += len;
+        run -= len;
+        while (run) {
+            len = MIN(run, max_opaque_run);
+            ADD_OPAQUE_COUNTS(0, len);
+            dst += enc->copy_opaque(dst, src + runstart, len, sf, df);
+            runstart += len;
+            run -= len;
+        }
+    } while (x < w);
+
+    /* Make sure the next output address is 32-bit aligned */
+    dst += (uintptr_t) dst & 2;
+
+    /* Next, encode all translucent pixels of the same scan line */
+    x = 0;
+    do {
+        int run, skip, len;
+        skipstart = x;
+        while (x < w && !ISTRANSL(src[x], sf))
+            x++;
+        runstart = x;
+        while (x < w && ISTRANSL(src[x], sf))
+            x++;
+        skip = runstart - skipstart;
+        run = x - runstart;
+        while (skip > max_transl_run) {
+            ADD_TRANSL_COUNTS(max_transl_run, 0);
+            skip -= max_transl_run;
+        }
+        len = MIN(run, max_transl_run);
+        ADD_TRANSL_COUNTS(skip, len);
+        dst += enc->copy_transl(dst, src + runstart, len, sf, df);
+        runstart += len;
+        run -= len;
+        while (run) {
+            len = MIN(run, max_transl_run);
+            ADD_TRANSL_COUNTS(0, len);
+            dst += enc->copy_transl(dst, src + runstart, len, sf, df);
+            runstart += len;
+            run -= len;
+        }
+    } while (x < w);
+
+#undef ADD_OPAQUE_COUNTS
+#undef ADD_TRANSL_COUNTS
+
+    return dst;
+}
 
 /* convert surface to be quickly alpha-blittable onto dest, if possible */
 static int
@@ -1027,15 +1444,8 @@ RLEAlphaSurface(SDL_Surface * surface)
 {
     SDL_Surface *dest;
     SDL_PixelFormat *df;
-    int maxsize = 0;
-    int max_opaque_run;
-    int max_transl_run = 65535;
     unsigned masksum;
-    Uint8 *rlebuf, *dst;
-    int (*copy_opaque) (void *, Uint32 *, int,
-                        SDL_PixelFormat *, SDL_PixelFormat *);
-    int (*copy_transl) (void *, Uint32 *, int,
-                        SDL_PixelFormat *, SDL_PixelFormat *);
+    RLEEncoder enc;
 
     dest = surface->map->dst;
     if (!dest)
@@ -1044,6 +1454,8 @@ RLEAlphaSurface(SDL_Surface * surface)
     if (surface->format->BitsPerPixel != 32)
         return -1;              /* only 32bpp source supported */
 
+    SDL_zero(enc);
+
     /* find out whether the destination is one we support,
        and determine the max size of the encoded result */
     masksum = df->Rmask | df->Gmask | df->Bmask;
@@ -1054,77 +1466,81 @@ RLEAlphaSurface(SDL_Surface * surface)
         case 0xffff:
             if (df->Gmask == 0x07e0
                 || df->Rmask == 0x07e0 || df->Bmask == 0x07e0) {
-                copy_opaque = copy_opaque_16;
-                copy_transl = copy_transl_565;
+                enc.copy_opaque = copy_opaque_16;
+                enc.copy_transl = copy_transl_565;
             } else
                 return -1;
             break;
         case 0x7fff:
             if (df->Gmask == 0x03e0
                 || df->Rmask == 0x03e0 || df->Bmask == 0x03e0) {
-                copy_opaque = copy_opaque_16;
-                copy_transl = copy_transl_555;
+                enc.copy_opaque = copy_opaque_16;
+                enc.copy_transl = copy_transl_555;
             } else
                 return -1;
             break;
         default:
             return -1;
         }
-        max_opaque_run = 255;   /* runs stored as bytes */
+        enc.max_opaque_run = 255;   /* runs stored as bytes */
 
         /* worst case is alternating opaque and translucent pixels,
            with room for alignment padding between lines */
-        maxsize = surface->h * (2 + (4 + 2) * (surface->w + 1)) + 2;
+        enc.max_line_size = 2 + (4 + 2) * (surface->w + 1);
+        enc.count_size = 2;
         break;
     case 4:
         if (masksum != 0x00ffffff)
             return -1;          /* requires unused high byte */
-        copy_opaque = copy_32;
-        copy_transl = copy_32;
-        max_opaque_run = 255;   /* runs stored as short ints */
+        enc.copy_opaque = copy_32;
+        enc.copy_transl = copy_32;
+        enc.max_opaque_run = 255;   /* runs stored as short ints */
 
         /* worst case is alternating opaque and translucent pixels */
-        maxsize = surface->h * 2 * 4 * (surface->w + 1) + 4;
+        enc.max_line_size = 2 * 4 * (surface->w + 1);
+        enc.count_size = 4;
         break;
     default:
         return -1;              /* anything else unsupported right now */
     }
 
-    maxsize += sizeof(RLEDestFormat);
-    rlebuf = (Uint8 *) SDL_malloc(maxsize);
-    if (!rlebuf) {
-        return SDL_OutOfMemory();
-    }
-    {
-        /* save the destination format so we can undo the encoding later */
-        RLEDestFormat *r = (RLEDestFormat *) rlebuf;
-        r->BytesPerPixel = df->BytesPerPixel;
-        r->Rmask = df->Rmask;
-        r->Gmask = df->Gmask;
-        r->Bmask = df->Bmask;
-        r->Amask = df->Amask;
-        r->Rloss = df->Rloss;
-        r->Gloss = df->Gloss;
-        r->Bloss = df->Bloss;
-        r->Aloss = df->Aloss;
-        r->Rshift = df->Rshift;
-        r->Gshift = df->Gshift;
-        r->Bshift = df->Bshift;
-        r->Ashift = df->Ashift;
-    }
-    dst = rlebuf + sizeof(RLEDestFormat);
+    enc.flags = SDL_COPY_RLE_ALPHAKEY;
+    enc.format.BytesPerPixel = df->BytesPerPixel;
+    enc.format.Rmask = df->Rmask;
+    enc.format.Gmask = df->Gmask;
+    enc.format.Bmask = df->Bmask;
+    enc.format.Amask = df->Amask;
+    enc.format.Rloss = df->Rloss;
+    enc.format.Gloss = df->Gloss;
+    enc.format.Bloss = df->Bloss;
+    enc.format.Aloss = df->Aloss;
+    enc.format.Rshift = df->Rshift;
+    enc.format.Gshift = df->Gshift;
+    enc.format.Bshift = df->Bshift;
+    enc.format.Ashift = df->Ashift;
+    enc.header_size = sizeof(RLEDestFormat);
+    enc.encode_line = RLEAlphaEncodeLine;
+    enc.w = surface->w;
+    enc.sf = surface->format;
+    enc.df = df;
+
+    return RLEEncodeSurface(surface, &enc);
+}
 
-    /* Do the actual encoding */
-    {
-        int x, y;
-        int h = surface->h, w = surface->w;
-        SDL_PixelFormat *sf = surface->format;
-        Uint32 *src = (Uint32 *) surface->pixels;
-        Uint8 *lastline = dst;  /* end of last non-blank line */
+/* encode one scan line of a colorkeyed surface */
+static Uint8 *
+RLEColorkeyEncodeLine(const RLEEncoder * enc, Uint8 * dst, Uint8 * srcbuf)
+{
+    const int bpp = enc->bpp;
+    const int maxn = enc->maxn;
+    const int w = enc->w;
+    const getpix_func getpix = enc->getpix;
+    const Uint32 rgbmask = enc->rgbmask;
+    const Uint32 ckey = enc->colorkey;
+    int x = 0;
 
-        /* opaque counts are 8 or 16 bits, depending on target depth */
-#define ADD_OPAQUE_COUNTS(n, m)         \
-    if(df->BytesPerPixel == 4) {        \
+#define ADD_COUNTS(n, m)            \
+    if(bpp == 4) {              \
         ((Uint16 *)dst)[0] = n;     \
         ((Uint16 *)dst)[1] = m;     \
         dst += 4;               \
@@ -1134,269 +1550,87 @@ RLEAlphaSurface(SDL_Surface * surface)
         dst += 2;               \
     }
 
-        /* translucent counts are always 16 bit */
-#define ADD_TRANSL_COUNTS(n, m)     \
-    (((Uint16 *)dst)[0] = n, ((Uint16 *)dst)[1] = m, dst += 4)
-
-        for (y = 0; y < h; y++) {
-            int runstart, skipstart;
-            int blankline = 0;
-            /* First encode all opaque pixels of a scan line */
-            x = 0;
-            do {
-                int run, skip, len;
-                skipstart = x;
-                while (x < w && !ISOPAQUE(src[x], sf))
-                    x++;
-                runstart = x;
-                while (x < w && ISOPAQUE(src[x], sf))
-                    x++;
-                skip = runstart - skipstart;
-                if (skip == w)
-                    blankline = 1;
-                run = x - runstart;
-                while (skip > max_opaque_run) {
-                    ADD_OPAQUE_COUNTS(max_opaque_run, 0);
-                    skip -= max_opaque_run;
-                }
-                len = MIN(run, max_opaque_run);
-                ADD_OPAQUE_COUNTS(skip, len);
-                dst += copy_opaque(dst, src + runstart, len, sf, df);
-                runstart += len;
-                run -= len;
-                while (run) {
-                    len = MIN(run, max_opaque_run);
-                    ADD_OPAQUE_COUNTS(0, len);
-                    dst += copy_opaque(dst, src + runstart, len, sf, df);
-                    runstart += len;
-                    run -= len;
-                }
-            } while (x < w);
-
-            /* Make sure the next output address is 32-bit aligned */
-            dst += (uintptr_t) dst & 2;
-
-            /* Next, encode all translucent pixels of the same scan line */
-            x = 0;
-            do {
-                int run, skip, len;
-                skipstart = x;
-                while (x < w && !ISTRANSL(src[x], sf))
-                    x++;
-                runstart = x;
-                while (x < w && ISTRANSL(src[x], sf))
-                    x++;
-                skip = runstart - skipstart;
-                blankline &= (skip == w);
-                run = x - runstart;
-                while (skip > max_transl_run) {
-                    ADD_TRANSL_COUNTS(max_transl_run, 0);
-                    skip -= max_transl_run;
-                }
-                len = MIN(run, max_transl_run);
-                ADD_TRANSL_COUNTS(skip, len);
-                dst += copy_transl(dst, src + runstart, len, sf, df);
-                runstart += len;
-                run -= len;
-                while (run) {
-                    len = MIN(run, max_transl_run);
-                    ADD_TRANSL_COUNTS(0, len);
-                    dst += copy_transl(dst, src + runstart, len, sf, df);
-                    runstart += len;
-                    run -= len;
-                }
-                if (!blankline)
-                    lastline = dst;
-            } while (x < w);
-
-            src += surface->pitch >> 2;
+    do {
+        int run, skip, len;
+        int runstart;
+        int skipstart = x;
+
+        /* find run of transparent, then opaque pixels */
+        while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) == ckey)
+            x++;
+        runstart = x;
+        while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) != ckey)
+            x++;
+        skip = runstart - skipstart;
+        run = x - runstart;
+
+        /* encode segment */
+        while (skip > maxn) {
+            ADD_COUNTS(maxn, 0);
+            skip -= maxn;
         }
-        dst = lastline;         /* back up past trailing blank lines */
-        ADD_OPAQUE_COUNTS(0, 0);
-    }
-
-#undef ADD_OPAQUE_COUNTS
-#undef ADD_TRANSL_COUNTS
-
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
-        surface->pixels = NULL;
-    }
-
-    /* realloc the buffer to release unused memory */
-    {
-        Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
-        if (!p)
-            p = rlebuf;
-        surface->map->data = p;
-    }
-
-    return 0;
-}
-
-static Uint32
-getpix_8(Uint8 * srcbuf)
-{
-    return *srcbuf;
-}
-
-static Uint32
-getpix_16(Uint8 * srcbuf)
-{
-    return *(Uint16 *) srcbuf;
-}
+        len = MIN(run, maxn);
+        ADD_COUNTS(skip, len);
+        SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
+        dst += len * bpp;
+        run -= len;
+        runstart += len;
+        while (run) {
+            len = MIN(run, maxn);
+            ADD_COUNTS(0, len);
+            SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
+            dst += len * bpp;
+            runstart += len;
+            run -= len;
+        }
+    } while (x < w);
 
-static Uint32
-getpix_24(Uint8 * srcbuf)
-{
-#if SDL_BYTEORDER == SDL_LIL_ENDIAN
-    return srcbuf[0] + (srcbuf[1] << 8) + (srcbuf[2] << 16);
-#else
-    return (srcbuf[0] << 16) + (srcbuf[1] << 8) + srcbuf[2];
-#endif
-}
+#undef ADD_COUNTS
 
-static Uint32
-getpix_32(Uint8 * srcbuf)
-{
-    return *(Uint32 *) srcbuf;
+    return dst;
 }
 
-typedef Uint32(*getpix_func) (Uint8 *);
-
-static const getpix_func getpixes[4] = {
-    getpix_8, getpix_16, getpix_24, getpix_32
-};
-
 static int
 RLEColorkeySurface(SDL_Surface * surface)
 {
-    Uint8 *rlebuf, *dst;
-    int maxn;
-    int y;
-    Uint8 *srcbuf, *lastline;
-    int maxsize = 0;
     const int bpp = surface->format->BytesPerPixel;
-    getpix_func getpix;
-    Uint32 ckey, rgbmask;
-    int w, h;
+    RLEEncoder enc;
+
+    SDL_zero(enc);
 
-    /* calculate the worst case size for the compressed surface */
+    /* calculate the worst case size for a compressed line */
     switch (bpp) {
     case 1:
         /* worst case is alternating opaque and transparent pixels,
            starting with an opaque pixel */
-        maxsize = surface->h * 3 * (surface->w / 2 + 1) + 2;
+        enc.max_line_size = 3 * (surface->w / 2 + 1);
         break;
     case 2:
     case 3:
         /* worst case is solid runs, at most 255 pixels wide */
-        maxsize = surface->h * (2 * (surface->w / 255 + 1)
-                                + surface->w * bpp) + 2;
+        enc.max_line_size = 2 * (surface->w / 255 + 1) + surface->w * bpp;
         break;
     case 4:
         /* worst case is solid runs, at most 65535 pixels wide */
-        maxsize = surface->h * (4 * (surface->w / 65535 + 1)
-                                + surface->w * 4) + 4;
+        enc.max_line_size = 4 * (surface->w / 65535 + 1) + surface->w * 4;
         break;
 
     default:
         return -1;
     }
 
-    rlebuf = (Uint8 *) SDL_malloc(maxsize);
-    if (rlebuf == NULL) {
-        return SDL_OutOfMemory();
-    }
-
     /* Set up the conversion */
-    srcbuf = (Uint8 *) surface->pixels;
-    maxn = bpp == 4 ? 65535 : 255;
-    dst = rlebuf;
-    rgbmask = ~surface->format->Amask;
-    ckey = surface->map->info.colorkey & rgbmask;
-    lastline = dst;
-    getpix = getpixes[bpp - 1];
-    w = surface->w;
-    h = surface->h;
-
-#define ADD_COUNTS(n, m)            \
-    if(bpp == 4) {              \
-        ((Uint16 *)dst)[0] = n;     \
-        ((Uint16 *)dst)[1] = m;     \
-        dst += 4;               \
-    } else {                \
-        dst[0] = n;             \
-        dst[1] = m;             \
-        dst += 2;               \
-    }
-
-    for (y = 0; y < h; y++) {
-        int x = 0;
-        int blankline = 0;
-        do {
-            int run, skip, len;
-            int runstart;
-            int skipstart = x;
-
-            /* find run of transparent, then opaque pixels */
-            while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) == ckey)
-                x++;
-            runstart = x;
-            while (x < w && (getpix(srcbuf + x * bpp) & rgbmask) != ckey)
-                x++;
-            skip = runstart - skipstart;
-            if (skip == w)
-                blankline = 1;
-            run = x - runstart;
-
-            /* encode segment */
-            while (skip > maxn) {
-                ADD_COUNTS(maxn, 0);
-                skip -= maxn;
-            }
-            len = MIN(run, maxn);
-            ADD_COUNTS(skip, len);
-            SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
-            dst += len * bpp;
-            run -= len;
-            runstart += len;
-            while (run) {
-                len = MIN(run, maxn);
-                ADD_COUNTS(0, len);
-                SDL_memcpy(dst, srcbuf + runstart * bpp, len * bpp);
-                dst += len * bpp;
-                runstart += len;
-                run -= len;
-            }
-            if (!blankline)
-                lastline = dst;
-        } while (x < w);
-
-        srcbuf += surface->pitch;
-    }
-    dst = lastline;             /* back up bast trailing blank lines */
-    ADD_COUNTS(0, 0);
-
-#undef ADD_COUNTS
-
-    /* Now that we have it encoded, release the original pixels */
-    if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
-        surface->pixels = NULL;
-    }
-
-    /* realloc the buffer to release unused memory */
-    {
-        /* If realloc returns NULL, the original block is left intact */
-        Uint8 *p = SDL_realloc(rlebuf, dst - rlebuf);
-        if (!p)
-            p = rlebuf;
-        surface->map->data = p;
-    }
-
-    return 0;
+    enc.flags = SDL_COPY_RLE_COLORKEY;
+    enc.rgbmask = ~surface->format->Amask;
+    enc.colorkey = surface->map->info.colorkey & enc.rgbmask;
+    enc.count_size = bpp == 4 ? 4 : 2;
+    enc.encode_line = RLEColorkeyEncodeLine;
+    enc.w = surface->w;
+    enc.bpp = bpp;
+    enc.maxn = bpp == 4 ? 65535 : 255;
+    enc.getpix = getpixes[bpp - 1];
+
+    return RLEEncodeSurface(surface, &enc);
 }
 
 int
@@ -1406,7 +1640,7 @@ SDL_RLESurface(SDL_Surface * surface)
 
     /* Clear any previous RLE conversion */
     if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 1);
+        SDL_UnRLESurface(surface);
     }
 
     /* We don't support RLE encoding of bitmaps */
@@ -1457,125 +1691,32 @@ SDL_RLESurface(SDL_Surface * surface)
     return (0);
 }
 
-/*
- * Un-RLE a surface with pixel alpha
- * This may not give back exactly the image before RLE-encoding; all
- * completely transparent pixels will be lost, and color and alpha depth
- * may have been reduced (when encoding for 16bpp targets).
- */
-static SDL_bool
-UnRLEAlpha(SDL_Surface * surface)
-{
-    Uint8 *srcbuf;
-    Uint32 *dst;
-    SDL_PixelFormat *sf = surface->format;
-    RLEDestFormat *df = surface->map->data;
-    int (*uncopy_opaque) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int (*uncopy_transl) (Uint32 *, void *, int,
-                          RLEDestFormat *, SDL_PixelFormat *);
-    int w = surface->w;
-    int bpp = df->BytesPerPixel;
-
-    if (bpp == 2) {
-        uncopy_opaque = uncopy_opaque_16;
-        uncopy_transl = uncopy_transl_16;
-    } else {
-        uncopy_opaque = uncopy_transl = uncopy_32;
-    }
-
-    surface->pixels = SDL_malloc(surface->h * surface->pitch);
-    if (!surface->pixels) {
-        return (SDL_FALSE);
-    }
-    /* fill background with transparent pixels */
-    SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
-
-    dst = surface->pixels;
-    srcbuf = (Uint8 *) (df + 1);
-    for (;;) {
-        /* copy opaque pixels */
-        int ofs = 0;
-        do {
-            unsigned run;
-            if (bpp == 2) {
-                ofs += srcbuf[0];
-                run = srcbuf[1];
-                srcbuf += 2;
-            } else {
-                ofs += ((Uint16 *) srcbuf)[0];
-                run = ((Uint16 *) srcbuf)[1];
-                srcbuf += 4;
-            }
-            if (run) {
-                srcbuf += uncopy_opaque(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            } else if (!ofs)
-                return (SDL_TRUE);
-        } while (ofs < w);
-
-        /* skip padding if needed */
-        if (bpp == 2)
-            srcbuf += (uintptr_t) srcbuf & 2;
-
-        /* copy translucent pixels */
-        ofs = 0;
-        do {
-            unsigned run;
-            ofs += ((Uint16 *) srcbuf)[0];
-            run = ((Uint16 *) srcbuf)[1];
-            srcbuf += 4;
-            if (run) {
-                srcbuf += uncopy_transl(dst + ofs, srcbuf, run, df, sf);
-                ofs += run;
-            }
-        } while (ofs < w);
-        dst += surface->pitch >> 2;
-    }
-    /* Make the compiler happy */
-    return (SDL_TRUE);
-}
-
 void
-SDL_UnRLESurface(SDL_Surface * surface, int recode)
+SDL_UnRLESurface(SDL_Surface * surface)
 {
     if (surface->flags & SDL_RLEACCEL) {
         surface->flags &= ~SDL_RLEACCEL;
 
-        if (recode && !(surface->flags & SDL_PREALLOC)) {
-            if (surface->map->info.flags & SDL_COPY_RLE_COLORKEY) {
-                SDL_Rect full;
-
-                /* re-create the original surface */
-                surface->pixels = SDL_malloc(surface->h * surface->pitch);
-                if (!surface->pixels) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
-
-                /* fill it with the background color */
-                SDL_FillRect(surface, NULL, surface->map->info.colorkey);
-
-                /* now render the encoded surface */
-                full.x = full.y = 0;
-                full.w = surface->w;
-                full.h = surface->h;
-                SDL_RLEBlit(surface, &full, surface, &full);
-            } else {
-                if (!UnRLEAlpha(surface)) {
-                    /* Oh crap... */
-                    surface->flags |= SDL_RLEACCEL;
-                    return;
-                }
-            }
-        }
+        /* The pixels were never released, so there's nothing to decode,
+           and the encoding stays in the cache for the next time */
         surface->map->info.flags &=
             ~(SDL_COPY_RLE_COLORKEY | SDL_COPY_RLE_ALPHAKEY);
-
-        SDL_free(surface->map->data);
         surface->map->data = NULL;
     }
 }
 
+void
+SDL_FreeRLECache(SDL_Surface * surface)
+{
+    RLECache *cache = surface->map ? (RLECache *) surface->map->rle_cache : NULL;
+
+    if (cache) {
+        SDL_UnRLESurface(surface);
+        SDL_free(cache->lines);
+        SDL_free(cache->data);
+        SDL_free(cache);
+        surface->map->rle_cache = NULL;
+    }
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -27,5 +27,6 @@ extern int SDLCALL SDL_RLEBlit     (SDL_Surface * src, SDL_Rect * srcrect,
                                     SDL_Surface * dst, SDL_Rect * dstrect);
 extern int SDLCALL SDL_RLEAlphaBlit(SDL_Surface * src, SDL_Rect * srcrect,
                                     SDL_Surface * dst, SDL_Rect * dstrect);
-extern void SDL_UnRLESurface(SDL_Surface * surface, int recode);
+extern void SDL_UnRLESurface(SDL_Surface * surface);
+extern void SDL_FreeRLECache(SDL_Surface * surface);
 /* vi: set ts=4 sw=4 expandtab: */
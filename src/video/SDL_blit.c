@@ -20,6 +20,7 @@
 */
 #include "../SDL_internal.h"
 
+#include "SDL_atomic.h"
 #include "SDL_video.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
@@ -28,11 +29,42 @@
 #include "SDL_blit_slow.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
+#include "../thread/SDL_parallel_c.h"
 
-/* The general purpose software blit routine */
-static int SDLCALL
-SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
-             SDL_Surface * dst, SDL_Rect * dstrect)
+/* Each band of a parallel blit covers at least this many pixels */
+#define SDL_PARALLEL_BLIT_BAND_PIXELS   (64 * 1024)
+
+typedef struct
+{
+    SDL_BlitFunc RunBlit;
+    const SDL_BlitInfo *info;
+} SDL_ParallelBlitJob;
+
+static void
+SDL_SoftBlitBand(void *data, int start, int end)
+{
+    const SDL_ParallelBlitJob *job = (const SDL_ParallelBlitJob *) data;
+    SDL_BlitInfo info = *job->info;
+
+    /* Every band gets its own copy of the blit info, the blitters modify it */
+    info.src += start * info.src_pitch;
+    info.dst += start * info.dst_pitch;
+    info.src_h = end - start;
+    info.dst_h = end - start;
+    job->RunBlit(&info);
+}
+
+/* The largest power of two, up to 64, that every row start is a multiple of */
+static int
+SDL_GetRowAlignment(const Uint8 * pixels, int pitch)
+{
+    const uintptr_t bits = (uintptr_t) pixels | (uintptr_t) pitch | 64;
+    return (int) (bits & (~bits + 1));
+}
+
+static int
+SDL_SoftBlitInternal(SDL_Surface * src, SDL_Rect * srcrect,
+                     SDL_Surface * dst, SDL_Rect * dstrect, SDL_bool parallel)
 {
     int okay;
     int src_locked;
@@ -50,9 +82,10 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
             dst_locked = 1;
         }
     }
-    /* Lock the source if it's in hardware */
+    /* Lock the source if it's in hardware. Reading a view doesn't need its
+       owner locked, and unlocking would encode an RLE owner again. */
     src_locked = 0;
-    if (SDL_MUSTLOCK(src)) {
+    if (src->flags & SDL_RLEACCEL) {
         if (SDL_LockSurface(src) < 0) {
             okay = 0;
         } else {
@@ -82,10 +115,23 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
         info->dst_pitch = dst->pitch;
         info->dst_skip =
             info->dst_pitch - info->dst_w * info->dst_fmt->BytesPerPixel;
+        info->src_align = SDL_GetRowAlignment(info->src, info->src_pitch);
+        info->dst_align = SDL_GetRowAlignment(info->dst, info->dst_pitch);
         RunBlit = (SDL_BlitFunc) src->map->data;
 
         /* Run the actual software blit */
-        RunBlit(info);
+        if (parallel && !(info->flags & SDL_COPY_NEAREST) &&
+            info->src_h == info->dst_h) {
+            SDL_ParallelBlitJob job;
+
+            job.RunBlit = RunBlit;
+            job.info = info;
+            SDL_ParallelFor(info->dst_h, 1,
+                            SDL_PARALLEL_BLIT_BAND_PIXELS / SDL_max(info->dst_w, 1),
+                            SDL_SoftBlitBand, &job);
+        } else {
+            RunBlit(info);
+        }
     }
 
     /* We need to unlock the surfaces if they're locked */
@@ -99,6 +145,29 @@ SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
     return (okay ? 0 : -1);
 }
 
+/* The general purpose software blit routine */
+static int SDLCALL
+SDL_SoftBlit(SDL_Surface * src, SDL_Rect * srcrect,
+             SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    return SDL_SoftBlitInternal(src, srcrect, dst, dstrect, SDL_FALSE);
+}
+
+/*
+ * Run an unscaled blit in bands of rows on the worker threads.
+ * The map must be up to date, and src and dst must not overlap.
+ * Blits that can't be split, like RLE ones, run on this thread.
+ */
+int
+SDL_ParallelBlit(SDL_Surface * src, SDL_Rect * srcrect,
+                 SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    if (src->map->blit != SDL_SoftBlit) {
+        return src->map->blit(src, srcrect, dst, dstrect);
+    }
+    return SDL_SoftBlitInternal(src, srcrect, dst, dstrect, SDL_TRUE);
+}
+
 #ifdef __MACOSX__
 #include <sys/sysctl.h>
 
@@ -124,14 +193,12 @@ SDL_UseAltivecPrefetch()
 }
 #endif /* __MACOSX__ */
 
-static SDL_BlitFunc
-SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
-                   SDL_BlitFuncEntry * entries)
+/* Get the SDL_CPU_* features blitters may use */
+Uint32
+SDL_GetBlitCPUFeatures(void)
 {
-    int i, flagcheck;
     static Uint32 features = 0xffffffff;
 
-    /* Get the available CPU features */
     if (features == 0xffffffff) {
         const char *override = SDL_getenv("SDL_BLIT_CPU_FEATURES");
 
@@ -153,6 +220,15 @@ SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
             if (SDL_HasSSE2()) {
                 features |= SDL_CPU_SSE2;
             }
+            if (SDL_HasSSE41()) {
+                features |= SDL_CPU_SSE41;
+            }
+            if (SDL_HasAVX2()) {
+                features |= SDL_CPU_AVX2;
+            }
+            if (SDL_HasNEON()) {
+                features |= SDL_CPU_NEON;
+            }
             if (SDL_HasAltiVec()) {
                 if (SDL_UseAltivecPrefetch()) {
                     features |= SDL_CPU_ALTIVEC_PREFETCH;
@@ -162,6 +238,15 @@ SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
             }
         }
     }
+    return features;
+}
+
+static SDL_BlitFunc
+SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
+                   SDL_BlitFuncEntry * entries)
+{
+    int i, flagcheck;
+    const Uint32 features = SDL_GetBlitCPUFeatures();
 
     for (i = 0; entries[i].func; ++i) {
         /* Check for matching pixel formats */
@@ -211,44 +296,19 @@ SDL_ChooseBlitFunc(Uint32 src_format, Uint32 dst_format, int flags,
     return NULL;
 }
 
-/* Figure out which of many blit routines to set up on a surface */
-int
-SDL_CalculateBlit(SDL_Surface * surface)
+/* Pick the blit function for the formats and flags of a surface's map */
+static SDL_BlitFunc
+SDL_ChooseBlit(SDL_Surface * surface)
 {
     SDL_BlitFunc blit = NULL;
     SDL_BlitMap *map = surface->map;
     SDL_Surface *dst = map->dst;
 
-    /* We don't currently support blitting to < 8 bpp surfaces */
-    if (dst->format->BitsPerPixel < 8) {
-        SDL_InvalidateMap(map);
-        return SDL_SetError("Blit combination not supported");
-    }
-
-    /* Clean everything out to start */
-    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 1);
-    }
-    map->blit = SDL_SoftBlit;
-    map->info.src_fmt = surface->format;
-    map->info.src_pitch = surface->pitch;
-    map->info.dst_fmt = dst->format;
-    map->info.dst_pitch = dst->pitch;
-
-    /* See if we can do RLE acceleration */
-    if (map->info.flags & SDL_COPY_RLE_DESIRED) {
-        if (SDL_RLESurface(surface) == 0) {
-            return 0;
-        }
-    }
-
-    /* Choose a standard blit function */
     if (map->identity && !(map->info.flags & ~SDL_COPY_RLE_DESIRED)) {
         blit = SDL_BlitCopy;
     } else if (surface->format->Rloss > 8 || dst->format->Rloss > 8) {
         /* Greater than 8 bits per channel not supported yet */
-        SDL_InvalidateMap(map);
-        return SDL_SetError("Blit combination not supported");
+        return NULL;
     } else if (surface->format->BitsPerPixel < 8 &&
                SDL_ISPIXELFORMAT_INDEXED(surface->format->format)) {
         blit = SDL_CalculateBlit0(surface);
@@ -282,14 +342,147 @@ SDL_CalculateBlit(SDL_Surface * surface)
             blit = SDL_Blit_Slow;
         }
     }
-    map->data = blit;
+    return blit;
+}
 
-    /* Make sure we have a blit function */
-    if (blit == NULL) {
+/*
+ * Everything SDL_ChooseBlit() looks at is implied by the pixel formats, the
+ * copy flags, whether the map is an identity and the CPU features, so its
+ * answers are kept in a small hash table. That way surfaces whose color mod,
+ * alpha mod or blend mode keep changing don't walk the blitter tables again.
+ */
+#define SDL_BLIT_CACHE_SIZE 256     /* must be a power of two */
+
+typedef struct
+{
+    Uint32 src_format;
+    Uint32 dst_format;
+    Uint32 flags;
+    Uint32 features;
+    int identity;
+    SDL_BlitFunc func;
+} SDL_BlitCacheEntry;
+
+static SDL_BlitCacheEntry SDL_blit_cache[SDL_BLIT_CACHE_SIZE];
+static SDL_SpinLock SDL_blit_cache_lock;
+
+static SDL_bool
+SDL_GetBlitCacheKey(SDL_Surface * surface, SDL_BlitCacheEntry * key)
+{
+    const SDL_BlitMap *map = surface->map;
+
+    key->src_format = surface->format->format;
+    key->dst_format = map->dst->format->format;
+    key->flags = map->info.flags;
+    key->features = SDL_GetBlitCPUFeatures();
+    key->identity = map->identity;
+
+    /* Surfaces with unusual masks don't have a format we can key on */
+    if (key->src_format == SDL_PIXELFORMAT_UNKNOWN ||
+        key->dst_format == SDL_PIXELFORMAT_UNKNOWN) {
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static int
+SDL_HashBlitCacheKey(const SDL_BlitCacheEntry * key)
+{
+    Uint32 hash = 2166136261u;
+
+    hash = (hash ^ key->src_format) * 16777619u;
+    hash = (hash ^ key->dst_format) * 16777619u;
+    hash = (hash ^ key->flags) * 16777619u;
+    hash = (hash ^ key->features) * 16777619u;
+    hash = (hash ^ (Uint32) key->identity) * 16777619u;
+    return (int) ((hash ^ (hash >> 16)) & (SDL_BLIT_CACHE_SIZE - 1));
+}
+
+static SDL_BlitFunc
+SDL_LookupBlitCache(SDL_Surface * surface)
+{
+    SDL_BlitCacheEntry key;
+    const SDL_BlitCacheEntry *entry;
+    SDL_BlitFunc func = NULL;
+
+    if (!SDL_GetBlitCacheKey(surface, &key)) {
+        return NULL;
+    }
+    entry = &SDL_blit_cache[SDL_HashBlitCacheKey(&key)];
+
+    SDL_AtomicLock(&SDL_blit_cache_lock);
+    if (entry->func &&
+        entry->src_format == key.src_format &&
+        entry->dst_format == key.dst_format &&
+        entry->flags == key.flags &&
+        entry->features == key.features &&
+        entry->identity == key.identity) {
+        func = entry->func;
+    }
+    SDL_AtomicUnlock(&SDL_blit_cache_lock);
+
+    return func;
+}
+
+static void
+SDL_AddBlitCache(SDL_Surface * surface, SDL_BlitFunc func)
+{
+    SDL_BlitCacheEntry key;
+
+    if (!SDL_GetBlitCacheKey(surface, &key)) {
+        return;
+    }
+    key.func = func;
+
+    /* Collisions just replace the older entry */
+    SDL_AtomicLock(&SDL_blit_cache_lock);
+    SDL_blit_cache[SDL_HashBlitCacheKey(&key)] = key;
+    SDL_AtomicUnlock(&SDL_blit_cache_lock);
+}
+
+/* Figure out which of many blit routines to set up on a surface */
+int
+SDL_CalculateBlit(SDL_Surface * surface)
+{
+    SDL_BlitFunc blit = NULL;
+    SDL_BlitMap *map = surface->map;
+    SDL_Surface *dst = map->dst;
+
+    /* We don't currently support blitting to < 8 bpp surfaces */
+    if (dst->format->BitsPerPixel < 8) {
         SDL_InvalidateMap(map);
         return SDL_SetError("Blit combination not supported");
     }
 
+    /* Clean everything out to start */
+    if ((surface->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
+        SDL_UnRLESurface(surface);
+    }
+    map->blit = SDL_SoftBlit;
+    map->info.src_fmt = surface->format;
+    map->info.src_pitch = surface->pitch;
+    map->info.dst_fmt = dst->format;
+    map->info.dst_pitch = dst->pitch;
+
+    /* See if we can do RLE acceleration */
+    if (map->info.flags & SDL_COPY_RLE_DESIRED) {
+        if (SDL_RLESurface(surface) == 0) {
+            return 0;
+        }
+    }
+
+    /* Choose a standard blit function */
+    blit = SDL_LookupBlitCache(surface);
+    if (blit == NULL) {
+        blit = SDL_ChooseBlit(surface);
+        if (blit == NULL) {
+            SDL_InvalidateMap(map);
+            return SDL_SetError("Blit combination not supported");
+        }
+        SDL_AddBlitCache(surface, blit);
+    }
+    map->data = blit;
+
     return 0;
 }
 
@@ -51,6 +51,9 @@ extern Uint8* SDL_expand_byte[9];
 #define SDL_CPU_SSE2                0x00000008
 #define SDL_CPU_ALTIVEC_PREFETCH    0x00000010
 #define SDL_CPU_ALTIVEC_NOPREFETCH  0x00000020
+#define SDL_CPU_SSE41               0x00000040
+#define SDL_CPU_AVX2                0x00000080
+#define SDL_CPU_NEON                0x00000100
 
 typedef struct
 {
@@ -62,6 +65,8 @@ typedef struct
     int dst_w, dst_h;
     int dst_pitch;
     int dst_skip;
+    int src_align;      /* every src row starts on a multiple of this */
+    int dst_align;      /* every dst row starts on a multiple of this */
     SDL_PixelFormat *src_fmt;
     SDL_PixelFormat *dst_fmt;
     Uint8 *table;
@@ -90,6 +95,7 @@ typedef struct SDL_BlitMap
     SDL_blit blit;
     void *data;
     SDL_BlitInfo info;
+    void *rle_cache;            /* encoded scan lines, see SDL_RLEaccel.c */
 
     /* the version count matches the destination; mismatch indicates
        an invalid mapping */
@@ -99,6 +105,10 @@ typedef struct SDL_BlitMap
 
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface * surface);
+extern Uint32 SDL_GetBlitCPUFeatures(void);
+extern int SDL_ParallelBlit(SDL_Surface * src, SDL_Rect * srcrect, SDL_Surface * dst, SDL_Rect * dstrect);
+extern int SDL_PrivateUpperBlitScaled(SDL_Surface * src, const SDL_Rect * srcrect, SDL_Surface * dst, SDL_Rect * dstrect, SDL_bool linear);
+extern int SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect, SDL_Surface * dst, SDL_Rect * dstrect, SDL_bool linear);
 
 /* Functions found in SDL_blit_*.c */
 extern SDL_BlitFunc SDL_CalculateBlit0(SDL_Surface * surface);
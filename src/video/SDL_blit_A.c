@@ -23,6 +23,10 @@
 #include "SDL_video.h"
 #include "SDL_blit.h"
 
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
 /* Functions to perform alpha blended blitting */
 
 /* N->1 blending with per-surface alpha */
@@ -1142,6 +1146,576 @@ BlitARGBto555PixelAlpha(SDL_BlitInfo * info)
     }
 }
 
+/* The vectorized blitters below give exactly the same results as the plain
+   C versions above. They work on as many whole vectors as fit in each row,
+   then hand the remaining columns to the C version. */
+static void
+BlitRemainingColumns(SDL_BlitInfo * info, int done, SDL_BlitFunc blit)
+{
+    const int srcbpp = info->src_fmt->BytesPerPixel;
+    const int dstbpp = info->dst_fmt->BytesPerPixel;
+    SDL_BlitInfo rest;
+
+    if (done < info->dst_w) {
+        rest = *info;
+        rest.src += done * srcbpp;
+        rest.src_skip += done * srcbpp;
+        rest.dst += done * dstbpp;
+        rest.dst_skip += done * dstbpp;
+        rest.dst_w -= done;
+        blit(&rest);
+    }
+}
+
+#if HAVE_SSE41_INTRINSICS
+
+/* Blend the color channels of 16-bit lanes as (s * a + d * (256 - a)) >> 8,
+   which is what the C blitters compute with d + ((s - d) * a >> 8) */
+#define BLEND_COLOR_EPI16(s, d, a) \
+    _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(s, a), \
+                                 _mm_mullo_epi16(d, _mm_sub_epi16(_mm_set1_epi16(256), a))), 8)
+
+/* Blend the alpha channel of 16-bit lanes as a + (d * (255 - a) >> 8) */
+#define BLEND_ALPHA_EPI16(d, a) \
+    _mm_add_epi16(a, _mm_srli_epi16(_mm_mullo_epi16(d, _mm_sub_epi16(_mm_set1_epi16(255), a)), 8))
+
+/* SSE4.1 version of BlitRGBtoRGBPixelAlpha, 4 pixels at a time */
+SDL_TARGETING("sse4.1") static void
+BlitRGBtoRGBPixelAlphaSSE41(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~3;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 4 - width * 4;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 4 - width * 4;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i opaque = _mm_set1_epi32(SDL_ALPHA_OPAQUE);
+    const __m128i alpha_lo = _mm_setr_epi8(3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1);
+    const __m128i alpha_hi = _mm_setr_epi8(11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1);
+    int n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 4) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) src);
+            const __m128i d = _mm_loadu_si128((const __m128i *) dst);
+            const __m128i alpha = _mm_srli_epi32(s, 24);
+            const __m128i is_opaque = _mm_cmpeq_epi32(alpha, opaque);
+            const __m128i is_clear = _mm_cmpeq_epi32(alpha, zero);
+
+            if (_mm_movemask_epi8(is_opaque) == 0xffff) {
+                _mm_storeu_si128((__m128i *) dst, s);
+            } else if (_mm_movemask_epi8(is_clear) != 0xffff) {
+                const __m128i a_lo = _mm_shuffle_epi8(s, alpha_lo);
+                const __m128i a_hi = _mm_shuffle_epi8(s, alpha_hi);
+                const __m128i s_lo = _mm_unpacklo_epi8(s, zero);
+                const __m128i s_hi = _mm_unpackhi_epi8(s, zero);
+                const __m128i d_lo = _mm_unpacklo_epi8(d, zero);
+                const __m128i d_hi = _mm_unpackhi_epi8(d, zero);
+                const __m128i lo = _mm_blend_epi16(BLEND_COLOR_EPI16(s_lo, d_lo, a_lo),
+                                                   BLEND_ALPHA_EPI16(d_lo, a_lo), 0x88);
+                const __m128i hi = _mm_blend_epi16(BLEND_COLOR_EPI16(s_hi, d_hi, a_hi),
+                                                   BLEND_ALPHA_EPI16(d_hi, a_hi), 0x88);
+                __m128i result = _mm_packus_epi16(lo, hi);
+
+                result = _mm_blendv_epi8(result, s, is_opaque);
+                result = _mm_blendv_epi8(result, d, is_clear);
+                _mm_storeu_si128((__m128i *) dst, result);
+            }
+            src += 16;
+            dst += 16;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, BlitRGBtoRGBPixelAlpha);
+}
+
+/* SSE4.1 version of BlitRGBtoRGBSurfaceAlpha, 4 pixels at a time */
+SDL_TARGETING("sse4.1") static void
+BlitRGBtoRGBSurfaceAlphaSSE41(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~3;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 4 - width * 4;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 4 - width * 4;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i alpha = _mm_set1_epi16(info->a);
+    const __m128i amask = _mm_set1_epi32(0xff000000);
+    int n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 4) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) src);
+            const __m128i d = _mm_loadu_si128((const __m128i *) dst);
+            const __m128i lo = BLEND_COLOR_EPI16(_mm_unpacklo_epi8(s, zero),
+                                                 _mm_unpacklo_epi8(d, zero), alpha);
+            const __m128i hi = BLEND_COLOR_EPI16(_mm_unpackhi_epi8(s, zero),
+                                                 _mm_unpackhi_epi8(d, zero), alpha);
+
+            _mm_storeu_si128((__m128i *) dst, _mm_or_si128(_mm_packus_epi16(lo, hi), amask));
+            src += 16;
+            dst += 16;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, BlitRGBtoRGBSurfaceAlpha);
+}
+
+/* Blend the 5, 6 and 5 bit fields of RGB565 lanes as d + ((s - d) * a >> 5) */
+#define BLEND_565_FIELD_EPI16(s, d, a) \
+    _mm_add_epi16(d, _mm_srai_epi16(_mm_mullo_epi16(_mm_sub_epi16(s, d), a), 5))
+
+SDL_TARGETING("sse4.1") static __m128i
+Blend565SSE41(__m128i s, __m128i d, __m128i alpha)
+{
+    const __m128i mask5 = _mm_set1_epi16(0x1f);
+    const __m128i mask6 = _mm_set1_epi16(0x3f);
+    const __m128i r = BLEND_565_FIELD_EPI16(_mm_srli_epi16(s, 11), _mm_srli_epi16(d, 11), alpha);
+    const __m128i g = BLEND_565_FIELD_EPI16(_mm_and_si128(_mm_srli_epi16(s, 5), mask6),
+                                            _mm_and_si128(_mm_srli_epi16(d, 5), mask6), alpha);
+    const __m128i b = BLEND_565_FIELD_EPI16(_mm_and_si128(s, mask5), _mm_and_si128(d, mask5), alpha);
+
+    return _mm_or_si128(_mm_or_si128(_mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b);
+}
+
+/* SSE4.1 version of Blit565to565SurfaceAlpha, 8 pixels at a time */
+SDL_TARGETING("sse4.1") static void
+Blit565to565SurfaceAlphaSSE41(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~7;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 2 - width * 2;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 2 - width * 2;
+    const __m128i alpha = _mm_set1_epi16(info->a >> 3);
+    int n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 8) {
+            const __m128i s = _mm_loadu_si128((const __m128i *) src);
+            const __m128i d = _mm_loadu_si128((const __m128i *) dst);
+
+            _mm_storeu_si128((__m128i *) dst, Blend565SSE41(s, d, alpha));
+            src += 16;
+            dst += 16;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, Blit565to565SurfaceAlpha);
+}
+
+/* Convert 4 ARGB8888 pixels to RGB565 in the low half of 32-bit lanes */
+#define ARGB_TO_565_EPI32(s) \
+    _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_srli_epi32(s, 8), _mm_set1_epi32(0xf800)), \
+                              _mm_and_si128(_mm_srli_epi32(s, 5), _mm_set1_epi32(0x7e0))), \
+                 _mm_and_si128(_mm_srli_epi32(s, 3), _mm_set1_epi32(0x1f)))
+
+/* SSE4.1 version of BlitARGBto565PixelAlpha, 8 pixels at a time */
+SDL_TARGETING("sse4.1") static void
+BlitARGBto565PixelAlphaSSE41(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~7;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 4 - width * 4;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 2 - width * 2;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i opaque = _mm_set1_epi16(SDL_ALPHA_OPAQUE >> 3);
+    int n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 8) {
+            const __m128i s0 = _mm_loadu_si128((const __m128i *) src);
+            const __m128i s1 = _mm_loadu_si128((const __m128i *) (src + 16));
+            const __m128i alpha = _mm_packs_epi32(_mm_srli_epi32(s0, 27), _mm_srli_epi32(s1, 27));
+            const __m128i is_opaque = _mm_cmpeq_epi16(alpha, opaque);
+            const __m128i is_clear = _mm_cmpeq_epi16(alpha, zero);
+            const __m128i s = _mm_packus_epi32(ARGB_TO_565_EPI32(s0), ARGB_TO_565_EPI32(s1));
+
+            if (_mm_movemask_epi8(is_opaque) == 0xffff) {
+                _mm_storeu_si128((__m128i *) dst, s);
+            } else if (_mm_movemask_epi8(is_clear) != 0xffff) {
+                const __m128i d = _mm_loadu_si128((const __m128i *) dst);
+                __m128i result = Blend565SSE41(s, d, alpha);
+
+                result = _mm_blendv_epi8(result, s, is_opaque);
+                result = _mm_blendv_epi8(result, d, is_clear);
+                _mm_storeu_si128((__m128i *) dst, result);
+            }
+            src += 32;
+            dst += 16;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, BlitARGBto565PixelAlpha);
+}
+
+#endif /* HAVE_SSE41_INTRINSICS */
+
+#if HAVE_AVX2_INTRINSICS
+
+#define BLEND_COLOR_EPI16_256(s, d, a) \
+    _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(s, a), \
+                                       _mm256_mullo_epi16(d, _mm256_sub_epi16(_mm256_set1_epi16(256), a))), 8)
+
+#define BLEND_ALPHA_EPI16_256(d, a) \
+    _mm256_add_epi16(a, _mm256_srli_epi16(_mm256_mullo_epi16(d, _mm256_sub_epi16(_mm256_set1_epi16(255), a)), 8))
+
+/* AVX2 version of BlitRGBtoRGBPixelAlpha, 8 pixels at a time */
+SDL_TARGETING("avx2") static void
+BlitRGBtoRGBPixelAlphaAVX2(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~7;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 4 - width * 4;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 4 - width * 4;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i opaque = _mm256_set1_epi32(SDL_ALPHA_OPAQUE);
+    const __m256i alpha_lo = _mm256_setr_epi8(3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1,
+                                              3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1);
+    const __m256i alpha_hi = _mm256_setr_epi8(11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1,
+                                              11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1);
+    int n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 8) {
+            const __m256i s = _mm256_loadu_si256((const __m256i *) src);
+            const __m256i d = _mm256_loadu_si256((const __m256i *) dst);
+            const __m256i alpha = _mm256_srli_epi32(s, 24);
+            const __m256i is_opaque = _mm256_cmpeq_epi32(alpha, opaque);
+            const __m256i is_clear = _mm256_cmpeq_epi32(alpha, zero);
+
+            if (_mm256_movemask_epi8(is_opaque) == -1) {
+                _mm256_storeu_si256((__m256i *) dst, s);
+            } else if (_mm256_movemask_epi8(is_clear) != -1) {
+                /* Unpacking and packing both work within 128-bit lanes,
+                   so the pixels come back out in their original order */
+                const __m256i a_lo = _mm256_shuffle_epi8(s, alpha_lo);
+                const __m256i a_hi = _mm256_shuffle_epi8(s, alpha_hi);
+                const __m256i s_lo = _mm256_unpacklo_epi8(s, zero);
+                const __m256i s_hi = _mm256_unpackhi_epi8(s, zero);
+                const __m256i d_lo = _mm256_unpacklo_epi8(d, zero);
+                const __m256i d_hi = _mm256_unpackhi_epi8(d, zero);
+                const __m256i lo = _mm256_blend_epi16(BLEND_COLOR_EPI16_256(s_lo, d_lo, a_lo),
+                                                      BLEND_ALPHA_EPI16_256(d_lo, a_lo), 0x88);
+                const __m256i hi = _mm256_blend_epi16(BLEND_COLOR_EPI16_256(s_hi, d_hi, a_hi),
+                                                      BLEND_ALPHA_EPI16_256(d_hi, a_hi), 0x88);
+                __m256i result = _mm256_packus_epi16(lo, hi);
+
+                result = _mm256_blendv_epi8(result, s, is_opaque);
+                result = _mm256_blendv_epi8(result, d, is_clear);
+                _mm256_storeu_si256((__m256i *) dst, result);
+            }
+            src += 32;
+            dst += 32;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, BlitRGBtoRGBPixelAlpha);
+}
+
+/* AVX2 version of BlitRGBtoRGBSurfaceAlpha, 8 pixels at a time */
+SDL_TARGETING("avx2") static void
+BlitRGBtoRGBSurfaceAlphaAVX2(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~7;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 4 - width * 4;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 4 - width * 4;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i alpha = _mm256_set1_epi16(info->a);
+    const __m256i amask = _mm256_set1_epi32(0xff000000);
+    int n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 8) {
+            const __m256i s = _mm256_loadu_si256((const __m256i *) src);
+            const __m256i d = _mm256_loadu_si256((const __m256i *) dst);
+            const __m256i lo = BLEND_COLOR_EPI16_256(_mm256_unpacklo_epi8(s, zero),
+                                                     _mm256_unpacklo_epi8(d, zero), alpha);
+            const __m256i hi = BLEND_COLOR_EPI16_256(_mm256_unpackhi_epi8(s, zero),
+                                                     _mm256_unpackhi_epi8(d, zero), alpha);
+
+            _mm256_storeu_si256((__m256i *) dst, _mm256_or_si256(_mm256_packus_epi16(lo, hi), amask));
+            src += 32;
+            dst += 32;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, BlitRGBtoRGBSurfaceAlpha);
+}
+
+#define BLEND_565_FIELD_EPI16_256(s, d, a) \
+    _mm256_add_epi16(d, _mm256_srai_epi16(_mm256_mullo_epi16(_mm256_sub_epi16(s, d), a), 5))
+
+SDL_TARGETING("avx2") static __m256i
+Blend565AVX2(__m256i s, __m256i d, __m256i alpha)
+{
+    const __m256i mask5 = _mm256_set1_epi16(0x1f);
+    const __m256i mask6 = _mm256_set1_epi16(0x3f);
+    const __m256i r = BLEND_565_FIELD_EPI16_256(_mm256_srli_epi16(s, 11), _mm256_srli_epi16(d, 11), alpha);
+    const __m256i g = BLEND_565_FIELD_EPI16_256(_mm256_and_si256(_mm256_srli_epi16(s, 5), mask6),
+                                                _mm256_and_si256(_mm256_srli_epi16(d, 5), mask6), alpha);
+    const __m256i b = BLEND_565_FIELD_EPI16_256(_mm256_and_si256(s, mask5), _mm256_and_si256(d, mask5), alpha);
+
+    return _mm256_or_si256(_mm256_or_si256(_mm256_slli_epi16(r, 11), _mm256_slli_epi16(g, 5)), b);
+}
+
+/* AVX2 version of Blit565to565SurfaceAlpha, 16 pixels at a time */
+SDL_TARGETING("avx2") static void
+Blit565to565SurfaceAlphaAVX2(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~15;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 2 - width * 2;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 2 - width * 2;
+    const __m256i alpha = _mm256_set1_epi16(info->a >> 3);
+    int n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 16) {
+            const __m256i s = _mm256_loadu_si256((const __m256i *) src);
+            const __m256i d = _mm256_loadu_si256((const __m256i *) dst);
+
+            _mm256_storeu_si256((__m256i *) dst, Blend565AVX2(s, d, alpha));
+            src += 32;
+            dst += 32;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, Blit565to565SurfaceAlpha);
+}
+
+#define ARGB_TO_565_EPI32_256(s) \
+    _mm256_or_si256(_mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(s, 8), _mm256_set1_epi32(0xf800)), \
+                                    _mm256_and_si256(_mm256_srli_epi32(s, 5), _mm256_set1_epi32(0x7e0))), \
+                    _mm256_and_si256(_mm256_srli_epi32(s, 3), _mm256_set1_epi32(0x1f)))
+
+/* AVX2 version of BlitARGBto565PixelAlpha, 16 pixels at a time */
+SDL_TARGETING("avx2") static void
+BlitARGBto565PixelAlphaAVX2(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~15;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 4 - width * 4;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 2 - width * 2;
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i opaque = _mm256_set1_epi16(SDL_ALPHA_OPAQUE >> 3);
+    int n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 16) {
+            const __m256i s0 = _mm256_loadu_si256((const __m256i *) src);
+            const __m256i s1 = _mm256_loadu_si256((const __m256i *) (src + 32));
+            /* Packing interleaves the 128-bit lanes, put them back in order */
+            const __m256i alpha = _mm256_permute4x64_epi64(
+                _mm256_packs_epi32(_mm256_srli_epi32(s0, 27), _mm256_srli_epi32(s1, 27)), 0xd8);
+            const __m256i s = _mm256_permute4x64_epi64(
+                _mm256_packus_epi32(ARGB_TO_565_EPI32_256(s0), ARGB_TO_565_EPI32_256(s1)), 0xd8);
+            const __m256i is_opaque = _mm256_cmpeq_epi16(alpha, opaque);
+            const __m256i is_clear = _mm256_cmpeq_epi16(alpha, zero);
+
+            if (_mm256_movemask_epi8(is_opaque) == -1) {
+                _mm256_storeu_si256((__m256i *) dst, s);
+            } else if (_mm256_movemask_epi8(is_clear) != -1) {
+                const __m256i d = _mm256_loadu_si256((const __m256i *) dst);
+                __m256i result = Blend565AVX2(s, d, alpha);
+
+                result = _mm256_blendv_epi8(result, s, is_opaque);
+                result = _mm256_blendv_epi8(result, d, is_clear);
+                _mm256_storeu_si256((__m256i *) dst, result);
+            }
+            src += 64;
+            dst += 32;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, BlitARGBto565PixelAlpha);
+}
+
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#ifdef __ARM_NEON
+
+/* Blend 8 color bytes as (d * 256 + (s - d) * a) >> 8. The sum can wrap in
+   16 bits along the way, but the result always fits. */
+#define BLEND_COLOR_U8(s, d, a) \
+    vshrn_n_u16(vsubq_u16(vaddq_u16(vshll_n_u8(d, 8), vmull_u8(s, a)), vmull_u8(d, a)), 8)
+
+/* NEON version of BlitRGBtoRGBPixelAlpha, 8 pixels at a time */
+static void
+BlitRGBtoRGBPixelAlphaNEON(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~7;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 4 - width * 4;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 4 - width * 4;
+    int i, n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 8) {
+            const uint8x8x4_t s = vld4_u8(src);
+            const uint8x8_t alpha = s.val[3];
+            const uint8x8_t is_opaque = vceq_u8(alpha, vdup_n_u8(SDL_ALPHA_OPAQUE));
+            const uint8x8_t is_clear = vceq_u8(alpha, vdup_n_u8(0));
+            uint8x8x4_t d = vld4_u8(dst);
+
+            for (i = 0; i < 3; ++i) {
+                const uint8x8_t c = BLEND_COLOR_U8(s.val[i], d.val[i], alpha);
+                d.val[i] = vbsl_u8(is_clear, d.val[i], vbsl_u8(is_opaque, s.val[i], c));
+            }
+            d.val[3] = vbsl_u8(is_clear, d.val[3],
+                               vbsl_u8(is_opaque, alpha,
+                                       vadd_u8(alpha, vshrn_n_u16(vmull_u8(d.val[3], vmvn_u8(alpha)), 8))));
+            vst4_u8(dst, d);
+            src += 32;
+            dst += 32;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, BlitRGBtoRGBPixelAlpha);
+}
+
+/* NEON version of BlitRGBtoRGBSurfaceAlpha, 8 pixels at a time */
+static void
+BlitRGBtoRGBSurfaceAlphaNEON(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~7;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 4 - width * 4;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 4 - width * 4;
+    const uint8x8_t alpha = vdup_n_u8(info->a);
+    int i, n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 8) {
+            const uint8x8x4_t s = vld4_u8(src);
+            uint8x8x4_t d = vld4_u8(dst);
+
+            for (i = 0; i < 3; ++i) {
+                d.val[i] = BLEND_COLOR_U8(s.val[i], d.val[i], alpha);
+            }
+            d.val[3] = vdup_n_u8(SDL_ALPHA_OPAQUE);
+            vst4_u8(dst, d);
+            src += 32;
+            dst += 32;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, BlitRGBtoRGBSurfaceAlpha);
+}
+
+/* Blend one field of 8 RGB565 pixels as d + ((s - d) * a >> 5) */
+#define BLEND_565_FIELD_S16(s, d, a) \
+    vaddq_s16(d, vshrq_n_s16(vmulq_s16(vsubq_s16(s, d), a), 5))
+
+static uint16x8_t
+Blend565NEON(uint16x8_t s, uint16x8_t d, int16x8_t alpha)
+{
+    const uint16x8_t mask5 = vdupq_n_u16(0x1f);
+    const uint16x8_t mask6 = vdupq_n_u16(0x3f);
+    const int16x8_t r = BLEND_565_FIELD_S16(vreinterpretq_s16_u16(vshrq_n_u16(s, 11)),
+                                            vreinterpretq_s16_u16(vshrq_n_u16(d, 11)), alpha);
+    const int16x8_t g = BLEND_565_FIELD_S16(vreinterpretq_s16_u16(vandq_u16(vshrq_n_u16(s, 5), mask6)),
+                                            vreinterpretq_s16_u16(vandq_u16(vshrq_n_u16(d, 5), mask6)), alpha);
+    const int16x8_t b = BLEND_565_FIELD_S16(vreinterpretq_s16_u16(vandq_u16(s, mask5)),
+                                            vreinterpretq_s16_u16(vandq_u16(d, mask5)), alpha);
+
+    return vorrq_u16(vorrq_u16(vshlq_n_u16(vreinterpretq_u16_s16(r), 11),
+                               vshlq_n_u16(vreinterpretq_u16_s16(g), 5)),
+                     vreinterpretq_u16_s16(b));
+}
+
+/* NEON version of Blit565to565SurfaceAlpha, 8 pixels at a time */
+static void
+Blit565to565SurfaceAlphaNEON(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~7;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 2 - width * 2;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 2 - width * 2;
+    const int16x8_t alpha = vdupq_n_s16(info->a >> 3);
+    int n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 8) {
+            const uint16x8_t s = vld1q_u16((const Uint16 *) src);
+            const uint16x8_t d = vld1q_u16((const Uint16 *) dst);
+
+            vst1q_u16((Uint16 *) dst, Blend565NEON(s, d, alpha));
+            src += 16;
+            dst += 16;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, Blit565to565SurfaceAlpha);
+}
+
+/* NEON version of BlitARGBto565PixelAlpha, 8 pixels at a time */
+static void
+BlitARGBto565PixelAlphaNEON(SDL_BlitInfo * info)
+{
+    const int width = info->dst_w & ~7;
+    int height = info->dst_h;
+    Uint8 *src = info->src;
+    int srcskip = info->src_skip + info->dst_w * 4 - width * 4;
+    Uint8 *dst = info->dst;
+    int dstskip = info->dst_skip + info->dst_w * 2 - width * 2;
+    int n;
+
+    while (height--) {
+        for (n = width; n > 0; n -= 8) {
+            const uint8x8x4_t p = vld4_u8(src);
+            const uint16x8_t alpha = vmovl_u8(vshr_n_u8(p.val[3], 3));
+            const uint16x8_t is_opaque = vceqq_u16(alpha, vdupq_n_u16(SDL_ALPHA_OPAQUE >> 3));
+            const uint16x8_t is_clear = vceqq_u16(alpha, vdupq_n_u16(0));
+            const uint16x8_t s = vorrq_u16(vorrq_u16(vshlq_n_u16(vmovl_u8(vshr_n_u8(p.val[2], 3)), 11),
+                                                     vshlq_n_u16(vmovl_u8(vshr_n_u8(p.val[1], 2)), 5)),
+                                           vmovl_u8(vshr_n_u8(p.val[0], 3)));
+            const uint16x8_t d = vld1q_u16((const Uint16 *) dst);
+            const uint16x8_t result = Blend565NEON(s, d, vreinterpretq_s16_u16(alpha));
+
+            vst1q_u16((Uint16 *) dst, vbslq_u16(is_clear, d, vbslq_u16(is_opaque, s, result)));
+            src += 32;
+            dst += 16;
+        }
+        src += srcskip;
+        dst += dstskip;
+    }
+    BlitRemainingColumns(info, width, BlitARGBto565PixelAlpha);
+}
+
+#endif /* __ARM_NEON */
+
 /* General (slow) N->N blending with per-surface alpha */
 static void
 BlitNtoNSurfaceAlpha(SDL_BlitInfo * info)
@@ -1283,8 +1857,21 @@ SDL_CalculateBlitA(SDL_Surface * surface)
                     && sf->Gmask == 0xff00
                     && ((sf->Rmask == 0xff && df->Rmask == 0x1f)
                         || (sf->Bmask == 0xff && df->Bmask == 0x1f))) {
-                if (df->Gmask == 0x7e0)
+                if (df->Gmask == 0x7e0) {
+#if HAVE_AVX2_INTRINSICS
+                    if (SDL_GetBlitCPUFeatures() & SDL_CPU_AVX2)
+                        return BlitARGBto565PixelAlphaAVX2;
+#endif
+#if HAVE_SSE41_INTRINSICS
+                    if (SDL_GetBlitCPUFeatures() & SDL_CPU_SSE41)
+                        return BlitARGBto565PixelAlphaSSE41;
+#endif
+#ifdef __ARM_NEON
+                    if (SDL_GetBlitCPUFeatures() & SDL_CPU_NEON)
+                        return BlitARGBto565PixelAlphaNEON;
+#endif
                     return BlitARGBto565PixelAlpha;
+                }
                 else if (df->Gmask == 0x3e0)
                     return BlitARGBto555PixelAlpha;
             }
@@ -1294,17 +1881,31 @@ SDL_CalculateBlitA(SDL_Surface * surface)
             if (sf->Rmask == df->Rmask
                 && sf->Gmask == df->Gmask
                 && sf->Bmask == df->Bmask && sf->BytesPerPixel == 4) {
+                if (sf->Amask == 0xff000000) {
+#if HAVE_AVX2_INTRINSICS
+                    if (SDL_GetBlitCPUFeatures() & SDL_CPU_AVX2)
+                        return BlitRGBtoRGBPixelAlphaAVX2;
+#endif
+#if HAVE_SSE41_INTRINSICS
+                    if (SDL_GetBlitCPUFeatures() & SDL_CPU_SSE41)
+                        return BlitRGBtoRGBPixelAlphaSSE41;
+#endif
+#ifdef __ARM_NEON
+                    if (SDL_GetBlitCPUFeatures() & SDL_CPU_NEON)
+                        return BlitRGBtoRGBPixelAlphaNEON;
+#endif
+                }
 #if defined(__MMX__) || defined(__3dNOW__)
                 if (sf->Rshift % 8 == 0
                     && sf->Gshift % 8 == 0
                     && sf->Bshift % 8 == 0
                     && sf->Ashift % 8 == 0 && sf->Aloss == 0) {
 #ifdef __3dNOW__
-                    if (SDL_Has3DNow())
+                    if (SDL_GetBlitCPUFeatures() & SDL_CPU_3DNOW)
                         return BlitRGBtoRGBPixelAlphaMMX3DNOW;
 #endif
 #ifdef __MMX__
-                    if (SDL_HasMMX())
+                    if (SDL_GetBlitCPUFeatures() & SDL_CPU_MMX)
                         return BlitRGBtoRGBPixelAlphaMMX;
 #endif
                 }
@@ -1331,15 +1932,27 @@ SDL_CalculateBlitA(SDL_Surface * surface)
             case 2:
                 if (surface->map->identity) {
                     if (df->Gmask == 0x7e0) {
+#if HAVE_AVX2_INTRINSICS
+                        if (SDL_GetBlitCPUFeatures() & SDL_CPU_AVX2)
+                            return Blit565to565SurfaceAlphaAVX2;
+#endif
+#if HAVE_SSE41_INTRINSICS
+                        if (SDL_GetBlitCPUFeatures() & SDL_CPU_SSE41)
+                            return Blit565to565SurfaceAlphaSSE41;
+#endif
+#ifdef __ARM_NEON
+                        if (SDL_GetBlitCPUFeatures() & SDL_CPU_NEON)
+                            return Blit565to565SurfaceAlphaNEON;
+#endif
 #ifdef __MMX__
-                        if (SDL_HasMMX())
+                        if (SDL_GetBlitCPUFeatures() & SDL_CPU_MMX)
                             return Blit565to565SurfaceAlphaMMX;
                         else
 #endif
                             return Blit565to565SurfaceAlpha;
                     } else if (df->Gmask == 0x3e0) {
 #ifdef __MMX__
-                        if (SDL_HasMMX())
+                        if (SDL_GetBlitCPUFeatures() & SDL_CPU_MMX)
                             return Blit555to555SurfaceAlphaMMX;
                         else
 #endif
@@ -1352,10 +1965,24 @@ SDL_CalculateBlitA(SDL_Surface * surface)
                 if (sf->Rmask == df->Rmask
                     && sf->Gmask == df->Gmask
                     && sf->Bmask == df->Bmask && sf->BytesPerPixel == 4) {
+                    if ((sf->Rmask | sf->Gmask | sf->Bmask) == 0xffffff) {
+#if HAVE_AVX2_INTRINSICS
+                        if (SDL_GetBlitCPUFeatures() & SDL_CPU_AVX2)
+                            return BlitRGBtoRGBSurfaceAlphaAVX2;
+#endif
+#if HAVE_SSE41_INTRINSICS
+                        if (SDL_GetBlitCPUFeatures() & SDL_CPU_SSE41)
+                            return BlitRGBtoRGBSurfaceAlphaSSE41;
+#endif
+#ifdef __ARM_NEON
+                        if (SDL_GetBlitCPUFeatures() & SDL_CPU_NEON)
+                            return BlitRGBtoRGBSurfaceAlphaNEON;
+#endif
+                    }
 #ifdef __MMX__
                     if (sf->Rshift % 8 == 0
                         && sf->Gshift % 8 == 0
-                        && sf->Bshift % 8 == 0 && SDL_HasMMX())
+                        && sf->Bshift % 8 == 0 && (SDL_GetBlitCPUFeatures() & SDL_CPU_MMX))
                         return BlitRGBtoRGBSurfaceAlphaMMX;
 #endif
                     if ((sf->Rmask | sf->Gmask | sf->Bmask) == 0xffffff) {
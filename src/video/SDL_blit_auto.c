@@ -27,6 +27,10 @@
 #include "SDL_blit.h"
 #include "SDL_blit_auto.h"
 
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
 static void SDL_Blit_RGB888_RGB888_Scale(SDL_BlitInfo *info)
 {
     int srcy, srcx;
@@ -7284,7 +7288,2905 @@ static void SDL_Blit_BGRA8888_ARGB8888_Modulate_Blend_Scale(SDL_BlitInfo *info)
     }
 }
 
+#if HAVE_AVX2_INTRINSICS
+
+/* x / 255 for products of two 8-bit values, exactly as the C code does it */
+SDL_TARGETING("avx2") static SDL_INLINE __m256i SDL_Blit_Div255_AVX2(__m256i x)
+{
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)), _mm256_srli_epi16(x, 8)), 8);
+}
+
+/* Blends ARGB8888 pixels widened to 16 bits per channel */
+SDL_TARGETING("avx2") static SDL_INLINE __m256i SDL_Blit_Blend16_AVX2(__m256i s, __m256i d, __m256i modulate, int flags)
+{
+    const __m256i alpha = _mm256_broadcastsi128_si256(_mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0));
+    const __m256i c255 = _mm256_set1_epi16(255);
+    __m256i sA;
+
+    if (flags & (SDL_COPY_MODULATE_COLOR|SDL_COPY_MODULATE_ALPHA)) {
+        s = SDL_Blit_Div255_AVX2(_mm256_mullo_epi16(s, modulate));
+    }
+    sA = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, 0xFF), 0xFF);
+    if (flags & (SDL_COPY_BLEND|SDL_COPY_ADD)) {
+        s = SDL_Blit_Div255_AVX2(_mm256_mullo_epi16(s, _mm256_or_si256(_mm256_andnot_si256(alpha, sA), _mm256_and_si256(alpha, c255))));
+    }
+    switch (flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) {
+    case SDL_COPY_BLEND:
+        d = _mm256_add_epi16(s, SDL_Blit_Div255_AVX2(_mm256_mullo_epi16(_mm256_sub_epi16(c255, sA), d)));
+        break;
+    case SDL_COPY_ADD:
+        d = _mm256_or_si256(_mm256_and_si256(alpha, d), _mm256_andnot_si256(alpha, _mm256_min_epi16(_mm256_add_epi16(s, d), c255)));
+        break;
+    case SDL_COPY_MOD:
+        d = _mm256_or_si256(_mm256_and_si256(alpha, d), _mm256_andnot_si256(alpha, SDL_Blit_Div255_AVX2(_mm256_mullo_epi16(s, d))));
+        break;    default:
+        /* Only modulation, the result replaces the destination */
+        d = s;
+        break;
+    }
+    return d;
+}
+
+SDL_TARGETING("avx2") static SDL_INLINE __m256i SDL_Blit_BlendARGB8888_AVX2(__m256i s, __m256i d, __m256i modulate, int flags)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lo = SDL_Blit_Blend16_AVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), modulate, flags);
+    const __m256i hi = SDL_Blit_Blend16_AVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), modulate, flags);
+    return _mm256_packus_epi16(lo, hi);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_RGB888_BGR888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGB888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(pixels, 16), _mm256_set1_epi32((int)0x00FF0000)), _mm256_or_si256(_mm256_and_si256(pixels, _mm256_set1_epi32((int)0x0000FF00)), _mm256_and_si256(_mm256_srli_epi32(pixels, 16), _mm256_set1_epi32((int)0x000000FF))));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_RGB888_ARGB8888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGB888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_or_si256(_mm256_and_si256(pixels, _mm256_set1_epi32((int)0x00FFFFFF)), _mm256_set1_epi32((int)0xFF000000));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel & 0x00FFFFFF) | 0xFF000000;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_BGR888_RGB888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGR888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(pixels, 16), _mm256_set1_epi32((int)0x00FF0000)), _mm256_or_si256(_mm256_and_si256(pixels, _mm256_set1_epi32((int)0x0000FF00)), _mm256_and_si256(_mm256_srli_epi32(pixels, 16), _mm256_set1_epi32((int)0x000000FF))));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_BGR888_ARGB8888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGR888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(pixels, 16), _mm256_set1_epi32((int)0x00FF0000)), _mm256_or_si256(_mm256_and_si256(pixels, _mm256_set1_epi32((int)0x0000FF00)), _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(pixels, 16), _mm256_set1_epi32((int)0x000000FF)), _mm256_set1_epi32((int)0xFF000000))));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF) | 0xFF000000;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_ARGB8888_RGB888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ARGB8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_and_si256(pixels, _mm256_set1_epi32((int)0x00FFFFFF));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel & 0x00FFFFFF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_ARGB8888_BGR888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ARGB8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(pixels, 16), _mm256_set1_epi32((int)0x00FF0000)), _mm256_or_si256(_mm256_and_si256(pixels, _mm256_set1_epi32((int)0x0000FF00)), _mm256_and_si256(_mm256_srli_epi32(pixels, 16), _mm256_set1_epi32((int)0x000000FF))));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_RGBA8888_RGB888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGBA8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_srli_epi32(pixels, 8);
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel >> 8);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_RGBA8888_BGR888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGBA8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(pixels, 8), _mm256_set1_epi32((int)0x00FF0000)), _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(pixels, 8), _mm256_set1_epi32((int)0x0000FF00)), _mm256_srli_epi32(pixels, 24)));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 8) & 0x00FF0000) | ((pixel >> 8) & 0x0000FF00) | (pixel >> 24);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_RGBA8888_ARGB8888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGBA8888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_or_si256(_mm256_slli_epi32(pixels, 24), _mm256_srli_epi32(pixels, 8));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel << 24) | (pixel >> 8);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_ABGR8888_RGB888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ABGR8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(pixels, 16), _mm256_set1_epi32((int)0x00FF0000)), _mm256_or_si256(_mm256_and_si256(pixels, _mm256_set1_epi32((int)0x0000FF00)), _mm256_and_si256(_mm256_srli_epi32(pixels, 16), _mm256_set1_epi32((int)0x000000FF))));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_ABGR8888_BGR888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ABGR8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_and_si256(pixels, _mm256_set1_epi32((int)0x00FFFFFF));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel & 0x00FFFFFF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_ABGR8888_ARGB8888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ABGR8888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(pixels, 16), _mm256_set1_epi32((int)0x00FF0000)), _mm256_or_si256(_mm256_and_si256(pixels, _mm256_set1_epi32((int)0xFF00FF00)), _mm256_and_si256(_mm256_srli_epi32(pixels, 16), _mm256_set1_epi32((int)0x000000FF))));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0xFF00FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_BGRA8888_RGB888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGRA8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(pixels, 8), _mm256_set1_epi32((int)0x00FF0000)), _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(pixels, 8), _mm256_set1_epi32((int)0x0000FF00)), _mm256_srli_epi32(pixels, 24)));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 8) & 0x00FF0000) | ((pixel >> 8) & 0x0000FF00) | (pixel >> 24);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_BGRA8888_BGR888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGRA8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_srli_epi32(pixels, 8);
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel >> 8);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_BGRA8888_ARGB8888_Scale_AVX2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGRA8888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 8 <= info->dst_w; i += 8) {
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = _mm256_or_si256(_mm256_slli_epi32(pixels, 24), _mm256_or_si256(_mm256_and_si256(_mm256_slli_epi32(pixels, 8), _mm256_set1_epi32((int)0x00FF0000)), _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(pixels, 8), _mm256_set1_epi32((int)0x0000FF00)), _mm256_srli_epi32(pixels, 24))));
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel << 24) | ((pixel << 8) & 0x00FF0000) | ((pixel >> 8) & 0x0000FF00) | (pixel >> 24);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_ARGB8888_ARGB8888_Blend_AVX2(SDL_BlitInfo *info)
+{
+    const int flags = info->flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD);
+    const Uint8 modulateR = (flags & SDL_COPY_MODULATE_COLOR) ? info->r : 255;
+    const Uint8 modulateG = (flags & SDL_COPY_MODULATE_COLOR) ? info->g : 255;
+    const Uint8 modulateB = (flags & SDL_COPY_MODULATE_COLOR) ? info->b : 255;
+    const Uint8 modulateA = (flags & SDL_COPY_MODULATE_ALPHA) ? info->a : 255;
+    const __m256i modulate = _mm256_broadcastsi128_si256(_mm_set_epi16(modulateA, modulateR, modulateG, modulateB, modulateA, modulateR, modulateG, modulateB));
+
+    while (info->dst_h--) {
+        const Uint32 *src = (const Uint32 *)info->src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        while (n >= 8) {
+            _mm256_storeu_si256((__m256i *)dst, SDL_Blit_BlendARGB8888_AVX2(_mm256_loadu_si256((const __m256i *)src), _mm256_loadu_si256((const __m256i *)dst), modulate, flags));
+            src += 8;
+            dst += 8;
+            n -= 8;
+        }
+        if (n > 0) {
+            /* Run the last few pixels through a full vector */
+            Uint32 srcbuf[8];
+            Uint32 dstbuf[8];
+            SDL_zero(srcbuf);
+            SDL_zero(dstbuf);
+            SDL_memcpy(srcbuf, src, n * sizeof(*src));
+            SDL_memcpy(dstbuf, dst, n * sizeof(*dst));
+            _mm256_storeu_si256((__m256i *)dstbuf, SDL_Blit_BlendARGB8888_AVX2(_mm256_loadu_si256((const __m256i *)srcbuf), _mm256_loadu_si256((const __m256i *)dstbuf), modulate, flags));
+            SDL_memcpy(dst, dstbuf, n * sizeof(*dst));
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+SDL_TARGETING("avx2") static void SDL_Blit_ARGB8888_ARGB8888_Modulate_Blend_AVX2(SDL_BlitInfo *info)
+{
+    const int flags = info->flags;
+    const Uint8 modulateR = (flags & SDL_COPY_MODULATE_COLOR) ? info->r : 255;
+    const Uint8 modulateG = (flags & SDL_COPY_MODULATE_COLOR) ? info->g : 255;
+    const Uint8 modulateB = (flags & SDL_COPY_MODULATE_COLOR) ? info->b : 255;
+    const Uint8 modulateA = (flags & SDL_COPY_MODULATE_ALPHA) ? info->a : 255;
+    const __m256i modulate = _mm256_broadcastsi128_si256(_mm_set_epi16(modulateA, modulateR, modulateG, modulateB, modulateA, modulateR, modulateG, modulateB));
+
+    while (info->dst_h--) {
+        const Uint32 *src = (const Uint32 *)info->src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        while (n >= 8) {
+            _mm256_storeu_si256((__m256i *)dst, SDL_Blit_BlendARGB8888_AVX2(_mm256_loadu_si256((const __m256i *)src), _mm256_loadu_si256((const __m256i *)dst), modulate, flags));
+            src += 8;
+            dst += 8;
+            n -= 8;
+        }
+        if (n > 0) {
+            /* Run the last few pixels through a full vector */
+            Uint32 srcbuf[8];
+            Uint32 dstbuf[8];
+            SDL_zero(srcbuf);
+            SDL_zero(dstbuf);
+            SDL_memcpy(srcbuf, src, n * sizeof(*src));
+            SDL_memcpy(dstbuf, dst, n * sizeof(*dst));
+            _mm256_storeu_si256((__m256i *)dstbuf, SDL_Blit_BlendARGB8888_AVX2(_mm256_loadu_si256((const __m256i *)srcbuf), _mm256_loadu_si256((const __m256i *)dstbuf), modulate, flags));
+            SDL_memcpy(dst, dstbuf, n * sizeof(*dst));
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#ifdef __SSE2__
+
+/* x / 255 for products of two 8-bit values, exactly as the C code does it */
+static SDL_INLINE __m128i SDL_Blit_Div255_SSE2(__m128i x)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+/* Blends ARGB8888 pixels widened to 16 bits per channel */
+static SDL_INLINE __m128i SDL_Blit_Blend16_SSE2(__m128i s, __m128i d, __m128i modulate, int flags)
+{
+    const __m128i alpha = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i c255 = _mm_set1_epi16(255);
+    __m128i sA;
+
+    if (flags & (SDL_COPY_MODULATE_COLOR|SDL_COPY_MODULATE_ALPHA)) {
+        s = SDL_Blit_Div255_SSE2(_mm_mullo_epi16(s, modulate));
+    }
+    sA = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xFF), 0xFF);
+    if (flags & (SDL_COPY_BLEND|SDL_COPY_ADD)) {
+        s = SDL_Blit_Div255_SSE2(_mm_mullo_epi16(s, _mm_or_si128(_mm_andnot_si128(alpha, sA), _mm_and_si128(alpha, c255))));
+    }
+    switch (flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) {
+    case SDL_COPY_BLEND:
+        d = _mm_add_epi16(s, SDL_Blit_Div255_SSE2(_mm_mullo_epi16(_mm_sub_epi16(c255, sA), d)));
+        break;
+    case SDL_COPY_ADD:
+        d = _mm_or_si128(_mm_and_si128(alpha, d), _mm_andnot_si128(alpha, _mm_min_epi16(_mm_add_epi16(s, d), c255)));
+        break;
+    case SDL_COPY_MOD:
+        d = _mm_or_si128(_mm_and_si128(alpha, d), _mm_andnot_si128(alpha, SDL_Blit_Div255_SSE2(_mm_mullo_epi16(s, d))));
+        break;    default:
+        /* Only modulation, the result replaces the destination */
+        d = s;
+        break;
+    }
+    return d;
+}
+
+static SDL_INLINE __m128i SDL_Blit_BlendARGB8888_SSE2(__m128i s, __m128i d, __m128i modulate, int flags)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = SDL_Blit_Blend16_SSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), modulate, flags);
+    const __m128i hi = SDL_Blit_Blend16_SSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), modulate, flags);
+    return _mm_packus_epi16(lo, hi);
+}
+
+static void SDL_Blit_RGB888_BGR888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGB888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(pixels, 16), _mm_set1_epi32((int)0x00FF0000)), _mm_or_si128(_mm_and_si128(pixels, _mm_set1_epi32((int)0x0000FF00)), _mm_and_si128(_mm_srli_epi32(pixels, 16), _mm_set1_epi32((int)0x000000FF))));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_RGB888_ARGB8888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGB888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_or_si128(_mm_and_si128(pixels, _mm_set1_epi32((int)0x00FFFFFF)), _mm_set1_epi32((int)0xFF000000));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel & 0x00FFFFFF) | 0xFF000000;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_BGR888_RGB888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGR888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(pixels, 16), _mm_set1_epi32((int)0x00FF0000)), _mm_or_si128(_mm_and_si128(pixels, _mm_set1_epi32((int)0x0000FF00)), _mm_and_si128(_mm_srli_epi32(pixels, 16), _mm_set1_epi32((int)0x000000FF))));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_BGR888_ARGB8888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGR888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(pixels, 16), _mm_set1_epi32((int)0x00FF0000)), _mm_or_si128(_mm_and_si128(pixels, _mm_set1_epi32((int)0x0000FF00)), _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 16), _mm_set1_epi32((int)0x000000FF)), _mm_set1_epi32((int)0xFF000000))));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF) | 0xFF000000;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ARGB8888_RGB888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ARGB8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_and_si128(pixels, _mm_set1_epi32((int)0x00FFFFFF));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel & 0x00FFFFFF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ARGB8888_BGR888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ARGB8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(pixels, 16), _mm_set1_epi32((int)0x00FF0000)), _mm_or_si128(_mm_and_si128(pixels, _mm_set1_epi32((int)0x0000FF00)), _mm_and_si128(_mm_srli_epi32(pixels, 16), _mm_set1_epi32((int)0x000000FF))));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_RGBA8888_RGB888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGBA8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_srli_epi32(pixels, 8);
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel >> 8);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_RGBA8888_BGR888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGBA8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(pixels, 8), _mm_set1_epi32((int)0x00FF0000)), _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 8), _mm_set1_epi32((int)0x0000FF00)), _mm_srli_epi32(pixels, 24)));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 8) & 0x00FF0000) | ((pixel >> 8) & 0x0000FF00) | (pixel >> 24);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_RGBA8888_ARGB8888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGBA8888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_or_si128(_mm_slli_epi32(pixels, 24), _mm_srli_epi32(pixels, 8));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel << 24) | (pixel >> 8);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ABGR8888_RGB888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ABGR8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(pixels, 16), _mm_set1_epi32((int)0x00FF0000)), _mm_or_si128(_mm_and_si128(pixels, _mm_set1_epi32((int)0x0000FF00)), _mm_and_si128(_mm_srli_epi32(pixels, 16), _mm_set1_epi32((int)0x000000FF))));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ABGR8888_BGR888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ABGR8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_and_si128(pixels, _mm_set1_epi32((int)0x00FFFFFF));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel & 0x00FFFFFF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ABGR8888_ARGB8888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ABGR8888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(pixels, 16), _mm_set1_epi32((int)0x00FF0000)), _mm_or_si128(_mm_and_si128(pixels, _mm_set1_epi32((int)0xFF00FF00)), _mm_and_si128(_mm_srli_epi32(pixels, 16), _mm_set1_epi32((int)0x000000FF))));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0xFF00FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_BGRA8888_RGB888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGRA8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_or_si128(_mm_and_si128(_mm_slli_epi32(pixels, 8), _mm_set1_epi32((int)0x00FF0000)), _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 8), _mm_set1_epi32((int)0x0000FF00)), _mm_srli_epi32(pixels, 24)));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 8) & 0x00FF0000) | ((pixel >> 8) & 0x0000FF00) | (pixel >> 24);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_BGRA8888_BGR888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGRA8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_srli_epi32(pixels, 8);
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel >> 8);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_BGRA8888_ARGB8888_Scale_SSE2(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGRA8888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = _mm_or_si128(_mm_slli_epi32(pixels, 24), _mm_or_si128(_mm_and_si128(_mm_slli_epi32(pixels, 8), _mm_set1_epi32((int)0x00FF0000)), _mm_or_si128(_mm_and_si128(_mm_srli_epi32(pixels, 8), _mm_set1_epi32((int)0x0000FF00)), _mm_srli_epi32(pixels, 24))));
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel << 24) | ((pixel << 8) & 0x00FF0000) | ((pixel >> 8) & 0x0000FF00) | (pixel >> 24);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ARGB8888_ARGB8888_Blend_SSE2(SDL_BlitInfo *info)
+{
+    const int flags = info->flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD);
+    const Uint8 modulateR = (flags & SDL_COPY_MODULATE_COLOR) ? info->r : 255;
+    const Uint8 modulateG = (flags & SDL_COPY_MODULATE_COLOR) ? info->g : 255;
+    const Uint8 modulateB = (flags & SDL_COPY_MODULATE_COLOR) ? info->b : 255;
+    const Uint8 modulateA = (flags & SDL_COPY_MODULATE_ALPHA) ? info->a : 255;
+    const __m128i modulate = _mm_set_epi16(modulateA, modulateR, modulateG, modulateB, modulateA, modulateR, modulateG, modulateB);
+
+    while (info->dst_h--) {
+        const Uint32 *src = (const Uint32 *)info->src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        while (n >= 4) {
+            _mm_storeu_si128((__m128i *)dst, SDL_Blit_BlendARGB8888_SSE2(_mm_loadu_si128((const __m128i *)src), _mm_loadu_si128((const __m128i *)dst), modulate, flags));
+            src += 4;
+            dst += 4;
+            n -= 4;
+        }
+        if (n > 0) {
+            /* Run the last few pixels through a full vector */
+            Uint32 srcbuf[4];
+            Uint32 dstbuf[4];
+            SDL_zero(srcbuf);
+            SDL_zero(dstbuf);
+            SDL_memcpy(srcbuf, src, n * sizeof(*src));
+            SDL_memcpy(dstbuf, dst, n * sizeof(*dst));
+            _mm_storeu_si128((__m128i *)dstbuf, SDL_Blit_BlendARGB8888_SSE2(_mm_loadu_si128((const __m128i *)srcbuf), _mm_loadu_si128((const __m128i *)dstbuf), modulate, flags));
+            SDL_memcpy(dst, dstbuf, n * sizeof(*dst));
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_ARGB8888_ARGB8888_Modulate_Blend_SSE2(SDL_BlitInfo *info)
+{
+    const int flags = info->flags;
+    const Uint8 modulateR = (flags & SDL_COPY_MODULATE_COLOR) ? info->r : 255;
+    const Uint8 modulateG = (flags & SDL_COPY_MODULATE_COLOR) ? info->g : 255;
+    const Uint8 modulateB = (flags & SDL_COPY_MODULATE_COLOR) ? info->b : 255;
+    const Uint8 modulateA = (flags & SDL_COPY_MODULATE_ALPHA) ? info->a : 255;
+    const __m128i modulate = _mm_set_epi16(modulateA, modulateR, modulateG, modulateB, modulateA, modulateR, modulateG, modulateB);
+
+    while (info->dst_h--) {
+        const Uint32 *src = (const Uint32 *)info->src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        while (n >= 4) {
+            _mm_storeu_si128((__m128i *)dst, SDL_Blit_BlendARGB8888_SSE2(_mm_loadu_si128((const __m128i *)src), _mm_loadu_si128((const __m128i *)dst), modulate, flags));
+            src += 4;
+            dst += 4;
+            n -= 4;
+        }
+        if (n > 0) {
+            /* Run the last few pixels through a full vector */
+            Uint32 srcbuf[4];
+            Uint32 dstbuf[4];
+            SDL_zero(srcbuf);
+            SDL_zero(dstbuf);
+            SDL_memcpy(srcbuf, src, n * sizeof(*src));
+            SDL_memcpy(dstbuf, dst, n * sizeof(*dst));
+            _mm_storeu_si128((__m128i *)dstbuf, SDL_Blit_BlendARGB8888_SSE2(_mm_loadu_si128((const __m128i *)srcbuf), _mm_loadu_si128((const __m128i *)dstbuf), modulate, flags));
+            SDL_memcpy(dst, dstbuf, n * sizeof(*dst));
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+#endif /* __SSE2__ */
+
+#ifdef __ARM_NEON
+
+/* x / 255 for products of two 8-bit values, exactly as the C code does it */
+static SDL_INLINE uint8x8_t SDL_Blit_Div255_NEON(uint16x8_t x)
+{
+    return vmovn_u16(vshrq_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8));
+}
+
+/* Blends ARGB8888 pixels split into B, G, R and A planes by vld4_u8() */
+static SDL_INLINE uint8x8x4_t SDL_Blit_BlendARGB8888_NEON(uint8x8x4_t s, uint8x8x4_t d, uint8x8x4_t modulate, int flags)
+{
+    int i;
+
+    if (flags & (SDL_COPY_MODULATE_COLOR|SDL_COPY_MODULATE_ALPHA)) {
+        for (i = 0; i < 4; ++i) {
+            s.val[i] = SDL_Blit_Div255_NEON(vmull_u8(s.val[i], modulate.val[i]));
+        }
+    }
+    if (flags & (SDL_COPY_BLEND|SDL_COPY_ADD)) {
+        for (i = 0; i < 3; ++i) {
+            s.val[i] = SDL_Blit_Div255_NEON(vmull_u8(s.val[i], s.val[3]));
+        }
+    }
+    switch (flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) {
+    case SDL_COPY_BLEND:
+        for (i = 0; i < 4; ++i) {
+            d.val[i] = vadd_u8(s.val[i], SDL_Blit_Div255_NEON(vmull_u8(vmvn_u8(s.val[3]), d.val[i])));
+        }
+        break;
+    case SDL_COPY_ADD:
+        for (i = 0; i < 3; ++i) {
+            d.val[i] = vqadd_u8(s.val[i], d.val[i]);
+        }
+        break;
+    case SDL_COPY_MOD:
+        for (i = 0; i < 3; ++i) {
+            d.val[i] = SDL_Blit_Div255_NEON(vmull_u8(s.val[i], d.val[i]));
+        }
+        break;    default:
+        /* Only modulation, the result replaces the destination */
+        d = s;
+        break;
+    }
+    return d;
+}
+
+static void SDL_Blit_RGB888_BGR888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGB888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vorrq_u32(vandq_u32(vshlq_n_u32(pixels, 16), vdupq_n_u32(0x00FF0000)), vorrq_u32(vandq_u32(pixels, vdupq_n_u32(0x0000FF00)), vandq_u32(vshrq_n_u32(pixels, 16), vdupq_n_u32(0x000000FF))));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_RGB888_ARGB8888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGB888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vorrq_u32(vandq_u32(pixels, vdupq_n_u32(0x00FFFFFF)), vdupq_n_u32(0xFF000000));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel & 0x00FFFFFF) | 0xFF000000;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_BGR888_RGB888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGR888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vorrq_u32(vandq_u32(vshlq_n_u32(pixels, 16), vdupq_n_u32(0x00FF0000)), vorrq_u32(vandq_u32(pixels, vdupq_n_u32(0x0000FF00)), vandq_u32(vshrq_n_u32(pixels, 16), vdupq_n_u32(0x000000FF))));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_BGR888_ARGB8888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGR888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vorrq_u32(vandq_u32(vshlq_n_u32(pixels, 16), vdupq_n_u32(0x00FF0000)), vorrq_u32(vandq_u32(pixels, vdupq_n_u32(0x0000FF00)), vorrq_u32(vandq_u32(vshrq_n_u32(pixels, 16), vdupq_n_u32(0x000000FF)), vdupq_n_u32(0xFF000000))));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF) | 0xFF000000;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ARGB8888_RGB888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ARGB8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vandq_u32(pixels, vdupq_n_u32(0x00FFFFFF));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel & 0x00FFFFFF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ARGB8888_BGR888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ARGB8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vorrq_u32(vandq_u32(vshlq_n_u32(pixels, 16), vdupq_n_u32(0x00FF0000)), vorrq_u32(vandq_u32(pixels, vdupq_n_u32(0x0000FF00)), vandq_u32(vshrq_n_u32(pixels, 16), vdupq_n_u32(0x000000FF))));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_RGBA8888_RGB888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGBA8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vshrq_n_u32(pixels, 8);
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel >> 8);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_RGBA8888_BGR888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGBA8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vorrq_u32(vandq_u32(vshlq_n_u32(pixels, 8), vdupq_n_u32(0x00FF0000)), vorrq_u32(vandq_u32(vshrq_n_u32(pixels, 8), vdupq_n_u32(0x0000FF00)), vshrq_n_u32(pixels, 24)));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 8) & 0x00FF0000) | ((pixel >> 8) & 0x0000FF00) | (pixel >> 24);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_RGBA8888_ARGB8888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_RGBA8888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vorrq_u32(vshlq_n_u32(pixels, 24), vshrq_n_u32(pixels, 8));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel << 24) | (pixel >> 8);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ABGR8888_RGB888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ABGR8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vorrq_u32(vandq_u32(vshlq_n_u32(pixels, 16), vdupq_n_u32(0x00FF0000)), vorrq_u32(vandq_u32(pixels, vdupq_n_u32(0x0000FF00)), vandq_u32(vshrq_n_u32(pixels, 16), vdupq_n_u32(0x000000FF))));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0x0000FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ABGR8888_BGR888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ABGR8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vandq_u32(pixels, vdupq_n_u32(0x00FFFFFF));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel & 0x00FFFFFF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ABGR8888_ARGB8888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_ABGR8888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vorrq_u32(vandq_u32(vshlq_n_u32(pixels, 16), vdupq_n_u32(0x00FF0000)), vorrq_u32(vandq_u32(pixels, vdupq_n_u32(0xFF00FF00)), vandq_u32(vshrq_n_u32(pixels, 16), vdupq_n_u32(0x000000FF))));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 16) & 0x00FF0000) | (pixel & 0xFF00FF00) | ((pixel >> 16) & 0x000000FF);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_BGRA8888_RGB888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGRA8888_RGB888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vorrq_u32(vandq_u32(vshlq_n_u32(pixels, 8), vdupq_n_u32(0x00FF0000)), vorrq_u32(vandq_u32(vshrq_n_u32(pixels, 8), vdupq_n_u32(0x0000FF00)), vshrq_n_u32(pixels, 24)));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = ((pixel << 8) & 0x00FF0000) | ((pixel >> 8) & 0x0000FF00) | (pixel >> 24);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_BGRA8888_BGR888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGRA8888_BGR888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vshrq_n_u32(pixels, 8);
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel >> 8);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_BGRA8888_ARGB8888_Scale_NEON(SDL_BlitInfo *info)
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+        SDL_Blit_BGRA8888_ARGB8888_Scale(info);
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const Uint32 *src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const Uint32 *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + 4 <= info->dst_w; i += 4) {
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = vorrq_u32(vshlq_n_u32(pixels, 24), vorrq_u32(vandq_u32(vshlq_n_u32(pixels, 8), vdupq_n_u32(0x00FF0000)), vorrq_u32(vandq_u32(vshrq_n_u32(pixels, 8), vdupq_n_u32(0x0000FF00)), vshrq_n_u32(pixels, 24))));
+            vst1q_u32(&dst[i], pixels);
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = (pixel << 24) | ((pixel << 8) & 0x00FF0000) | ((pixel >> 8) & 0x0000FF00) | (pixel >> 24);
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+static void SDL_Blit_ARGB8888_ARGB8888_Blend_NEON(SDL_BlitInfo *info)
+{
+    const int flags = info->flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD);
+    const Uint8 modulateR = (flags & SDL_COPY_MODULATE_COLOR) ? info->r : 255;
+    const Uint8 modulateG = (flags & SDL_COPY_MODULATE_COLOR) ? info->g : 255;
+    const Uint8 modulateB = (flags & SDL_COPY_MODULATE_COLOR) ? info->b : 255;
+    const Uint8 modulateA = (flags & SDL_COPY_MODULATE_ALPHA) ? info->a : 255;
+    uint8x8x4_t modulate;
+
+    modulate.val[0] = vdup_n_u8(modulateB);
+    modulate.val[1] = vdup_n_u8(modulateG);
+    modulate.val[2] = vdup_n_u8(modulateR);
+    modulate.val[3] = vdup_n_u8(modulateA);
+
+    while (info->dst_h--) {
+        const Uint32 *src = (const Uint32 *)info->src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        while (n >= 8) {
+            vst4_u8((Uint8 *)dst, SDL_Blit_BlendARGB8888_NEON(vld4_u8((const Uint8 *)src), vld4_u8((const Uint8 *)dst), modulate, flags));
+            src += 8;
+            dst += 8;
+            n -= 8;
+        }
+        if (n > 0) {
+            /* Run the last few pixels through a full vector */
+            Uint32 srcbuf[8];
+            Uint32 dstbuf[8];
+            SDL_zero(srcbuf);
+            SDL_zero(dstbuf);
+            SDL_memcpy(srcbuf, src, n * sizeof(*src));
+            SDL_memcpy(dstbuf, dst, n * sizeof(*dst));
+            vst4_u8((Uint8 *)dstbuf, SDL_Blit_BlendARGB8888_NEON(vld4_u8((const Uint8 *)srcbuf), vld4_u8((const Uint8 *)dstbuf), modulate, flags));
+            SDL_memcpy(dst, dstbuf, n * sizeof(*dst));
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_ARGB8888_ARGB8888_Modulate_Blend_NEON(SDL_BlitInfo *info)
+{
+    const int flags = info->flags;
+    const Uint8 modulateR = (flags & SDL_COPY_MODULATE_COLOR) ? info->r : 255;
+    const Uint8 modulateG = (flags & SDL_COPY_MODULATE_COLOR) ? info->g : 255;
+    const Uint8 modulateB = (flags & SDL_COPY_MODULATE_COLOR) ? info->b : 255;
+    const Uint8 modulateA = (flags & SDL_COPY_MODULATE_ALPHA) ? info->a : 255;
+    uint8x8x4_t modulate;
+
+    modulate.val[0] = vdup_n_u8(modulateB);
+    modulate.val[1] = vdup_n_u8(modulateG);
+    modulate.val[2] = vdup_n_u8(modulateR);
+    modulate.val[3] = vdup_n_u8(modulateA);
+
+    while (info->dst_h--) {
+        const Uint32 *src = (const Uint32 *)info->src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        while (n >= 8) {
+            vst4_u8((Uint8 *)dst, SDL_Blit_BlendARGB8888_NEON(vld4_u8((const Uint8 *)src), vld4_u8((const Uint8 *)dst), modulate, flags));
+            src += 8;
+            dst += 8;
+            n -= 8;
+        }
+        if (n > 0) {
+            /* Run the last few pixels through a full vector */
+            Uint32 srcbuf[8];
+            Uint32 dstbuf[8];
+            SDL_zero(srcbuf);
+            SDL_zero(dstbuf);
+            SDL_memcpy(srcbuf, src, n * sizeof(*src));
+            SDL_memcpy(dstbuf, dst, n * sizeof(*dst));
+            vst4_u8((Uint8 *)dstbuf, SDL_Blit_BlendARGB8888_NEON(vld4_u8((const Uint8 *)srcbuf), vld4_u8((const Uint8 *)dstbuf), modulate, flags));
+            SDL_memcpy(dst, dstbuf, n * sizeof(*dst));
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+#endif /* __ARM_NEON */
+
 SDL_BlitFuncEntry SDL_GeneratedBlitFuncTable[] = {
+#if HAVE_AVX2_INTRINSICS
+    { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_RGB888_BGR888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_RGB888_ARGB8888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_BGR888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_BGR888_RGB888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_BGR888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_BGR888_ARGB8888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_ARGB8888_RGB888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_ARGB8888_BGR888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_RGBA8888_RGB888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_RGBA8888_BGR888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_RGBA8888_ARGB8888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_ABGR8888_RGB888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_ABGR8888_BGR888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_ABGR8888_ARGB8888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_BGRA8888_RGB888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_BGRA8888_BGR888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_AVX2, SDL_Blit_BGRA8888_ARGB8888_Scale_AVX2 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD), SDL_CPU_AVX2, SDL_Blit_ARGB8888_ARGB8888_Blend_AVX2 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA | SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD), SDL_CPU_AVX2, SDL_Blit_ARGB8888_ARGB8888_Modulate_Blend_AVX2 },
+#endif /* HAVE_AVX2_INTRINSICS */
+#ifdef __SSE2__
+    { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_RGB888_BGR888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_RGB888_ARGB8888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_BGR888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_BGR888_RGB888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_BGR888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_BGR888_ARGB8888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_ARGB8888_RGB888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_ARGB8888_BGR888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_RGBA8888_RGB888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_RGBA8888_BGR888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_RGBA8888_ARGB8888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_ABGR8888_RGB888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_ABGR8888_BGR888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_ABGR8888_ARGB8888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_BGRA8888_RGB888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_BGRA8888_BGR888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_SSE2, SDL_Blit_BGRA8888_ARGB8888_Scale_SSE2 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD), SDL_CPU_SSE2, SDL_Blit_ARGB8888_ARGB8888_Blend_SSE2 },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA | SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD), SDL_CPU_SSE2, SDL_Blit_ARGB8888_ARGB8888_Modulate_Blend_SSE2 },
+#endif /* __SSE2__ */
+#ifdef __ARM_NEON
+    { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_RGB888_BGR888_Scale_NEON },
+    { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_RGB888_ARGB8888_Scale_NEON },
+    { SDL_PIXELFORMAT_BGR888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_BGR888_RGB888_Scale_NEON },
+    { SDL_PIXELFORMAT_BGR888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_BGR888_ARGB8888_Scale_NEON },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_ARGB8888_RGB888_Scale_NEON },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_ARGB8888_BGR888_Scale_NEON },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_RGBA8888_RGB888_Scale_NEON },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_RGBA8888_BGR888_Scale_NEON },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_RGBA8888_ARGB8888_Scale_NEON },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_ABGR8888_RGB888_Scale_NEON },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_ABGR8888_BGR888_Scale_NEON },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_ABGR8888_ARGB8888_Scale_NEON },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_BGRA8888_RGB888_Scale_NEON },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_BGR888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_BGRA8888_BGR888_Scale_NEON },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_NEAREST), SDL_CPU_NEON, SDL_Blit_BGRA8888_ARGB8888_Scale_NEON },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD), SDL_CPU_NEON, SDL_Blit_ARGB8888_ARGB8888_Blend_NEON },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, (SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA | SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD), SDL_CPU_NEON, SDL_Blit_ARGB8888_ARGB8888_Modulate_Blend_NEON },
+#endif /* __ARM_NEON */
     { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_NEAREST), SDL_CPU_ANY, SDL_Blit_RGB888_RGB888_Scale },
     { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD), SDL_CPU_ANY, SDL_Blit_RGB888_RGB888_Blend },
     { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_RGB888, (SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD | SDL_COPY_NEAREST), SDL_CPU_ANY, SDL_Blit_RGB888_RGB888_Blend_Scale },
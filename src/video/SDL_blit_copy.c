@@ -128,9 +128,7 @@ SDL_BlitCopy(SDL_BlitInfo * info)
     }
 
 #ifdef __SSE__
-    if (SDL_HasSSE() &&
-        !((uintptr_t) src & 15) && !(srcskip & 15) &&
-        !((uintptr_t) dst & 15) && !(dstskip & 15)) {
+    if (SDL_HasSSE() && info->src_align >= 16 && info->dst_align >= 16) {
         while (h--) {
             SDL_memcpySSE(dst, src, w);
             src += srcskip;
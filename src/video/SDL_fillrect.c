@@ -21,7 +21,24 @@
 #include "../SDL_internal.h"
 
 #include "SDL_video.h"
+#include "SDL_hints.h"
 #include "SDL_blit.h"
+#include "../thread/SDL_parallel_c.h"
+
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+/* Fills this big go around the cache with non-temporal stores, they would
+   evict everything else and be evicted themselves before being read back. */
+#define SDL_FILLRECT_STREAM_BYTES       (4 * 1024 * 1024)
+
+/* Fills smaller than this aren't worth waking up the worker threads for */
+#define SDL_FILLRECT_THREADS_MIN_BYTES  (2 * 1024 * 1024)
+#define SDL_FILLRECT_BAND_BYTES         (256 * 1024)
+
+/* The fillers that can choose use non-temporal stores when asked to stream */
+typedef void (*SDL_FillRectFunc)(Uint8 *pixels, int pitch, Uint32 color, int w, int h, SDL_bool stream);
 
 
 #ifdef __SSE__
@@ -58,12 +75,13 @@
 
 #define DEFINE_SSE_FILLRECT(bpp, type) \
 static void \
-SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
+SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h, SDL_bool stream) \
 { \
     int i, n; \
     Uint8 *p = NULL; \
  \
     SSE_BEGIN; \
+    (void) stream; \
  \
     while (h--) { \
         n = w * bpp; \
@@ -96,11 +114,12 @@ SDL_FillRect##bpp##SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h) \
 }
 
 static void
-SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h)
+SDL_FillRect1SSE(Uint8 *pixels, int pitch, Uint32 color, int w, int h, SDL_bool stream)
 {
     int i, n;
 
     SSE_BEGIN;
+    (void) stream;
     while (h--) {
         Uint8 *p = pixels;
         n = w;
@@ -131,11 +150,12 @@ DEFINE_SSE_FILLRECT(4, Uint32)
 #endif /* __SSE__ */
 
 static void
-SDL_FillRect1(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
+SDL_FillRect1(Uint8 * pixels, int pitch, Uint32 color, int w, int h, SDL_bool stream)
 {
     int n;
     Uint8 *p = NULL;
-    
+
+    (void) stream;
     while (h--) {
         n = w;
         p = pixels;
@@ -170,11 +190,12 @@ SDL_FillRect1(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
 }
 
 static void
-SDL_FillRect2(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
+SDL_FillRect2(Uint8 * pixels, int pitch, Uint32 color, int w, int h, SDL_bool stream)
 {
     int n;
     Uint16 *p = NULL;
-    
+
+    (void) stream;
     while (h--) {
         n = w;
         p = (Uint16 *) pixels;
@@ -194,7 +215,7 @@ SDL_FillRect2(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
 }
 
 static void
-SDL_FillRect3(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
+SDL_FillRect3(Uint8 * pixels, int pitch, Uint32 color, int w, int h, SDL_bool stream)
 {
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
     Uint8 b1 = (Uint8) (color & 0xFF);
@@ -208,6 +229,7 @@ SDL_FillRect3(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
     int n;
     Uint8 *p = NULL;
 
+    (void) stream;
     while (h--) {
         n = w;
         p = pixels;
@@ -222,14 +244,332 @@ SDL_FillRect3(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
 }
 
 static void
-SDL_FillRect4(Uint8 * pixels, int pitch, Uint32 color, int w, int h)
+SDL_FillRect4(Uint8 * pixels, int pitch, Uint32 color, int w, int h, SDL_bool stream)
 {
+    (void) stream;
     while (h--) {
         SDL_memset4(pixels, color, w);
         pixels += pitch;
     }
 }
 
+/* The vector fillers below work on rows of bytes that repeat every 'period'
+ * bytes: 3 for 24-bit pixels, 4 for everything else since the color has been
+ * replicated to 32 bits. The pattern holds the bytes of a row from its first
+ * pixel, long enough to load three vectors starting at any phase.
+ *
+ * Each row starts with an unaligned store, continues with aligned stores and
+ * ends with an unaligned store that overlaps the last aligned one, so rows
+ * must be at least two vectors wide. Narrower fills use the scalar code.
+ * Rows written with non-temporal stores must be at least two cache lines wide.
+ */
+#define SDL_FILL_PATTERN_SIZE   128
+#define SDL_FILL_VECTOR_MIN     64
+
+static void
+SDL_InitFillPattern(Uint8 *pattern, Uint32 color, int bpp)
+{
+    Uint8 pixel[4];
+    int i, period;
+
+    if (bpp == 3) {
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+        pixel[0] = (Uint8) (color & 0xFF);
+        pixel[1] = (Uint8) ((color >> 8) & 0xFF);
+        pixel[2] = (Uint8) ((color >> 16) & 0xFF);
+#else
+        pixel[0] = (Uint8) ((color >> 16) & 0xFF);
+        pixel[1] = (Uint8) ((color >> 8) & 0xFF);
+        pixel[2] = (Uint8) (color & 0xFF);
+#endif
+        period = 3;
+    } else {
+        SDL_memcpy(pixel, &color, sizeof(color));
+        period = 4;
+    }
+    for (i = 0; i < SDL_FILL_PATTERN_SIZE; ++i) {
+        pattern[i] = pixel[i % period];
+    }
+}
+
+#ifdef __SSE2__
+static void
+SDL_FillRowsSSE2(Uint8 *pixels, int pitch, const Uint8 *pattern, int period, int n, int h, SDL_bool stream)
+{
+    while (h--) {
+        Uint8 *p = pixels;
+        Uint8 *end = pixels + n;
+
+        if (stream) {
+            /* Stream whole cache lines, the partial ones at either end go
+               through the cache so no line gets both kinds of stores. */
+            Uint8 *q = (Uint8 *) (((uintptr_t) p + 63) & ~(uintptr_t) 63);
+            Uint8 *last = (Uint8 *) ((uintptr_t) end & ~(uintptr_t) 63);
+            const Uint8 *phase = pattern + (q - p) % period;
+            const __m128i v0 = _mm_loadu_si128((const __m128i *) phase);
+            const __m128i v1 = _mm_loadu_si128((const __m128i *) (phase + 16));
+            const __m128i v2 = _mm_loadu_si128((const __m128i *) (phase + 32));
+
+            SDL_memcpy(p, pattern, q - p);
+            while (last - q >= 48) {
+                _mm_stream_si128((__m128i *) q, v0);
+                _mm_stream_si128((__m128i *) (q + 16), v1);
+                _mm_stream_si128((__m128i *) (q + 32), v2);
+                q += 48;
+            }
+            if (last - q >= 16) {
+                _mm_stream_si128((__m128i *) q, v0);
+                q += 16;
+                if (last - q >= 16) {
+                    _mm_stream_si128((__m128i *) q, v1);
+                    q += 16;
+                }
+            }
+            SDL_memcpy(last, pattern + (last - p) % period, end - last);
+        } else {
+            Uint8 *q = (Uint8 *) (((uintptr_t) p + 16) & ~(uintptr_t) 15);
+            const Uint8 *phase = pattern + (q - p) % period;
+            const __m128i v0 = _mm_loadu_si128((const __m128i *) phase);
+            const __m128i v1 = _mm_loadu_si128((const __m128i *) (phase + 16));
+            const __m128i v2 = _mm_loadu_si128((const __m128i *) (phase + 32));
+
+            _mm_storeu_si128((__m128i *) p, _mm_loadu_si128((const __m128i *) pattern));
+            while (end - q >= 48) {
+                _mm_store_si128((__m128i *) q, v0);
+                _mm_store_si128((__m128i *) (q + 16), v1);
+                _mm_store_si128((__m128i *) (q + 32), v2);
+                q += 48;
+            }
+            if (end - q >= 16) {
+                _mm_store_si128((__m128i *) q, v0);
+                q += 16;
+                if (end - q >= 16) {
+                    _mm_store_si128((__m128i *) q, v1);
+                    q += 16;
+                }
+            }
+            if (q < end) {
+                q = end - 16;
+                _mm_storeu_si128((__m128i *) q, _mm_loadu_si128((const __m128i *) (pattern + (q - p) % period)));
+            }
+        }
+        pixels += pitch;
+    }
+    if (stream) {
+        _mm_sfence();
+    }
+}
+#endif /* __SSE2__ */
+
+#if HAVE_AVX2_INTRINSICS
+SDL_TARGETING("avx2") static void
+SDL_FillRowsAVX2(Uint8 *pixels, int pitch, const Uint8 *pattern, int period, int n, int h, SDL_bool stream)
+{
+    while (h--) {
+        Uint8 *p = pixels;
+        Uint8 *end = pixels + n;
+
+        if (stream) {
+            /* Stream whole cache lines, the partial ones at either end go
+               through the cache so no line gets both kinds of stores. */
+            Uint8 *q = (Uint8 *) (((uintptr_t) p + 63) & ~(uintptr_t) 63);
+            Uint8 *last = (Uint8 *) ((uintptr_t) end & ~(uintptr_t) 63);
+            const Uint8 *phase = pattern + (q - p) % period;
+            const __m256i v0 = _mm256_loadu_si256((const __m256i *) phase);
+            const __m256i v1 = _mm256_loadu_si256((const __m256i *) (phase + 32));
+            const __m256i v2 = _mm256_loadu_si256((const __m256i *) (phase + 64));
+
+            SDL_memcpy(p, pattern, q - p);
+            while (last - q >= 96) {
+                _mm256_stream_si256((__m256i *) q, v0);
+                _mm256_stream_si256((__m256i *) (q + 32), v1);
+                _mm256_stream_si256((__m256i *) (q + 64), v2);
+                q += 96;
+            }
+            if (last - q >= 32) {
+                _mm256_stream_si256((__m256i *) q, v0);
+                q += 32;
+                if (last - q >= 32) {
+                    _mm256_stream_si256((__m256i *) q, v1);
+                    q += 32;
+                }
+            }
+            SDL_memcpy(last, pattern + (last - p) % period, end - last);
+        } else {
+            Uint8 *q = (Uint8 *) (((uintptr_t) p + 32) & ~(uintptr_t) 31);
+            const Uint8 *phase = pattern + (q - p) % period;
+            const __m256i v0 = _mm256_loadu_si256((const __m256i *) phase);
+            const __m256i v1 = _mm256_loadu_si256((const __m256i *) (phase + 32));
+            const __m256i v2 = _mm256_loadu_si256((const __m256i *) (phase + 64));
+
+            _mm256_storeu_si256((__m256i *) p, _mm256_loadu_si256((const __m256i *) pattern));
+            while (end - q >= 96) {
+                _mm256_store_si256((__m256i *) q, v0);
+                _mm256_store_si256((__m256i *) (q + 32), v1);
+                _mm256_store_si256((__m256i *) (q + 64), v2);
+                q += 96;
+            }
+            if (end - q >= 32) {
+                _mm256_store_si256((__m256i *) q, v0);
+                q += 32;
+                if (end - q >= 32) {
+                    _mm256_store_si256((__m256i *) q, v1);
+                    q += 32;
+                }
+            }
+            if (q < end) {
+                q = end - 32;
+                _mm256_storeu_si256((__m256i *) q, _mm256_loadu_si256((const __m256i *) (pattern + (q - p) % period)));
+            }
+        }
+        pixels += pitch;
+    }
+    if (stream) {
+        _mm_sfence();
+    }
+    _mm256_zeroupper();
+}
+#endif /* HAVE_AVX2_INTRINSICS */
+
+#ifdef __ARM_NEON
+/* There's no non-temporal store intrinsic, so this always goes through the cache */
+static void
+SDL_FillRowsNEON(Uint8 *pixels, int pitch, const Uint8 *pattern, int period, int n, int h, SDL_bool stream)
+{
+    while (h--) {
+        Uint8 *p = pixels;
+        Uint8 *end = pixels + n;
+        Uint8 *q = (Uint8 *) (((uintptr_t) p + 16) & ~(uintptr_t) 15);
+        const Uint8 *phase = pattern + (q - p) % period;
+        const uint8x16_t v0 = vld1q_u8(phase);
+        const uint8x16_t v1 = vld1q_u8(phase + 16);
+        const uint8x16_t v2 = vld1q_u8(phase + 32);
+
+        vst1q_u8(p, vld1q_u8(pattern));
+        while (end - q >= 48) {
+            vst1q_u8(q, v0);
+            vst1q_u8(q + 16, v1);
+            vst1q_u8(q + 32, v2);
+            q += 48;
+        }
+        if (end - q >= 16) {
+            vst1q_u8(q, v0);
+            q += 16;
+            if (end - q >= 16) {
+                vst1q_u8(q, v1);
+                q += 16;
+            }
+        }
+        if (q < end) {
+            q = end - 16;
+            vst1q_u8(q, vld1q_u8(pattern + (q - p) % period));
+        }
+        pixels += pitch;
+    }
+    (void) stream;
+}
+#endif /* __ARM_NEON */
+
+#define DEFINE_VECTOR_FILLRECT(bpp, ext) \
+static void \
+SDL_FillRect##bpp##ext(Uint8 *pixels, int pitch, Uint32 color, int w, int h, SDL_bool stream) \
+{ \
+    Uint8 pattern[SDL_FILL_PATTERN_SIZE]; \
+ \
+    SDL_InitFillPattern(pattern, color, bpp); \
+    SDL_FillRows##ext(pixels, pitch, pattern, (bpp == 3) ? 3 : 4, w * bpp, h, stream); \
+}
+
+#ifdef __SSE2__
+DEFINE_VECTOR_FILLRECT(1, SSE2)
+DEFINE_VECTOR_FILLRECT(2, SSE2)
+DEFINE_VECTOR_FILLRECT(3, SSE2)
+DEFINE_VECTOR_FILLRECT(4, SSE2)
+#endif
+#if HAVE_AVX2_INTRINSICS
+DEFINE_VECTOR_FILLRECT(1, AVX2)
+DEFINE_VECTOR_FILLRECT(2, AVX2)
+DEFINE_VECTOR_FILLRECT(3, AVX2)
+DEFINE_VECTOR_FILLRECT(4, AVX2)
+#endif
+#ifdef __ARM_NEON
+DEFINE_VECTOR_FILLRECT(1, NEON)
+DEFINE_VECTOR_FILLRECT(2, NEON)
+DEFINE_VECTOR_FILLRECT(3, NEON)
+DEFINE_VECTOR_FILLRECT(4, NEON)
+#endif
+
+static SDL_FillRectFunc
+SDL_ChooseFillRect(int bpp, int w)
+{
+    const Uint32 features = (w * bpp >= SDL_FILL_VECTOR_MIN) ? SDL_GetBlitCPUFeatures() : 0;
+
+#if HAVE_AVX2_INTRINSICS
+    if (features & SDL_CPU_AVX2) {
+        switch (bpp) {
+        case 1: return SDL_FillRect1AVX2;
+        case 2: return SDL_FillRect2AVX2;
+        case 3: return SDL_FillRect3AVX2;
+        case 4: return SDL_FillRect4AVX2;
+        }
+    }
+#endif
+#ifdef __SSE2__
+    if (features & SDL_CPU_SSE2) {
+        switch (bpp) {
+        case 1: return SDL_FillRect1SSE2;
+        case 2: return SDL_FillRect2SSE2;
+        case 3: return SDL_FillRect3SSE2;
+        case 4: return SDL_FillRect4SSE2;
+        }
+    }
+#endif
+#ifdef __SSE__
+    if (features & SDL_CPU_SSE) {
+        switch (bpp) {
+        case 1: return SDL_FillRect1SSE;
+        case 2: return SDL_FillRect2SSE;
+        case 4: return SDL_FillRect4SSE;
+        }
+    }
+#endif
+#ifdef __ARM_NEON
+    if (features & SDL_CPU_NEON) {
+        switch (bpp) {
+        case 1: return SDL_FillRect1NEON;
+        case 2: return SDL_FillRect2NEON;
+        case 3: return SDL_FillRect3NEON;
+        case 4: return SDL_FillRect4NEON;
+        }
+    }
+#endif
+    switch (bpp) {
+    case 1: return SDL_FillRect1;
+    case 2: return SDL_FillRect2;
+    case 3: return SDL_FillRect3;
+    default: return SDL_FillRect4;
+    }
+}
+
+typedef struct
+{
+    SDL_FillRectFunc func;
+    Uint8 *pixels;
+    int pitch;
+    Uint32 color;
+    int w;
+    SDL_bool stream;
+} SDL_FillRectJob;
+
+static void
+SDL_FillRectBand(void *data, int start, int end)
+{
+    const SDL_FillRectJob *job = (const SDL_FillRectJob *) data;
+
+    job->func(job->pixels + (size_t) start * job->pitch, job->pitch,
+              job->color, job->w, end - start, job->stream);
+}
+
 /* 
  * This function performs a fast fill of the given rectangle with 'color'
  */
@@ -238,6 +578,9 @@ SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
 {
     SDL_Rect clipped;
     Uint8 *pixels;
+    SDL_FillRectFunc func;
+    SDL_bool stream;
+    int bpp;
 
     if (!dst) {
         return SDL_SetError("Passed NULL destination surface");
@@ -248,6 +591,18 @@ SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
         return SDL_SetError("SDL_FillRect(): Unsupported surface format");
     }
 
+    /* RLE surfaces keep their pixels, but only re-encode them on unlock */
+    if (SDL_MUSTLOCK(dst) && !dst->locked) {
+        int status;
+
+        if (SDL_LockSurface(dst) < 0) {
+            return -1;
+        }
+        status = SDL_FillRect(dst, rect, color);
+        SDL_UnlockSurface(dst);
+        return status;
+    }
+
     /* If 'rect' == NULL, then fill the whole surface */
     if (rect) {
         /* Perform clipping */
@@ -270,53 +625,38 @@ SDL_FillRect(SDL_Surface * dst, const SDL_Rect * rect, Uint32 color)
 
     pixels = (Uint8 *) dst->pixels + rect->y * dst->pitch +
                                      rect->x * dst->format->BytesPerPixel;
+    bpp = dst->format->BytesPerPixel;
 
-    switch (dst->format->BytesPerPixel) {
+    switch (bpp) {
     case 1:
-        {
-            color |= (color << 8);
-            color |= (color << 16);
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect1SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect1(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
-
+        color |= (color << 8);
+        color |= (color << 16);
+        break;
     case 2:
-        {
-            color |= (color << 16);
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect2SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect2(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
-
-    case 3:
-        /* 24-bit RGB is a slow path, at least for now. */
-        {
-            SDL_FillRect3(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
-
-    case 4:
-        {
-#ifdef __SSE__
-            if (SDL_HasSSE()) {
-                SDL_FillRect4SSE(pixels, dst->pitch, color, rect->w, rect->h);
-                break;
-            }
-#endif
-            SDL_FillRect4(pixels, dst->pitch, color, rect->w, rect->h);
-            break;
-        }
+        color |= (color << 16);
+        break;
+    }
+    func = SDL_ChooseFillRect(bpp, rect->w);
+
+    /* Decided on the whole fill, since the threaded bands are much smaller */
+    stream = (rect->w * bpp >= 128 &&
+              (Sint64) rect->w * bpp * rect->h >= SDL_FILLRECT_STREAM_BYTES) ? SDL_TRUE : SDL_FALSE;
+
+    /* Split big fills like clearing the whole screen over the worker threads */
+    if ((Sint64) rect->w * bpp * rect->h >= SDL_FILLRECT_THREADS_MIN_BYTES &&
+        SDL_GetHintBoolean(SDL_HINT_FILLRECT_THREADS, SDL_FALSE)) {
+        SDL_FillRectJob job;
+
+        job.func = func;
+        job.pixels = pixels;
+        job.pitch = dst->pitch;
+        job.color = color;
+        job.w = rect->w;
+        job.stream = stream;
+        SDL_ParallelFor(rect->h, 1, SDL_max(1, SDL_FILLRECT_BAND_BYTES / (rect->w * bpp)),
+                        SDL_FillRectBand, &job);
+    } else {
+        func(pixels, dst->pitch, color, rect->w, rect->h, stream);
     }
 
     /* We're done! */
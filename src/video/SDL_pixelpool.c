@@ -0,0 +1,179 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+/* Aligned pixel memory with a pool of recently freed blocks */
+
+#include "SDL_atomic.h"
+#include "SDL_error.h"
+#include "SDL_pixelpool_c.h"
+
+/* Blocks between these sizes are rounded up to one of four size classes per
+   power of two and pooled when freed, anything else goes straight back to
+   the heap. */
+#define SDL_PIXEL_POOL_MIN_SIZE     (4 * 1024)
+#define SDL_PIXEL_POOL_MAX_SIZE     (16 * 1024 * 1024)
+#define SDL_PIXEL_POOL_CLASSES      49
+
+/* Limits on how much freed memory is kept around */
+#define SDL_PIXEL_POOL_CLASS_DEPTH  4
+#define SDL_PIXEL_POOL_MAX_BYTES    (32 * 1024 * 1024)
+
+/* This sits just before the pixels of every block */
+typedef struct SDL_PixelBlock
+{
+    void *base;                     /* what SDL_malloc() returned */
+    size_t size;                    /* usable bytes after the header */
+    int size_class;                 /* -1 for blocks that aren't pooled */
+    struct SDL_PixelBlock *next;    /* next free block of the same class */
+} SDL_PixelBlock;
+
+SDL_COMPILE_TIME_ASSERT(pixel_block_header, sizeof(SDL_PixelBlock) <= SDL_PIXEL_ALIGNMENT);
+
+static struct
+{
+    SDL_SpinLock lock;
+    SDL_PixelBlock *free[SDL_PIXEL_POOL_CLASSES];
+    int count[SDL_PIXEL_POOL_CLASSES];
+    size_t pooled_bytes;
+} SDL_pixel_pool;
+
+
+static int
+SDL_GetPixelSizeClass(size_t size, size_t *class_size)
+{
+    size_t n = SDL_PIXEL_POOL_MIN_SIZE;
+    size_t step = SDL_PIXEL_POOL_MIN_SIZE / 4;
+    int size_class = 0;
+
+    if (size < SDL_PIXEL_POOL_MIN_SIZE || size > SDL_PIXEL_POOL_MAX_SIZE) {
+        return -1;
+    }
+    while (n < size) {
+        n += step;
+        if (n == step * 8) {
+            step *= 2;
+        }
+        ++size_class;
+    }
+    *class_size = n;
+    return size_class;
+}
+
+static SDL_PixelBlock *
+SDL_GetPixelBlock(void *pixels)
+{
+    return (SDL_PixelBlock *) ((Uint8 *) pixels - SDL_PIXEL_ALIGNMENT);
+}
+
+void *
+SDL_AllocPixels(size_t size)
+{
+    SDL_PixelBlock *block = NULL;
+    size_t class_size = size;
+    const int size_class = SDL_GetPixelSizeClass(size, &class_size);
+    void *base;
+    Uint8 *pixels;
+
+    if (size_class >= 0) {
+        SDL_AtomicLock(&SDL_pixel_pool.lock);
+        block = SDL_pixel_pool.free[size_class];
+        if (block) {
+            SDL_pixel_pool.free[size_class] = block->next;
+            --SDL_pixel_pool.count[size_class];
+            SDL_pixel_pool.pooled_bytes -= block->size;
+        }
+        SDL_AtomicUnlock(&SDL_pixel_pool.lock);
+        if (block) {
+            return (Uint8 *) block + SDL_PIXEL_ALIGNMENT;
+        }
+    }
+
+    if (class_size > SDL_MAX_SINT32 ||
+        class_size + 2 * SDL_PIXEL_ALIGNMENT < class_size) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+    base = SDL_malloc(class_size + 2 * SDL_PIXEL_ALIGNMENT);
+    if (!base) {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    /* The header takes the aligned slot before the pixels */
+    pixels = (Uint8 *) (((uintptr_t) base + 2 * SDL_PIXEL_ALIGNMENT) & ~(uintptr_t) (SDL_PIXEL_ALIGNMENT - 1));
+    block = SDL_GetPixelBlock(pixels);
+    block->base = base;
+    block->size = class_size;
+    block->size_class = size_class;
+    block->next = NULL;
+    return pixels;
+}
+
+void
+SDL_FreePixels(void *pixels)
+{
+    SDL_PixelBlock *block;
+
+    if (!pixels) {
+        return;
+    }
+
+    block = SDL_GetPixelBlock(pixels);
+    if (block->size_class >= 0) {
+        SDL_bool pooled = SDL_FALSE;
+
+        SDL_AtomicLock(&SDL_pixel_pool.lock);
+        if (SDL_pixel_pool.count[block->size_class] < SDL_PIXEL_POOL_CLASS_DEPTH &&
+            SDL_pixel_pool.pooled_bytes + block->size <= SDL_PIXEL_POOL_MAX_BYTES) {
+            block->next = SDL_pixel_pool.free[block->size_class];
+            SDL_pixel_pool.free[block->size_class] = block;
+            ++SDL_pixel_pool.count[block->size_class];
+            SDL_pixel_pool.pooled_bytes += block->size;
+            pooled = SDL_TRUE;
+        }
+        SDL_AtomicUnlock(&SDL_pixel_pool.lock);
+        if (pooled) {
+            return;
+        }
+    }
+    SDL_free(block->base);
+}
+
+void
+SDL_QuitPixelPool(void)
+{
+    int i;
+
+    SDL_AtomicLock(&SDL_pixel_pool.lock);
+    for (i = 0; i < SDL_PIXEL_POOL_CLASSES; ++i) {
+        while (SDL_pixel_pool.free[i]) {
+            SDL_PixelBlock *block = SDL_pixel_pool.free[i];
+            SDL_pixel_pool.free[i] = block->next;
+            SDL_free(block->base);
+        }
+        SDL_pixel_pool.count[i] = 0;
+    }
+    SDL_pixel_pool.pooled_bytes = 0;
+    SDL_AtomicUnlock(&SDL_pixel_pool.lock);
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
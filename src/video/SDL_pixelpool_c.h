@@ -0,0 +1,48 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+#include "../SDL_internal.h"
+
+#ifndef SDL_pixelpool_c_h_
+#define SDL_pixelpool_c_h_
+
+/* Pixel memory for surfaces.
+
+   Every block starts on a SDL_PIXEL_ALIGNMENT boundary, so surfaces whose
+   pitch is a multiple of it have every row aligned for SIMD and start rows on
+   a cache line. Freed blocks of common sizes are kept around for a while,
+   which makes short-lived surfaces, like the temporary ones in scaled and
+   rotated blits, cheap to create.
+ */
+
+#define SDL_PIXEL_ALIGNMENT     64
+
+/* Allocate 'size' bytes of uninitialized, aligned pixel memory */
+extern void *SDL_AllocPixels(size_t size);
+
+/* Free memory from SDL_AllocPixels(), NULL is fine */
+extern void SDL_FreePixels(void *pixels);
+
+/* Release all the memory held by the pool */
+extern void SDL_QuitPixelPool(void);
+
+#endif /* SDL_pixelpool_c_h_ */
+
+/* vi: set ts=4 sw=4 expandtab: */
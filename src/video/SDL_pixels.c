@@ -982,7 +982,7 @@ SDL_MapSurface(SDL_Surface * src, SDL_Surface * dst)
     /* Clear out any previous mapping */
     map = src->map;
     if ((src->flags & SDL_RLEACCEL) == SDL_RLEACCEL) {
-        SDL_UnRLESurface(src, 1);
+        SDL_UnRLESurface(src);
     }
     SDL_InvalidateMap(map);
 
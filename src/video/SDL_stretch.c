@@ -29,6 +29,10 @@
 #include "SDL_video.h"
 #include "SDL_blit.h"
 
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
 /* This isn't ready for general consumption yet - it should be folded
    into the general blitting mechanism.
 */
@@ -260,9 +264,10 @@ SDL_SoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
         }
         dst_locked = 1;
     }
-    /* Lock the source if it's in hardware */
+    /* Lock the source if it's in hardware. Reading a view doesn't need its
+       owner locked, and unlocking would encode an RLE owner again. */
     src_locked = 0;
-    if (SDL_MUSTLOCK(src)) {
+    if (src->flags & SDL_RLEACCEL) {
         if (SDL_LockSurface(src) < 0) {
             if (dst_locked) {
                 SDL_UnlockSurface(dst);
@@ -350,4 +355,284 @@ SDL_SoftStretch(SDL_Surface * src, const SDL_Rect * srcrect,
     return (0);
 }
 
+/* Bilinear filtering uses 7 bit weights, so a vertically filtered channel
+   fits in 16 bits. Every version below does exactly the same integer math,
+   so the results don't depend on the CPU.
+*/
+#define LINEAR_BITS     7
+#define LINEAR_ONE      (1 << LINEAR_BITS)
+#define LINEAR_ROUND    (1 << (2 * LINEAR_BITS - 1))
+
+typedef struct
+{
+    int x0, x1;         /* channel offsets of the two source pixels */
+    Uint32 weights;     /* LINEAR_ONE - weight in the low word, weight in the high word */
+} SDL_LinearColumn;
+
+typedef void (*SDL_LinearRowV)(const Uint8 *src0, const Uint8 *src1, int weight, Uint16 *dst, int count);
+typedef void (*SDL_LinearRowH)(const Uint16 *src, const SDL_LinearColumn *columns, Uint8 *dst, int width);
+
+/* Maps a destination pixel center onto the source, in 16.16 fixed point */
+static void
+get_linear_step(int dst_pos, int src_len, int dst_len, int *p0, int *p1, int *weight)
+{
+    Sint64 pos = ((((Sint64)(2 * dst_pos + 1)) * src_len) << 16) / (2 * dst_len) - 0x8000;
+
+    if (pos < 0) {
+        pos = 0;
+    }
+    *p0 = (int)(pos >> 16);
+    *weight = (int)(pos >> (16 - LINEAR_BITS)) & (LINEAR_ONE - 1);
+    if (*p0 >= src_len - 1) {
+        *p0 = src_len - 1;
+        *p1 = *p0;
+        *weight = 0;
+    } else {
+        *p1 = *p0 + 1;
+    }
+}
+
+static void
+linear_row_v(const Uint8 *src0, const Uint8 *src1, int weight, Uint16 *dst, int count)
+{
+    const int weight0 = LINEAR_ONE - weight;
+    int i;
+
+    for (i = 0; i < count; ++i) {
+        dst[i] = (Uint16)(src0[i] * weight0 + src1[i] * weight);
+    }
+}
+
+static void
+linear_row_h(const Uint16 *src, const SDL_LinearColumn *columns, Uint8 *dst, int width)
+{
+    int i, c;
+
+    for (i = 0; i < width; ++i) {
+        const Uint16 *p0 = src + columns[i].x0;
+        const Uint16 *p1 = src + columns[i].x1;
+        const Uint32 weight0 = columns[i].weights & 0xFFFF;
+        const Uint32 weight1 = columns[i].weights >> 16;
+
+        for (c = 0; c < 4; ++c) {
+            *dst++ = (Uint8)((p0[c] * weight0 + p1[c] * weight1 + LINEAR_ROUND) >> (2 * LINEAR_BITS));
+        }
+    }
+}
+
+#ifdef __SSE2__
+static void
+linear_row_v_SSE2(const Uint8 *src0, const Uint8 *src1, int weight, Uint16 *dst, int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weight0 = _mm_set1_epi16((short)(LINEAR_ONE - weight));
+    const __m128i weight1 = _mm_set1_epi16((short)weight);
+    int i;
+
+    for (i = 0; i + 16 <= count; i += 16) {
+        const __m128i a = _mm_loadu_si128((const __m128i *)(src0 + i));
+        const __m128i b = _mm_loadu_si128((const __m128i *)(src1 + i));
+        const __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(a, zero), weight0),
+                                         _mm_mullo_epi16(_mm_unpacklo_epi8(b, zero), weight1));
+        const __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(a, zero), weight0),
+                                         _mm_mullo_epi16(_mm_unpackhi_epi8(b, zero), weight1));
+        _mm_storeu_si128((__m128i *)(dst + i), lo);
+        _mm_storeu_si128((__m128i *)(dst + i + 8), hi);
+    }
+    linear_row_v(src0 + i, src1 + i, weight, dst + i, count - i);
+}
+
+static void
+linear_row_h_SSE2(const Uint16 *src, const SDL_LinearColumn *columns, Uint8 *dst, int width)
+{
+    const __m128i round = _mm_set1_epi32(LINEAR_ROUND);
+    int i;
+
+    for (i = 0; i + 2 <= width; i += 2) {
+        /* Interleave the two pixels so pmaddwd weighs and sums each channel */
+        __m128i p = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)(src + columns[i].x0)),
+                                       _mm_loadl_epi64((const __m128i *)(src + columns[i].x1)));
+        __m128i q = _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)(src + columns[i + 1].x0)),
+                                       _mm_loadl_epi64((const __m128i *)(src + columns[i + 1].x1)));
+        p = _mm_madd_epi16(p, _mm_set1_epi32((int)columns[i].weights));
+        q = _mm_madd_epi16(q, _mm_set1_epi32((int)columns[i + 1].weights));
+        p = _mm_srai_epi32(_mm_add_epi32(p, round), 2 * LINEAR_BITS);
+        q = _mm_srai_epi32(_mm_add_epi32(q, round), 2 * LINEAR_BITS);
+        p = _mm_packs_epi32(p, q);
+        _mm_storel_epi64((__m128i *)(dst + i * 4), _mm_packus_epi16(p, p));
+    }
+    linear_row_h(src, columns + i, dst + i * 4, width - i);
+}
+#endif /* __SSE2__ */
+
+#ifdef __ARM_NEON
+static void
+linear_row_v_NEON(const Uint8 *src0, const Uint8 *src1, int weight, Uint16 *dst, int count)
+{
+    const uint8x8_t weight0 = vdup_n_u8((Uint8)(LINEAR_ONE - weight));
+    const uint8x8_t weight1 = vdup_n_u8((Uint8)weight);
+    int i;
+
+    for (i = 0; i + 8 <= count; i += 8) {
+        vst1q_u16(dst + i, vmlal_u8(vmull_u8(vld1_u8(src0 + i), weight0), vld1_u8(src1 + i), weight1));
+    }
+    linear_row_v(src0 + i, src1 + i, weight, dst + i, count - i);
+}
+
+static void
+linear_row_h_NEON(const Uint16 *src, const SDL_LinearColumn *columns, Uint8 *dst, int width)
+{
+    int i;
+
+    for (i = 0; i + 2 <= width; i += 2) {
+        uint32x4_t p = vmull_n_u16(vld1_u16(src + columns[i].x0), (Uint16)(columns[i].weights & 0xFFFF));
+        uint32x4_t q = vmull_n_u16(vld1_u16(src + columns[i + 1].x0), (Uint16)(columns[i + 1].weights & 0xFFFF));
+        p = vmlal_n_u16(p, vld1_u16(src + columns[i].x1), (Uint16)(columns[i].weights >> 16));
+        q = vmlal_n_u16(q, vld1_u16(src + columns[i + 1].x1), (Uint16)(columns[i + 1].weights >> 16));
+        vst1_u8(dst + i * 4, vmovn_u16(vcombine_u16(vrshrn_n_u32(p, 2 * LINEAR_BITS), vrshrn_n_u32(q, 2 * LINEAR_BITS))));
+    }
+    linear_row_h(src, columns + i, dst + i * 4, width - i);
+}
+#endif /* __ARM_NEON */
+
+/* Perform a bilinear filtered stretch blit between two surfaces of the same
+   32-bit format. Unlike SDL_SoftStretch() this is safe to call from multiple
+   threads.
+*/
+int
+SDL_SoftStretchLinear(SDL_Surface * src, const SDL_Rect * srcrect,
+                      SDL_Surface * dst, const SDL_Rect * dstrect)
+{
+    const Uint32 features = SDL_GetBlitCPUFeatures();
+    SDL_LinearRowV row_v = linear_row_v;
+    SDL_LinearRowH row_h = linear_row_h;
+    SDL_LinearColumn *columns;
+    Uint16 *row;
+    int src_locked;
+    int dst_locked;
+    int i, y;
+    SDL_Rect full_src;
+    SDL_Rect full_dst;
+
+    if (src->format->format != dst->format->format) {
+        return SDL_SetError("Only works with same format surfaces");
+    }
+    if (src->format->BytesPerPixel != 4 ||
+        SDL_ISPIXELFORMAT_INDEXED(src->format->format) ||
+        SDL_ISPIXELFORMAT_FOURCC(src->format->format) ||
+        src->format->format == SDL_PIXELFORMAT_ARGB2101010) {
+        return SDL_SetError("Only works with 32-bit 8888 surfaces");
+    }
+
+    /* Verify the blit rectangles */
+    if (srcrect) {
+        if ((srcrect->x < 0) || (srcrect->y < 0) ||
+            ((srcrect->x + srcrect->w) > src->w) ||
+            ((srcrect->y + srcrect->h) > src->h)) {
+            return SDL_SetError("Invalid source blit rectangle");
+        }
+    } else {
+        full_src.x = 0;
+        full_src.y = 0;
+        full_src.w = src->w;
+        full_src.h = src->h;
+        srcrect = &full_src;
+    }
+    if (dstrect) {
+        if ((dstrect->x < 0) || (dstrect->y < 0) ||
+            ((dstrect->x + dstrect->w) > dst->w) ||
+            ((dstrect->y + dstrect->h) > dst->h)) {
+            return SDL_SetError("Invalid destination blit rectangle");
+        }
+    } else {
+        full_dst.x = 0;
+        full_dst.y = 0;
+        full_dst.w = dst->w;
+        full_dst.h = dst->h;
+        dstrect = &full_dst;
+    }
+    if (srcrect->w <= 0 || srcrect->h <= 0 || dstrect->w <= 0 || dstrect->h <= 0) {
+        return 0;
+    }
+
+#ifdef __SSE2__
+    if (features & SDL_CPU_SSE2) {
+        row_v = linear_row_v_SSE2;
+        row_h = linear_row_h_SSE2;
+    }
+#endif
+#ifdef __ARM_NEON
+    if (features & SDL_CPU_NEON) {
+        row_v = linear_row_v_NEON;
+        row_h = linear_row_h_NEON;
+    }
+#endif
+
+    columns = (SDL_LinearColumn *) SDL_malloc(dstrect->w * sizeof(*columns));
+    row = (Uint16 *) SDL_malloc(srcrect->w * 4 * sizeof(*row));
+    if (!columns || !row) {
+        SDL_free(columns);
+        SDL_free(row);
+        return SDL_OutOfMemory();
+    }
+    for (i = 0; i < dstrect->w; ++i) {
+        int x0, x1, weight;
+
+        get_linear_step(i, srcrect->w, dstrect->w, &x0, &x1, &weight);
+        columns[i].x0 = x0 * 4;
+        columns[i].x1 = x1 * 4;
+        columns[i].weights = ((Uint32)weight << 16) | (Uint32)(LINEAR_ONE - weight);
+    }
+
+    /* Lock the destination if it's in hardware */
+    dst_locked = 0;
+    if (SDL_MUSTLOCK(dst)) {
+        if (SDL_LockSurface(dst) < 0) {
+            SDL_free(columns);
+            SDL_free(row);
+            return SDL_SetError("Unable to lock destination surface");
+        }
+        dst_locked = 1;
+    }
+    /* Lock the source if it's in hardware. Reading a view doesn't need its
+       owner locked, and unlocking would encode an RLE owner again. */
+    src_locked = 0;
+    if (src->flags & SDL_RLEACCEL) {
+        if (SDL_LockSurface(src) < 0) {
+            if (dst_locked) {
+                SDL_UnlockSurface(dst);
+            }
+            SDL_free(columns);
+            SDL_free(row);
+            return SDL_SetError("Unable to lock source surface");
+        }
+        src_locked = 1;
+    }
+
+    /* Filter each row vertically into a 16-bit buffer, then horizontally */
+    for (y = 0; y < dstrect->h; ++y) {
+        const Uint8 *srcp = (const Uint8 *) src->pixels + (srcrect->x * 4);
+        Uint8 *dstp = (Uint8 *) dst->pixels + ((dstrect->y + y) * dst->pitch)
+            + (dstrect->x * 4);
+        int y0, y1, weight;
+
+        get_linear_step(y, srcrect->h, dstrect->h, &y0, &y1, &weight);
+        row_v(srcp + ((srcrect->y + y0) * src->pitch),
+              srcp + ((srcrect->y + y1) * src->pitch),
+              weight, row, srcrect->w * 4);
+        row_h(row, columns, dstp, dstrect->w);
+    }
+
+    /* We need to unlock the surfaces if they're locked */
+    if (dst_locked) {
+        SDL_UnlockSurface(dst);
+    }
+    if (src_locked) {
+        SDL_UnlockSurface(src);
+    }
+    SDL_free(columns);
+    SDL_free(row);
+    return 0;
+}
+
 /* vi: set ts=4 sw=4 expandtab: */
@@ -21,10 +21,12 @@
 #include "../SDL_internal.h"
 
 #include "SDL_video.h"
+#include "SDL_hints.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
 #include "SDL_pixels_c.h"
+#include "SDL_pixelpool_c.h"
 #include "SDL_yuv_c.h"
 
 
@@ -32,6 +34,9 @@
 SDL_COMPILE_TIME_ASSERT(surface_size_assumptions,
     sizeof(int) == sizeof(Sint32) && sizeof(size_t) >= sizeof(Sint32));
 
+/* Conversions smaller than this aren't worth waking up the worker threads for */
+#define SDL_CONVERT_THREADS_MIN_PIXELS  (256 * 1024)
+
 /* Public routines */
 
 /*
@@ -54,7 +59,12 @@ SDL_CalculatePitch(Uint32 format, int width)
     default:
         break;
     }
-    pitch = (pitch + 3) & ~3;   /* 4-byte aligning */
+    if (pitch >= 4 * SDL_PIXEL_ALIGNMENT) {
+        /* Start every row on a cache line, the padding is at most 25% */
+        pitch = (pitch + SDL_PIXEL_ALIGNMENT - 1) & ~(SDL_PIXEL_ALIGNMENT - 1);
+    } else {
+        pitch = (pitch + 3) & ~3;   /* 4-byte aligning */
+    }
     return pitch;
 }
 
@@ -119,12 +129,12 @@ SDL_CreateRGBSurfaceWithFormat(Uint32 flags, int width, int height, int depth,
             return NULL;
         }
 
-        surface->pixels = SDL_malloc((size_t)size);
+        surface->pixels = SDL_AllocPixels((size_t)size);
         if (!surface->pixels) {
             SDL_FreeSurface(surface);
-            SDL_OutOfMemory();
             return NULL;
         }
+        surface->flags |= SDL_SIMD_ALIGNED;
         /* This is important for bitmaps */
         SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
     }
@@ -380,6 +390,27 @@ SDL_ConvertColorkeyToAlpha(SDL_Surface * surface)
     SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_BLEND);
 }
 
+/*
+ * Called when the modulation or blend flags of a surface change.
+ * The lookup table of an RGB source doesn't depend on them, so if the
+ * map is still set up only the blit function has to be picked again.
+ * Locked and RLE encoded surfaces are left for the next blit to remap,
+ * since picking a blitter would encode or decode the pixels.
+ */
+static void
+SDL_UpdateBlitFlags(SDL_Surface * surface)
+{
+    SDL_BlitMap *map = surface->map;
+
+    if (map->dst && !SDL_ISPIXELFORMAT_INDEXED(surface->format->format) &&
+        !surface->locked && !(surface->flags & SDL_RLEACCEL)) {
+        /* This invalidates the map itself if there's no blitter for the new flags */
+        SDL_CalculateBlit(surface);
+    } else {
+        SDL_InvalidateMap(map);
+    }
+}
+
 int
 SDL_SetSurfaceColorMod(SDL_Surface * surface, Uint8 r, Uint8 g, Uint8 b)
 {
@@ -400,7 +431,7 @@ SDL_SetSurfaceColorMod(SDL_Surface * surface, Uint8 r, Uint8 g, Uint8 b)
         surface->map->info.flags &= ~SDL_COPY_MODULATE_COLOR;
     }
     if (surface->map->info.flags != flags) {
-        SDL_InvalidateMap(surface->map);
+        SDL_UpdateBlitFlags(surface);
     }
     return 0;
 }
@@ -443,7 +474,7 @@ SDL_SetSurfaceAlphaMod(SDL_Surface * surface, Uint8 alpha)
         surface->map->info.flags &= ~SDL_COPY_MODULATE_ALPHA;
     }
     if (surface->map->info.flags != flags) {
-        SDL_InvalidateMap(surface->map);
+        SDL_UpdateBlitFlags(surface);
     }
     return 0;
 }
@@ -492,7 +523,7 @@ SDL_SetSurfaceBlendMode(SDL_Surface * surface, SDL_BlendMode blendMode)
     }
 
     if (surface->map->info.flags != flags) {
-        SDL_InvalidateMap(surface->map);
+        SDL_UpdateBlitFlags(surface);
     }
 
     return status;
@@ -570,9 +601,8 @@ SDL_GetClipRect(SDL_Surface * surface, SDL_Rect * rect)
  * you know exactly what you are doing, you can optimize your code
  * by calling the one(s) you need.
  */
-int
-SDL_LowerBlit(SDL_Surface * src, SDL_Rect * srcrect,
-              SDL_Surface * dst, SDL_Rect * dstrect)
+static int
+SDL_ValidateBlitMap(SDL_Surface * src, SDL_Surface * dst)
 {
     /* Check to make sure the blit mapping is valid */
     if ((src->map->dst != dst) ||
@@ -589,9 +619,37 @@ SDL_LowerBlit(SDL_Surface * src, SDL_Rect * srcrect,
 /*              src, dst->flags, src->map->info.flags, dst, dst->flags, */
 /*              dst->map->info.flags, src->map->blit); */
     }
+    return 0;
+}
+
+int
+SDL_LowerBlit(SDL_Surface * src, SDL_Rect * srcrect,
+              SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    if (SDL_ValidateBlitMap(src, dst) < 0) {
+        return (-1);
+    }
     return (src->map->blit(src, srcrect, dst, dstrect));
 }
 
+/*
+ * Copy the pixels in rect from src to the same place in a separate dst,
+ * splitting big copies up over the worker threads if the application
+ * asked for that with SDL_HINT_CONVERT_THREADS.
+ */
+static int
+SDL_ConvertBlit(SDL_Surface * src, SDL_Rect * rect, SDL_Surface * dst)
+{
+    if (SDL_ValidateBlitMap(src, dst) < 0) {
+        return (-1);
+    }
+    if ((Sint64) rect->w * rect->h >= SDL_CONVERT_THREADS_MIN_PIXELS &&
+        SDL_GetHintBoolean(SDL_HINT_CONVERT_THREADS, SDL_FALSE)) {
+        return SDL_ParallelBlit(src, rect, dst, rect);
+    }
+    return (src->map->blit(src, rect, dst, rect));
+}
+
 
 int
 SDL_UpperBlit(SDL_Surface * src, const SDL_Rect * srcrect,
@@ -695,6 +753,13 @@ SDL_UpperBlit(SDL_Surface * src, const SDL_Rect * srcrect,
 int
 SDL_UpperBlitScaled(SDL_Surface * src, const SDL_Rect * srcrect,
               SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    return SDL_PrivateUpperBlitScaled(src, srcrect, dst, dstrect, SDL_FALSE);
+}
+
+int
+SDL_PrivateUpperBlitScaled(SDL_Surface * src, const SDL_Rect * srcrect,
+              SDL_Surface * dst, SDL_Rect * dstrect, SDL_bool linear)
 {
     double src_x0, src_y0, src_x1, src_y1;
     double dst_x0, dst_y0, dst_x1, dst_y1;
@@ -839,7 +904,80 @@ SDL_UpperBlitScaled(SDL_Surface * src, const SDL_Rect * srcrect,
         return 0;
     }
 
-    return SDL_LowerBlitScaled(src, &final_src, dst, &final_dst);
+    return SDL_PrivateLowerBlitScaled(src, &final_src, dst, &final_dst, linear);
+}
+
+static SDL_bool
+SDL_CanStretchLinear(const SDL_PixelFormat * format)
+{
+    return (format->BytesPerPixel == 4 &&
+            !SDL_ISPIXELFORMAT_INDEXED(format->format) &&
+            !SDL_ISPIXELFORMAT_FOURCC(format->format) &&
+            format->format != SDL_PIXELFORMAT_ARGB2101010);
+}
+
+/* Filter the source into a 32-bit surface the size of the destination,
+   then blit that with the blend mode and modulation of the source. */
+static int
+SDL_BlitScaledLinearIndirect(SDL_Surface * src, SDL_Rect * srcrect,
+                             SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    SDL_Surface *converted = NULL;
+    SDL_Surface *filtered;
+    SDL_Surface *stretch_src = src;
+    SDL_Rect *stretch_rect = srcrect;
+    SDL_Rect filtered_rect;
+    SDL_BlendMode blendMode;
+    Uint8 r, g, b, a;
+    int retval;
+
+    if (!SDL_CanStretchLinear(src->format)) {
+        SDL_Surface *view;
+
+        if (SDL_LockSurface(src) < 0) {
+            return -1;
+        }
+        view = SDL_CreateRGBSurfaceWithFormatFrom(
+            (Uint8 *)src->pixels + srcrect->y * src->pitch + srcrect->x * src->format->BytesPerPixel,
+            srcrect->w, srcrect->h, src->format->BitsPerPixel, src->pitch, src->format->format);
+        if (view) {
+            if (src->format->palette) {
+                SDL_SetSurfacePalette(view, src->format->palette);
+            }
+            converted = SDL_ConvertSurfaceFormat(view, SDL_PIXELFORMAT_ARGB8888, 0);
+            SDL_FreeSurface(view);
+        }
+        SDL_UnlockSurface(src);
+        if (!converted) {
+            return -1;
+        }
+        stretch_src = converted;
+        stretch_rect = NULL;
+    }
+
+    filtered = SDL_CreateRGBSurfaceWithFormat(0, dstrect->w, dstrect->h, 32, stretch_src->format->format);
+    if (!filtered) {
+        SDL_FreeSurface(converted);
+        return -1;
+    }
+    retval = SDL_SoftStretchLinear(stretch_src, stretch_rect, filtered, NULL);
+    if (retval == 0) {
+        SDL_GetSurfaceBlendMode(src, &blendMode);
+        SDL_GetSurfaceColorMod(src, &r, &g, &b);
+        SDL_GetSurfaceAlphaMod(src, &a);
+        SDL_SetSurfaceBlendMode(filtered, blendMode);
+        SDL_SetSurfaceColorMod(filtered, r, g, b);
+        SDL_SetSurfaceAlphaMod(filtered, a);
+
+        filtered_rect.x = 0;
+        filtered_rect.y = 0;
+        filtered_rect.w = dstrect->w;
+        filtered_rect.h = dstrect->h;
+        retval = SDL_LowerBlit(filtered, &filtered_rect, dst, dstrect);
+    }
+    SDL_FreeSurface(filtered);
+    SDL_FreeSurface(converted);
+    return retval;
 }
 
 /**
@@ -849,6 +987,13 @@ SDL_UpperBlitScaled(SDL_Surface * src, const SDL_Rect * srcrect,
 int
 SDL_LowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
                 SDL_Surface * dst, SDL_Rect * dstrect)
+{
+    return SDL_PrivateLowerBlitScaled(src, srcrect, dst, dstrect, SDL_FALSE);
+}
+
+int
+SDL_PrivateLowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
+                SDL_Surface * dst, SDL_Rect * dstrect, SDL_bool linear)
 {
     static const Uint32 complex_copy_flags = (
         SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA |
@@ -856,6 +1001,19 @@ SDL_LowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
         SDL_COPY_COLORKEY
     );
 
+    /* Filtering would smear the color key, so that always uses nearest */
+    if (linear && !(src->map->info.flags & SDL_COPY_COLORKEY) &&
+        src->format->BitsPerPixel >= 8 &&
+        !SDL_ISPIXELFORMAT_FOURCC(src->format->format)) {
+        if (!(src->map->info.flags & complex_copy_flags) &&
+            src->format->format == dst->format->format &&
+            SDL_CanStretchLinear(src->format)) {
+            return SDL_SoftStretchLinear(src, srcrect, dst, dstrect);
+        } else {
+            return SDL_BlitScaledLinearIndirect(src, srcrect, dst, dstrect);
+        }
+    }
+
     if (!(src->map->info.flags & SDL_COPY_NEAREST)) {
         src->map->info.flags |= SDL_COPY_NEAREST;
         SDL_InvalidateMap(src->map);
@@ -876,10 +1034,15 @@ SDL_LowerBlitScaled(SDL_Surface * src, SDL_Rect * srcrect,
 int
 SDL_LockSurface(SDL_Surface * surface)
 {
+    /* Views write straight into the owner's pixels */
+    if (surface->flags & SDL_SURFACEVIEW) {
+        SDL_LockSurface((SDL_Surface *) surface->lock_data);
+    }
+
     if (!surface->locked) {
         /* Perform the lock */
         if (surface->flags & SDL_RLEACCEL) {
-            SDL_UnRLESurface(surface, 1);
+            SDL_UnRLESurface(surface);
             surface->flags |= SDL_RLEACCEL;     /* save accel'd state */
         }
     }
@@ -898,7 +1061,13 @@ void
 SDL_UnlockSurface(SDL_Surface * surface)
 {
     /* Only perform an unlock if we are locked */
-    if (!surface->locked || (--surface->locked > 0)) {
+    if (!surface->locked) {
+        return;
+    }
+    if (surface->flags & SDL_SURFACEVIEW) {
+        SDL_UnlockSurface((SDL_Surface *) surface->lock_data);
+    }
+    if (--surface->locked > 0) {
         return;
     }
 
@@ -918,6 +1087,81 @@ SDL_DuplicateSurface(SDL_Surface * surface)
     return SDL_ConvertSurface(surface, surface->format, surface->flags);
 }
 
+/*
+ * Creates a surface sharing the pixels of part of an existing surface
+ */
+SDL_Surface *
+SDL_CreateSurfaceView(SDL_Surface * surface, const SDL_Rect * rect)
+{
+    SDL_Surface *owner;
+    SDL_Surface *view;
+    SDL_Rect bounds, area;
+    Uint8 *pixels;
+    const Uint32 copy_flags = (SDL_COPY_COLORKEY |
+                               SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA |
+                               SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD);
+
+    if (!surface) {
+        SDL_InvalidParamError("surface");
+        return NULL;
+    }
+    if (surface->flags & SDL_DONTFREE) {
+        SDL_SetError("Can't create a view of a surface owned by SDL");
+        return NULL;
+    }
+
+    /* Views of views share the pixels of the original surface */
+    owner = surface;
+    if (surface->flags & SDL_SURFACEVIEW) {
+        owner = (SDL_Surface *) surface->lock_data;
+    }
+
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = surface->w;
+    bounds.h = surface->h;
+    if (rect) {
+        if (!SDL_IntersectRect(rect, &bounds, &area)) {
+            area.x = area.y = area.w = area.h = 0;
+        }
+    } else {
+        area = bounds;
+    }
+    if ((area.x * surface->format->BitsPerPixel) % 8 != 0) {
+        SDL_SetError("View must start on a byte boundary");
+        return NULL;
+    }
+
+    pixels = (Uint8 *) surface->pixels + area.y * surface->pitch +
+             (area.x * surface->format->BitsPerPixel) / 8;
+    view = SDL_CreateRGBSurfaceWithFormatFrom(pixels, area.w, area.h,
+                                              surface->format->BitsPerPixel,
+                                              surface->pitch,
+                                              surface->format->format);
+    if (!view) {
+        return NULL;
+    }
+    if (surface->format->palette &&
+        SDL_SetSurfacePalette(view, surface->format->palette) < 0) {
+        SDL_FreeSurface(view);
+        return NULL;
+    }
+
+    view->map->info.flags = (surface->map->info.flags & copy_flags);
+    view->map->info.colorkey = surface->map->info.colorkey;
+    view->map->info.r = surface->map->info.r;
+    view->map->info.g = surface->map->info.g;
+    view->map->info.b = surface->map->info.b;
+    view->map->info.a = surface->map->info.a;
+
+    /* Keep the pixels alive until the view is freed */
+    view->flags |= SDL_SURFACEVIEW;
+    view->lock_data = owner;
+    ++owner->refcount;
+
+    return view;
+}
+
 /*
  * Convert a surface into the specified pixel format.
  */
@@ -989,7 +1233,7 @@ SDL_ConvertSurface(SDL_Surface * surface, const SDL_PixelFormat * format,
     bounds.y = 0;
     bounds.w = surface->w;
     bounds.h = surface->h;
-    SDL_LowerBlit(surface, &bounds, convert, &bounds);
+    SDL_ConvertBlit(surface, &bounds, convert);
 
     /* Clean up the original surface, and update converted surface */
     convert->map->info.r = copy_color.r;
@@ -1189,7 +1433,7 @@ int SDL_ConvertPixels(int width, int height,
     rect.y = 0;
     rect.w = width;
     rect.h = height;
-    return SDL_LowerBlit(&src_surface, &rect, &dst_surface, &rect);
+    return SDL_ConvertBlit(&src_surface, &rect, &dst_surface);
 }
 
 /*
@@ -1212,20 +1456,26 @@ SDL_FreeSurface(SDL_Surface * surface)
     while (surface->locked > 0) {
         SDL_UnlockSurface(surface);
     }
-    if (surface->flags & SDL_RLEACCEL) {
-        SDL_UnRLESurface(surface, 0);
-    }
+    SDL_FreeRLECache(surface);
     if (surface->format) {
         SDL_SetSurfacePalette(surface, NULL);
         SDL_FreeFormat(surface->format);
         surface->format = NULL;
     }
     if (!(surface->flags & SDL_PREALLOC)) {
-        SDL_free(surface->pixels);
+        if (surface->flags & SDL_SIMD_ALIGNED) {
+            SDL_FreePixels(surface->pixels);
+        } else {
+            SDL_free(surface->pixels);
+        }
     }
     if (surface->map) {
         SDL_FreeBlitMap(surface->map);
     }
+    if (surface->flags & SDL_SURFACEVIEW) {
+        /* Let go of the surface that owns the pixels */
+        SDL_FreeSurface((SDL_Surface *) surface->lock_data);
+    }
     SDL_free(surface);
 }
 
@@ -69,6 +69,9 @@ typedef struct SDL_WindowUserData
     struct SDL_WindowUserData *next;
 } SDL_WindowUserData;
 
+/* Frames a video driver can have in flight before reporting them displayed */
+#define SDL_PRESENT_HISTORY 8
+
 /* Define the SDL window structure, corresponding to toplevel windows */
 struct SDL_Window
 {
@@ -106,6 +109,13 @@ struct SDL_Window
     SDL_HitTest hit_test;
     void *hit_test_data;
 
+    Uint64 frame_count;
+    int present_depth;          /* presents in progress, more than 1 while nested */
+    SDL_PresentStats present_history[SDL_PRESENT_HISTORY];  /* submitted frames by frame % SDL_PRESENT_HISTORY */
+    SDL_PresentStats present_stats;     /* the last frame known to have been displayed */
+    SDL_WindowFrameCallback frame_callback;
+    void *frame_callback_data;
+
     SDL_WindowUserData *data;
 
     void *driverdata;
@@ -236,6 +246,7 @@ struct SDL_VideoDevice
     int (*UpdateWindowFramebuffer) (_THIS, SDL_Window * window, const SDL_Rect * rects, int numrects);
     void (*DestroyWindowFramebuffer) (_THIS, SDL_Window * window);
     void (*OnWindowEnter) (_THIS, SDL_Window * window);
+    int (*GetWindowVBlank) (_THIS, SDL_Window * window, Uint64 * sequence, Uint64 * timestamp);
 
     /* * * */
     /*
@@ -279,6 +290,10 @@ struct SDL_VideoDevice
      */
     void (*PumpEvents) (_THIS);
 
+    /* Block for up to timeout milliseconds until the event source has input.
+       Returns 1 if it may have events, 0 on timeout. */
+    int (*WaitEventTimeout) (_THIS, int timeout);
+
     /* Suspend the screensaver */
     void (*SuspendScreenSaver) (_THIS);
 
@@ -306,7 +321,10 @@ struct SDL_VideoDevice
 
     /* * * */
     /* Data common to all drivers */
+    SDL_VideoInitTimes init_times;
     SDL_bool is_dummy;
+    SDL_bool has_framebuffer_policy;     /* the driver knows whether a texture framebuffer is faster */
+    SDL_bool prefer_texture_framebuffer; /* ... and this is its choice */
     SDL_bool suspend_screensaver;
     int num_displays;
     SDL_VideoDisplay *displays;
@@ -441,6 +459,7 @@ extern void SDL_OnWindowEnter(SDL_Window * window);
 extern void SDL_OnWindowLeave(SDL_Window * window);
 extern void SDL_OnWindowFocusGained(SDL_Window * window);
 extern void SDL_OnWindowFocusLost(SDL_Window * window);
+extern void SDL_OnWindowPresented(SDL_Window * window, Uint64 frame, Uint64 present_time, Uint64 sequence);
 extern void SDL_UpdateWindowGrab(SDL_Window * window);
 extern SDL_Window * SDL_GetFocusWindow(void);
 
@@ -201,6 +201,11 @@ ShouldUseTextureFramebuffer()
         }
     }
 
+    /* Some drivers know without having to create a window to find out */
+    if (_this->has_framebuffer_policy) {
+        return _this->prefer_texture_framebuffer;
+    }
+
     /* Each platform has different performance characteristics */
 #if defined(__WIN32__)
     /* GDI BitBlt() is way faster than Direct3D dynamic textures right now.
@@ -368,32 +373,114 @@ SDL_CreateWindowTexture(SDL_VideoDevice *unused, SDL_Window * window, Uint32 * f
     return 0;
 }
 
+/* The cost of a texture upload call, in pixels that could be copied instead */
+#define SDL_WINDOW_TEXTURE_UPLOAD_COST  (64 * 64)
+/* With more rects than this, don't bother looking for ones to merge */
+#define SDL_WINDOW_TEXTURE_MAX_RECTS    32
+
+static int
+SDL_RectArea(const SDL_Rect * rect)
+{
+    return rect->w * rect->h;
+}
+
+/* Clip the update rects to the window and merge the ones that are cheaper
+   to upload together, returning how many are left */
+static int
+SDL_MergeWindowTextureRects(SDL_Window * window, const SDL_Rect * rects, int numrects,
+                            SDL_Rect * merged)
+{
+    SDL_Rect bounds, rect;
+    SDL_bool merging;
+    int i, j, count = 0;
+
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = window->w;
+    bounds.h = window->h;
+    for (i = 0; i < numrects; ++i) {
+        if (SDL_IntersectRect(&rects[i], &bounds, &merged[count])) {
+            ++count;
+        }
+    }
+
+    /* Merge any pair whose enclosing rect costs no more than uploading
+       both, until none are left */
+    do {
+        merging = SDL_FALSE;
+        for (i = 0; i < count; ++i) {
+            for (j = i + 1; j < count; ++j) {
+                SDL_UnionRect(&merged[i], &merged[j], &rect);
+                if (SDL_RectArea(&rect) <= SDL_RectArea(&merged[i]) + SDL_RectArea(&merged[j]) + SDL_WINDOW_TEXTURE_UPLOAD_COST) {
+                    merged[i] = rect;
+                    merged[j] = merged[--count];
+                    merging = SDL_TRUE;
+                    --j;
+                }
+            }
+        }
+    } while (merging);
+
+    return count;
+}
+
+static int
+SDL_UpdateWindowTextureRect(SDL_WindowTextureData *data, const SDL_Rect * rect)
+{
+    const void *src = (const void *)((const Uint8 *)data->pixels +
+                                     rect->y * data->pitch +
+                                     rect->x * data->bytes_per_pixel);
+
+    return SDL_UpdateTexture(data->texture, rect, src, data->pitch);
+}
+
 static int
 SDL_UpdateWindowTexture(SDL_VideoDevice *unused, SDL_Window * window, const SDL_Rect * rects, int numrects)
 {
     SDL_WindowTextureData *data;
-    SDL_Rect rect;
-    void *src;
+    SDL_Rect merged[SDL_WINDOW_TEXTURE_MAX_RECTS];
+    SDL_Rect span;
+    SDL_RendererStats stats;
+    int i, count = 0, area = 0;
 
     data = SDL_GetWindowData(window, SDL_WINDOWTEXTUREDATA);
     if (!data || !data->texture) {
         return SDL_SetError("No window texture data");
     }
 
-    /* Update a single rect that contains subrects for best DMA performance */
-    if (SDL_GetSpanEnclosingRect(window->w, window->h, numrects, rects, &rect)) {
-        src = (void *)((Uint8 *)data->pixels +
-                        rect.y * data->pitch +
-                        rect.x * data->bytes_per_pixel);
-        if (SDL_UpdateTexture(data->texture, &rect, src, data->pitch) < 0) {
-            return -1;
+    /* A single span of rows that contains all the rects is one contiguous
+       upload, which is best for DMA, but it can be much larger than the
+       rects themselves. Upload them separately when that's cheaper. */
+    if (!SDL_GetSpanEnclosingRect(window->w, window->h, numrects, rects, &span)) {
+        return 0;
+    }
+    if (numrects <= SDL_WINDOW_TEXTURE_MAX_RECTS) {
+        count = SDL_MergeWindowTextureRects(window, rects, numrects, merged);
+        for (i = 0; i < count; ++i) {
+            area += SDL_RectArea(&merged[i]);
         }
+    }
 
-        if (SDL_RenderCopy(data->renderer, data->texture, NULL, NULL) < 0) {
+    if (count > 0 && area + (count - 1) * SDL_WINDOW_TEXTURE_UPLOAD_COST < SDL_RectArea(&span)) {
+        for (i = 0; i < count; ++i) {
+            if (SDL_UpdateWindowTextureRect(data, &merged[i]) < 0) {
+                return -1;
+            }
+        }
+    } else {
+        if (SDL_UpdateWindowTextureRect(data, &span) < 0) {
             return -1;
         }
+    }
 
-        SDL_RenderPresent(data->renderer);
+    if (SDL_RenderCopy(data->renderer, data->texture, NULL, NULL) < 0) {
+        return -1;
+    }
+
+    SDL_RenderPresent(data->renderer);
+
+    if (SDL_GetRendererStats(data->renderer, &stats) == 0) {
+        window->present_history[window->frame_count % SDL_PRESENT_HISTORY].upload_bytes = stats.upload_bytes;
     }
     return 0;
 }
@@ -467,6 +554,7 @@ int
 SDL_VideoInit(const char *driver_name)
 {
     SDL_VideoDevice *video;
+    Uint64 start, connect_start, driver_start;
     int index;
     int i;
 
@@ -478,6 +566,7 @@ SDL_VideoInit(const char *driver_name)
 #if !SDL_TIMERS_DISABLED
     SDL_TicksInit();
 #endif
+    start = SDL_GetPerformanceCounter();
 
     /* Start the event loop */
     if (SDL_InitSubSystem(SDL_INIT_EVENTS) < 0 ||
@@ -488,6 +577,7 @@ SDL_VideoInit(const char *driver_name)
     }
 
     /* Select the proper video driver */
+    connect_start = SDL_GetPerformanceCounter();
     index = 0;
     video = NULL;
     if (driver_name == NULL) {
@@ -521,7 +611,8 @@ SDL_VideoInit(const char *driver_name)
     _this = video;
     _this->name = bootstrap[i]->name;
     _this->next_object_id = 1;
-
+    _this->init_times.events = connect_start - start;
+    _this->init_times.connect = SDL_GetPerformanceCounter() - connect_start;
 
     /* Set some very sane GL defaults */
     _this->gl_config.driver_loaded = 0;
@@ -532,10 +623,12 @@ SDL_VideoInit(const char *driver_name)
     _this->current_glctx_tls = SDL_TLSCreate();
 
     /* Initialize the video subsystem */
+    driver_start = SDL_GetPerformanceCounter();
     if (_this->VideoInit(_this) < 0) {
         SDL_VideoQuit();
         return -1;
     }
+    _this->init_times.driver = SDL_GetPerformanceCounter() - driver_start;
 
     /* Make sure some displays were added */
     if (_this->num_displays == 0) {
@@ -572,6 +665,7 @@ SDL_VideoInit(const char *driver_name)
     }
 
     /* We're ready to go! */
+    _this->init_times.total = SDL_GetPerformanceCounter() - start;
     return 0;
 }
 
@@ -585,6 +679,19 @@ SDL_GetCurrentVideoDriver()
     return _this->name;
 }
 
+int
+SDL_GetVideoInitTimes(SDL_VideoInitTimes * times)
+{
+    if (!_this) {
+        return SDL_UninitializedVideo();
+    }
+    if (!times) {
+        return SDL_InvalidParamError("times");
+    }
+    *times = _this->init_times;
+    return 0;
+}
+
 SDL_VideoDevice *
 SDL_GetVideoDevice(void)
 {
@@ -2248,17 +2355,143 @@ SDL_UpdateWindowSurface(SDL_Window * window)
     return SDL_UpdateWindowSurfaceRects(window, &full_rect, 1);
 }
 
+/* Start counting the time spent presenting the next frame.
+   Presenting the window surface through a texture swaps the window's
+   GL buffers within it, which is still the same frame. */
+static void
+SDL_BeginPresent(SDL_Window * window, Uint64 start)
+{
+    SDL_PresentStats *stats;
+
+    if (window->present_depth++ > 0) {
+        return;
+    }
+
+    ++window->frame_count;
+    stats = &window->present_history[window->frame_count % SDL_PRESENT_HISTORY];
+    SDL_zerop(stats);
+    stats->frame = window->frame_count;
+    stats->submit_time = start;
+}
+
+static void
+SDL_EndPresent(SDL_Window * window)
+{
+    SDL_PresentStats *stats = &window->present_history[window->frame_count % SDL_PRESENT_HISTORY];
+
+    if (--window->present_depth > 0) {
+        return;
+    }
+
+    stats->return_time = SDL_GetPerformanceCounter();
+
+    /* The video driver may have displayed it before returning */
+    if (window->present_stats.frame == stats->frame) {
+        window->present_stats.return_time = stats->return_time;
+    }
+}
+
+void
+SDL_OnWindowPresented(SDL_Window * window, Uint64 frame, Uint64 present_time, Uint64 sequence)
+{
+    SDL_PresentStats *stats = &window->present_stats;
+    const SDL_PresentStats *submitted = &window->present_history[frame % SDL_PRESENT_HISTORY];
+    const Uint64 last_sequence = stats->sequence;
+
+    if (frame <= stats->frame) {
+        /* A newer frame was already reported */
+        return;
+    }
+
+    if (submitted->frame == frame) {
+        *stats = *submitted;
+    } else {
+        SDL_zerop(stats);
+        stats->frame = frame;
+    }
+    stats->present_time = present_time;
+    stats->sequence = sequence;
+    if (sequence && last_sequence && sequence > last_sequence + 1) {
+        stats->missed_vsyncs = (Uint32) (sequence - last_sequence - 1);
+    }
+}
+
 int
 SDL_UpdateWindowSurfaceRects(SDL_Window * window, const SDL_Rect * rects,
                              int numrects)
 {
+    Uint64 start;
+
     CHECK_WINDOW_MAGIC(window, -1);
 
     if (!window->surface_valid) {
         return SDL_SetError("Window surface is invalid, please call SDL_GetWindowSurface() to get a new surface");
     }
 
-    return _this->UpdateWindowFramebuffer(_this, window, rects, numrects);
+    start = SDL_GetPerformanceCounter();
+    SDL_BeginPresent(window, start);
+    if (_this->UpdateWindowFramebuffer(_this, window, rects, numrects) < 0) {
+        if (--window->present_depth == 0) {
+            --window->frame_count;
+        }
+        return -1;
+    }
+    SDL_EndPresent(window);
+
+    if (window->frame_callback) {
+        SDL_WindowFrame frame;
+
+        frame.window = window;
+        frame.surface = window->surface;
+        frame.rects = rects;
+        frame.numrects = numrects;
+        frame.frame = window->frame_count;
+        frame.timestamp = start;
+        frame.present_duration = SDL_GetPerformanceCounter() - start;
+        window->frame_callback(window->frame_callback_data, &frame);
+    }
+    return 0;
+}
+
+int
+SDL_SetWindowFrameCallback(SDL_Window * window, SDL_WindowFrameCallback callback, void *userdata)
+{
+    CHECK_WINDOW_MAGIC(window, -1);
+
+    window->frame_callback = callback;
+    window->frame_callback_data = userdata;
+
+    return 0;
+}
+
+int
+SDL_GetWindowVBlank(SDL_Window * window, Uint64 * sequence, Uint64 * timestamp)
+{
+    CHECK_WINDOW_MAGIC(window, -1);
+
+    if (!_this->GetWindowVBlank) {
+        return SDL_Unsupported();
+    }
+    return _this->GetWindowVBlank(_this, window, sequence, timestamp);
+}
+
+int
+SDL_GetWindowPresentStats(SDL_Window * window, SDL_PresentStats * stats)
+{
+    CHECK_WINDOW_MAGIC(window, -1);
+
+    if (!stats) {
+        return SDL_InvalidParamError("stats");
+    }
+
+    if (window->present_stats.frame) {
+        *stats = window->present_stats;
+    } else if (window->frame_count) {
+        *stats = window->present_history[window->frame_count % SDL_PRESENT_HISTORY];
+    } else {
+        return SDL_SetError("No frames have been presented in this window");
+    }
+    return 0;
 }
 
 int
@@ -3518,7 +3751,9 @@ SDL_GL_SwapWindow(SDL_Window * window)
         return;
     }
 
+    SDL_BeginPresent(window, SDL_GetPerformanceCounter());
     _this->GL_SwapWindow(_this, window);
+    SDL_EndPresent(window);
 }
 
 void
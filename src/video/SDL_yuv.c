@@ -21,8 +21,10 @@
 #include "../SDL_internal.h"
 
 #include "SDL_endian.h"
+#include "SDL_hints.h"
 #include "SDL_video.h"
 #include "SDL_pixels_c.h"
+#include "../thread/SDL_parallel_c.h"
 
 #include "yuv2rgb/yuv_rgb.h"
 
@@ -178,216 +180,151 @@ static int GetYUVPlanes(int width, int height, Uint32 format, const void *yuv, i
     return 0;
 }
 
-static SDL_bool yuv_rgb_sse(
-    Uint32 src_format, Uint32 dst_format,
-	Uint32 width, Uint32 height, 
-	const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride, 
-	Uint8 *rgb, Uint32 rgb_stride, 
-	YCbCrType yuv_type)
-{
-#ifdef __SSE2__
-    if (!SDL_HasSSE2()) {
-        return SDL_FALSE;
-    }
+typedef void (*YUVToRGBFunc)(
+	uint32_t width, uint32_t height, 
+	const uint8_t *y, const uint8_t *u, const uint8_t *v, uint32_t y_stride, uint32_t uv_stride, 
+	uint8_t *rgb, uint32_t rgb_stride, 
+	YCbCrType yuv_type);
 
-    if (src_format == SDL_PIXELFORMAT_YV12 ||
-        src_format == SDL_PIXELFORMAT_IYUV) {
-
-        switch (dst_format) {
-        case SDL_PIXELFORMAT_RGB565:
-            yuv420_rgb565_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB24:
-            yuv420_rgb24_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGBX8888:
-        case SDL_PIXELFORMAT_RGBA8888:
-            yuv420_rgba_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGRX8888:
-        case SDL_PIXELFORMAT_BGRA8888:
-            yuv420_bgra_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB888:
-        case SDL_PIXELFORMAT_ARGB8888:
-            yuv420_argb_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGR888:
-        case SDL_PIXELFORMAT_ABGR8888:
-            yuv420_abgr_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        default:
-            break;
-        }
-    }
+#define YUV_TO_RGB_FUNCS(impl) { \
+    { yuv420_rgb565_##impl, yuv420_rgb24_##impl, yuv420_rgba_##impl, yuv420_bgra_##impl, yuv420_argb_##impl, yuv420_abgr_##impl }, \
+    { yuv422_rgb565_##impl, yuv422_rgb24_##impl, yuv422_rgba_##impl, yuv422_bgra_##impl, yuv422_argb_##impl, yuv422_abgr_##impl }, \
+    { yuvnv12_rgb565_##impl, yuvnv12_rgb24_##impl, yuvnv12_rgba_##impl, yuvnv12_bgra_##impl, yuvnv12_argb_##impl, yuvnv12_abgr_##impl } \
+}
 
-    if (src_format == SDL_PIXELFORMAT_YUY2 ||
-        src_format == SDL_PIXELFORMAT_UYVY ||
-        src_format == SDL_PIXELFORMAT_YVYU) {
+/* Rows of the source image per chroma row, as a shift */
+static int GetYUVChromaRowShift(Uint32 format)
+{
+    return IsPlanar2x2Format(format) ? 1 : 0;
+}
 
-        switch (dst_format) {
-        case SDL_PIXELFORMAT_RGB565:
-            yuv422_rgb565_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB24:
-            yuv422_rgb24_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGBX8888:
-        case SDL_PIXELFORMAT_RGBA8888:
-            yuv422_rgba_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGRX8888:
-        case SDL_PIXELFORMAT_BGRA8888:
-            yuv422_bgra_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB888:
-        case SDL_PIXELFORMAT_ARGB8888:
-            yuv422_argb_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGR888:
-        case SDL_PIXELFORMAT_ABGR8888:
-            yuv422_abgr_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        default:
-            break;
-        }
-    }
+typedef enum
+{
+    YUV_SIMD_NONE,
+    YUV_SIMD_128,   /* SSE2 or NEON */
+    YUV_SIMD_AVX2
+} YUVConversionSIMD;
 
-    if (src_format == SDL_PIXELFORMAT_NV12 ||
-        src_format == SDL_PIXELFORMAT_NV21) {
+static YUVConversionSIMD GetYUVConversionSIMD(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_YUV_CONVERSION_SIMD);
 
-        switch (dst_format) {
-        case SDL_PIXELFORMAT_RGB565:
-            yuvnv12_rgb565_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB24:
-            yuvnv12_rgb24_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGBX8888:
-        case SDL_PIXELFORMAT_RGBA8888:
-            yuvnv12_rgba_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGRX8888:
-        case SDL_PIXELFORMAT_BGRA8888:
-            yuvnv12_bgra_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB888:
-        case SDL_PIXELFORMAT_ARGB8888:
-            yuvnv12_argb_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGR888:
-        case SDL_PIXELFORMAT_ABGR8888:
-            yuvnv12_abgr_sseu(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        default:
-            break;
-        }
+    if (hint == NULL || *hint == '\0' || SDL_strcasecmp(hint, "avx2") == 0) {
+        return YUV_SIMD_AVX2;
     }
-#endif
-    return SDL_FALSE;
+    if (SDL_strcasecmp(hint, "sse2") == 0 || SDL_strcasecmp(hint, "neon") == 0) {
+        return YUV_SIMD_128;
+    }
+    return YUV_SIMD_NONE;
 }
 
-static SDL_bool yuv_rgb_std(
-    Uint32 src_format, Uint32 dst_format,
-	Uint32 width, Uint32 height, 
-	const Uint8 *y, const Uint8 *u, const Uint8 *v, Uint32 y_stride, Uint32 uv_stride, 
-	Uint8 *rgb, Uint32 rgb_stride, 
-	YCbCrType yuv_type)
+static YUVToRGBFunc GetYUVToRGBFunc(Uint32 src_format, Uint32 dst_format)
 {
-    if (src_format == SDL_PIXELFORMAT_YV12 ||
-        src_format == SDL_PIXELFORMAT_IYUV) {
+    static const YUVToRGBFunc std_funcs[3][6] = YUV_TO_RGB_FUNCS(std);
+#ifdef __SSE2__
+    static const YUVToRGBFunc sse_funcs[3][6] = YUV_TO_RGB_FUNCS(sseu);
+#if HAVE_AVX2_INTRINSICS
+    static const YUVToRGBFunc avx2_funcs[3][6] = YUV_TO_RGB_FUNCS(avx2);
+#endif
+#endif
+#ifdef __ARM_NEON
+    static const YUVToRGBFunc neon_funcs[3][6] = YUV_TO_RGB_FUNCS(neon);
+#endif
+    int yuv_layout, rgb_layout;
+    YUVConversionSIMD simd;
 
-        switch (dst_format) {
-        case SDL_PIXELFORMAT_RGB565:
-            yuv420_rgb565_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB24:
-            yuv420_rgb24_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGBX8888:
-        case SDL_PIXELFORMAT_RGBA8888:
-            yuv420_rgba_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGRX8888:
-        case SDL_PIXELFORMAT_BGRA8888:
-            yuv420_bgra_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB888:
-        case SDL_PIXELFORMAT_ARGB8888:
-            yuv420_argb_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGR888:
-        case SDL_PIXELFORMAT_ABGR8888:
-            yuv420_abgr_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        default:
-            break;
-        }
+    switch (src_format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+        yuv_layout = 0;
+        break;
+    case SDL_PIXELFORMAT_YUY2:
+    case SDL_PIXELFORMAT_UYVY:
+    case SDL_PIXELFORMAT_YVYU:
+        yuv_layout = 1;
+        break;
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+        yuv_layout = 2;
+        break;
+    default:
+        return NULL;
     }
 
-    if (src_format == SDL_PIXELFORMAT_YUY2 ||
-        src_format == SDL_PIXELFORMAT_UYVY ||
-        src_format == SDL_PIXELFORMAT_YVYU) {
-
-        switch (dst_format) {
-        case SDL_PIXELFORMAT_RGB565:
-            yuv422_rgb565_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB24:
-            yuv422_rgb24_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGBX8888:
-        case SDL_PIXELFORMAT_RGBA8888:
-            yuv422_rgba_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGRX8888:
-        case SDL_PIXELFORMAT_BGRA8888:
-            yuv422_bgra_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB888:
-        case SDL_PIXELFORMAT_ARGB8888:
-            yuv422_argb_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGR888:
-        case SDL_PIXELFORMAT_ABGR8888:
-            yuv422_abgr_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        default:
-            break;
-        }
+    switch (dst_format) {
+    case SDL_PIXELFORMAT_RGB565:
+        rgb_layout = 0;
+        break;
+    case SDL_PIXELFORMAT_RGB24:
+        rgb_layout = 1;
+        break;
+    case SDL_PIXELFORMAT_RGBX8888:
+    case SDL_PIXELFORMAT_RGBA8888:
+        rgb_layout = 2;
+        break;
+    case SDL_PIXELFORMAT_BGRX8888:
+    case SDL_PIXELFORMAT_BGRA8888:
+        rgb_layout = 3;
+        break;
+    case SDL_PIXELFORMAT_RGB888:
+    case SDL_PIXELFORMAT_ARGB8888:
+        rgb_layout = 4;
+        break;
+    case SDL_PIXELFORMAT_BGR888:
+    case SDL_PIXELFORMAT_ABGR8888:
+        rgb_layout = 5;
+        break;
+    default:
+        return NULL;
     }
 
-    if (src_format == SDL_PIXELFORMAT_NV12 ||
-        src_format == SDL_PIXELFORMAT_NV21) {
+    simd = GetYUVConversionSIMD();
 
-        switch (dst_format) {
-        case SDL_PIXELFORMAT_RGB565:
-            yuvnv12_rgb565_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB24:
-            yuvnv12_rgb24_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGBX8888:
-        case SDL_PIXELFORMAT_RGBA8888:
-            yuvnv12_rgba_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGRX8888:
-        case SDL_PIXELFORMAT_BGRA8888:
-            yuvnv12_bgra_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_RGB888:
-        case SDL_PIXELFORMAT_ARGB8888:
-            yuvnv12_argb_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        case SDL_PIXELFORMAT_BGR888:
-        case SDL_PIXELFORMAT_ABGR8888:
-            yuvnv12_abgr_std(width, height, y, u, v, y_stride, uv_stride, rgb, rgb_stride, yuv_type);
-            return SDL_TRUE;
-        default:
-            break;
-        }
+#ifdef __SSE2__
+#if HAVE_AVX2_INTRINSICS
+    if (simd >= YUV_SIMD_AVX2 && SDL_HasAVX2()) {
+        return avx2_funcs[yuv_layout][rgb_layout];
     }
-    return SDL_FALSE;
+#endif
+    if (simd >= YUV_SIMD_128 && SDL_HasSSE2()) {
+        return sse_funcs[yuv_layout][rgb_layout];
+    }
+#endif
+#ifdef __ARM_NEON
+    if (simd >= YUV_SIMD_128 && SDL_HasNEON()) {
+        return neon_funcs[yuv_layout][rgb_layout];
+    }
+#endif
+    return std_funcs[yuv_layout][rgb_layout];
+}
+
+/* Images smaller than this many pixels per thread are converted on one thread */
+#define YUV_TO_RGB_PARALLEL_PIXELS  (64 * 1024)
+
+typedef struct
+{
+    YUVToRGBFunc func;
+    Uint32 width;
+    const Uint8 *y;
+    const Uint8 *u;
+    const Uint8 *v;
+    Uint32 y_stride;
+    Uint32 uv_stride;
+    int uv_row_shift;
+    Uint8 *rgb;
+    Uint32 rgb_stride;
+    YCbCrType yuv_type;
+} YUVToRGBJob;
+
+static void YUVToRGBBand(void *data, int start, int end)
+{
+    const YUVToRGBJob *job = (const YUVToRGBJob *)data;
+    const Uint32 uv_offset = (Uint32)(start >> job->uv_row_shift) * job->uv_stride;
+
+    job->func(job->width, (Uint32)(end - start),
+              job->y + (Uint32)start * job->y_stride, job->u + uv_offset, job->v + uv_offset,
+              job->y_stride, job->uv_stride,
+              job->rgb + (Uint32)start * job->rgb_stride, job->rgb_stride, job->yuv_type);
 }
 
 int
@@ -401,6 +338,7 @@ SDL_ConvertPixels_YUV_to_RGB(int width, int height,
     Uint32 y_stride = 0;
     Uint32 uv_stride = 0;
     YCbCrType yuv_type = YCBCR_601;
+    YUVToRGBFunc func;
 
     if (GetYUVPlanes(width, height, src_format, src, src_pitch, &y, &u, &v, &y_stride, &uv_stride) < 0) {
         return -1;
@@ -410,11 +348,22 @@ SDL_ConvertPixels_YUV_to_RGB(int width, int height,
         return -1;
     }
 
-    if (yuv_rgb_sse(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
-        return 0;
-    }
-
-    if (yuv_rgb_std(src_format, dst_format, width, height, y, u, v, y_stride, uv_stride, (Uint8*)dst, dst_pitch, yuv_type)) {
+    func = GetYUVToRGBFunc(src_format, dst_format);
+    if (func) {
+        /* Each pair of rows shares a chroma row in the 2x2 formats, so bands start on even rows */
+        YUVToRGBJob job;
+        job.func = func;
+        job.width = width;
+        job.y = y;
+        job.u = u;
+        job.v = v;
+        job.y_stride = y_stride;
+        job.uv_stride = uv_stride;
+        job.uv_row_shift = GetYUVChromaRowShift(src_format);
+        job.rgb = (Uint8 *)dst;
+        job.rgb_stride = dst_pitch;
+        job.yuv_type = yuv_type;
+        SDL_ParallelFor(height, 1 << job.uv_row_shift, YUV_TO_RGB_PARALLEL_PIXELS / SDL_max(width, 1), YUVToRGBBand, &job);
         return 0;
     }
 
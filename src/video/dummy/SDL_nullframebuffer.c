@@ -22,34 +22,224 @@
 
 #if SDL_VIDEO_DRIVER_DUMMY
 
+#include "SDL_hints.h"
+#include "SDL_timer.h"
 #include "../SDL_sysvideo.h"
 #include "SDL_nullframebuffer_c.h"
 
+#if defined(__LINUX__) || defined(__MACOSX__) || defined(__FREEBSD__) || defined(__NETBSD__) || defined(__OPENBSD__)
+#define DUMMY_HAVE_SHM  1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
 
 #define DUMMY_SURFACE   "_SDL_DummySurface"
 
+#define DUMMY_FRAME_MAGIC   0x46534453  /* "SDSF" in memory on little endian */
+#define DUMMY_RING_MAGIC    0x52534453  /* "SDSR" */
+#define DUMMY_RING_SLOTS    3
+#define DUMMY_RING_HEADER   64
+
+/* Written before the pixels of every raw frame */
+typedef struct
+{
+    Uint32 magic;
+    Uint32 window_id;
+    Uint32 format;
+    Uint32 w;
+    Uint32 h;
+    Uint32 pitch;
+    Uint64 frame;
+    Uint64 timestamp;   /* nanoseconds */
+} DUMMY_FrameHeader;
+
+/* Start of the shared memory ring, followed by the slots */
+typedef struct
+{
+    Uint32 magic;
+    Uint32 slots;
+    Uint32 slot_size;
+    SDL_atomic_t latest;
+} DUMMY_RingHeader;
+
+typedef struct
+{
+    SDL_Surface *surface;
+    Uint64 frame;
+    SDL_RWops *output;
+#if DUMMY_HAVE_SHM
+    Uint8 *ring;
+    size_t ring_size;
+#endif
+} DUMMY_Framebuffer;
+
+static void
+DUMMY_DestroyFramebuffer(DUMMY_Framebuffer *framebuffer)
+{
+    if (!framebuffer) {
+        return;
+    }
+    if (framebuffer->output) {
+        SDL_RWclose(framebuffer->output);
+    }
+#if DUMMY_HAVE_SHM
+    if (framebuffer->ring) {
+        munmap(framebuffer->ring, framebuffer->ring_size);
+    }
+#endif
+    SDL_FreeSurface(framebuffer->surface);
+    SDL_free(framebuffer);
+}
+
+#if DUMMY_HAVE_SHM
+/* The ring is a file of its own for each window, so it can be mapped by another process */
+static int
+DUMMY_CreateRing(DUMMY_Framebuffer *framebuffer, const char *path, SDL_Window * window)
+{
+    const size_t slot_size = (DUMMY_RING_HEADER + (size_t) window->w * window->h * 4 + 63) & ~(size_t) 63;
+    DUMMY_RingHeader *header;
+    char file[4096];
+    int fd;
+
+    SDL_snprintf(file, sizeof(file), "%s-%u", path, (unsigned int) SDL_GetWindowID(window));
+    fd = open(file, O_RDWR | O_CREAT, 0600);
+    if (fd < 0) {
+        return SDL_SetError("Couldn't open %s", file);
+    }
+    framebuffer->ring_size = DUMMY_RING_HEADER + DUMMY_RING_SLOTS * slot_size;
+    if (ftruncate(fd, framebuffer->ring_size) < 0) {
+        close(fd);
+        return SDL_SetError("Couldn't resize %s", file);
+    }
+    framebuffer->ring = (Uint8 *) mmap(NULL, framebuffer->ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (framebuffer->ring == (Uint8 *) MAP_FAILED) {
+        framebuffer->ring = NULL;
+        return SDL_SetError("Couldn't map %s", file);
+    }
+
+    header = (DUMMY_RingHeader *) framebuffer->ring;
+    header->magic = DUMMY_RING_MAGIC;
+    header->slots = DUMMY_RING_SLOTS;
+    header->slot_size = (Uint32) slot_size;
+    SDL_AtomicSet(&header->latest, 0);
+    return 0;
+}
+#endif /* DUMMY_HAVE_SHM */
+
+static void
+DUMMY_FillFrameHeader(DUMMY_FrameHeader *header, SDL_Window * window, DUMMY_Framebuffer *framebuffer)
+{
+    const Uint64 counter = SDL_GetPerformanceCounter();
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+
+    header->magic = DUMMY_FRAME_MAGIC;
+    header->window_id = SDL_GetWindowID(window);
+    header->format = framebuffer->surface->format->format;
+    header->w = framebuffer->surface->w;
+    header->h = framebuffer->surface->h;
+    header->pitch = framebuffer->surface->w * 4;
+    header->frame = framebuffer->frame;
+    header->timestamp = (counter / frequency) * 1000000000 + ((counter % frequency) * 1000000000) / frequency;
+}
+
+/* Copy the rows without the surface's padding */
+static void
+DUMMY_CopyPixels(Uint8 *dst, const SDL_Surface *surface)
+{
+    const int row_bytes = surface->w * 4;
+    const Uint8 *src = (const Uint8 *) surface->pixels;
+    int y;
+
+    if (surface->pitch == row_bytes) {
+        SDL_memcpy(dst, src, (size_t) row_bytes * surface->h);
+        return;
+    }
+    for (y = 0; y < surface->h; ++y) {
+        SDL_memcpy(dst, src, row_bytes);
+        src += surface->pitch;
+        dst += row_bytes;
+    }
+}
+
+static int
+DUMMY_WriteFrame(DUMMY_Framebuffer *framebuffer, const DUMMY_FrameHeader *header)
+{
+    const SDL_Surface *surface = framebuffer->surface;
+    const Uint8 *src = (const Uint8 *) surface->pixels;
+    const size_t row_bytes = header->pitch;
+    int y;
+
+    if (SDL_RWwrite(framebuffer->output, header, sizeof(*header), 1) != 1) {
+        return -1;
+    }
+    if ((size_t) surface->pitch == row_bytes) {
+        if (SDL_RWwrite(framebuffer->output, src, row_bytes * surface->h, 1) != 1) {
+            return -1;
+        }
+        return 0;
+    }
+    for (y = 0; y < surface->h; ++y) {
+        if (SDL_RWwrite(framebuffer->output, src, row_bytes, 1) != 1) {
+            return -1;
+        }
+        src += surface->pitch;
+    }
+    return 0;
+}
+
 int SDL_DUMMY_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format, void ** pixels, int *pitch)
 {
+    DUMMY_Framebuffer *framebuffer;
     SDL_Surface *surface;
     const Uint32 surface_format = SDL_PIXELFORMAT_RGB888;
+    const char *output;
     int w, h;
     int bpp;
     Uint32 Rmask, Gmask, Bmask, Amask;
 
     /* Free the old framebuffer surface */
-    surface = (SDL_Surface *) SDL_GetWindowData(window, DUMMY_SURFACE);
-    SDL_FreeSurface(surface);
+    framebuffer = (DUMMY_Framebuffer *) SDL_SetWindowData(window, DUMMY_SURFACE, NULL);
+    DUMMY_DestroyFramebuffer(framebuffer);
 
     /* Create a new one */
+    framebuffer = (DUMMY_Framebuffer *) SDL_calloc(1, sizeof(*framebuffer));
+    if (!framebuffer) {
+        return SDL_OutOfMemory();
+    }
     SDL_PixelFormatEnumToMasks(surface_format, &bpp, &Rmask, &Gmask, &Bmask, &Amask);
     SDL_GetWindowSize(window, &w, &h);
     surface = SDL_CreateRGBSurface(0, w, h, bpp, Rmask, Gmask, Bmask, Amask);
     if (!surface) {
+        SDL_free(framebuffer);
         return -1;
     }
+    framebuffer->surface = surface;
+
+    /* Open where the frames go, if anywhere */
+    output = SDL_GetHint(SDL_HINT_VIDEO_DUMMY_OUTPUT);
+    if (output && SDL_strncmp(output, "file:", 5) == 0) {
+        framebuffer->output = SDL_RWFromFile(output + 5, "wb");
+        if (!framebuffer->output) {
+            DUMMY_DestroyFramebuffer(framebuffer);
+            return -1;
+        }
+    } else if (output && SDL_strncmp(output, "shm:", 4) == 0) {
+#if DUMMY_HAVE_SHM
+        if (DUMMY_CreateRing(framebuffer, output + 4, window) < 0) {
+            DUMMY_DestroyFramebuffer(framebuffer);
+            return -1;
+        }
+#else
+        DUMMY_DestroyFramebuffer(framebuffer);
+        return SDL_Unsupported();
+#endif
+    }
 
     /* Save the info and return! */
-    SDL_SetWindowData(window, DUMMY_SURFACE, surface);
+    SDL_SetWindowData(window, DUMMY_SURFACE, framebuffer);
     *format = surface_format;
     *pixels = surface->pixels;
     *pitch = surface->pitch;
@@ -59,29 +249,56 @@ int SDL_DUMMY_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * forma
 int SDL_DUMMY_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect * rects, int numrects)
 {
     static int frame_number;
-    SDL_Surface *surface;
+    DUMMY_Framebuffer *framebuffer;
+    DUMMY_FrameHeader header;
 
-    surface = (SDL_Surface *) SDL_GetWindowData(window, DUMMY_SURFACE);
-    if (!surface) {
+    framebuffer = (DUMMY_Framebuffer *) SDL_GetWindowData(window, DUMMY_SURFACE);
+    if (!framebuffer) {
         return SDL_SetError("Couldn't find dummy surface for window");
     }
+    ++framebuffer->frame;
 
     /* Send the data to the display */
+    if (framebuffer->output) {
+        DUMMY_FillFrameHeader(&header, window, framebuffer);
+        if (DUMMY_WriteFrame(framebuffer, &header) < 0) {
+            return -1;
+        }
+    }
+#if DUMMY_HAVE_SHM
+    if (framebuffer->ring) {
+        DUMMY_RingHeader *ring = (DUMMY_RingHeader *) framebuffer->ring;
+        Uint8 *slot = framebuffer->ring + DUMMY_RING_HEADER + (framebuffer->frame % ring->slots) * ring->slot_size;
+
+        /* Readers check the slot's frame number after copying it, so clear
+           it while the pixels are being replaced */
+        ((DUMMY_FrameHeader *) slot)->frame = 0;
+        SDL_MemoryBarrierRelease();
+        DUMMY_CopyPixels(slot + DUMMY_RING_HEADER, framebuffer->surface);
+        DUMMY_FillFrameHeader(&header, window, framebuffer);
+        SDL_memcpy(slot, &header, sizeof(header));
+        SDL_MemoryBarrierRelease();
+        SDL_AtomicSet(&ring->latest, (int) framebuffer->frame);
+    }
+#endif
     if (SDL_getenv("SDL_VIDEO_DUMMY_SAVE_FRAMES")) {
         char file[128];
         SDL_snprintf(file, sizeof(file), "SDL_window%d-%8.8d.bmp",
                      SDL_GetWindowID(window), ++frame_number);
-        SDL_SaveBMP(surface, file);
+        SDL_SaveBMP(framebuffer->surface, file);
     }
+
+    /* There's no display to wait for, the frame is out as soon as it's written */
+    SDL_OnWindowPresented(window, window->frame_count, SDL_GetPerformanceCounter(), 0);
     return 0;
 }
 
 void SDL_DUMMY_DestroyWindowFramebuffer(_THIS, SDL_Window * window)
 {
-    SDL_Surface *surface;
+    DUMMY_Framebuffer *framebuffer;
 
-    surface = (SDL_Surface *) SDL_SetWindowData(window, DUMMY_SURFACE, NULL);
-    SDL_FreeSurface(surface);
+    framebuffer = (DUMMY_Framebuffer *) SDL_SetWindowData(window, DUMMY_SURFACE, NULL);
+    DUMMY_DestroyFramebuffer(framebuffer);
 }
 
 #endif /* SDL_VIDEO_DRIVER_DUMMY */
@@ -32,10 +32,19 @@
 
 void KMSDRM_PumpEvents(_THIS)
 {
+    SDL_Window *window;
+
 #ifdef SDL_INPUT_LINUXEV
     SDL_EVDEV_Poll();
 #endif
 
+    /* Handle completed page flips, so a frame queued behind one goes on
+       screen even if the app doesn't swap again */
+    for (window = _this->windows; window; window = window->next) {
+        if (window->driverdata) {
+            KMSDRM_PollPageFlip(_this, (SDL_WindowData *) window->driverdata);
+        }
+    }
 }
 
 #endif /* SDL_VIDEO_DRIVER_KMSDRM */
@@ -0,0 +1,305 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2016 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "../../SDL_internal.h"
+
+#if SDL_VIDEO_DRIVER_KMSDRM
+
+#include <sys/mman.h>
+
+#include "SDL_log.h"
+#include "SDL_timer.h"
+
+#include "SDL_kmsdrmvideo.h"
+#include "SDL_kmsdrmframebuffer.h"
+#include "SDL_kmsdrmdyn.h"
+
+/* The window framebuffer lives in system memory, because dumb buffers are
+   usually uncached and slow to read back when blending. Updates copy the
+   damaged rectangles into a dumb buffer that isn't being scanned out, and
+   flip to it. */
+
+static void
+KMSDRM_DestroyDumbBuffer(int drm_fd, KMSDRM_DumbBuffer *buffer)
+{
+    struct drm_mode_destroy_dumb dreq;
+
+    if (buffer->pixels != NULL) {
+        munmap(buffer->pixels, buffer->size);
+        buffer->pixels = NULL;
+    }
+    if (buffer->fb_id != 0) {
+        KMSDRM_drmModeRmFB(drm_fd, buffer->fb_id);
+        buffer->fb_id = 0;
+    }
+    if (buffer->handle != 0) {
+        SDL_zero(dreq);
+        dreq.handle = buffer->handle;
+        KMSDRM_drmIoctl(drm_fd, DRM_IOCTL_MODE_DESTROY_DUMB, &dreq);
+        buffer->handle = 0;
+    }
+}
+
+static int
+KMSDRM_CreateDumbBuffer(int drm_fd, int w, int h, KMSDRM_DumbBuffer *buffer)
+{
+    struct drm_mode_create_dumb creq;
+    struct drm_mode_map_dumb mreq;
+    void *pixels;
+
+    SDL_zero(creq);
+    creq.width = w;
+    creq.height = h;
+    creq.bpp = 32;
+    if (KMSDRM_drmIoctl(drm_fd, DRM_IOCTL_MODE_CREATE_DUMB, &creq) < 0) {
+        return SDL_SetError("Couldn't create %dx%d dumb buffer", w, h);
+    }
+    buffer->handle = creq.handle;
+    buffer->pitch = creq.pitch;
+    buffer->size = creq.size;
+
+    if (KMSDRM_drmModeAddFB(drm_fd, w, h, 24, 32, buffer->pitch, buffer->handle, &buffer->fb_id) < 0) {
+        buffer->fb_id = 0;
+        KMSDRM_DestroyDumbBuffer(drm_fd, buffer);
+        return SDL_SetError("Couldn't create DRM FB for dumb buffer");
+    }
+
+    SDL_zero(mreq);
+    mreq.handle = buffer->handle;
+    if (KMSDRM_drmIoctl(drm_fd, DRM_IOCTL_MODE_MAP_DUMB, &mreq) < 0) {
+        KMSDRM_DestroyDumbBuffer(drm_fd, buffer);
+        return SDL_SetError("Couldn't map dumb buffer");
+    }
+    pixels = mmap(NULL, buffer->size, PROT_READ | PROT_WRITE, MAP_SHARED, drm_fd, mreq.offset);
+    if (pixels == MAP_FAILED) {
+        KMSDRM_DestroyDumbBuffer(drm_fd, buffer);
+        return SDL_SetError("Couldn't map dumb buffer");
+    }
+    buffer->pixels = (Uint8 *) pixels;
+    SDL_LogDebug(SDL_LOG_CATEGORY_VIDEO, "New dumb buffer DRM FB (%u): %dx%d, stride %u", buffer->fb_id, w, h, buffer->pitch);
+
+    /* Everything has to be copied in the first time */
+    buffer->damage[0].x = 0;
+    buffer->damage[0].y = 0;
+    buffer->damage[0].w = w;
+    buffer->damage[0].h = h;
+    buffer->num_damage = 1;
+    return 0;
+}
+
+static void
+KMSDRM_AddDumbDamage(KMSDRM_DumbBuffer *buffer, const SDL_Rect *rect)
+{
+    int i;
+
+    if (buffer->num_damage == KMSDRM_MAX_DUMB_DAMAGE) {
+        /* Too many to keep track of, copy everything they cover instead */
+        for (i = 1; i < buffer->num_damage; ++i) {
+            SDL_UnionRect(&buffer->damage[0], &buffer->damage[i], &buffer->damage[0]);
+        }
+        buffer->num_damage = 1;
+    }
+    buffer->damage[buffer->num_damage++] = *rect;
+}
+
+/* The pending buffer is on screen once its flip has completed */
+static void
+KMSDRM_FinishDumbFlip(SDL_WindowData *wdata)
+{
+    if (!wdata->waiting_for_flip && wdata->pending_dumb_buffer >= 0) {
+        wdata->front_dumb_buffer = wdata->pending_dumb_buffer;
+        wdata->pending_dumb_buffer = -1;
+    }
+}
+
+/* Handle a page flip event if there is one, without waiting */
+static void
+KMSDRM_PollDumbFlip(_THIS, SDL_WindowData *wdata)
+{
+    KMSDRM_PollPageFlip(_this, wdata);
+    KMSDRM_FinishDumbFlip(wdata);
+}
+
+int
+KMSDRM_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format,
+                               void ** pixels, int *pitch)
+{
+    SDL_WindowData *wdata = ((SDL_WindowData *) window->driverdata);
+    SDL_VideoData *vdata = ((SDL_VideoData *)_this->driverdata);
+    const int count = wdata->double_buffer ? 2 : KMSDRM_MAX_DUMB_BUFFERS;
+    int i;
+
+    /* Free the old framebuffer surface */
+    KMSDRM_DestroyWindowFramebuffer(_this, window);
+
+    *format = SDL_PIXELFORMAT_RGB888;
+    *pitch = window->w * 4;
+    wdata->framebuffer = SDL_calloc(window->h, *pitch);
+    if (wdata->framebuffer == NULL) {
+        return SDL_OutOfMemory();
+    }
+
+    for (i = 0; i < count; ++i) {
+        if (KMSDRM_CreateDumbBuffer(vdata->drm_fd, window->w, window->h, &wdata->dumb_buffers[i]) < 0) {
+            KMSDRM_DestroyWindowFramebuffer(_this, window);
+            return -1;
+        }
+        ++wdata->num_dumb_buffers;
+    }
+    wdata->front_dumb_buffer = -1;
+    wdata->pending_dumb_buffer = -1;
+
+    *pixels = wdata->framebuffer;
+    return 0;
+}
+
+int
+KMSDRM_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect * rects,
+                               int numrects)
+{
+    SDL_WindowData *wdata = ((SDL_WindowData *) window->driverdata);
+    SDL_DisplayData *displaydata = (SDL_DisplayData *) SDL_GetDisplayForWindow(window)->driverdata;
+    SDL_VideoData *vdata = ((SDL_VideoData *)_this->driverdata);
+    const int pitch = window->w * 4;
+    KMSDRM_DumbBuffer *buffer;
+    SDL_Rect bounds, rect;
+    SDL_bool damaged = SDL_FALSE;
+    int i, y, target = -1;
+
+    if (wdata->num_dumb_buffers == 0) {
+        return SDL_SetError("Window has no framebuffer");
+    }
+
+    /* Find a buffer that's neither on screen nor about to be */
+    KMSDRM_PollDumbFlip(_this, wdata);
+    while (target < 0) {
+        for (i = 0; i < wdata->num_dumb_buffers; ++i) {
+            if (i != wdata->front_dumb_buffer && i != wdata->pending_dumb_buffer) {
+                target = i;
+                break;
+            }
+        }
+        if (target < 0) {
+            if (!KMSDRM_WaitPageFlip(_this, wdata, -1)) {
+                return SDL_SetError("Couldn't wait for page flip");
+            }
+            KMSDRM_FinishDumbFlip(wdata);
+        }
+    }
+
+    /* Every buffer is missing this update, the target gets it now */
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = window->w;
+    bounds.h = window->h;
+    for (i = 0; i < numrects; ++i) {
+        int j;
+
+        if (!SDL_IntersectRect(&rects[i], &bounds, &rect)) {
+            continue;
+        }
+        for (j = 0; j < wdata->num_dumb_buffers; ++j) {
+            KMSDRM_AddDumbDamage(&wdata->dumb_buffers[j], &rect);
+        }
+        damaged = SDL_TRUE;
+    }
+    if (!damaged && wdata->front_dumb_buffer >= 0) {
+        return 0;
+    }
+
+    buffer = &wdata->dumb_buffers[target];
+    for (i = 0; i < buffer->num_damage; ++i) {
+        const Uint8 *src;
+        Uint8 *dst;
+
+        rect = buffer->damage[i];
+        src = (const Uint8 *) wdata->framebuffer + rect.y * pitch + rect.x * 4;
+        dst = buffer->pixels + rect.y * buffer->pitch + rect.x * 4;
+        for (y = 0; y < rect.h; ++y) {
+            SDL_memcpy(dst, src, rect.w * 4);
+            src += pitch;
+            dst += buffer->pitch;
+        }
+    }
+    buffer->num_damage = 0;
+
+    /* Only one flip can be queued at a time */
+    if (wdata->pending_dumb_buffer >= 0) {
+        if (!KMSDRM_WaitPageFlip(_this, wdata, -1)) {
+            return SDL_SetError("Couldn't wait for page flip");
+        }
+        KMSDRM_FinishDumbFlip(wdata);
+    }
+
+    if (wdata->front_dumb_buffer >= 0 &&
+        KMSDRM_drmModePageFlip(vdata->drm_fd, displaydata->crtc_id, buffer->fb_id,
+                               DRM_MODE_PAGE_FLIP_EVENT, wdata) == 0) {
+        wdata->waiting_for_flip = SDL_TRUE;
+        wdata->flip_frame = window->frame_count;
+        wdata->pending_dumb_buffer = target;
+
+        /* Wait for vsync right away for low input lag, see SDL_HINT_VIDEO_DOUBLE_BUFFER */
+        if (wdata->double_buffer) {
+            KMSDRM_WaitPageFlip(_this, wdata, -1);
+            KMSDRM_FinishDumbFlip(wdata);
+        }
+        return 0;
+    }
+
+    /* The first frame, or the CRTC isn't showing one of our buffers */
+    if (KMSDRM_drmModeSetCrtc(vdata->drm_fd, displaydata->crtc_id, buffer->fb_id,
+                              0, 0, &vdata->saved_conn_id, 1, &displaydata->cur_mode) != 0) {
+        return SDL_SetError("Could not set up CRTC to dumb buffer");
+    }
+    wdata->front_dumb_buffer = target;
+    SDL_OnWindowPresented(window, window->frame_count, SDL_GetPerformanceCounter(), 0);
+    return 0;
+}
+
+void
+KMSDRM_DestroyWindowFramebuffer(_THIS, SDL_Window * window)
+{
+    SDL_WindowData *wdata = ((SDL_WindowData *) window->driverdata);
+    SDL_VideoData *vdata = ((SDL_VideoData *)_this->driverdata);
+    int i;
+
+    if (wdata == NULL) {
+        return;
+    }
+
+    /* The buffers can't go away while a flip to one of them is queued */
+    if (wdata->pending_dumb_buffer >= 0) {
+        KMSDRM_WaitPageFlip(_this, wdata, -1);
+    }
+    for (i = 0; i < wdata->num_dumb_buffers; ++i) {
+        KMSDRM_DestroyDumbBuffer(vdata->drm_fd, &wdata->dumb_buffers[i]);
+    }
+    wdata->num_dumb_buffers = 0;
+    wdata->front_dumb_buffer = -1;
+    wdata->pending_dumb_buffer = -1;
+
+    SDL_free(wdata->framebuffer);
+    wdata->framebuffer = NULL;
+}
+
+#endif /* SDL_VIDEO_DRIVER_KMSDRM */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -24,6 +24,7 @@
 #if SDL_VIDEO_DRIVER_KMSDRM && SDL_VIDEO_OPENGL_EGL
 
 #include "SDL_log.h"
+#include "SDL_timer.h"
 
 #include "SDL_kmsdrmvideo.h"
 #include "SDL_kmsdrmopengles.h"
@@ -90,6 +91,140 @@ int KMSDRM_GLES_SetSwapInterval(_THIS, int interval) {
     return 0;
 }
 
+/* Queue a page flip to bo, holding the window's frame, at the next vblank.
+   It becomes next_bo. */
+static SDL_bool
+KMSDRM_GLES_QueueFlip(_THIS, SDL_Window * window, struct gbm_bo *bo, Uint64 frame) {
+    SDL_WindowData *wdata = ((SDL_WindowData *) window->driverdata);
+    SDL_DisplayData *displaydata = (SDL_DisplayData *) SDL_GetDisplayForWindow(window)->driverdata;
+    SDL_VideoData *vdata = ((SDL_VideoData *)_this->driverdata);
+    KMSDRM_FBInfo *fb_info;
+    int ret;
+
+    fb_info = KMSDRM_FBFromBO(_this, bo);
+    if (fb_info == NULL) {
+        return SDL_FALSE;
+    }
+    ret = KMSDRM_drmModePageFlip(vdata->drm_fd, displaydata->crtc_id, fb_info->fb_id,
+                                 DRM_MODE_PAGE_FLIP_EVENT, wdata);
+    if (ret != 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Could not queue pageflip: %d", ret);
+        return SDL_FALSE;
+    }
+    wdata->waiting_for_flip = SDL_TRUE;
+    wdata->flip_frame = frame;
+    wdata->next_bo = bo;
+    return SDL_TRUE;
+}
+
+/* Called from the page flip handler when a frame is queued behind the flip
+   that just completed: release the buffer that flip replaced on screen and
+   flip to the queued one, so it shows without waiting for another swap. */
+void
+KMSDRM_GLES_FlipQueued(_THIS, SDL_Window * window) {
+    SDL_WindowData *wdata = ((SDL_WindowData *) window->driverdata);
+    struct gbm_bo *bo = wdata->queued_bo;
+
+    if (wdata->next_bo != NULL) {
+        if (wdata->current_bo != NULL) {
+            KMSDRM_gbm_surface_release_buffer(wdata->gs, wdata->current_bo);
+        }
+        wdata->current_bo = wdata->next_bo;
+        wdata->next_bo = NULL;
+    }
+
+    wdata->queued_bo = NULL;
+    if (!KMSDRM_GLES_QueueFlip(_this, window, bo, wdata->queued_frame)) {
+        KMSDRM_gbm_surface_release_buffer(wdata->gs, bo);
+    }
+}
+
+/* Once the pending flip has completed, release the buffer it replaced on
+   screen. The page flip handler flips to a queued frame by itself.
+   timeout is as for KMSDRM_WaitPageFlip. */
+static void
+KMSDRM_GLES_RetireFlip(_THIS, SDL_Window * window, int timeout) {
+    SDL_WindowData *wdata = ((SDL_WindowData *) window->driverdata);
+
+    if (timeout == 0) {
+        KMSDRM_PollPageFlip(_this, wdata);
+    } else {
+        KMSDRM_WaitPageFlip(_this, wdata, timeout);
+    }
+    if (wdata->waiting_for_flip) {
+        return;
+    }
+
+    if (wdata->next_bo != NULL) {
+        if (wdata->current_bo != NULL) {
+            KMSDRM_gbm_surface_release_buffer(wdata->gs, wdata->current_bo);
+        }
+        wdata->current_bo = wdata->next_bo;
+        wdata->next_bo = NULL;
+    }
+}
+
+/* Triple buffering: one buffer on screen, one waiting for its flip and one
+   queued behind it, while the app renders into the last one gbm has. This
+   only waits for a flip if a frame is already queued, instead of on every
+   swap like the double buffered path. */
+static int
+KMSDRM_GLES_SwapWindowTriple(_THIS, SDL_Window * window) {
+    SDL_WindowData *wdata = ((SDL_WindowData *) window->driverdata);
+    SDL_DisplayData *displaydata = (SDL_DisplayData *) SDL_GetDisplayForWindow(window)->driverdata;
+    SDL_VideoData *vdata = ((SDL_VideoData *)_this->driverdata);
+    KMSDRM_FBInfo *fb_info;
+    struct gbm_bo *bo;
+
+    KMSDRM_GLES_RetireFlip(_this, window, 0);
+    while (wdata->queued_bo != NULL) {
+        /* The flip handler moves the queued frame up once the pending flip is done */
+        if (!KMSDRM_WaitPageFlipEvent(_this, -1)) {
+            /* The flip never came, drop the queued frame rather than hang */
+            KMSDRM_gbm_surface_release_buffer(wdata->gs, wdata->queued_bo);
+            wdata->queued_bo = NULL;
+        }
+    }
+
+    if (!(_this->egl_data->eglSwapBuffers(_this->egl_data->egl_display, wdata->egl_surface))) {
+        SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "eglSwapBuffers failed.");
+        return 0;
+    }
+
+    bo = KMSDRM_gbm_surface_lock_front_buffer(wdata->gs);
+    if (bo == NULL) {
+        SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Could not lock GBM surface front buffer");
+        return 0;
+    }
+
+    if (!wdata->crtc_ready) {
+        /* Page flips need the CRTC to be showing one of our buffers first */
+        fb_info = KMSDRM_FBFromBO(_this, bo);
+        if (fb_info == NULL ||
+            KMSDRM_drmModeSetCrtc(vdata->drm_fd, displaydata->crtc_id, fb_info->fb_id,
+                                  0, 0, &vdata->saved_conn_id, 1, &displaydata->cur_mode) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Could not set up CRTC for doing vsync-ed pageflips");
+            KMSDRM_gbm_surface_release_buffer(wdata->gs, bo);
+            return 0;
+        }
+        if (wdata->current_bo != NULL) {
+            KMSDRM_gbm_surface_release_buffer(wdata->gs, wdata->current_bo);
+        }
+        wdata->current_bo = bo;
+        wdata->crtc_ready = SDL_TRUE;
+        SDL_OnWindowPresented(window, window->frame_count, SDL_GetPerformanceCounter(), 0);
+        return 0;
+    }
+
+    if (wdata->waiting_for_flip) {
+        wdata->queued_bo = bo;
+        wdata->queued_frame = window->frame_count;
+    } else if (!KMSDRM_GLES_QueueFlip(_this, window, bo, window->frame_count)) {
+        KMSDRM_gbm_surface_release_buffer(wdata->gs, bo);
+    }
+    return 0;
+}
+
 int
 KMSDRM_GLES_SwapWindow(_THIS, SDL_Window * window) {
     SDL_WindowData *wdata = ((SDL_WindowData *) window->driverdata);
@@ -97,9 +232,18 @@ KMSDRM_GLES_SwapWindow(_THIS, SDL_Window * window) {
     SDL_VideoData *vdata = ((SDL_VideoData *)_this->driverdata);
     KMSDRM_FBInfo *fb_info;
     int ret;
+    int timeout = 0;
+
+    if (_this->egl_data->egl_swapinterval == 1 && !wdata->double_buffer) {
+        return KMSDRM_GLES_SwapWindowTriple(_this, window);
+    }
+
+    /* Put a frame left queued by triple buffering on screen first */
+    if (wdata->queued_bo != NULL) {
+        KMSDRM_GLES_RetireFlip(_this, window, -1);
+    }
 
     /* Do we still need to wait for a flip? */
-    int timeout = 0;
     if (_this->egl_data->egl_swapinterval == 1) {
         timeout = -1;
     }
@@ -149,6 +293,8 @@ KMSDRM_GLES_SwapWindow(_THIS, SDL_Window * window) {
                                     0, 0, &vdata->saved_conn_id, 1, &displaydata->cur_mode);
         if(ret != 0) {
             SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Could not pageflip with drmModeSetCrtc: %d", ret);
+        } else {
+            SDL_OnWindowPresented(window, window->frame_count, SDL_GetPerformanceCounter(), 0);
         }
     } else {
         /* Queue page flip at vsync */
@@ -162,12 +308,13 @@ KMSDRM_GLES_SwapWindow(_THIS, SDL_Window * window) {
             }
 	}
 
-        /* SDL_LogDebug(SDL_LOG_CATEGORY_VIDEO, "drmModePageFlip(%d, %u, %u, DRM_MODE_PAGE_FLIP_EVENT, &wdata->waiting_for_flip)",
+        /* SDL_LogDebug(SDL_LOG_CATEGORY_VIDEO, "drmModePageFlip(%d, %u, %u, DRM_MODE_PAGE_FLIP_EVENT, wdata)",
             vdata->drm_fd, displaydata->crtc_id, fb_info->fb_id); */
         ret = KMSDRM_drmModePageFlip(vdata->drm_fd, displaydata->crtc_id, fb_info->fb_id,
-                                     DRM_MODE_PAGE_FLIP_EVENT, &wdata->waiting_for_flip);
+                                     DRM_MODE_PAGE_FLIP_EVENT, wdata);
         if (ret == 0) {
             wdata->waiting_for_flip = SDL_TRUE;
+            wdata->flip_frame = window->frame_count;
         } else {
             SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "Could not queue pageflip: %d", ret);
         }
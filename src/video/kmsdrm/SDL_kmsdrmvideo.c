@@ -28,6 +28,7 @@
 #include "SDL_syswm.h"
 #include "SDL_log.h"
 #include "SDL_hints.h"
+#include "SDL_timer.h"
 #include "../../events/SDL_mouse_c.h"
 #include "../../events/SDL_keyboard_c.h"
 
@@ -35,9 +36,12 @@
 #include "../../core/linux/SDL_evdev.h"
 #endif
 
+#include <time.h>
+
 /* KMS/DRM declarations */
 #include "SDL_kmsdrmvideo.h"
 #include "SDL_kmsdrmevents.h"
+#include "SDL_kmsdrmframebuffer.h"
 #include "SDL_kmsdrmopengles.h"
 #include "SDL_kmsdrmmouse.h"
 #include "SDL_kmsdrmdyn.h"
@@ -135,7 +139,11 @@ KMSDRM_Create(int devindex)
     device->RestoreWindow = KMSDRM_RestoreWindow;
     device->SetWindowGrab = KMSDRM_SetWindowGrab;
     device->DestroyWindow = KMSDRM_DestroyWindow;
+    device->GetWindowVBlank = KMSDRM_GetWindowVBlank;
     device->GetWindowWMInfo = KMSDRM_GetWindowWMInfo;
+    device->CreateWindowFramebuffer = KMSDRM_CreateWindowFramebuffer;
+    device->UpdateWindowFramebuffer = KMSDRM_UpdateWindowFramebuffer;
+    device->DestroyWindowFramebuffer = KMSDRM_DestroyWindowFramebuffer;
 #if SDL_VIDEO_OPENGL_EGL
     device->GL_LoadLibrary = KMSDRM_GLES_LoadLibrary;
     device->GL_GetProcAddress = KMSDRM_GLES_GetProcAddress;
@@ -220,38 +228,94 @@ KMSDRM_FBFromBO(_THIS, struct gbm_bo *bo)
     return fb_info;
 }
 
+/* Wait for DRM events and handle them once */
 SDL_bool
-KMSDRM_WaitPageFlip(_THIS, SDL_WindowData *wdata, int timeout) {
+KMSDRM_WaitPageFlipEvent(_THIS, int timeout) {
     SDL_VideoData *vdata = ((SDL_VideoData *)_this->driverdata);
 
+    vdata->drm_pollfd.revents = 0;
+    if (poll(&vdata->drm_pollfd, 1, timeout) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "DRM poll error");
+        return SDL_FALSE;
+    }
+
+    if (vdata->drm_pollfd.revents & (POLLHUP | POLLERR)) {
+        SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "DRM poll hup or error");
+        return SDL_FALSE;
+    }
+
+    if (vdata->drm_pollfd.revents & POLLIN) {
+        /* Page flip? If so, drmHandleEvent will unset wdata->waiting_for_flip */
+        KMSDRM_drmHandleEvent(vdata->drm_fd, &vdata->drm_evctx);
+    } else {
+        /* Timed out and page flip didn't happen */
+        SDL_LogDebug(SDL_LOG_CATEGORY_VIDEO, "Dropping frame while waiting_for_flip");
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+SDL_bool
+KMSDRM_WaitPageFlip(_THIS, SDL_WindowData *wdata, int timeout) {
     while (wdata->waiting_for_flip) {
-        vdata->drm_pollfd.revents = 0;
-        if (poll(&vdata->drm_pollfd, 1, timeout) < 0) {
-            SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "DRM poll error");
+        if (!KMSDRM_WaitPageFlipEvent(_this, timeout)) {
             return SDL_FALSE;
         }
+    }
+    return SDL_TRUE;
+}
 
-        if (vdata->drm_pollfd.revents & (POLLHUP | POLLERR)) {
-            SDL_LogError(SDL_LOG_CATEGORY_VIDEO, "DRM poll hup or error");
-            return SDL_FALSE;
-        }
+void
+KMSDRM_PollPageFlip(_THIS, SDL_WindowData *wdata) {
+    SDL_VideoData *vdata = ((SDL_VideoData *)_this->driverdata);
 
-        if (vdata->drm_pollfd.revents & POLLIN) {
-            /* Page flip? If so, drmHandleEvent will unset wdata->waiting_for_flip */
+    if (wdata->waiting_for_flip) {
+        vdata->drm_pollfd.revents = 0;
+        if (poll(&vdata->drm_pollfd, 1, 0) > 0 && (vdata->drm_pollfd.revents & POLLIN)) {
             KMSDRM_drmHandleEvent(vdata->drm_fd, &vdata->drm_evctx);
-        } else {
-            /* Timed out and page flip didn't happen */
-            SDL_LogDebug(SDL_LOG_CATEGORY_VIDEO, "Dropping frame while waiting_for_flip");
-            return SDL_FALSE;
         }
     }
-    return SDL_TRUE;
+}
+
+/* Convert a CLOCK_MONOTONIC time from the kernel to performance counter ticks */
+static Uint64
+KMSDRM_GetPerformanceCounterAt(unsigned int sec, unsigned int usec)
+{
+    const Uint64 counter = SDL_GetPerformanceCounter();
+    struct timespec now;
+    Sint64 age;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    age = ((Sint64) now.tv_sec - sec) * 1000000 + (now.tv_nsec / 1000 - (Sint64) usec);
+    if (age <= 0) {
+        return counter;
+    }
+    return counter - (Uint64) age * SDL_GetPerformanceFrequency() / 1000000;
 }
 
 static void
 KMSDRM_FlipHandler(int fd, unsigned int frame, unsigned int sec, unsigned int usec, void *data)
 {
-    *((SDL_bool *) data) = SDL_FALSE;
+    SDL_WindowData *wdata = (SDL_WindowData *) data;
+
+    /* The kernel's vblank counter is 32 bits, keep counting past it wrapping */
+    if (wdata->vblank_timestamp == 0) {
+        wdata->vblank_sequence = frame;
+    } else {
+        wdata->vblank_sequence += (Uint32) (frame - (Uint32) wdata->vblank_sequence);
+    }
+    wdata->vblank_timestamp = (Uint64) sec * 1000000 + usec;
+    wdata->waiting_for_flip = SDL_FALSE;
+
+    SDL_OnWindowPresented(wdata->window, wdata->flip_frame,
+                          KMSDRM_GetPerformanceCounterAt(sec, usec), wdata->vblank_sequence);
+
+#if SDL_VIDEO_OPENGL_EGL
+    /* Triple buffering queued a frame behind this flip, show it next */
+    if (wdata->queued_bo != NULL) {
+        KMSDRM_GLES_FlipQueued(SDL_GetVideoDevice(), wdata->window);
+    }
+#endif
 }
 
 
@@ -296,12 +360,22 @@ KMSDRM_VideoInit(_THIS)
     }
     SDL_LogDebug(SDL_LOG_CATEGORY_VIDEO, "Opened DRM FD (%d)", vdata->drm_fd);
 
+    /* Without GBM there's no OpenGL, but window surfaces still work */
     vdata->gbm = KMSDRM_gbm_create_device(vdata->drm_fd);
     if (vdata->gbm == NULL) {
-        ret = SDL_SetError("Couldn't create gbm device.");
-        goto cleanup;
+        SDL_LogWarn(SDL_LOG_CATEGORY_VIDEO, "Couldn't create gbm device, OpenGL ES is not available.");
     }
 
+    /* Probing OpenGL for the window surface would create a window and set a
+       mode. Present it with OpenGL ES whenever there's a GPU to do that, and
+       with dumb buffers otherwise. */
+    _this->has_framebuffer_policy = SDL_TRUE;
+#if SDL_VIDEO_OPENGL_EGL
+    _this->prefer_texture_framebuffer = (vdata->gbm != NULL);
+#else
+    _this->prefer_texture_framebuffer = SDL_FALSE;
+#endif
+
     /* Find the first available connector with modes */
     resources = KMSDRM_drmModeGetResources(vdata->drm_fd);
     if (!resources) {
@@ -477,13 +551,61 @@ KMSDRM_SetDisplayMode(_THIS, SDL_VideoDisplay * display, SDL_DisplayMode * mode)
     return 0;
 }
 
+static void
+KMSDRM_DestroyGLSurface(_THIS, SDL_WindowData *wdata)
+{
+#if SDL_VIDEO_OPENGL_EGL
+    if (wdata->egl_surface != EGL_NO_SURFACE) {
+        SDL_EGL_DestroySurface(_this, wdata->egl_surface);
+        wdata->egl_surface = EGL_NO_SURFACE;
+    }
+#endif /* SDL_VIDEO_OPENGL_EGL */
+    if (wdata->gs != NULL) {
+        KMSDRM_gbm_surface_destroy(wdata->gs);
+        wdata->gs = NULL;
+    }
+}
+
+static int
+KMSDRM_CreateGLSurface(_THIS, SDL_Window * window, SDL_WindowData *wdata)
+{
+    SDL_VideoData *vdata = ((SDL_VideoData *)_this->driverdata);
+    Uint32 surface_fmt, surface_flags;
+
+    if (vdata->gbm == NULL) {
+        return SDL_SetError("No gbm device");
+    }
+
+    surface_fmt = GBM_FORMAT_XRGB8888;
+    surface_flags = GBM_BO_USE_SCANOUT | GBM_BO_USE_RENDERING;
+
+    if (!KMSDRM_gbm_device_is_format_supported(vdata->gbm, surface_fmt, surface_flags)) {
+        SDL_LogWarn(SDL_LOG_CATEGORY_VIDEO, "GBM surface format not supported. Trying anyway.");
+    }
+    wdata->gs = KMSDRM_gbm_surface_create(vdata->gbm, window->w, window->h, surface_fmt, surface_flags);
+
+#if SDL_VIDEO_OPENGL_EGL
+    if (!_this->egl_data) {
+        if (SDL_GL_LoadLibrary(NULL) < 0) {
+            return -1;
+        }
+    }
+    wdata->egl_surface = SDL_EGL_CreateSurface(_this, (NativeWindowType) wdata->gs);
+
+    if (wdata->egl_surface == EGL_NO_SURFACE) {
+        return SDL_SetError("Could not create EGL window surface");
+    }
+#endif /* SDL_VIDEO_OPENGL_EGL */
+
+    return 0;
+}
+
 int
 KMSDRM_CreateWindow(_THIS, SDL_Window * window)
 {
     SDL_WindowData *wdata;
     SDL_VideoDisplay *display;
-    SDL_VideoData *vdata = ((SDL_VideoData *)_this->driverdata);
-    Uint32 surface_fmt, surface_flags;
+    SDL_bool opengl = (window->flags & SDL_WINDOW_OPENGL) ? SDL_TRUE : SDL_FALSE;
 
     /* Allocate window internal data */
     wdata = (SDL_WindowData *) SDL_calloc(1, sizeof(SDL_WindowData));
@@ -492,7 +614,10 @@ KMSDRM_CreateWindow(_THIS, SDL_Window * window)
         goto error;
     }
 
+    wdata->window = window;
     wdata->waiting_for_flip = SDL_FALSE;
+    wdata->front_dumb_buffer = -1;
+    wdata->pending_dumb_buffer = -1;
     display = SDL_GetDisplayForWindow(window);
 
     /* Windows have one size for now */
@@ -502,27 +627,16 @@ KMSDRM_CreateWindow(_THIS, SDL_Window * window)
     /* Maybe you didn't ask for a fullscreen OpenGL window, but that's what you get */
     window->flags |= (SDL_WINDOW_FULLSCREEN | SDL_WINDOW_OPENGL);
 
-    surface_fmt = GBM_FORMAT_XRGB8888;
-    surface_flags = GBM_BO_USE_SCANOUT | GBM_BO_USE_RENDERING;
-
-    if (!KMSDRM_gbm_device_is_format_supported(vdata->gbm, surface_fmt, surface_flags)) {
-        SDL_LogWarn(SDL_LOG_CATEGORY_VIDEO, "GBM surface format not supported. Trying anyway.");
-    }
-    wdata->gs = KMSDRM_gbm_surface_create(vdata->gbm, window->w, window->h, surface_fmt, surface_flags);
-
-#if SDL_VIDEO_OPENGL_EGL
-    if (!_this->egl_data) {
-        if (SDL_GL_LoadLibrary(NULL) < 0) {
+    if (KMSDRM_CreateGLSurface(_this, window, wdata) < 0) {
+        if (opengl) {
             goto error;
         }
-    }
-    wdata->egl_surface = SDL_EGL_CreateSurface(_this, (NativeWindowType) wdata->gs);
 
-    if (wdata->egl_surface == EGL_NO_SURFACE) {
-        SDL_SetError("Could not create EGL window surface");
-        goto error;
+        /* The window surface doesn't need OpenGL, it uses dumb buffers */
+        SDL_LogDebug(SDL_LOG_CATEGORY_VIDEO, "No OpenGL ES for window: %s", SDL_GetError());
+        KMSDRM_DestroyGLSurface(_this, wdata);
+        window->flags &= ~SDL_WINDOW_OPENGL;
     }
-#endif /* SDL_VIDEO_OPENGL_EGL */
 
     /* In case we want low-latency, double-buffer video, we take note here */
     wdata->double_buffer = SDL_FALSE;
@@ -548,12 +662,7 @@ KMSDRM_CreateWindow(_THIS, SDL_Window * window)
 
 error:
     if (wdata != NULL) {
-#if SDL_VIDEO_OPENGL_EGL
-        if (wdata->egl_surface != EGL_NO_SURFACE)
-            SDL_EGL_DestroySurface(_this, wdata->egl_surface);
-#endif /* SDL_VIDEO_OPENGL_EGL */
-        if (wdata->gs != NULL)
-            KMSDRM_gbm_surface_destroy(wdata->gs);
+        KMSDRM_DestroyGLSurface(_this, wdata);
         SDL_free(wdata);
     }
     return -1;
@@ -566,6 +675,10 @@ KMSDRM_DestroyWindow(_THIS, SDL_Window * window)
     if(data) {
         /* Wait for any pending page flips and unlock buffer */
         KMSDRM_WaitPageFlip(_this, data, -1);
+        if (data->queued_bo != NULL) {
+            KMSDRM_gbm_surface_release_buffer(data->gs, data->queued_bo);
+            data->queued_bo = NULL;
+        }
         if (data->next_bo != NULL) {
             KMSDRM_gbm_surface_release_buffer(data->gs, data->next_bo);
             data->next_bo = NULL;
@@ -575,20 +688,36 @@ KMSDRM_DestroyWindow(_THIS, SDL_Window * window)
             data->current_bo = NULL;
         }
 #if SDL_VIDEO_OPENGL_EGL
-        SDL_EGL_MakeCurrent(_this, EGL_NO_SURFACE, EGL_NO_CONTEXT);
-        if (data->egl_surface != EGL_NO_SURFACE) {
-            SDL_EGL_DestroySurface(_this, data->egl_surface);
+        if (_this->egl_data) {
+            SDL_EGL_MakeCurrent(_this, EGL_NO_SURFACE, EGL_NO_CONTEXT);
         }
 #endif /* SDL_VIDEO_OPENGL_EGL */
-        if (data->gs != NULL) {
-            KMSDRM_gbm_surface_destroy(data->gs);
-            data->gs = NULL;
-        }
+        KMSDRM_DestroyGLSurface(_this, data);
         SDL_free(data);
         window->driverdata = NULL;
     }
 }
 
+int
+KMSDRM_GetWindowVBlank(_THIS, SDL_Window * window, Uint64 * sequence, Uint64 * timestamp)
+{
+    SDL_WindowData *wdata = (SDL_WindowData *) window->driverdata;
+
+    /* Pick up a flip that completed since the last swap */
+    KMSDRM_PollPageFlip(_this, wdata);
+
+    if (wdata->vblank_timestamp == 0) {
+        return SDL_SetError("No frame has been displayed yet");
+    }
+    if (sequence) {
+        *sequence = wdata->vblank_sequence;
+    }
+    if (timestamp) {
+        *timestamp = wdata->vblank_timestamp;
+    }
+    return 0;
+}
+
 int
 KMSDRM_CreateWindowFrom(_THIS, SDL_Window * window, const void *data)
 {
@@ -57,17 +57,45 @@ typedef struct SDL_DisplayData
 } SDL_DisplayData;
 
 
+#define KMSDRM_MAX_DUMB_BUFFERS 3
+#define KMSDRM_MAX_DUMB_DAMAGE  16
+
+typedef struct KMSDRM_DumbBuffer
+{
+    uint32_t handle;
+    uint32_t fb_id;
+    uint32_t pitch;
+    uint64_t size;
+    Uint8 *pixels;
+    /* Updates since this buffer was last written, which it's still missing */
+    SDL_Rect damage[KMSDRM_MAX_DUMB_DAMAGE];
+    int num_damage;
+} KMSDRM_DumbBuffer;
+
 typedef struct SDL_WindowData
 {
+    SDL_Window *window;
     struct gbm_surface *gs;
     struct gbm_bo *current_bo;
     struct gbm_bo *next_bo;
+    struct gbm_bo *queued_bo;   /* rendered, waiting for the flip to next_bo */
     SDL_bool waiting_for_flip;
+    Uint64 flip_frame;          /* the window frame the pending flip shows */
+    Uint64 queued_frame;        /* the window frame in queued_bo */
     SDL_bool crtc_ready;
     SDL_bool double_buffer;
 #if SDL_VIDEO_OPENGL_EGL
     EGLSurface egl_surface;
 #endif
+    /* The window framebuffer, copied into dumb buffers that are flipped to */
+    void *framebuffer;
+    KMSDRM_DumbBuffer dumb_buffers[KMSDRM_MAX_DUMB_BUFFERS];
+    int num_dumb_buffers;
+    int front_dumb_buffer;      /* being scanned out, or -1 */
+    int pending_dumb_buffer;    /* waiting for its page flip, or -1 */
+    /* The vblank at which the last page flip completed */
+    Uint64 vblank_sequence;
+    Uint64 vblank_timestamp;    /* microseconds, CLOCK_MONOTONIC */
 } SDL_WindowData;
 
 typedef struct KMSDRM_FBInfo
@@ -78,7 +106,9 @@ typedef struct KMSDRM_FBInfo
 
 /* Helper functions */
 KMSDRM_FBInfo *KMSDRM_FBFromBO(_THIS, struct gbm_bo *bo);
+SDL_bool KMSDRM_WaitPageFlipEvent(_THIS, int timeout);
 SDL_bool KMSDRM_WaitPageFlip(_THIS, SDL_WindowData *wdata, int timeout);
+void KMSDRM_PollPageFlip(_THIS, SDL_WindowData *wdata);
 
 /****************************************************************************/
 /* SDL_VideoDevice functions declaration                                    */
@@ -103,6 +133,7 @@ void KMSDRM_MinimizeWindow(_THIS, SDL_Window * window);
 void KMSDRM_RestoreWindow(_THIS, SDL_Window * window);
 void KMSDRM_SetWindowGrab(_THIS, SDL_Window * window, SDL_bool grabbed);
 void KMSDRM_DestroyWindow(_THIS, SDL_Window * window);
+int KMSDRM_GetWindowVBlank(_THIS, SDL_Window * window, Uint64 * sequence, Uint64 * timestamp);
 
 /* Window manager function */
 SDL_bool KMSDRM_GetWindowWMInfo(_THIS, SDL_Window * window,
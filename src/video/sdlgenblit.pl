@@ -85,6 +85,94 @@ my %set_rgba_string = (
     "BGRA8888" => "_pixel = ((Uint32)_B << 24) | ((Uint32)_G << 16) | ((Uint32)_R << 8) | _A;",
 );
 
+my %format_shift = (
+    "RGB888" => { "R" => 16, "G" => 8, "B" => 0 },
+    "BGR888" => { "B" => 16, "G" => 8, "R" => 0 },
+    "ARGB8888" => { "A" => 24, "R" => 16, "G" => 8, "B" => 0 },
+    "RGBA8888" => { "R" => 24, "G" => 16, "B" => 8, "A" => 0 },
+    "ABGR8888" => { "A" => 24, "B" => 16, "G" => 8, "R" => 0 },
+    "BGRA8888" => { "B" => 24, "G" => 16, "R" => 8, "A" => 0 },
+);
+
+# The instruction sets we create vector blitters for, in order of preference
+my @simd_isas = (
+    "AVX2",
+    "SSE2",
+    "NEON",
+);
+
+my %simd_guard = (
+    "AVX2" => "#if HAVE_AVX2_INTRINSICS",
+    "SSE2" => "#ifdef __SSE2__",
+    "NEON" => "#ifdef __ARM_NEON",
+);
+
+my %simd_cpu = (
+    "AVX2" => "SDL_CPU_AVX2",
+    "SSE2" => "SDL_CPU_SSE2",
+    "NEON" => "SDL_CPU_NEON",
+);
+
+my %simd_attr = (
+    "AVX2" => "SDL_TARGETING(\"avx2\") ",
+    "SSE2" => "",
+    "NEON" => "",
+);
+
+# Pixels per vector for the blend and scale loops
+my %simd_width = (
+    "AVX2" => 8,
+    "SSE2" => 4,
+    "NEON" => 8,
+);
+
+my %simd_scale_width = (
+    "AVX2" => 8,
+    "SSE2" => 4,
+    "NEON" => 4,
+);
+
+# 32-bit lane operations used to swizzle pixels between formats
+my %simd_ops = (
+    "AVX2" => {
+        "shl" => "_mm256_slli_epi32(X, N)",
+        "shr" => "_mm256_srli_epi32(X, N)",
+        "and" => "_mm256_and_si256(X, _mm256_set1_epi32((int)M))",
+        "or" => "_mm256_or_si256(X, Y)",
+    },
+    "SSE2" => {
+        "shl" => "_mm_slli_epi32(X, N)",
+        "shr" => "_mm_srli_epi32(X, N)",
+        "and" => "_mm_and_si128(X, _mm_set1_epi32((int)M))",
+        "or" => "_mm_or_si128(X, Y)",
+    },
+    "NEON" => {
+        "shl" => "vshlq_n_u32(X, N)",
+        "shr" => "vshrq_n_u32(X, N)",
+        "and" => "vandq_u32(X, vdupq_n_u32(M))",
+        "or" => "vorrq_u32(X, Y)",
+    },
+    "C" => {
+        "shl" => "(X << N)",
+        "shr" => "(X >> N)",
+        "and" => "(X & M)",
+        "or" => "X | Y",
+    },
+);
+
+# The blitters that get vector versions, as [ src, dst, modulate, blend, scale ]
+my @simd_blitters;
+foreach my $src (@src_formats) {
+    foreach my $dst (@dst_formats) {
+        # Same format stretches go through SDL_SoftStretch()
+        if ( $src ne $dst ) {
+            push(@simd_blitters, [ $src, $dst, 0, 0, 1 ]);
+        }
+    }
+}
+push(@simd_blitters, [ "ARGB8888", "ARGB8888", 0, 1, 0 ]);
+push(@simd_blitters, [ "ARGB8888", "ARGB8888", 1, 1, 0 ]);
+
 sub open_file {
     my $name = shift;
     open(FILE, ">$name.new") || die "Cant' open $name.new: $!";
@@ -139,27 +227,44 @@ extern SDL_BlitFuncEntry SDL_GeneratedBlitFuncTable[];
 __EOF__
 }
 
-sub output_copyfuncname
+sub get_copyfuncname
 {
-    my $prefix = shift;
     my $src = shift;
     my $dst = shift;
     my $modulate = shift;
     my $blend = shift;
     my $scale = shift;
-    my $args = shift;
-    my $suffix = shift;
+    my $isa = shift;
+    my $name = "SDL_Blit_${src}_${dst}";
 
-    print FILE "$prefix SDL_Blit_${src}_${dst}";
     if ( $modulate ) {
-        print FILE "_Modulate";
+        $name .= "_Modulate";
     }
     if ( $blend ) {
-        print FILE "_Blend";
+        $name .= "_Blend";
     }
     if ( $scale ) {
-        print FILE "_Scale";
+        $name .= "_Scale";
+    }
+    if ( $isa ) {
+        $name .= "_$isa";
     }
+    return $name;
+}
+
+sub output_copyfuncname
+{
+    my $prefix = shift;
+    my $src = shift;
+    my $dst = shift;
+    my $modulate = shift;
+    my $blend = shift;
+    my $scale = shift;
+    my $args = shift;
+    my $suffix = shift;
+    my $isa = shift;
+
+    print FILE "$prefix " . get_copyfuncname($src, $dst, $modulate, $blend, $scale, $isa);
     if ( $args ) {
         print FILE "(SDL_BlitInfo *info)";
     }
@@ -437,14 +542,515 @@ sub output_copyinc
 #include "SDL_blit.h"
 #include "SDL_blit_auto.h"
 
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
+
+__EOF__
+}
+
+sub get_copyflags
+{
+    my $modulate = shift;
+    my $blend = shift;
+    my $scale = shift;
+    my @flags;
+
+    if ( $modulate ) {
+        push(@flags, "SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA");
+    }
+    if ( $blend ) {
+        push(@flags, "SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD");
+    }
+    if ( $scale ) {
+        push(@flags, "SDL_COPY_NEAREST");
+    }
+    if ( !@flags ) {
+        return "0";
+    }
+    return join(" | ", @flags);
+}
+
+sub simd_op
+{
+    my $isa = shift;
+    my $op = shift;
+    my $x = shift;
+    my $y = shift;
+    my $string = $simd_ops{$isa}{$op};
+
+    $string =~ s/X/$x/;
+    if ( $op eq "and" ) {
+        $y = sprintf("0x%08X", $y);
+        $string =~ s/M/$y/;
+    } elsif ( $op eq "or" ) {
+        $string =~ s/Y/$y/;
+    } else {
+        $string =~ s/N/$y/;
+    }
+    return $string;
+}
+
+sub simd_const
+{
+    my $isa = shift;
+    my $value = sprintf("0x%08X", shift);
+
+    if ( $isa eq "AVX2" ) {
+        return "_mm256_set1_epi32((int)$value)";
+    } elsif ( $isa eq "SSE2" ) {
+        return "_mm_set1_epi32((int)$value)";
+    } elsif ( $isa eq "NEON" ) {
+        return "vdupq_n_u32($value)";
+    }
+    return $value;
+}
+
+# Returns an expression converting the pixels in $var from $src to $dst,
+# giving the same results as get_rgba() followed by set_rgba().
+sub simd_swizzle
+{
+    my $isa = shift;
+    my $src = shift;
+    my $dst = shift;
+    my $var = shift;
+    my %masks;
+    my $fill = 0;
+    my @terms;
+
+    if ( $src eq $dst ) {
+        return $var;
+    }
+
+    foreach my $channel ("R", "G", "B", "A") {
+        if ( !defined($format_shift{$dst}{$channel}) ) {
+            next;
+        }
+        my $dshift = $format_shift{$dst}{$channel};
+        if ( defined($format_shift{$src}{$channel}) ) {
+            my $delta = $dshift - $format_shift{$src}{$channel};
+            $masks{$delta} = ($masks{$delta} || 0) | (0xFF << $dshift);
+        } else {
+            $fill |= (0xFF << $dshift);
+        }
+    }
+
+    foreach my $delta (sort { $b <=> $a } keys %masks) {
+        my $term = $var;
+        my $kept = 0xFFFFFFFF;
+        if ( $delta > 0 ) {
+            $term = simd_op($isa, "shl", $term, $delta);
+            $kept = (0xFFFFFFFF << $delta) & 0xFFFFFFFF;
+        } elsif ( $delta < 0 ) {
+            $term = simd_op($isa, "shr", $term, -$delta);
+            $kept = 0xFFFFFFFF >> -$delta;
+        }
+        if ( $masks{$delta} != $kept ) {
+            $term = simd_op($isa, "and", $term, $masks{$delta});
+        }
+        push(@terms, $term);
+    }
+    if ( $fill ) {
+        push(@terms, simd_const($isa, $fill));
+    }
+
+    my $string = pop(@terms);
+    while ( @terms ) {
+        $string = simd_op($isa, "or", pop(@terms), $string);
+    }
+    return $string;
+}
+
+sub output_simd_helpers
+{
+    my $isa = shift;
+
+    if ( $isa eq "AVX2" ) {
+        print FILE <<__EOF__;
+/* x / 255 for products of two 8-bit values, exactly as the C code does it */
+SDL_TARGETING("avx2") static SDL_INLINE __m256i SDL_Blit_Div255_AVX2(__m256i x)
+{
+    return _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(x, _mm256_set1_epi16(1)), _mm256_srli_epi16(x, 8)), 8);
+}
+
+/* Blends ARGB8888 pixels widened to 16 bits per channel */
+SDL_TARGETING("avx2") static SDL_INLINE __m256i SDL_Blit_Blend16_AVX2(__m256i s, __m256i d, __m256i modulate, int flags)
+{
+    const __m256i alpha = _mm256_broadcastsi128_si256(_mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0));
+    const __m256i c255 = _mm256_set1_epi16(255);
+    __m256i sA;
+
+    if (flags & (SDL_COPY_MODULATE_COLOR|SDL_COPY_MODULATE_ALPHA)) {
+        s = SDL_Blit_Div255_AVX2(_mm256_mullo_epi16(s, modulate));
+    }
+    sA = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(s, 0xFF), 0xFF);
+    if (flags & (SDL_COPY_BLEND|SDL_COPY_ADD)) {
+        s = SDL_Blit_Div255_AVX2(_mm256_mullo_epi16(s, _mm256_or_si256(_mm256_andnot_si256(alpha, sA), _mm256_and_si256(alpha, c255))));
+    }
+    switch (flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) {
+    case SDL_COPY_BLEND:
+        d = _mm256_add_epi16(s, SDL_Blit_Div255_AVX2(_mm256_mullo_epi16(_mm256_sub_epi16(c255, sA), d)));
+        break;
+    case SDL_COPY_ADD:
+        d = _mm256_or_si256(_mm256_and_si256(alpha, d), _mm256_andnot_si256(alpha, _mm256_min_epi16(_mm256_add_epi16(s, d), c255)));
+        break;
+    case SDL_COPY_MOD:
+        d = _mm256_or_si256(_mm256_and_si256(alpha, d), _mm256_andnot_si256(alpha, SDL_Blit_Div255_AVX2(_mm256_mullo_epi16(s, d))));
+        break;    default:
+        /* Only modulation, the result replaces the destination */
+        d = s;
+        break;
+    }
+    return d;
+}
+
+SDL_TARGETING("avx2") static SDL_INLINE __m256i SDL_Blit_BlendARGB8888_AVX2(__m256i s, __m256i d, __m256i modulate, int flags)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i lo = SDL_Blit_Blend16_AVX2(_mm256_unpacklo_epi8(s, zero), _mm256_unpacklo_epi8(d, zero), modulate, flags);
+    const __m256i hi = SDL_Blit_Blend16_AVX2(_mm256_unpackhi_epi8(s, zero), _mm256_unpackhi_epi8(d, zero), modulate, flags);
+    return _mm256_packus_epi16(lo, hi);
+}
+
+__EOF__
+    } elsif ( $isa eq "SSE2" ) {
+        print FILE <<__EOF__;
+/* x / 255 for products of two 8-bit values, exactly as the C code does it */
+static SDL_INLINE __m128i SDL_Blit_Div255_SSE2(__m128i x)
+{
+    return _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(x, _mm_set1_epi16(1)), _mm_srli_epi16(x, 8)), 8);
+}
+
+/* Blends ARGB8888 pixels widened to 16 bits per channel */
+static SDL_INLINE __m128i SDL_Blit_Blend16_SSE2(__m128i s, __m128i d, __m128i modulate, int flags)
+{
+    const __m128i alpha = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i c255 = _mm_set1_epi16(255);
+    __m128i sA;
+
+    if (flags & (SDL_COPY_MODULATE_COLOR|SDL_COPY_MODULATE_ALPHA)) {
+        s = SDL_Blit_Div255_SSE2(_mm_mullo_epi16(s, modulate));
+    }
+    sA = _mm_shufflehi_epi16(_mm_shufflelo_epi16(s, 0xFF), 0xFF);
+    if (flags & (SDL_COPY_BLEND|SDL_COPY_ADD)) {
+        s = SDL_Blit_Div255_SSE2(_mm_mullo_epi16(s, _mm_or_si128(_mm_andnot_si128(alpha, sA), _mm_and_si128(alpha, c255))));
+    }
+    switch (flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) {
+    case SDL_COPY_BLEND:
+        d = _mm_add_epi16(s, SDL_Blit_Div255_SSE2(_mm_mullo_epi16(_mm_sub_epi16(c255, sA), d)));
+        break;
+    case SDL_COPY_ADD:
+        d = _mm_or_si128(_mm_and_si128(alpha, d), _mm_andnot_si128(alpha, _mm_min_epi16(_mm_add_epi16(s, d), c255)));
+        break;
+    case SDL_COPY_MOD:
+        d = _mm_or_si128(_mm_and_si128(alpha, d), _mm_andnot_si128(alpha, SDL_Blit_Div255_SSE2(_mm_mullo_epi16(s, d))));
+        break;    default:
+        /* Only modulation, the result replaces the destination */
+        d = s;
+        break;
+    }
+    return d;
+}
+
+static SDL_INLINE __m128i SDL_Blit_BlendARGB8888_SSE2(__m128i s, __m128i d, __m128i modulate, int flags)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i lo = SDL_Blit_Blend16_SSE2(_mm_unpacklo_epi8(s, zero), _mm_unpacklo_epi8(d, zero), modulate, flags);
+    const __m128i hi = SDL_Blit_Blend16_SSE2(_mm_unpackhi_epi8(s, zero), _mm_unpackhi_epi8(d, zero), modulate, flags);
+    return _mm_packus_epi16(lo, hi);
+}
+
+__EOF__
+    } elsif ( $isa eq "NEON" ) {
+        print FILE <<__EOF__;
+/* x / 255 for products of two 8-bit values, exactly as the C code does it */
+static SDL_INLINE uint8x8_t SDL_Blit_Div255_NEON(uint16x8_t x)
+{
+    return vmovn_u16(vshrq_n_u16(vaddq_u16(vaddq_u16(x, vdupq_n_u16(1)), vshrq_n_u16(x, 8)), 8));
+}
+
+/* Blends ARGB8888 pixels split into B, G, R and A planes by vld4_u8() */
+static SDL_INLINE uint8x8x4_t SDL_Blit_BlendARGB8888_NEON(uint8x8x4_t s, uint8x8x4_t d, uint8x8x4_t modulate, int flags)
+{
+    int i;
+
+    if (flags & (SDL_COPY_MODULATE_COLOR|SDL_COPY_MODULATE_ALPHA)) {
+        for (i = 0; i < 4; ++i) {
+            s.val[i] = SDL_Blit_Div255_NEON(vmull_u8(s.val[i], modulate.val[i]));
+        }
+    }
+    if (flags & (SDL_COPY_BLEND|SDL_COPY_ADD)) {
+        for (i = 0; i < 3; ++i) {
+            s.val[i] = SDL_Blit_Div255_NEON(vmull_u8(s.val[i], s.val[3]));
+        }
+    }
+    switch (flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) {
+    case SDL_COPY_BLEND:
+        for (i = 0; i < 4; ++i) {
+            d.val[i] = vadd_u8(s.val[i], SDL_Blit_Div255_NEON(vmull_u8(vmvn_u8(s.val[3]), d.val[i])));
+        }
+        break;
+    case SDL_COPY_ADD:
+        for (i = 0; i < 3; ++i) {
+            d.val[i] = vqadd_u8(s.val[i], d.val[i]);
+        }
+        break;
+    case SDL_COPY_MOD:
+        for (i = 0; i < 3; ++i) {
+            d.val[i] = SDL_Blit_Div255_NEON(vmull_u8(s.val[i], d.val[i]));
+        }
+        break;    default:
+        /* Only modulation, the result replaces the destination */
+        d = s;
+        break;
+    }
+    return d;
+}
+
+__EOF__
+    }
+}
+
+sub output_simd_blendfunc
+{
+    my $isa = shift;
+    my $src = shift;
+    my $dst = shift;
+    my $modulate = shift;
+    my $width = $simd_width{$isa};
+    my $type;
+    my $load;
+    my $loadbuf;
+    my $store;
+    my $storebuf;
+
+    if ( $isa eq "AVX2" ) {
+        $type = "__m256i";
+        $load = "_mm256_loadu_si256((const __m256i *)P)";
+        $store = "_mm256_storeu_si256((__m256i *)P, V)";
+    } elsif ( $isa eq "SSE2" ) {
+        $type = "__m128i";
+        $load = "_mm_loadu_si128((const __m128i *)P)";
+        $store = "_mm_storeu_si128((__m128i *)P, V)";
+    } else {
+        $type = "uint8x8x4_t";
+        $load = "vld4_u8((const Uint8 *)P)";
+        $store = "vst4_u8((Uint8 *)P, V)";
+    }
+    my $loadsrc = $load;
+    my $loaddst = $load;
+    my $storedst = $store;
+    $loadsrc =~ s/P/src/;
+    $loaddst =~ s/P/dst/;
+    $storedst =~ s/P/dst/;
+    $storedst =~ s/V/SDL_Blit_BlendARGB8888_${isa}($loadsrc, $loaddst, modulate, flags)/;
+    my $loadsrcbuf = $load;
+    my $loaddstbuf = $load;
+    my $storedstbuf = $store;
+    $loadsrcbuf =~ s/P/srcbuf/;
+    $loaddstbuf =~ s/P/dstbuf/;
+    $storedstbuf =~ s/P/dstbuf/;
+    $storedstbuf =~ s/V/SDL_Blit_BlendARGB8888_${isa}($loadsrcbuf, $loaddstbuf, modulate, flags)/;
+
+    output_copyfuncname("$simd_attr{$isa}static void", $src, $dst, $modulate, 1, 0, 1, "\n", $isa);
+    print FILE <<__EOF__;
+{
+__EOF__
+    if ( $modulate ) {
+        print FILE <<__EOF__;
+    const int flags = info->flags;
+__EOF__
+    } else {
+        print FILE <<__EOF__;
+    const int flags = info->flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD);
+__EOF__
+    }
+    print FILE <<__EOF__;
+    const Uint8 modulateR = (flags & SDL_COPY_MODULATE_COLOR) ? info->r : 255;
+    const Uint8 modulateG = (flags & SDL_COPY_MODULATE_COLOR) ? info->g : 255;
+    const Uint8 modulateB = (flags & SDL_COPY_MODULATE_COLOR) ? info->b : 255;
+    const Uint8 modulateA = (flags & SDL_COPY_MODULATE_ALPHA) ? info->a : 255;
+__EOF__
+    if ( $isa eq "AVX2" ) {
+        print FILE <<__EOF__;
+    const __m256i modulate = _mm256_broadcastsi128_si256(_mm_set_epi16(modulateA, modulateR, modulateG, modulateB, modulateA, modulateR, modulateG, modulateB));
+__EOF__
+    } elsif ( $isa eq "SSE2" ) {
+        print FILE <<__EOF__;
+    const __m128i modulate = _mm_set_epi16(modulateA, modulateR, modulateG, modulateB, modulateA, modulateR, modulateG, modulateB);
+__EOF__
+    } else {
+        print FILE <<__EOF__;
+    uint8x8x4_t modulate;
+
+    modulate.val[0] = vdup_n_u8(modulateB);
+    modulate.val[1] = vdup_n_u8(modulateG);
+    modulate.val[2] = vdup_n_u8(modulateR);
+    modulate.val[3] = vdup_n_u8(modulateA);
+__EOF__
+    }
+    print FILE <<__EOF__;
+
+    while (info->dst_h--) {
+        const $format_type{$src} *src = (const $format_type{$src} *)info->src;
+        $format_type{$dst} *dst = ($format_type{$dst} *)info->dst;
+        int n = info->dst_w;
+        while (n >= $width) {
+            $storedst;
+            src += $width;
+            dst += $width;
+            n -= $width;
+        }
+        if (n > 0) {
+            /* Run the last few pixels through a full vector */
+            $format_type{$src} srcbuf[$width];
+            $format_type{$dst} dstbuf[$width];
+            SDL_zero(srcbuf);
+            SDL_zero(dstbuf);
+            SDL_memcpy(srcbuf, src, n * sizeof(*src));
+            SDL_memcpy(dstbuf, dst, n * sizeof(*dst));
+            $storedstbuf;
+            SDL_memcpy(dst, dstbuf, n * sizeof(*dst));
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
 __EOF__
 }
 
+sub output_simd_scalefunc
+{
+    my $isa = shift;
+    my $src = shift;
+    my $dst = shift;
+    my $width = $simd_scale_width{$isa};
+    my $swizzle = simd_swizzle($isa, $src, $dst, "pixels");
+    my $swizzle_c = simd_swizzle("C", $src, $dst, "pixel");
+
+    output_copyfuncname("$simd_attr{$isa}static void", $src, $dst, 0, 0, 1, 1, "\n", $isa);
+    print FILE <<__EOF__;
+{
+    int *srcxs;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+    int i;
+
+    srcxs = SDL_stack_alloc(int, info->dst_w);
+    if (!srcxs) {
+__EOF__
+    output_copyfuncname("       ", $src, $dst, 0, 0, 1, 0, "(info);\n");
+    print FILE <<__EOF__;
+        return;
+    }
+
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    /* Every row samples the same columns, so step through them once */
+    srcx = -1;
+    posx = 0x10000L;
+    for (i = 0; i < info->dst_w; ++i) {
+        while (posx >= 0x10000L) {
+            ++srcx;
+            posx -= 0x10000L;
+        }
+        srcxs[i] = srcx;
+        posx += incx;
+    }
+
+    srcy = 0;
+    posy = 0;
+    while (info->dst_h--) {
+        const $format_type{$src} *src;
+        $format_type{$dst} *dst = ($format_type{$dst} *)info->dst;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        src = (const $format_type{$src} *)(info->src + (srcy * info->src_pitch));
+        for (i = 0; i + $width <= info->dst_w; i += $width) {
+__EOF__
+    if ( $isa eq "AVX2" ) {
+        print FILE <<__EOF__;
+            __m256i pixels = _mm256_i32gather_epi32((const int *)src, _mm256_loadu_si256((const __m256i *)&srcxs[i]), 4);
+            pixels = $swizzle;
+            _mm256_storeu_si256((__m256i *)&dst[i], pixels);
+__EOF__
+    } elsif ( $isa eq "SSE2" ) {
+        print FILE <<__EOF__;
+            __m128i pixels = _mm_set_epi32(src[srcxs[i + 3]], src[srcxs[i + 2]], src[srcxs[i + 1]], src[srcxs[i]]);
+            pixels = $swizzle;
+            _mm_storeu_si128((__m128i *)&dst[i], pixels);
+__EOF__
+    } else {
+        print FILE <<__EOF__;
+            uint32x4_t pixels = vdupq_n_u32(src[srcxs[i]]);
+            pixels = vsetq_lane_u32(src[srcxs[i + 1]], pixels, 1);
+            pixels = vsetq_lane_u32(src[srcxs[i + 2]], pixels, 2);
+            pixels = vsetq_lane_u32(src[srcxs[i + 3]], pixels, 3);
+            pixels = $swizzle;
+            vst1q_u32(&dst[i], pixels);
+__EOF__
+    }
+    print FILE <<__EOF__;
+        }
+        for ( ; i < info->dst_w; ++i) {
+            const Uint32 pixel = src[srcxs[i]];
+            dst[i] = $swizzle_c;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+    SDL_stack_free(srcxs);
+}
+
+__EOF__
+}
+
+sub output_simd_funcs
+{
+    foreach my $isa (@simd_isas) {
+        print FILE <<__EOF__;
+$simd_guard{$isa}
+
+__EOF__
+        output_simd_helpers($isa);
+        foreach my $blitter (@simd_blitters) {
+            my ($src, $dst, $modulate, $blend, $scale) = @$blitter;
+            if ( $scale ) {
+                output_simd_scalefunc($isa, $src, $dst);
+            } else {
+                output_simd_blendfunc($isa, $src, $dst, $modulate);
+            }
+        }
+        (my $guard = $simd_guard{$isa}) =~ s/^#if(def)? //;
+        print FILE <<__EOF__;
+#endif /* $guard */
+
+__EOF__
+    }
+}
+
 sub output_copyfunctable
 {
     print FILE <<__EOF__;
 SDL_BlitFuncEntry SDL_GeneratedBlitFuncTable[] = {
 __EOF__
+    # The vector versions come first so SDL_ChooseBlitFunc() prefers them
+    foreach my $isa (@simd_isas) {
+        (my $guard = $simd_guard{$isa}) =~ s/^#if(def)? //;
+        print FILE "$simd_guard{$isa}\n";
+        foreach my $blitter (@simd_blitters) {
+            my ($src, $dst, $modulate, $blend, $scale) = @$blitter;
+            my $flags = get_copyflags($modulate, $blend, $scale);
+            print FILE "    { SDL_PIXELFORMAT_$src, SDL_PIXELFORMAT_$dst, ($flags), $simd_cpu{$isa},";
+            output_copyfuncname("", $src, $dst, $modulate, $blend, $scale, 0, " },\n", $isa);
+        }
+        print FILE "#endif /* $guard */\n";
+    }
     for (my $i = 0; $i <= $#src_formats; ++$i) {
         my $src = $src_formats[$i];
         for (my $j = 0; $j <= $#dst_formats; ++$j) {
@@ -453,38 +1059,9 @@ __EOF__
                 for (my $blend = 0; $blend <= 1; ++$blend) {
                     for (my $scale = 0; $scale <= 1; ++$scale) {
                         if ( $modulate || $blend || $scale ) {
-                            print FILE "    { SDL_PIXELFORMAT_$src, SDL_PIXELFORMAT_$dst, ";
-                            my $flags = "";
-                            my $flag = "";
-                            if ( $modulate ) {
-                                $flag = "SDL_COPY_MODULATE_COLOR | SDL_COPY_MODULATE_ALPHA";
-                                if ( $flags eq "" ) {
-                                    $flags = $flag;
-                                } else {
-                                    $flags = "$flags | $flag";
-                                }
-                            }
-                            if ( $blend ) {
-                                $flag = "SDL_COPY_BLEND | SDL_COPY_ADD | SDL_COPY_MOD";
-                                if ( $flags eq "" ) {
-                                    $flags = $flag;
-                                } else {
-                                    $flags = "$flags | $flag";
-                                }
-                            }
-                            if ( $scale ) {
-                                $flag = "SDL_COPY_NEAREST";
-                                if ( $flags eq "" ) {
-                                    $flags = $flag;
-                                } else {
-                                    $flags = "$flags | $flag";
-                                }
-                            }
-                            if ( $flags eq "" ) {
-                                $flags = "0";
-                            }
-                            print FILE "($flags), SDL_CPU_ANY,";
-                            output_copyfuncname("", $src_formats[$i], $dst_formats[$j], $modulate, $blend, $scale, 0, " },\n");
+                            my $flags = get_copyflags($modulate, $blend, $scale);
+                            print FILE "    { SDL_PIXELFORMAT_$src, SDL_PIXELFORMAT_$dst, ($flags), SDL_CPU_ANY,";
+                            output_copyfuncname("", $src, $dst, $modulate, $blend, $scale, 0, " },\n");
                         }
                     }
                 }
@@ -514,6 +1091,321 @@ sub output_copyfunc_c
     }
 }
 
+sub output_testfile
+{
+    my $name = shift;
+
+    open(FILE, ">$name.new") || die "Cant' open $name.new: $!";
+    print FILE <<__EOF__;
+/* DO NOT EDIT!  This file is generated by sdlgenblit.pl */
+/**
+ * Generated blitter test suite
+ *
+ * SDL_blit_auto.c has vector versions of some of its blitters, and picks
+ * them whenever the CPU supports them. These tests check that every one of
+ * them gives exactly the same pixels as the C code it was generated from.
+ * Set SDL_BLIT_CPU_FEATURES to test a particular instruction set.
+ */
+
+#include "SDL.h"
+#include "SDL_test.h"
+
+__EOF__
+
+    # Copy the flags and blit info from SDL_blit.h for the reference blitters
+    open(HEADER, "<SDL_blit.h") || die "Can't open SDL_blit.h: $!";
+    my @header = <HEADER>;
+    close HEADER;
+    foreach my $line (@header) {
+        if ( $line =~ /^#define SDL_COPY_(MODULATE|BLEND|ADD|MOD|NEAREST)/ ) {
+            print FILE $line;
+        }
+    }
+    print FILE <<__EOF__;
+
+typedef struct
+{
+    Uint8 *src;
+    int src_w, src_h;
+    int src_pitch;
+    Uint8 *dst;
+    int dst_w, dst_h;
+    int dst_pitch;
+    int flags;
+    Uint8 r, g, b, a;
+} SDL_BlitInfo;
+
+typedef struct
+{
+    Uint32 src_format;
+    Uint32 dst_format;
+    void (*blit)(SDL_BlitInfo *info);
+    const char *name;
+} BlitReference;
+
+/* ================= Reference blitters ================== */
+
+/* *INDENT-OFF* */
+
+__EOF__
+    # SDL_BLENDMODE_NONE with color or alpha mod is checked against the
+    # plain modulate blitter, which the vector blend blitters also cover
+    my @references = @simd_blitters;
+    foreach my $blitter (@simd_blitters) {
+        my ($src, $dst, $modulate, $blend, $scale) = @$blitter;
+        if ( $modulate && $blend && !$scale ) {
+            push(@references, [ $src, $dst, 1, 0, 0 ]);
+        }
+    }
+    foreach my $blitter (@references) {
+        output_copyfunc(@$blitter);
+    }
+    print FILE <<__EOF__;
+/* *INDENT-ON* */
+
+static const BlitReference scaleReferences[] = {
+__EOF__
+    foreach my $blitter (@simd_blitters) {
+        my ($src, $dst, $modulate, $blend, $scale) = @$blitter;
+        if ( $scale ) {
+            my $name = get_copyfuncname($src, $dst, $modulate, $blend, $scale);
+            print FILE "    { SDL_PIXELFORMAT_$src, SDL_PIXELFORMAT_$dst, $name, \"$name\" },\n";
+        }
+    }
+    print FILE <<__EOF__;
+};
+
+static const BlitReference blendReferences[] = {
+__EOF__
+    foreach my $blitter (@references) {
+        my ($src, $dst, $modulate, $blend, $scale) = @$blitter;
+        if ( !$scale ) {
+            my $name = get_copyfuncname($src, $dst, $modulate, $blend, $scale);
+            print FILE "    { SDL_PIXELFORMAT_$src, SDL_PIXELFORMAT_$dst, $name, \"$name\" },\n";
+        }
+    }
+    print FILE <<__EOF__;
+};
+
+/* ================= Test Case Implementation ================== */
+
+/* Helper functions */
+
+static SDL_Surface *
+_blitCreateRandomSurface(Uint32 format, int w, int h)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, format);
+    int i;
+
+    SDLTest_AssertCheck(surface != NULL, "Verify surface creation, expected: not NULL, got: %s", surface ? "not NULL" : SDL_GetError());
+    if (surface) {
+        for (i = 0; i < surface->h * surface->pitch; ++i) {
+            ((Uint8 *)surface->pixels)[i] = SDLTest_RandomUint8();
+        }
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    }
+    return surface;
+}
+
+/* Runs the reference blitter on a copy of dst and compares it with what SDL did */
+static int
+_blitCompare(const BlitReference *reference, SDL_BlitInfo *info, SDL_Surface *src, SDL_Surface *dst, const Uint8 *original)
+{
+    const int size = dst->h * dst->pitch;
+    Uint8 *expected = (Uint8 *)SDL_malloc(size);
+    int i, mismatches = 0;
+
+    SDLTest_AssertCheck(expected != NULL, "Verify allocation of %d bytes", size);
+    if (!expected) {
+        return 1;
+    }
+    SDL_memcpy(expected, original, size);
+    info->src = (Uint8 *)src->pixels;
+    info->src_w = src->w;
+    info->src_h = src->h;
+    info->src_pitch = src->pitch;
+    info->dst = expected;
+    info->dst_w = dst->w;
+    info->dst_h = dst->h;
+    info->dst_pitch = dst->pitch;
+    reference->blit(info);
+
+    for (i = 0; i < size; ++i) {
+        if (expected[i] != ((Uint8 *)dst->pixels)[i]) {
+            ++mismatches;
+        }
+    }
+    SDL_free(expected);
+
+    SDLTest_AssertCheck(mismatches == 0, "Validate %s %dx%d -> %dx%d flags 0x%x, expected: 0 mismatched bytes, got: %d", reference->name, src->w, src->h, dst->w, dst->h, info->flags, mismatches);
+    return mismatches;
+}
+
+/* Test case functions */
+
+/**
+ * \@brief Tests that scaled blits give the same results as the C blitters
+ */
+int
+blit_testScaled(void *arg)
+{
+    static const int sizes[][4] = {
+        { 37, 13, 61, 29 }, { 61, 29, 17, 11 }, { 8, 8, 33, 1 }, { 1, 1, 9, 5 }, { 100, 3, 64, 6 }
+    };
+    int i, j;
+
+    for (i = 0; i < SDL_arraysize(scaleReferences); ++i) {
+        const BlitReference *reference = &scaleReferences[i];
+
+        for (j = 0; j < SDL_arraysize(sizes); ++j) {
+            SDL_Surface *src = _blitCreateRandomSurface(reference->src_format, sizes[j][0], sizes[j][1]);
+            SDL_Surface *dst = _blitCreateRandomSurface(reference->dst_format, sizes[j][2], sizes[j][3]);
+            Uint8 *original = dst ? (Uint8 *)SDL_malloc(dst->h * dst->pitch) : NULL;
+            SDL_BlitInfo info;
+            int ret;
+
+            if (src && dst && original) {
+                SDL_memcpy(original, dst->pixels, dst->h * dst->pitch);
+                ret = SDL_BlitScaled(src, NULL, dst, NULL);
+                SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitScaled, expected: 0, got: %i", ret);
+
+                SDL_zero(info);
+                info.flags = SDL_COPY_NEAREST;
+                _blitCompare(reference, &info, src, dst, original);
+            }
+            SDL_free(original);
+            SDL_FreeSurface(dst);
+            SDL_FreeSurface(src);
+        }
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * \@brief Tests that blended blits give the same results as the C blitters
+ */
+int
+blit_testBlended(void *arg)
+{
+    /* Blend mode and color/alpha mod, avoiding the cases SDL_blit_A.c handles */
+    static const struct {
+        SDL_BlendMode mode;
+        Uint8 r, g, b, a;
+    } modes[] = {
+        { SDL_BLENDMODE_ADD, 255, 255, 255, 255 },
+        { SDL_BLENDMODE_MOD, 255, 255, 255, 255 },
+        { SDL_BLENDMODE_BLEND, 200, 100, 0, 255 },
+        { SDL_BLENDMODE_BLEND, 17, 255, 128, 99 },
+        { SDL_BLENDMODE_ADD, 255, 255, 255, 128 },
+        { SDL_BLENDMODE_ADD, 1, 254, 77, 200 },
+        { SDL_BLENDMODE_MOD, 33, 66, 99, 255 },
+        { SDL_BLENDMODE_MOD, 255, 255, 255, 0 },
+        { SDL_BLENDMODE_NONE, 200, 100, 50, 255 },
+        { SDL_BLENDMODE_NONE, 255, 255, 255, 128 }
+    };
+    static const int widths[] = { 1, 3, 8, 13, 64, 71 };
+    int i, j, k;
+
+    for (i = 0; i < SDL_arraysize(modes); ++i) {
+        int flags = 0;
+        const BlitReference *reference = NULL;
+
+        switch (modes[i].mode) {
+        case SDL_BLENDMODE_BLEND:
+            flags |= SDL_COPY_BLEND;
+            break;
+        case SDL_BLENDMODE_ADD:
+            flags |= SDL_COPY_ADD;
+            break;
+        case SDL_BLENDMODE_MOD:
+            flags |= SDL_COPY_MOD;
+            break;
+        default:
+            break;
+        }
+        if (modes[i].r != 255 || modes[i].g != 255 || modes[i].b != 255) {
+            flags |= SDL_COPY_MODULATE_COLOR;
+        }
+        if (modes[i].a != 255) {
+            flags |= SDL_COPY_MODULATE_ALPHA;
+        }
+
+        for (j = 0; j < SDL_arraysize(blendReferences); ++j) {
+            const SDL_bool modulated = (SDL_strstr(blendReferences[j].name, "_Modulate") != NULL);
+            const SDL_bool blended = (SDL_strstr(blendReferences[j].name, "_Blend") != NULL);
+            if (modulated == ((flags & (SDL_COPY_MODULATE_COLOR|SDL_COPY_MODULATE_ALPHA)) != 0) &&
+                blended == ((flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) != 0)) {
+                reference = &blendReferences[j];
+            } else {
+                continue;
+            }
+
+            for (k = 0; k < SDL_arraysize(widths); ++k) {
+                SDL_Surface *src = _blitCreateRandomSurface(reference->src_format, widths[k], 5);
+                SDL_Surface *dst = _blitCreateRandomSurface(reference->dst_format, widths[k], 5);
+                Uint8 *original = dst ? (Uint8 *)SDL_malloc(dst->h * dst->pitch) : NULL;
+                SDL_BlitInfo info;
+                int ret;
+
+                if (src && dst && original) {
+                    SDL_memcpy(original, dst->pixels, dst->h * dst->pitch);
+                    SDL_SetSurfaceBlendMode(src, modes[i].mode);
+                    SDL_SetSurfaceColorMod(src, modes[i].r, modes[i].g, modes[i].b);
+                    SDL_SetSurfaceAlphaMod(src, modes[i].a);
+                    ret = SDL_BlitSurface(src, NULL, dst, NULL);
+                    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+
+                    SDL_zero(info);
+                    info.flags = flags;
+                    info.r = modes[i].r;
+                    info.g = modes[i].g;
+                    info.b = modes[i].b;
+                    info.a = modes[i].a;
+                    _blitCompare(reference, &info, src, dst, original);
+                }
+                SDL_free(original);
+                SDL_FreeSurface(dst);
+                SDL_FreeSurface(src);
+            }
+        }
+    }
+
+    return TEST_COMPLETED;
+}
+
+/* ================= Test References ================== */
+
+/* Blit test cases */
+static const SDLTest_TestCaseReference blitTest1 =
+        { (SDLTest_TestCaseFp)blit_testScaled, "blit_testScaled", "Tests scaled blits against the C blitters.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference blitTest2 =
+        { (SDLTest_TestCaseFp)blit_testBlended, "blit_testBlended", "Tests blended blits against the C blitters.", TEST_ENABLED};
+
+/* Sequence of Blit test cases */
+static const SDLTest_TestCaseReference *blitTests[] =  {
+    &blitTest1, &blitTest2, NULL
+};
+
+/* Blit test suite (global) */
+SDLTest_TestSuiteReference blitTestSuite = {
+    "Blit",
+    NULL,
+    blitTests,
+    NULL
+};
+
+/* vi: set ts=4 sw=4 expandtab: */
+__EOF__
+    close FILE;
+    if ( ! -f $name || system("cmp -s $name $name.new") != 0 ) {
+        rename("$name.new", "$name");
+    } else {
+        unlink("$name.new");
+    }
+}
+
 open_file("SDL_blit_auto.h");
 output_copydefs();
 for (my $i = 0; $i <= $#src_formats; ++$i) {
@@ -531,5 +1423,8 @@ for (my $i = 0; $i <= $#src_formats; ++$i) {
         output_copyfunc_c($src_formats[$i], $dst_formats[$j]);
     }
 }
+output_simd_funcs();
 output_copyfunctable();
 close_file("SDL_blit_auto.c");
+
+output_testfile("../../test/testautomation_blit.c");
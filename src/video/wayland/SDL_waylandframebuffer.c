@@ -0,0 +1,340 @@
+/*
+  Simple DirectMedia Layer
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely, subject to the following restrictions:
+
+  1. The origin of this software must not be misrepresented; you must not
+     claim that you wrote the original software. If you use this software
+     in a product, an acknowledgment in the product documentation would be
+     appreciated but is not required.
+  2. Altered source versions must be plainly marked as such, and must not be
+     misrepresented as being the original software.
+  3. This notice may not be removed or altered from any source distribution.
+*/
+
+#include "../../SDL_internal.h"
+
+#if SDL_VIDEO_DRIVER_WAYLAND
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <limits.h>
+
+#include "../SDL_sysvideo.h"
+#include "SDL_timer.h"
+#include "SDL_waylandvideo.h"
+#include "SDL_waylandwindow.h"
+#include "SDL_waylandframebuffer.h"
+#include "SDL_waylanddyn.h"
+
+#ifndef MFD_CLOEXEC
+#define MFD_CLOEXEC 0x0001U
+#endif
+
+/* The window framebuffer lives in system memory, and updates copy the
+   damaged rectangles into a wl_shm buffer the compositor isn't reading.
+   The buffers come from one memfd pool, and are only created when every
+   existing one is still held by the compositor. */
+
+int
+Wayland_CreateShmFile(off_t size)
+{
+    static const char template[] = "/sdl-shared-XXXXXX";
+    char *xdg_path;
+    char tmp_path[PATH_MAX];
+    int fd = -1;
+
+#ifdef SYS_memfd_create
+    fd = (int) syscall(SYS_memfd_create, "SDL", MFD_CLOEXEC);
+#endif
+    if (fd < 0) {
+        /* No memfd, use an unlinked file in the runtime directory */
+        xdg_path = SDL_getenv("XDG_RUNTIME_DIR");
+        if (!xdg_path) {
+            return -1;
+        }
+
+        SDL_strlcpy(tmp_path, xdg_path, PATH_MAX);
+        SDL_strlcat(tmp_path, template, PATH_MAX);
+
+        fd = mkostemp(tmp_path, O_CLOEXEC);
+        if (fd < 0) {
+            return -1;
+        }
+        unlink(tmp_path);
+    }
+
+    if (ftruncate(fd, size) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void
+shm_buffer_release(void *data, struct wl_buffer *buffer)
+{
+    Wayland_ShmBuffer *shm_buffer = (Wayland_ShmBuffer *) data;
+
+    shm_buffer->busy = SDL_FALSE;
+}
+
+static const struct wl_buffer_listener shm_buffer_listener = {
+    shm_buffer_release
+};
+
+static void
+Wayland_AddShmDamage(Wayland_ShmBuffer *buffer, const SDL_Rect *rect)
+{
+    int i;
+
+    if (buffer->num_damage == WAYLAND_MAX_SHM_DAMAGE) {
+        /* Too many to keep track of, copy everything they cover instead */
+        for (i = 1; i < buffer->num_damage; ++i) {
+            SDL_UnionRect(&buffer->damage[0], &buffer->damage[i], &buffer->damage[0]);
+        }
+        buffer->num_damage = 1;
+    }
+    buffer->damage[buffer->num_damage++] = *rect;
+}
+
+/* Use the next slot of the pool for another buffer */
+static Wayland_ShmBuffer *
+Wayland_CreateShmBuffer(SDL_WindowData *wind)
+{
+    Wayland_ShmBuffer *buffer = &wind->shm_buffers[wind->num_shm_buffers];
+    const int pitch = wind->framebuffer_w * 4;
+    const int offset = wind->num_shm_buffers * wind->framebuffer_h * pitch;
+
+    buffer->buffer = wl_shm_pool_create_buffer(wind->shm_pool, offset,
+                                               wind->framebuffer_w, wind->framebuffer_h,
+                                               pitch, WL_SHM_FORMAT_XRGB8888);
+    if (!buffer->buffer) {
+        SDL_SetError("Couldn't create wl_shm buffer");
+        return NULL;
+    }
+    WAYLAND_wl_proxy_set_queue((struct wl_proxy *) buffer->buffer, wind->shm_queue);
+    wl_buffer_add_listener(buffer->buffer, &shm_buffer_listener, buffer);
+    buffer->pixels = (Uint8 *) wind->shm_data + offset;
+    buffer->busy = SDL_FALSE;
+
+    /* Everything has to be copied in the first time */
+    buffer->damage[0].x = 0;
+    buffer->damage[0].y = 0;
+    buffer->damage[0].w = wind->framebuffer_w;
+    buffer->damage[0].h = wind->framebuffer_h;
+    buffer->num_damage = 1;
+
+    ++wind->num_shm_buffers;
+    return buffer;
+}
+
+/* Find a buffer the compositor has released, making one if there's room.
+   Only the buffer release queue is dispatched, so the window can't be
+   reconfigured underneath the update. */
+static Wayland_ShmBuffer *
+Wayland_GetFreeShmBuffer(_THIS, SDL_WindowData *wind)
+{
+    SDL_VideoData *data = _this->driverdata;
+    int i;
+
+    /* Pick up any release events that have been read */
+    WAYLAND_wl_display_dispatch_queue_pending(data->display, wind->shm_queue);
+
+    for (;;) {
+        for (i = 0; i < wind->num_shm_buffers; ++i) {
+            if (!wind->shm_buffers[i].busy) {
+                return &wind->shm_buffers[i];
+            }
+        }
+        if (wind->num_shm_buffers < WAYLAND_MAX_SHM_BUFFERS) {
+            return Wayland_CreateShmBuffer(wind);
+        }
+        if (WAYLAND_wl_display_dispatch_queue(data->display, wind->shm_queue) < 0) {
+            SDL_SetError("Lost connection to the Wayland compositor");
+            return NULL;
+        }
+    }
+}
+
+int
+Wayland_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format,
+                                void ** pixels, int *pitch)
+{
+    SDL_VideoData *data = _this->driverdata;
+    SDL_WindowData *wind = window->driverdata;
+    int fd;
+
+    /* Free the old framebuffer surface */
+    Wayland_DestroyWindowFramebuffer(_this, window);
+
+    if (!data->shm) {
+        return SDL_SetError("The compositor doesn't support wl_shm");
+    }
+
+    *format = SDL_PIXELFORMAT_RGB888;
+    *pitch = window->w * 4;
+    wind->framebuffer = SDL_calloc(window->h, *pitch);
+    if (!wind->framebuffer) {
+        return SDL_OutOfMemory();
+    }
+    wind->framebuffer_w = window->w;
+    wind->framebuffer_h = window->h;
+
+    wind->shm_queue = WAYLAND_wl_display_create_queue(data->display);
+    if (!wind->shm_queue) {
+        Wayland_DestroyWindowFramebuffer(_this, window);
+        return SDL_SetError("Couldn't create a Wayland event queue");
+    }
+
+    /* Only the buffers that get used are ever backed by memory */
+    wind->shm_size = (size_t) WAYLAND_MAX_SHM_BUFFERS * window->h * *pitch;
+    fd = Wayland_CreateShmFile((off_t) wind->shm_size);
+    if (fd < 0) {
+        Wayland_DestroyWindowFramebuffer(_this, window);
+        return SDL_SetError("Couldn't create shared memory for the framebuffer");
+    }
+
+    wind->shm_data = mmap(NULL, wind->shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (wind->shm_data == MAP_FAILED) {
+        wind->shm_data = NULL;
+        close(fd);
+        Wayland_DestroyWindowFramebuffer(_this, window);
+        return SDL_SetError("mmap() failed.");
+    }
+
+    wind->shm_pool = wl_shm_create_pool(data->shm, fd, (int32_t) wind->shm_size);
+    close(fd);
+    if (!wind->shm_pool) {
+        Wayland_DestroyWindowFramebuffer(_this, window);
+        return SDL_SetError("Couldn't create wl_shm pool");
+    }
+
+    *pixels = wind->framebuffer;
+    return 0;
+}
+
+int
+Wayland_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect * rects,
+                                int numrects)
+{
+    SDL_VideoData *data = _this->driverdata;
+    SDL_WindowData *wind = window->driverdata;
+    const int pitch = wind->framebuffer_w * 4;
+    Wayland_ShmBuffer *buffer;
+    SDL_Rect bounds, rect;
+    int i, y;
+
+    if (!wind->shm_pool) {
+        return SDL_SetError("Window has no framebuffer");
+    }
+
+    buffer = Wayland_GetFreeShmBuffer(_this, wind);
+    if (!buffer) {
+        return -1;
+    }
+
+    /* Every buffer is missing this update, the target gets it now */
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = wind->framebuffer_w;
+    bounds.h = wind->framebuffer_h;
+    if (!wind->shm_attached) {
+        /* Nothing of ours is on screen yet */
+        wl_surface_damage(wind->surface, 0, 0, bounds.w, bounds.h);
+        wind->shm_attached = SDL_TRUE;
+    }
+    for (i = 0; i < numrects; ++i) {
+        int j;
+
+        if (!SDL_IntersectRect(&rects[i], &bounds, &rect)) {
+            continue;
+        }
+        for (j = 0; j < wind->num_shm_buffers; ++j) {
+            if (&wind->shm_buffers[j] != buffer) {
+                Wayland_AddShmDamage(&wind->shm_buffers[j], &rect);
+            }
+        }
+        Wayland_AddShmDamage(buffer, &rect);
+
+        if (data->compositor_version >= WL_SURFACE_DAMAGE_BUFFER_SINCE_VERSION) {
+            wl_surface_damage_buffer(wind->surface, rect.x, rect.y, rect.w, rect.h);
+        } else {
+            wl_surface_damage(wind->surface, rect.x, rect.y, rect.w, rect.h);
+        }
+    }
+
+    for (i = 0; i < buffer->num_damage; ++i) {
+        const Uint8 *src;
+        Uint8 *dst;
+
+        rect = buffer->damage[i];
+        src = (const Uint8 *) wind->framebuffer + rect.y * pitch + rect.x * 4;
+        dst = buffer->pixels + rect.y * pitch + rect.x * 4;
+        for (y = 0; y < rect.h; ++y) {
+            SDL_memcpy(dst, src, rect.w * 4);
+            src += pitch;
+            dst += pitch;
+        }
+    }
+    buffer->num_damage = 0;
+
+    wl_surface_attach(wind->surface, buffer->buffer, 0, 0);
+    Wayland_RequestPresentFeedback(_this, window);
+    wl_surface_commit(wind->surface);
+    buffer->busy = SDL_TRUE;
+
+    WAYLAND_wl_display_flush(data->display);
+    return 0;
+}
+
+void
+Wayland_DestroyWindowFramebuffer(_THIS, SDL_Window * window)
+{
+    SDL_WindowData *wind = window->driverdata;
+    int i;
+
+    if (!wind) {
+        return;
+    }
+
+    for (i = 0; i < wind->num_shm_buffers; ++i) {
+        wl_buffer_destroy(wind->shm_buffers[i].buffer);
+    }
+    SDL_zero(wind->shm_buffers);
+    wind->num_shm_buffers = 0;
+
+    if (wind->shm_pool) {
+        wl_shm_pool_destroy(wind->shm_pool);
+        wind->shm_pool = NULL;
+    }
+    if (wind->shm_data) {
+        munmap(wind->shm_data, wind->shm_size);
+        wind->shm_data = NULL;
+    }
+    wind->shm_size = 0;
+    wind->shm_attached = SDL_FALSE;
+
+    if (wind->shm_queue) {
+        WAYLAND_wl_event_queue_destroy(wind->shm_queue);
+        wind->shm_queue = NULL;
+    }
+
+    SDL_free(wind->framebuffer);
+    wind->framebuffer = NULL;
+    wind->framebuffer_w = 0;
+    wind->framebuffer_h = 0;
+}
+
+#endif /* SDL_VIDEO_DRIVER_WAYLAND */
+
+/* vi: set ts=4 sw=4 expandtab: */
@@ -36,6 +36,7 @@
 #include "../../events/SDL_mouse_c.h"
 #include "SDL_waylandvideo.h"
 #include "SDL_waylandevents_c.h"
+#include "SDL_waylandframebuffer.h"
 
 #include "SDL_waylanddyn.h"
 #include "wayland-cursor.h"
@@ -55,34 +56,6 @@ typedef struct {
     void               *shm_data;
 } Wayland_CursorData;
 
-static int
-wayland_create_tmp_file(off_t size)
-{
-    static const char template[] = "/sdl-shared-XXXXXX";
-    char *xdg_path;
-    char tmp_path[PATH_MAX];
-    int fd;
-
-    xdg_path = SDL_getenv("XDG_RUNTIME_DIR");
-    if (!xdg_path) {
-        return -1;
-    }
-
-    SDL_strlcpy(tmp_path, xdg_path, PATH_MAX);
-    SDL_strlcat(tmp_path, template, PATH_MAX);
-
-    fd = mkostemp(tmp_path, O_CLOEXEC);
-    if (fd < 0)
-        return -1;
-
-    if (ftruncate(fd, size) < 0) {
-        close(fd);
-        return -1;
-    }
-
-    return fd;
-}
-
 static void
 mouse_buffer_release(void *data, struct wl_buffer *buffer)
 {
@@ -107,7 +80,7 @@ create_buffer_from_shm(Wayland_CursorData *d,
 
     int shm_fd;
 
-    shm_fd = wayland_create_tmp_file(size);
+    shm_fd = Wayland_CreateShmFile(size);
     if (shm_fd < 0)
     {
         return SDL_SetError("Creating mouse cursor buffer failed.");
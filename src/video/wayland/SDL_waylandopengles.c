@@ -57,6 +57,9 @@ Wayland_GLES_CreateContext(_THIS, SDL_Window * window)
 int
 Wayland_GLES_SwapWindow(_THIS, SDL_Window *window)
 {
+    /* eglSwapBuffers() commits the surface, so the feedback is for this frame */
+    Wayland_RequestPresentFeedback(_this, window);
+
     if (SDL_EGL_SwapBuffers(_this, ((SDL_WindowData *) window->driverdata)->egl_surface) < 0) {
         return -1;
     }
@@ -31,6 +31,7 @@
 #include "SDL_waylandvideo.h"
 #include "SDL_waylandevents_c.h"
 #include "SDL_waylandwindow.h"
+#include "SDL_waylandframebuffer.h"
 #include "SDL_waylandopengles.h"
 #include "SDL_waylandmouse.h"
 #include "SDL_waylandtouch.h"
@@ -45,6 +46,8 @@
 #include "SDL_waylanddyn.h"
 #include <wayland-util.h>
 
+#include "presentation-time-client-protocol.h"
+
 #define WAYLANDVID_DRIVER_NAME "wayland"
 
 /* Initialization/Query functions */
@@ -176,6 +179,9 @@ Wayland_CreateDevice(int devindex)
     device->SetWindowSize = Wayland_SetWindowSize;
     device->SetWindowTitle = Wayland_SetWindowTitle;
     device->DestroyWindow = Wayland_DestroyWindow;
+    device->CreateWindowFramebuffer = Wayland_CreateWindowFramebuffer;
+    device->UpdateWindowFramebuffer = Wayland_UpdateWindowFramebuffer;
+    device->DestroyWindowFramebuffer = Wayland_DestroyWindowFramebuffer;
     device->SetWindowHitTest = Wayland_SetWindowHitTest;
 
     device->SetClipboardText = Wayland_SetClipboardText;
@@ -306,6 +312,19 @@ static const struct qt_windowmanager_listener windowmanager_listener = {
 };
 #endif /* SDL_VIDEO_DRIVER_WAYLAND_QT_TOUCH */
 
+static void
+presentation_handle_clock_id(void *data, struct wp_presentation *presentation,
+                             uint32_t clk_id)
+{
+    SDL_VideoData *d = data;
+
+    d->presentation_clock = clk_id;
+}
+
+static const struct wp_presentation_listener presentation_listener = {
+    presentation_handle_clock_id,
+};
+
 static void
 display_handle_global(void *data, struct wl_registry *registry, uint32_t id,
                       const char *interface, uint32_t version)
@@ -313,7 +332,9 @@ display_handle_global(void *data, struct wl_registry *registry, uint32_t id,
     SDL_VideoData *d = data;
 
     if (strcmp(interface, "wl_compositor") == 0) {
-        d->compositor = wl_registry_bind(d->registry, id, &wl_compositor_interface, 1);
+        /* Version 4 adds wl_surface.damage_buffer */
+        d->compositor_version = SDL_min(version, 4);
+        d->compositor = wl_registry_bind(d->registry, id, &wl_compositor_interface, d->compositor_version);
     } else if (strcmp(interface, "wl_output") == 0) {
         Wayland_add_display(d, id);
     } else if (strcmp(interface, "wl_seat") == 0) {
@@ -329,6 +350,9 @@ display_handle_global(void *data, struct wl_registry *registry, uint32_t id,
         Wayland_display_add_pointer_constraints(d, id);
     } else if (strcmp(interface, "wl_data_device_manager") == 0) {
         d->data_device_manager = wl_registry_bind(d->registry, id, &wl_data_device_manager_interface, 3);
+    } else if (strcmp(interface, "wp_presentation") == 0) {
+        d->presentation = wl_registry_bind(d->registry, id, &wp_presentation_interface, 1);
+        wp_presentation_add_listener(d->presentation, &presentation_listener, d);
 #ifdef SDL_VIDEO_DRIVER_WAYLAND_QT_TOUCH
     } else if (strcmp(interface, "qt_touch_extension") == 0) {
         Wayland_touch_create(d, id);
@@ -436,6 +460,9 @@ Wayland_VideoQuit(_THIS)
     Wayland_touch_destroy(data);
 #endif /* SDL_VIDEO_DRIVER_WAYLAND_QT_TOUCH */
 
+    if (data->presentation)
+        wp_presentation_destroy(data->presentation);
+
     if (data->shm)
         wl_shm_destroy(data->shm);
 
@@ -40,6 +40,7 @@ typedef struct {
     struct wl_display *display;
     struct wl_registry *registry;
     struct wl_compositor *compositor;
+    uint32_t compositor_version;
     struct wl_shm *shm;
     struct wl_cursor_theme *cursor_theme;
     struct wl_pointer *pointer;
@@ -47,6 +48,8 @@ typedef struct {
     struct zwp_relative_pointer_manager_v1 *relative_pointer_manager;
     struct zwp_pointer_constraints_v1 *pointer_constraints;
     struct wl_data_device_manager *data_device_manager;
+    struct wp_presentation *presentation;
+    uint32_t presentation_clock;    /* clockid_t of presentation feedback times */
 
     EGLDisplay edpy;
     EGLContext context;
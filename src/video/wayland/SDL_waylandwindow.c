@@ -32,6 +32,11 @@
 #include "SDL_waylandtouch.h"
 #include "SDL_waylanddyn.h"
 #include "SDL_hints.h"
+#include "SDL_timer.h"
+
+#include <time.h>
+
+#include "presentation-time-client-protocol.h"
 
 static void
 handle_ping(void *data, struct wl_shell_surface *shell_surface,
@@ -386,12 +391,110 @@ void Wayland_SetWindowTitle(_THIS, SDL_Window * window)
     WAYLAND_wl_display_flush( ((SDL_VideoData*)_this->driverdata)->display );
 }
 
+static int
+feedback_slot(SDL_WindowData *wind, struct wp_presentation_feedback *feedback)
+{
+    int i;
+
+    for (i = 0; i < SDL_PRESENT_HISTORY; ++i) {
+        if (wind->feedback[i] == feedback) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void
+feedback_handle_sync_output(void *data, struct wp_presentation_feedback *feedback,
+                            struct wl_output *output)
+{
+}
+
+static void
+feedback_handle_presented(void *data, struct wp_presentation_feedback *feedback,
+                          uint32_t tv_sec_hi, uint32_t tv_sec_lo, uint32_t tv_nsec,
+                          uint32_t refresh, uint32_t seq_hi, uint32_t seq_lo,
+                          uint32_t flags)
+{
+    SDL_WindowData *wind = (SDL_WindowData *)data;
+    const int slot = feedback_slot(wind, feedback);
+    const Uint64 sec = ((Uint64) tv_sec_hi << 32) | tv_sec_lo;
+    Uint64 present_time = SDL_GetPerformanceCounter();
+    struct timespec now;
+    Sint64 age;
+
+    /* Convert from the compositor's clock to performance counter ticks */
+    if (clock_gettime((clockid_t) wind->waylandData->presentation_clock, &now) == 0) {
+        age = ((Sint64) now.tv_sec - (Sint64) sec) * 1000000000 + ((Sint64) now.tv_nsec - tv_nsec);
+        if (age > 0) {
+            present_time -= (Uint64) age * SDL_GetPerformanceFrequency() / 1000000000;
+        }
+    }
+
+    if (slot >= 0) {
+        SDL_OnWindowPresented(wind->sdlwindow, wind->feedback_frame[slot], present_time,
+                              ((Uint64) seq_hi << 32) | seq_lo);
+        wind->feedback[slot] = NULL;
+    }
+    wp_presentation_feedback_destroy(feedback);
+}
+
+static void
+feedback_handle_discarded(void *data, struct wp_presentation_feedback *feedback)
+{
+    SDL_WindowData *wind = (SDL_WindowData *)data;
+    const int slot = feedback_slot(wind, feedback);
+
+    if (slot >= 0) {
+        wind->feedback[slot] = NULL;
+    }
+    wp_presentation_feedback_destroy(feedback);
+}
+
+static const struct wp_presentation_feedback_listener feedback_listener = {
+    feedback_handle_sync_output,
+    feedback_handle_presented,
+    feedback_handle_discarded,
+};
+
+/* Ask to be told when the frame about to be committed reaches the display */
+void
+Wayland_RequestPresentFeedback(_THIS, SDL_Window *window)
+{
+    SDL_VideoData *data = _this->driverdata;
+    SDL_WindowData *wind = window->driverdata;
+    const int slot = (int) (window->frame_count % SDL_PRESENT_HISTORY);
+
+    if (!data->presentation) {
+        return;
+    }
+
+    /* Give up on a frame that's been waiting too long */
+    if (wind->feedback[slot]) {
+        wp_presentation_feedback_destroy(wind->feedback[slot]);
+    }
+
+    wind->feedback[slot] = wp_presentation_feedback(data->presentation, wind->surface);
+    wind->feedback_frame[slot] = window->frame_count;
+    if (wind->feedback[slot]) {
+        wp_presentation_feedback_add_listener(wind->feedback[slot], &feedback_listener, wind);
+    }
+}
+
 void Wayland_DestroyWindow(_THIS, SDL_Window *window)
 {
     SDL_VideoData *data = _this->driverdata;
     SDL_WindowData *wind = window->driverdata;
 
     if (data) {
+        int i;
+
+        for (i = 0; i < SDL_PRESENT_HISTORY; ++i) {
+            if (wind->feedback[i]) {
+                wp_presentation_feedback_destroy(wind->feedback[i]);
+            }
+        }
+
         SDL_EGL_DestroySurface(_this, wind->egl_surface);
         WAYLAND_wl_egl_window_destroy(wind->egl_window);
 
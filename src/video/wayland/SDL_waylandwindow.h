@@ -31,6 +31,18 @@
 
 struct SDL_WaylandInput;
 
+#define WAYLAND_MAX_SHM_BUFFERS 3
+#define WAYLAND_MAX_SHM_DAMAGE  16
+
+typedef struct {
+    struct wl_buffer *buffer;
+    Uint8 *pixels;
+    SDL_bool busy;      /* attached, waiting for the compositor to release it */
+    /* Updates since this buffer was last written, which it's still missing */
+    SDL_Rect damage[WAYLAND_MAX_SHM_DAMAGE];
+    int num_damage;
+} Wayland_ShmBuffer;
+
 typedef struct {
     SDL_Window *sdlwindow;
     SDL_VideoData *waylandData;
@@ -41,6 +53,24 @@ typedef struct {
     EGLSurface egl_surface;
     struct zwp_locked_pointer_v1 *locked_pointer;
 
+    /* Presentation feedback for frames by frame % SDL_PRESENT_HISTORY */
+    struct wp_presentation_feedback *feedback[SDL_PRESENT_HISTORY];
+    Uint64 feedback_frame[SDL_PRESENT_HISTORY];
+
+    /* The window framebuffer, copied into wl_shm buffers from one pool.
+       Its size is kept since a configure event can resize the window before
+       the framebuffer is recreated, and the buffer releases have their own
+       queue so waiting for one doesn't run any other handlers. */
+    void *framebuffer;
+    int framebuffer_w, framebuffer_h;
+    struct wl_event_queue *shm_queue;
+    struct wl_shm_pool *shm_pool;
+    void *shm_data;
+    size_t shm_size;
+    Wayland_ShmBuffer shm_buffers[WAYLAND_MAX_SHM_BUFFERS];
+    int num_shm_buffers;
+    SDL_bool shm_attached;
+
 #ifdef SDL_VIDEO_DRIVER_WAYLAND_QT_TOUCH
     struct qt_extended_surface *extended_surface;
 #endif /* SDL_VIDEO_DRIVER_WAYLAND_QT_TOUCH */    
@@ -56,6 +86,7 @@ extern int Wayland_CreateWindow(_THIS, SDL_Window *window);
 extern void Wayland_SetWindowSize(_THIS, SDL_Window * window);
 extern void Wayland_SetWindowTitle(_THIS, SDL_Window * window);
 extern void Wayland_DestroyWindow(_THIS, SDL_Window *window);
+extern void Wayland_RequestPresentFeedback(_THIS, SDL_Window *window);
 
 extern SDL_bool
 Wayland_GetWindowWMInfo(_THIS, SDL_Window * window, SDL_SysWMinfo * info);
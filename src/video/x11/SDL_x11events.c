@@ -29,6 +29,7 @@
 #include <limits.h> /* For INT_MAX */
 
 #include "SDL_x11video.h"
+#include "SDL_x11framebuffer.h"
 #include "SDL_x11touch.h"
 #include "SDL_x11xinput2.h"
 #include "../../core/unix/SDL_poll.h"
@@ -629,6 +630,53 @@ X11_HandleClipboardEvent(_THIS, const XEvent *xevent)
 }
 
 
+typedef struct
+{
+    const XMotionEvent *motion;
+    Bool blocked;
+} X11_MotionMatch;
+
+static Bool
+X11_IsLaterMotion(Display *display, XEvent *xevent, XPointer arg)
+{
+    X11_MotionMatch *match = (X11_MotionMatch *) arg;
+
+    if (match->blocked) {
+        return False;
+    }
+    if (xevent->type == MotionNotify &&
+        xevent->xmotion.window == match->motion->window &&
+        xevent->xmotion.state == match->motion->state) {
+        return True;
+    }
+    /* XInput2 raw motion is interleaved with core motion and handled
+       independently of it, so it doesn't end the run */
+    if (X11_Xinput2IsRawMotion(xevent)) {
+        return False;
+    }
+    /* Anything else has to be seen after the motion before it */
+    match->blocked = True;
+    return False;
+}
+
+/* Replace a motion event with the newest queued one for the same window and
+   button state, as long as nothing else is queued in between */
+static void
+X11_CoalesceMotion(Display *display, XEvent *xevent)
+{
+    X11_MotionMatch match;
+    XEvent next;
+
+    for (;;) {
+        match.motion = &xevent->xmotion;
+        match.blocked = False;
+        if (!X11_XCheckIfEvent(display, &next, X11_IsLaterMotion, (XPointer) &match)) {
+            break;
+        }
+        *xevent = next;
+    }
+}
+
 static void
 X11_DispatchEvent(_THIS)
 {
@@ -649,6 +697,13 @@ X11_DispatchEvent(_THIS)
     SDL_zero(xevent);           /* valgrind fix. --ryan. */
     X11_XNextEvent(display, &xevent);
 
+    /* Only the last of a run of pointer motion matters, unless the
+       application is watching the raw events */
+    if (xevent.type == MotionNotify &&
+        SDL_GetEventState(SDL_SYSWMEVENT) != SDL_ENABLE) {
+        X11_CoalesceMotion(display, &xevent);
+    }
+
     /* Save the original keycode for dead keys, which are filtered out by
        the XFilterEvent() call below.
     */
@@ -701,6 +756,15 @@ X11_DispatchEvent(_THIS)
     }
 #endif
 
+#if SDL_VIDEO_DRIVER_X11_XRANDR
+    if (videodata->xrandr_event_base &&
+        (xevent.type == videodata->xrandr_event_base + RRScreenChangeNotify ||
+         xevent.type == videodata->xrandr_event_base + RRNotify)) {
+        X11_HandleXRandREvent(_this, &xevent);
+        return;
+    }
+#endif
+
 #if 0
     printf("type = %d display = %d window = %d\n",
            xevent.type, xevent.xany.display, xevent.xany.window);
@@ -745,6 +809,13 @@ X11_DispatchEvent(_THIS)
         return;
     }
 
+#ifndef NO_SHARED_MEMORY
+    if (videodata->shm_completion_event && xevent.type == videodata->shm_completion_event) {
+        X11_HandleShmCompletion(data, &xevent);
+        return;
+    }
+#endif
+
     switch (xevent.type) {
 
         /* Gaining mouse coverage? */
@@ -1399,23 +1470,18 @@ X11_HandleFocusChanges(_THIS)
         }
     }
 }
-/* Ack!  X11_XPending() actually performs a blocking read if no events available */
-static int
-X11_Pending(Display * display)
+int
+X11_WaitEventTimeout(_THIS, int timeout)
 {
-    /* Flush the display connection and look to see if events are queued */
+    SDL_VideoData *data = (SDL_VideoData *) _this->driverdata;
+    Display *display = data->display;
+
+    /* Requests still in the output buffer may be what the reply is waiting on */
     X11_XFlush(display);
     if (X11_XEventsQueued(display, QueuedAlready)) {
-        return (1);
+        return 1;
     }
-
-    /* More drastic measures are required -- see if X is ready to talk */
-    if (SDL_IOReady(ConnectionNumber(display), SDL_FALSE, 0)) {
-        return (X11_XPending(display));
-    }
-
-    /* Oh well, nothing is ready .. */
-    return (0);
+    return SDL_IOReady(ConnectionNumber(display), SDL_FALSE, timeout) > 0 ? 1 : 0;
 }
 
 void
@@ -1444,9 +1510,15 @@ X11_PumpEvents(_THIS)
         }
     }
 
-    /* Keep processing pending events */
-    while (X11_Pending(data->display)) {
-        X11_DispatchEvent(_this);
+    /* Read whatever has arrived on the connection once, without blocking,
+       then drain the queue. Anything read while handling those events
+       (replies to property requests, etc.) lands in the queue too, so
+       there's no need to go back to the socket for it. */
+    X11_XFlush(data->display);
+    if (X11_XEventsQueued(data->display, QueuedAfterReading)) {
+        while (X11_XEventsQueued(data->display, QueuedAlready)) {
+            X11_DispatchEvent(_this);
+        }
     }
 
 #ifdef SDL_USE_IME
@@ -24,8 +24,22 @@
 
 #include "SDL_x11video.h"
 #include "SDL_x11framebuffer.h"
+#include "SDL_hints.h"
+#include "SDL_timer.h"
 
 
+static SDL_bool
+X11_ClipFramebufferRect(SDL_Window * window, const SDL_Rect * rect, SDL_Rect * clipped)
+{
+    SDL_Rect bounds;
+
+    bounds.x = 0;
+    bounds.y = 0;
+    bounds.w = window->w;
+    bounds.h = window->h;
+    return SDL_IntersectRect(rect, &bounds, clipped);
+}
+
 #ifndef NO_SHARED_MEMORY
 
 /* Shared memory error handler routine */
@@ -50,6 +64,172 @@ static SDL_bool have_mitshm(void)
     return SDL_FALSE;
 }
 
+static int
+X11_GetShmSegmentCount(void)
+{
+    const char *hint = SDL_GetHint(SDL_HINT_VIDEO_X11_SHM_SEGMENTS);
+    int count = 2;
+
+    if (hint && *hint) {
+        count = SDL_atoi(hint);
+    }
+    return SDL_max(SDL_min(count, X11_MAX_SHM_SEGMENTS), 1);
+}
+
+/* Attach a shared memory segment and create an image in it.
+   Returns SDL_FALSE if the server can't attach the segment. */
+static SDL_bool
+X11_CreateShmImage(Display *display, Visual *visual, int depth, int w, int h,
+                   int size, XShmSegmentInfo *shminfo, XImage **ximage)
+{
+    shminfo->shmid = shmget(IPC_PRIVATE, size, IPC_CREAT | 0777);
+    if ( shminfo->shmid >= 0 ) {
+        shminfo->shmaddr = (char *)shmat(shminfo->shmid, 0, 0);
+        shminfo->readOnly = False;
+        if ( shminfo->shmaddr != (char *)-1 ) {
+            shm_error = False;
+            X_handler = X11_XSetErrorHandler(shm_errhandler);
+            X11_XShmAttach(display, shminfo);
+            X11_XSync(display, False);
+            X11_XSetErrorHandler(X_handler);
+            if ( shm_error )
+                shmdt(shminfo->shmaddr);
+        } else {
+            shm_error = True;
+        }
+        shmctl(shminfo->shmid, IPC_RMID, NULL);
+    } else {
+        shm_error = True;
+    }
+    if (shm_error) {
+        return SDL_FALSE;
+    }
+
+    *ximage = X11_XShmCreateImage(display, visual, depth, ZPixmap,
+                                  shminfo->shmaddr, shminfo, w, h);
+    if (!*ximage) {
+        X11_XShmDetach(display, shminfo);
+        X11_XSync(display, False);
+        shmdt(shminfo->shmaddr);
+        return SDL_FALSE;
+    }
+    return SDL_TRUE;
+}
+
+static Bool
+X11_IsShmCompletion(Display *display, XEvent *xevent, XPointer arg)
+{
+    SDL_WindowData *data = (SDL_WindowData *) arg;
+
+    return (xevent->type == data->videodata->shm_completion_event &&
+            ((XShmCompletionEvent *) xevent)->drawable == data->xwindow);
+}
+
+void
+X11_HandleShmCompletion(SDL_WindowData *data, const XEvent *xevent)
+{
+    const XShmCompletionEvent *event = (const XShmCompletionEvent *) xevent;
+    int i;
+
+    for (i = 0; i < data->num_shm_segments; ++i) {
+        if (data->shm_segments[i].shminfo.shmseg == event->shmseg) {
+            data->shm_segments[i].busy = SDL_FALSE;
+            SDL_OnWindowPresented(data->window, data->shm_segments[i].frame,
+                                  SDL_GetPerformanceCounter(), 0);
+            break;
+        }
+    }
+}
+
+static void
+X11_DestroyShmSegments(Display *display, SDL_WindowData *data)
+{
+    XEvent xevent;
+    int i;
+
+    for (i = 0; i < data->num_shm_segments; ++i) {
+        XDestroyImage(data->shm_segments[i].ximage);
+        X11_XShmDetach(display, &data->shm_segments[i].shminfo);
+    }
+    X11_XSync(display, False);
+    for (i = 0; i < data->num_shm_segments; ++i) {
+        shmdt(data->shm_segments[i].shminfo.shmaddr);
+    }
+
+    /* Drop completions for segments that no longer exist */
+    while (X11_XCheckIfEvent(display, &xevent, X11_IsShmCompletion, (XPointer) data)) {
+        continue;
+    }
+
+    data->num_shm_segments = 0;
+    SDL_free(data->shm_pixels);
+    data->shm_pixels = NULL;
+}
+
+/* Copy the updated parts of the framebuffer into a free segment, and
+   present it without waiting for the server. The server sends a
+   ShmCompletion event once it has read the segment. */
+static void
+X11_UpdateShmSegments(SDL_Window * window, SDL_WindowData *data,
+                      const SDL_Rect * rects, int numrects)
+{
+    Display *display = data->videodata->display;
+    X11_ShmSegment *segment = &data->shm_segments[data->shm_segment];
+    const int bpp = segment->ximage->bits_per_pixel / 8;
+    const int pitch = segment->ximage->bytes_per_line;
+    XEvent xevent;
+    SDL_Rect rect;
+    int i, y, last = -1;
+
+    while (X11_XCheckIfEvent(display, &xevent, X11_IsShmCompletion, (XPointer) data)) {
+        X11_HandleShmCompletion(data, &xevent);
+    }
+    while (segment->busy) {
+        X11_XIfEvent(display, &xevent, X11_IsShmCompletion, (XPointer) data);
+        X11_HandleShmCompletion(data, &xevent);
+    }
+
+    for (i = 0; i < numrects; ++i) {
+        if (X11_ClipFramebufferRect(window, &rects[i], &rect)) {
+            last = i;
+        }
+    }
+
+    for (i = 0; i <= last; ++i) {
+        const Uint8 *src;
+        Uint8 *dst;
+
+        if (!X11_ClipFramebufferRect(window, &rects[i], &rect)) {
+            continue;
+        }
+
+        src = (const Uint8 *) data->shm_pixels + rect.y * pitch + rect.x * bpp;
+        dst = (Uint8 *) segment->shminfo.shmaddr + rect.y * pitch + rect.x * bpp;
+        if (rect.w == window->w) {
+            SDL_memcpy(dst, src, rect.h * pitch);
+        } else {
+            for (y = 0; y < rect.h; ++y) {
+                SDL_memcpy(dst, src, rect.w * bpp);
+                src += pitch;
+                dst += pitch;
+            }
+        }
+
+        /* The server handles requests in order, so one event for the last
+           rectangle means it's done with the whole segment */
+        X11_XShmPutImage(display, data->xwindow, data->gc, segment->ximage,
+            rect.x, rect.y, rect.x, rect.y, rect.w, rect.h,
+            (i == last) ? True : False);
+    }
+
+    if (last >= 0) {
+        segment->busy = SDL_TRUE;
+        segment->frame = window->frame_count;
+        data->shm_segment = (data->shm_segment + 1) % data->num_shm_segments;
+    }
+    X11_XFlush(display);
+}
+
 #endif /* !NO_SHARED_MEMORY */
 
 int
@@ -57,9 +237,13 @@ X11_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format,
                             void ** pixels, int *pitch)
 {
     SDL_WindowData *data = (SDL_WindowData *) window->driverdata;
-    Display *display = data->videodata->display;
+    SDL_VideoData *videodata = data->videodata;
+    Display *display = videodata->display;
     XGCValues gcv;
     XVisualInfo vinfo;
+#ifndef NO_SHARED_MEMORY
+    int i;
+#endif
 
     /* Free the old framebuffer surface */
     X11_DestroyWindowFramebuffer(_this, window);
@@ -87,42 +271,48 @@ X11_CreateWindowFramebuffer(_THIS, SDL_Window * window, Uint32 * format,
     /* Create the actual image */
 #ifndef NO_SHARED_MEMORY
     if (have_mitshm()) {
-        XShmSegmentInfo *shminfo = &data->shminfo;
-
-        shminfo->shmid = shmget(IPC_PRIVATE, window->h*(*pitch), IPC_CREAT | 0777);
-        if ( shminfo->shmid >= 0 ) {
-            shminfo->shmaddr = (char *)shmat(shminfo->shmid, 0, 0);
-            shminfo->readOnly = False;
-            if ( shminfo->shmaddr != (char *)-1 ) {
-                shm_error = False;
-                X_handler = X11_XSetErrorHandler(shm_errhandler);
-                X11_XShmAttach(display, shminfo);
-                X11_XSync(display, False);
-                X11_XSetErrorHandler(X_handler);
-                if ( shm_error )
-                    shmdt(shminfo->shmaddr);
-            } else {
-                shm_error = True;
+        const int count = X11_GetShmSegmentCount();
+
+        if (count == 1) {
+            /* Draw straight into the segment, and wait for the server to
+               finish with it every frame */
+            if (X11_CreateShmImage(display, data->visual, vinfo.depth,
+                                   window->w, window->h, window->h*(*pitch),
+                                   &data->shminfo, &data->ximage)) {
+                /* Done! */
+                data->use_mitshm = SDL_TRUE;
+                *pixels = data->shminfo.shmaddr;
+                return 0;
             }
-            shmctl(shminfo->shmid, IPC_RMID, NULL);
         } else {
-            shm_error = True;
-        }
-        if (!shm_error) {
-            data->ximage = X11_XShmCreateImage(display, data->visual,
-                             vinfo.depth, ZPixmap,
-                             shminfo->shmaddr, shminfo,
-                             window->w, window->h);
-            if (!data->ximage) {
-                X11_XShmDetach(display, shminfo);
-                X11_XSync(display, False);
-                shmdt(shminfo->shmaddr);
-            } else {
-                /* Done! */
+            /* Draw into memory of our own, and copy it into whichever
+               segment the server is done with when the window is updated */
+            data->shm_pixels = SDL_malloc(window->h*(*pitch));
+            if (data->shm_pixels == NULL) {
+                return SDL_OutOfMemory();
+            }
+            for (i = 0; i < count; ++i) {
+                X11_ShmSegment *segment = &data->shm_segments[i];
+
+                if (!X11_CreateShmImage(display, data->visual, vinfo.depth,
+                                        window->w, window->h, window->h*(*pitch),
+                                        &segment->shminfo, &segment->ximage)) {
+                    break;
+                }
+                segment->busy = SDL_FALSE;
+                ++data->num_shm_segments;
+            }
+            if (data->num_shm_segments > 0) {
+                if (!videodata->shm_completion_event) {
+                    videodata->shm_completion_event = X11_XShmGetEventBase(display) + ShmCompletion;
+                }
                 data->use_mitshm = SDL_TRUE;
-                *pixels = shminfo->shmaddr;
+                data->shm_segment = 0;
+                *pixels = data->shm_pixels;
                 return 0;
             }
+            SDL_free(data->shm_pixels);
+            data->shm_pixels = NULL;
         }
     }
 #endif /* not NO_SHARED_MEMORY */
@@ -148,73 +338,41 @@ X11_UpdateWindowFramebuffer(_THIS, SDL_Window * window, const SDL_Rect * rects,
 {
     SDL_WindowData *data = (SDL_WindowData *) window->driverdata;
     Display *display = data->videodata->display;
+    SDL_Rect rect;
     int i;
-    int x, y, w ,h;
+
 #ifndef NO_SHARED_MEMORY
+    if (data->num_shm_segments > 0) {
+        X11_UpdateShmSegments(window, data, rects, numrects);
+        return 0;
+    }
     if (data->use_mitshm) {
         for (i = 0; i < numrects; ++i) {
-            x = rects[i].x;
-            y = rects[i].y;
-            w = rects[i].w;
-            h = rects[i].h;
-
-            if (w <= 0 || h <= 0 || (x + w) <= 0 || (y + h) <= 0) {
-                /* Clipped? */
+            if (!X11_ClipFramebufferRect(window, &rects[i], &rect)) {
                 continue;
             }
-            if (x < 0)
-            {
-                x += w;
-                w += rects[i].x;
-            }
-            if (y < 0)
-            {
-                y += h;
-                h += rects[i].y;
-            }
-            if (x + w > window->w)
-                w = window->w - x;
-            if (y + h > window->h)
-                h = window->h - y;
-
             X11_XShmPutImage(display, data->xwindow, data->gc, data->ximage,
-                x, y, x, y, w, h, False);
+                rect.x, rect.y, rect.x, rect.y, rect.w, rect.h, False);
         }
+
+        /* The application draws into the segment, so it has to wait until
+           the server has read it */
+        X11_XSync(display, False);
+        SDL_OnWindowPresented(window, window->frame_count, SDL_GetPerformanceCounter(), 0);
+        return 0;
     }
-    else
 #endif /* !NO_SHARED_MEMORY */
-    {
-        for (i = 0; i < numrects; ++i) {
-            x = rects[i].x;
-            y = rects[i].y;
-            w = rects[i].w;
-            h = rects[i].h;
-
-            if (w <= 0 || h <= 0 || (x + w) <= 0 || (y + h) <= 0) {
-                /* Clipped? */
-                continue;
-            }
-            if (x < 0)
-            {
-                x += w;
-                w += rects[i].x;
-            }
-            if (y < 0)
-            {
-                y += h;
-                h += rects[i].y;
-            }
-            if (x + w > window->w)
-                w = window->w - x;
-            if (y + h > window->h)
-                h = window->h - y;
 
-            X11_XPutImage(display, data->xwindow, data->gc, data->ximage,
-                x, y, x, y, w, h);
+    for (i = 0; i < numrects; ++i) {
+        if (!X11_ClipFramebufferRect(window, &rects[i], &rect)) {
+            continue;
         }
+        X11_XPutImage(display, data->xwindow, data->gc, data->ximage,
+            rect.x, rect.y, rect.x, rect.y, rect.w, rect.h);
     }
 
-    X11_XSync(display, False);
+    /* XPutImage() has copied the pixels into the request already */
+    X11_XFlush(display);
 
     return 0;
 }
@@ -232,6 +390,13 @@ X11_DestroyWindowFramebuffer(_THIS, SDL_Window * window)
 
     display = data->videodata->display;
 
+#ifndef NO_SHARED_MEMORY
+    if (data->num_shm_segments > 0) {
+        X11_DestroyShmSegments(display, data);
+        data->use_mitshm = SDL_FALSE;
+    }
+#endif /* !NO_SHARED_MEMORY */
+
     if (data->ximage) {
         XDestroyImage(data->ximage);
 
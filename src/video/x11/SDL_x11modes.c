@@ -260,23 +260,29 @@ CalculateXRandRRefreshRate(const XRRModeInfo *info)
         round(((double)info->dotClock / (double)(info->hTotal * info->vTotal))) : 0;
 }
 
+static Rotation
+GetXRandRRotation(Display *display, XRRScreenResources *res, RRCrtc crtc)
+{
+    Rotation rotation = 0;
+
+    if (crtc) {
+        XRRCrtcInfo *crtcinfo = X11_XRRGetCrtcInfo(display, res, crtc);
+        if (crtcinfo) {
+            rotation = crtcinfo->rotation;
+            X11_XRRFreeCrtcInfo(crtcinfo);
+        }
+    }
+    return rotation;
+}
+
 static SDL_bool
-SetXRandRModeInfo(Display *display, XRRScreenResources *res, RRCrtc crtc,
+SetXRandRModeInfo(XRRScreenResources *res, Rotation rotation,
                   RRMode modeID, SDL_DisplayMode *mode)
 {
     int i;
     for (i = 0; i < res->nmode; ++i) {
         const XRRModeInfo *info = &res->modes[i];
         if (info->id == modeID) {
-            XRRCrtcInfo *crtcinfo;
-            Rotation rotation = 0;
-
-            crtcinfo = X11_XRRGetCrtcInfo(display, res, crtc);
-            if (crtcinfo) {
-                rotation = crtcinfo->rotation;
-                X11_XRRFreeCrtcInfo(crtcinfo);
-            }
-
             if (rotation & (XRANDR_ROTATION_LEFT|XRANDR_ROTATION_RIGHT)) {
                 mode->w = info->height;
                 mode->h = info->width;
@@ -295,43 +301,81 @@ SetXRandRModeInfo(Display *display, XRRScreenResources *res, RRCrtc crtc,
     return SDL_FALSE;
 }
 
-static void
-SetXRandRDisplayName(Display *dpy, Atom EDID, char *name, const size_t namelen, RROutput output, const unsigned long widthmm, const unsigned long heightmm)
+/* Monitor names from EDID, kept across video reinitialization since reading
+   and parsing EDID costs a couple of round trips per output. The cache is
+   keyed by server, output and the time the server last probed the outputs,
+   and dropped whenever RandR reports a change. */
+#define X11_MAX_CACHED_OUTPUT_NAMES 16
+
+typedef struct
 {
-    /* See if we can get the EDID data for the real monitor name */
-    int inches;
-    int nprop;
-    Atom *props = X11_XRRListOutputProperties(dpy, output, &nprop);
-    int i;
+    char display[64];
+    Window root;
+    Time config_timestamp;
+    RROutput output;
+    char name[128];
+} X11_CachedOutputName;
+
+static X11_CachedOutputName cached_output_names[X11_MAX_CACHED_OUTPUT_NAMES];
+static int num_cached_output_names;
 
-    for (i = 0; i < nprop; ++i) {
-        unsigned char *prop;
-        int actual_format;
-        unsigned long nitems, bytes_after;
-        Atom actual_type;
-
-        if (props[i] == EDID) {
-            if (X11_XRRGetOutputProperty(dpy, output, props[i], 0, 100, False,
-                                         False, AnyPropertyType, &actual_type,
-                                         &actual_format, &nitems, &bytes_after,
-                                         &prop) == Success) {
-                MonitorInfo *info = decode_edid(prop);
-                if (info) {
+static void
+GetXRandREDIDName(Display *dpy, Atom EDID, char *name, const size_t namelen, RROutput output)
+{
+    unsigned char *prop = NULL;
+    int actual_format;
+    unsigned long nitems, bytes_after;
+    Atom actual_type;
+
+    if (X11_XRRGetOutputProperty(dpy, output, EDID, 0, 100, False,
+                                 False, AnyPropertyType, &actual_type,
+                                 &actual_format, &nitems, &bytes_after,
+                                 &prop) == Success) {
+        if (actual_type != None && nitems > 0) {
+            MonitorInfo *info = decode_edid(prop);
+            if (info) {
 #ifdef X11MODES_DEBUG
-                    printf("Found EDID data for %s\n", name);
-                    dump_monitor_info(info);
+                printf("Found EDID data for %s\n", name);
+                dump_monitor_info(info);
 #endif
-                    SDL_strlcpy(name, info->dsc_product_name, namelen);
-                    free(info);
-                }
-                X11_XFree(prop);
+                SDL_strlcpy(name, info->dsc_product_name, namelen);
+                free(info);
             }
-            break;
+        }
+        if (prop) {
+            X11_XFree(prop);
         }
     }
+}
 
-    if (props) {
-        X11_XFree(props);
+static void
+SetXRandRDisplayName(Display *dpy, Atom EDID, char *name, const size_t namelen, XRRScreenResources *res, int screen, RROutput output, const unsigned long widthmm, const unsigned long heightmm)
+{
+    const Window root = RootWindow(dpy, screen);
+    X11_CachedOutputName *cached;
+    int inches;
+    int i;
+
+    /* See if we can get the EDID data for the real monitor name */
+    for (i = 0; i < num_cached_output_names; ++i) {
+        cached = &cached_output_names[i];
+        if (cached->output == output && cached->root == root &&
+            cached->config_timestamp == res->configTimestamp &&
+            SDL_strcmp(cached->display, DisplayString(dpy)) == 0) {
+            SDL_strlcpy(name, cached->name, namelen);
+            break;
+        }
+    }
+    if (i == num_cached_output_names) {
+        GetXRandREDIDName(dpy, EDID, name, namelen, output);
+        if (num_cached_output_names < X11_MAX_CACHED_OUTPUT_NAMES) {
+            cached = &cached_output_names[num_cached_output_names++];
+            SDL_strlcpy(cached->display, DisplayString(dpy), sizeof (cached->display));
+            cached->root = root;
+            cached->config_timestamp = res->configTimestamp;
+            cached->output = output;
+            SDL_strlcpy(cached->name, name, sizeof (cached->name));
+        }
     }
 
     inches = (int)((SDL_sqrtf(widthmm * widthmm + heightmm * heightmm) / 25.4f) + 0.5f);
@@ -346,6 +390,23 @@ SetXRandRDisplayName(Display *dpy, Atom EDID, char *name, const size_t namelen,
 }
 
 
+/* Use what the server already knows about its outputs. Asking it to probe
+   them again can take hundreds of milliseconds, so only do that if it
+   doesn't know of any. */
+static XRRScreenResources *
+GetXRandRScreenResources(Display *dpy, int screen)
+{
+    XRRScreenResources *res = X11_XRRGetScreenResourcesCurrent(dpy, RootWindow(dpy, screen));
+    if (!res || res->noutput == 0) {
+        if (res) {
+            X11_XRRFreeScreenResources(res);
+        }
+
+        res = X11_XRRGetScreenResources(dpy, RootWindow(dpy, screen));
+    }
+    return res;
+}
+
 static int
 X11_InitModes_XRandR(_THIS)
 {
@@ -393,16 +454,9 @@ X11_InitModes_XRandR(_THIS)
                 X11_XFree(pixmapformats);
             }
 
-            res = X11_XRRGetScreenResourcesCurrent(dpy, RootWindow(dpy, screen));
-            if (!res || res->noutput == 0) {
-                if (res) {
-                    X11_XRRFreeScreenResources(res);
-                }
-
-                res = X11_XRRGetScreenResources(dpy, RootWindow(dpy, screen));
-                if (!res) {
-                    continue;
-                }
+            res = GetXRandRScreenResources(dpy, screen);
+            if (!res) {
+                continue;
             }
 
             for (output = 0; output < res->noutput; output++) {
@@ -417,6 +471,7 @@ X11_InitModes_XRandR(_THIS)
                 RRMode modeID;
                 RRCrtc output_crtc;
                 XRRCrtcInfo *crtc;
+                Rotation rotation;
 
                 /* The primary output _should_ always be sorted first, but just in case... */
                 if ((looking_for_primary && (res->outputs[output] != primary)) ||
@@ -449,6 +504,7 @@ X11_InitModes_XRandR(_THIS)
 
                 display_x = crtc->x;
                 display_y = crtc->y;
+                rotation = crtc->rotation;
 
                 X11_XRRFreeCrtcInfo(crtc);
 
@@ -477,8 +533,8 @@ X11_InitModes_XRandR(_THIS)
                 displaydata->use_xrandr = 1;
                 displaydata->xrandr_output = res->outputs[output];
 
-                SetXRandRModeInfo(dpy, res, output_crtc, modeID, &mode);
-                SetXRandRDisplayName(dpy, EDID, display_name, sizeof (display_name), res->outputs[output], display_mm_width, display_mm_height);
+                SetXRandRModeInfo(res, rotation, modeID, &mode);
+                SetXRandRDisplayName(dpy, EDID, display_name, sizeof (display_name), res, screen, res->outputs[output], display_mm_width, display_mm_height);
 
                 SDL_zero(display);
                 if (*display_name) {
@@ -491,6 +547,11 @@ X11_InitModes_XRandR(_THIS)
             }
 
             X11_XRRFreeScreenResources(res);
+
+            /* Find out when outputs change, so the mode lists and
+               monitor names can be refreshed */
+            X11_XRRSelectInput(dpy, RootWindow(dpy, screen),
+                               RRScreenChangeNotifyMask | RROutputChangeNotifyMask);
         }
     }
 
@@ -498,8 +559,37 @@ X11_InitModes_XRandR(_THIS)
         return SDL_SetError("No available displays");
     }
 
+    if (!X11_XRRQueryExtension(dpy, &data->xrandr_event_base, &i)) {
+        data->xrandr_event_base = 0;
+    }
+
     return 0;
 }
+
+void
+X11_HandleXRandREvent(_THIS, XEvent *xevent)
+{
+    int i, j;
+
+    X11_XRRUpdateConfiguration(xevent);
+
+    num_cached_output_names = 0;
+
+    /* Enumerate modes again the next time they're asked for. Don't pull the
+       list out from under a fullscreen mode that's using one of them. */
+    for (i = 0; i < _this->num_displays; ++i) {
+        SDL_VideoDisplay *display = &_this->displays[i];
+
+        if (display->current_mode.driverdata != display->desktop_mode.driverdata) {
+            continue;
+        }
+        for (j = display->num_display_modes; j--;) {
+            SDL_free(display->display_modes[j].driverdata);
+            display->display_modes[j].driverdata = NULL;
+        }
+        display->num_display_modes = 0;
+    }
+}
 #endif /* SDL_VIDEO_DRIVER_X11_XRANDR */
 
 #if SDL_VIDEO_DRIVER_X11_XVIDMODE
@@ -890,14 +980,16 @@ X11_GetDisplayModes(_THIS, SDL_VideoDisplay * sdl_display)
     if (data->use_xrandr) {
         XRRScreenResources *res;
 
-        res = X11_XRRGetScreenResources (display, RootWindow(display, data->screen));
+        res = GetXRandRScreenResources(display, data->screen);
         if (res) {
             SDL_DisplayModeData *modedata;
             XRROutputInfo *output_info;
+            Rotation rotation;
             int i;
 
             output_info = X11_XRRGetOutputInfo(display, res, data->xrandr_output);
             if (output_info && output_info->connection != RR_Disconnected) {
+                rotation = GetXRandRRotation(display, res, output_info->crtc);
                 for (i = 0; i < output_info->nmode; ++i) {
                     modedata = (SDL_DisplayModeData *) SDL_calloc(1, sizeof(SDL_DisplayModeData));
                     if (!modedata) {
@@ -905,7 +997,7 @@ X11_GetDisplayModes(_THIS, SDL_VideoDisplay * sdl_display)
                     }
                     mode.driverdata = modedata;
 
-                    if (!SetXRandRModeInfo(display, res, output_info->crtc, output_info->modes[i], &mode) ||
+                    if (!SetXRandRModeInfo(res, rotation, output_info->modes[i], &mode) ||
                         !SDL_AddDisplayMode(sdl_display, &mode)) {
                         SDL_free(modedata);
                     }
@@ -980,7 +1072,7 @@ X11_SetDisplayMode(_THIS, SDL_VideoDisplay * sdl_display, SDL_DisplayMode * mode
         XRRCrtcInfo *crtc;
         Status status;
 
-        res = X11_XRRGetScreenResources (display, RootWindow(display, data->screen));
+        res = GetXRandRScreenResources(display, data->screen);
         if (!res) {
             return SDL_SetError("Couldn't get XRandR screen resources");
         }
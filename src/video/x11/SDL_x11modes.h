@@ -70,6 +70,9 @@ extern int X11_InitModes(_THIS);
 extern void X11_GetDisplayModes(_THIS, SDL_VideoDisplay * display);
 extern int X11_SetDisplayMode(_THIS, SDL_VideoDisplay * display, SDL_DisplayMode * mode);
 extern void X11_QuitModes(_THIS);
+#if SDL_VIDEO_DRIVER_X11_XRANDR
+extern void X11_HandleXRandREvent(_THIS, XEvent *xevent);
+#endif
 
 /* Some utility functions for working with visuals */
 extern int X11_GetVisualInfoFromVisual(Display * display, Visual * visual,
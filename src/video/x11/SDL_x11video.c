@@ -27,6 +27,7 @@
 #include "SDL_video.h"
 #include "SDL_mouse.h"
 #include "SDL_timer.h"
+#include "SDL_assert.h"
 #include "../SDL_sysvideo.h"
 #include "../SDL_pixels_c.h"
 
@@ -230,6 +231,7 @@ X11_CreateDevice(int devindex)
     device->SetDisplayMode = X11_SetDisplayMode;
     device->SuspendScreenSaver = X11_SuspendScreenSaver;
     device->PumpEvents = X11_PumpEvents;
+    device->WaitEventTimeout = X11_WaitEventTimeout;
 
     device->CreateSDLWindow = X11_CreateWindow;
     device->CreateSDLWindowFrom = X11_CreateWindowFrom;
@@ -388,6 +390,12 @@ int
 X11_VideoInit(_THIS)
 {
     SDL_VideoData *data = (SDL_VideoData *) _this->driverdata;
+    char *atom_names[64];
+    Atom *atom_values[64];
+    Atom atoms[64];
+    int num_atoms = 0;
+    Uint64 start;
+    int i;
 
     /* Get the window class name, usually the name of the application */
     data->classname = get_classname();
@@ -398,8 +406,8 @@ X11_VideoInit(_THIS)
     /* I have no idea how random this actually is, or has to be. */
     data->window_group = (XID) (((size_t) data->pid) ^ ((size_t) _this));
 
-    /* Look up some useful Atoms */
-#define GET_ATOM(X) data->X = X11_XInternAtom(data->display, #X, False)
+    /* Look up some useful Atoms, all in one round trip */
+#define GET_ATOM(X) atom_names[num_atoms] = #X; atom_values[num_atoms++] = &data->X
     GET_ATOM(WM_PROTOCOLS);
     GET_ATOM(WM_DELETE_WINDOW);
     GET_ATOM(WM_TAKE_FOCUS);
@@ -433,14 +441,26 @@ X11_VideoInit(_THIS)
     GET_ATOM(XdndFinished);
     GET_ATOM(XdndSelection);
     GET_ATOM(XKLAVIER_STATE);
+#undef GET_ATOM
+
+    SDL_assert(num_atoms <= (int) SDL_arraysize(atoms));
+    if (!X11_XInternAtoms(data->display, atom_names, num_atoms, False, atoms)) {
+        return SDL_SetError("Couldn't look up X11 atoms");
+    }
+    for (i = 0; i < num_atoms; ++i) {
+        *atom_values[i] = atoms[i];
+    }
 
     /* Detect the window manager */
     X11_CheckWindowManager(_this);
 
+    start = SDL_GetPerformanceCounter();
     if (X11_InitModes(_this) < 0) {
         return -1;
     }
+    _this->init_times.displays = SDL_GetPerformanceCounter() - start;
 
+    start = SDL_GetPerformanceCounter();
     X11_InitXinput2(_this);
 
     if (X11_InitKeyboard(_this) != 0) {
@@ -449,6 +469,7 @@ X11_VideoInit(_THIS)
     X11_InitMouse(_this);
 
     X11_InitTouch(_this);
+    _this->init_times.input = SDL_GetPerformanceCounter() - start;
 
 #if SDL_USE_LIBDBUS
     SDL_DBus_Init();
@@ -130,6 +130,10 @@ typedef struct SDL_VideoData
 
     Uint32 last_mode_change_deadline;
 
+#if SDL_VIDEO_DRIVER_X11_XRANDR
+    int xrandr_event_base;
+#endif
+
     SDL_bool global_mouse_changed;
     SDL_Point global_mouse_position;
     Uint32 global_mouse_buttons;
@@ -141,6 +145,10 @@ typedef struct SDL_VideoData
     KeyCode filter_code;
     Time    filter_time;
 
+#ifndef NO_SHARED_MEMORY
+    int shm_completion_event;
+#endif
+
 #if SDL_VIDEO_VULKAN
     /* Vulkan variables only valid if _this->vulkan_config.loader_handle is not NULL */
     void *vulkan_xlib_xcb_library;
@@ -40,6 +40,18 @@ typedef enum
     PENDING_FOCUS_OUT
 } PendingFocusEnum;
 
+#ifndef NO_SHARED_MEMORY
+#define X11_MAX_SHM_SEGMENTS    3
+
+typedef struct
+{
+    XShmSegmentInfo shminfo;
+    XImage *ximage;
+    SDL_bool busy;      /* presented, waiting for the ShmCompletion event */
+    Uint64 frame;       /* the window frame it was presented for */
+} X11_ShmSegment;
+#endif
+
 typedef struct
 {
     SDL_Window *window;
@@ -51,6 +63,11 @@ typedef struct
     /* MIT shared memory extension information */
     SDL_bool use_mitshm;
     XShmSegmentInfo shminfo;
+    /* The framebuffer is copied into these and presented asynchronously */
+    X11_ShmSegment shm_segments[X11_MAX_SHM_SEGMENTS];
+    int num_shm_segments;
+    int shm_segment;
+    void *shm_pixels;
 #endif
     XImage *ximage;
     GC gc;
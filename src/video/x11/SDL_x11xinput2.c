@@ -298,6 +298,20 @@ X11_Xinput2IsInitialized()
 #endif
 }
 
+/* This only looks at the event's header, so it works on queued events
+   whose data hasn't been fetched yet */
+int
+X11_Xinput2IsRawMotion(const XEvent *xevent)
+{
+#if SDL_VIDEO_DRIVER_X11_XINPUT2
+    return xinput2_initialized && xevent->type == GenericEvent &&
+           xevent->xcookie.extension == xinput2_opcode &&
+           xevent->xcookie.evtype == XI_RawMotion;
+#else
+    return 0;
+#endif
+}
+
 int
 X11_Xinput2IsMultitouchSupported()
 {
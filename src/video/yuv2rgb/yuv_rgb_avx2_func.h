@@ -0,0 +1,407 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+/* AVX2 version of yuv_rgb_sse_func.h, converting 64 pixels per iteration.
+
+   The 256-bit unpack and pack instructions work within each 128-bit lane,
+   so the chroma values are loaded with their 8-byte quarters swapped into
+   the order [0 2 | 1 3]. After unpacking, each lane then holds the chroma
+   for the same pixels as the luma in that lane, and packing the results
+   brings the pixels back into memory order.
+*/
+
+/* You need to define the following macros before including this file:
+	AVX2_FUNCTION_NAME
+	SSE_FUNCTION_NAME
+	YUV_FORMAT
+	RGB_FORMAT
+*/
+
+#define LOAD_SI256 _mm256_loadu_si256
+#define SAVE_SI256 _mm256_storeu_si256
+
+#define UV2RGB_32(U,V,R1,G1,B1,R2,G2,B2) \
+	r_tmp = _mm256_mullo_epi16(V, _mm256_set1_epi16(param->v_r_factor)); \
+	g_tmp = _mm256_add_epi16( \
+		_mm256_mullo_epi16(U, _mm256_set1_epi16(param->u_g_factor)), \
+		_mm256_mullo_epi16(V, _mm256_set1_epi16(param->v_g_factor))); \
+	b_tmp = _mm256_mullo_epi16(U, _mm256_set1_epi16(param->u_b_factor)); \
+	R1 = _mm256_unpacklo_epi16(r_tmp, r_tmp); \
+	G1 = _mm256_unpacklo_epi16(g_tmp, g_tmp); \
+	B1 = _mm256_unpacklo_epi16(b_tmp, b_tmp); \
+	R2 = _mm256_unpackhi_epi16(r_tmp, r_tmp); \
+	G2 = _mm256_unpackhi_epi16(g_tmp, g_tmp); \
+	B2 = _mm256_unpackhi_epi16(b_tmp, b_tmp); \
+
+/* Saturating adds, a bright luma plus a strong chroma term does not fit in 16 bits */
+#define ADD_Y2RGB_32(Y1,Y2,R1,G1,B1,R2,G2,B2) \
+	Y1 = _mm256_mullo_epi16(_mm256_sub_epi16(Y1, _mm256_set1_epi16(param->y_shift)), _mm256_set1_epi16(param->y_factor)); \
+	Y2 = _mm256_mullo_epi16(_mm256_sub_epi16(Y2, _mm256_set1_epi16(param->y_shift)), _mm256_set1_epi16(param->y_factor)); \
+	\
+	R1 = _mm256_srai_epi16(_mm256_adds_epi16(R1, Y1), PRECISION); \
+	G1 = _mm256_srai_epi16(_mm256_adds_epi16(G1, Y1), PRECISION); \
+	B1 = _mm256_srai_epi16(_mm256_adds_epi16(B1, Y1), PRECISION); \
+	R2 = _mm256_srai_epi16(_mm256_adds_epi16(R2, Y2), PRECISION); \
+	G2 = _mm256_srai_epi16(_mm256_adds_epi16(G2, Y2), PRECISION); \
+	B2 = _mm256_srai_epi16(_mm256_adds_epi16(B2, Y2), PRECISION); \
+
+/* Takes 32 pixels in memory order, stores 64 bytes */
+#define PACK_RGB565_64(R, G, B, RGB1, RGB2) \
+{ \
+	__m256i red_mask, lo, hi, tmp1, tmp2; \
+\
+	red_mask = _mm256_set1_epi16(0xF800); \
+	lo = _mm256_and_si256(_mm256_unpacklo_epi8(_mm256_setzero_si256(), R), red_mask); \
+	hi = _mm256_and_si256(_mm256_unpackhi_epi8(_mm256_setzero_si256(), R), red_mask); \
+	tmp1 = _mm256_slli_epi16(_mm256_srli_epi16(_mm256_unpacklo_epi8(G, _mm256_setzero_si256()), 2), 5); \
+	tmp2 = _mm256_slli_epi16(_mm256_srli_epi16(_mm256_unpackhi_epi8(G, _mm256_setzero_si256()), 2), 5); \
+	lo = _mm256_or_si256(lo, tmp1); \
+	hi = _mm256_or_si256(hi, tmp2); \
+	tmp1 = _mm256_srli_epi16(_mm256_unpacklo_epi8(B, _mm256_setzero_si256()), 3); \
+	tmp2 = _mm256_srli_epi16(_mm256_unpackhi_epi8(B, _mm256_setzero_si256()), 3); \
+	lo = _mm256_or_si256(lo, tmp1); \
+	hi = _mm256_or_si256(hi, tmp2); \
+	RGB1 = _mm256_permute2x128_si256(lo, hi, 0x20); \
+	RGB2 = _mm256_permute2x128_si256(lo, hi, 0x31); \
+}
+
+/* Takes 32 pixels in memory order, stores 128 bytes */
+#define PACK_RGBA_64(R, G, B, A, RGB1, RGB2, RGB3, RGB4) \
+{ \
+	__m256i lo_ab, hi_ab, lo_gr, hi_gr, tmp1, tmp2, tmp3, tmp4; \
+\
+	lo_ab = _mm256_unpacklo_epi8( A, B ); \
+	hi_ab = _mm256_unpackhi_epi8( A, B ); \
+	lo_gr = _mm256_unpacklo_epi8( G, R ); \
+	hi_gr = _mm256_unpackhi_epi8( G, R ); \
+	tmp1 = _mm256_unpacklo_epi16( lo_ab, lo_gr ); \
+	tmp2 = _mm256_unpackhi_epi16( lo_ab, lo_gr ); \
+	tmp3 = _mm256_unpacklo_epi16( hi_ab, hi_gr ); \
+	tmp4 = _mm256_unpackhi_epi16( hi_ab, hi_gr ); \
+	RGB1 = _mm256_permute2x128_si256(tmp1, tmp2, 0x20); \
+	RGB2 = _mm256_permute2x128_si256(tmp3, tmp4, 0x20); \
+	RGB3 = _mm256_permute2x128_si256(tmp1, tmp2, 0x31); \
+	RGB4 = _mm256_permute2x128_si256(tmp3, tmp4, 0x31); \
+}
+
+/* The 24-bit shuffle doesn't map onto 128-bit lanes, so it is done with
+   the SSE2 steps on each half of the 256-bit registers. */
+#define PACK_RGB24_32_STEP1(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+RGB1 = _mm_packus_epi16(_mm_and_si128(R1,_mm_set1_epi16(0xFF)), _mm_and_si128(R2,_mm_set1_epi16(0xFF))); \
+RGB2 = _mm_packus_epi16(_mm_and_si128(G1,_mm_set1_epi16(0xFF)), _mm_and_si128(G2,_mm_set1_epi16(0xFF))); \
+RGB3 = _mm_packus_epi16(_mm_and_si128(B1,_mm_set1_epi16(0xFF)), _mm_and_si128(B2,_mm_set1_epi16(0xFF))); \
+RGB4 = _mm_packus_epi16(_mm_srli_epi16(R1,8), _mm_srli_epi16(R2,8)); \
+RGB5 = _mm_packus_epi16(_mm_srli_epi16(G1,8), _mm_srli_epi16(G2,8)); \
+RGB6 = _mm_packus_epi16(_mm_srli_epi16(B1,8), _mm_srli_epi16(B2,8)); \
+
+#define PACK_RGB24_32_STEP2(R1, R2, G1, G2, B1, B2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+R1 = _mm_packus_epi16(_mm_and_si128(RGB1,_mm_set1_epi16(0xFF)), _mm_and_si128(RGB2,_mm_set1_epi16(0xFF))); \
+R2 = _mm_packus_epi16(_mm_and_si128(RGB3,_mm_set1_epi16(0xFF)), _mm_and_si128(RGB4,_mm_set1_epi16(0xFF))); \
+G1 = _mm_packus_epi16(_mm_and_si128(RGB5,_mm_set1_epi16(0xFF)), _mm_and_si128(RGB6,_mm_set1_epi16(0xFF))); \
+G2 = _mm_packus_epi16(_mm_srli_epi16(RGB1,8), _mm_srli_epi16(RGB2,8)); \
+B1 = _mm_packus_epi16(_mm_srli_epi16(RGB3,8), _mm_srli_epi16(RGB4,8)); \
+B2 = _mm_packus_epi16(_mm_srli_epi16(RGB5,8), _mm_srli_epi16(RGB6,8)); \
+
+/* Takes 32 pixels in memory order, stores 96 bytes */
+#define PACK_RGB24_64(R, G, B, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+{ \
+	__m128i r1 = _mm256_castsi256_si128(R), r2 = _mm256_extracti128_si256(R, 1); \
+	__m128i g1 = _mm256_castsi256_si128(G), g2 = _mm256_extracti128_si256(G, 1); \
+	__m128i b1 = _mm256_castsi256_si128(B), b2 = _mm256_extracti128_si256(B, 1); \
+	\
+	PACK_RGB24_32_STEP1(r1, r2, g1, g2, b1, b2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+	PACK_RGB24_32_STEP2(r1, r2, g1, g2, b1, b2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+	PACK_RGB24_32_STEP1(r1, r2, g1, g2, b1, b2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+	PACK_RGB24_32_STEP2(r1, r2, g1, g2, b1, b2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+	PACK_RGB24_32_STEP1(r1, r2, g1, g2, b1, b2, RGB1, RGB2, RGB3, RGB4, RGB5, RGB6) \
+}
+
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+
+#define PACK_AND_SAVE_LINE(rgb_ptr, r1, g1, b1, r2, g2, b2) \
+{ \
+	__m256i rgb_1, rgb_2, rgb_3, rgb_4; \
+	\
+	PACK_RGB565_64(r1, g1, b1, rgb_1, rgb_2) \
+	PACK_RGB565_64(r2, g2, b2, rgb_3, rgb_4) \
+	SAVE_SI256((__m256i*)(rgb_ptr), rgb_1); \
+	SAVE_SI256((__m256i*)(rgb_ptr+32), rgb_2); \
+	SAVE_SI256((__m256i*)(rgb_ptr+64), rgb_3); \
+	SAVE_SI256((__m256i*)(rgb_ptr+96), rgb_4); \
+}
+
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+
+#define PACK_AND_SAVE_LINE(rgb_ptr, r1, g1, b1, r2, g2, b2) \
+{ \
+	__m128i rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6; \
+	\
+	PACK_RGB24_64(r1, g1, b1, rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6) \
+	_mm_storeu_si128((__m128i*)(rgb_ptr), rgb_1); \
+	_mm_storeu_si128((__m128i*)(rgb_ptr+16), rgb_2); \
+	_mm_storeu_si128((__m128i*)(rgb_ptr+32), rgb_3); \
+	_mm_storeu_si128((__m128i*)(rgb_ptr+48), rgb_4); \
+	_mm_storeu_si128((__m128i*)(rgb_ptr+64), rgb_5); \
+	_mm_storeu_si128((__m128i*)(rgb_ptr+80), rgb_6); \
+	PACK_RGB24_64(r2, g2, b2, rgb_1, rgb_2, rgb_3, rgb_4, rgb_5, rgb_6) \
+	_mm_storeu_si128((__m128i*)(rgb_ptr+96), rgb_1); \
+	_mm_storeu_si128((__m128i*)(rgb_ptr+112), rgb_2); \
+	_mm_storeu_si128((__m128i*)(rgb_ptr+128), rgb_3); \
+	_mm_storeu_si128((__m128i*)(rgb_ptr+144), rgb_4); \
+	_mm_storeu_si128((__m128i*)(rgb_ptr+160), rgb_5); \
+	_mm_storeu_si128((__m128i*)(rgb_ptr+176), rgb_6); \
+}
+
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+
+/* Same channel order as PACK_RGBA_32 in yuv_rgb_sse_func.h */
+#if RGB_FORMAT == RGB_FORMAT_RGBA
+#define PACK_RGBA_ORDER(r, g, b, a) r, g, b, a
+#elif RGB_FORMAT == RGB_FORMAT_BGRA
+#define PACK_RGBA_ORDER(r, g, b, a) b, g, r, a
+#elif RGB_FORMAT == RGB_FORMAT_ARGB
+#define PACK_RGBA_ORDER(r, g, b, a) a, r, g, b
+#elif RGB_FORMAT == RGB_FORMAT_ABGR
+#define PACK_RGBA_ORDER(r, g, b, a) a, b, g, r
+#endif
+
+#define PACK_RGBA_64_EXPAND(x) PACK_RGBA_64 x
+
+#define PACK_AND_SAVE_LINE(rgb_ptr, r1, g1, b1, r2, g2, b2) \
+{ \
+	__m256i rgb_1, rgb_2, rgb_3, rgb_4; \
+	const __m256i a = _mm256_set1_epi8( (char)0xFF ); \
+	\
+	PACK_RGBA_64_EXPAND((PACK_RGBA_ORDER(r1, g1, b1, a), rgb_1, rgb_2, rgb_3, rgb_4)) \
+	SAVE_SI256((__m256i*)(rgb_ptr), rgb_1); \
+	SAVE_SI256((__m256i*)(rgb_ptr+32), rgb_2); \
+	SAVE_SI256((__m256i*)(rgb_ptr+64), rgb_3); \
+	SAVE_SI256((__m256i*)(rgb_ptr+96), rgb_4); \
+	PACK_RGBA_64_EXPAND((PACK_RGBA_ORDER(r2, g2, b2, a), rgb_1, rgb_2, rgb_3, rgb_4)) \
+	SAVE_SI256((__m256i*)(rgb_ptr+128), rgb_1); \
+	SAVE_SI256((__m256i*)(rgb_ptr+160), rgb_2); \
+	SAVE_SI256((__m256i*)(rgb_ptr+192), rgb_3); \
+	SAVE_SI256((__m256i*)(rgb_ptr+224), rgb_4); \
+}
+
+#else
+#error PACK_AND_SAVE_LINE unimplemented
+#endif
+
+/* READ_UV leaves the chroma quarters in the order [0 2 | 1 3] */
+#if YUV_FORMAT == YUV_FORMAT_420
+
+#define READ_Y(y_ptr) \
+	y_8 = LOAD_SI256((const __m256i*)(y_ptr)); \
+
+#define READ_UV	\
+	u = _mm256_permute4x64_epi64(LOAD_SI256((const __m256i*)(u_ptr)), _MM_SHUFFLE(3, 1, 2, 0)); \
+	v = _mm256_permute4x64_epi64(LOAD_SI256((const __m256i*)(v_ptr)), _MM_SHUFFLE(3, 1, 2, 0)); \
+
+#elif YUV_FORMAT == YUV_FORMAT_422
+
+#define READ_Y(y_ptr) \
+{ \
+	__m256i y1, y2; \
+	y1 = _mm256_srli_epi16(_mm256_slli_epi16(LOAD_SI256((const __m256i*)(y_ptr)), 8), 8); \
+	y2 = _mm256_srli_epi16(_mm256_slli_epi16(LOAD_SI256((const __m256i*)(y_ptr+32)), 8), 8); \
+	y_8 = _mm256_permute4x64_epi64(_mm256_packus_epi16(y1, y2), _MM_SHUFFLE(3, 1, 2, 0)); \
+}
+
+#define READ_UV_422(dst, ptr) \
+{ \
+	__m256i c1, c2, c3, c4; \
+	c1 = _mm256_srli_epi32(_mm256_slli_epi32(LOAD_SI256((const __m256i*)(ptr)), 24), 24); \
+	c2 = _mm256_srli_epi32(_mm256_slli_epi32(LOAD_SI256((const __m256i*)(ptr+32)), 24), 24); \
+	c3 = _mm256_srli_epi32(_mm256_slli_epi32(LOAD_SI256((const __m256i*)(ptr+64)), 24), 24); \
+	c4 = _mm256_srli_epi32(_mm256_slli_epi32(LOAD_SI256((const __m256i*)(ptr+96)), 24), 24); \
+	dst = _mm256_packus_epi16(_mm256_packs_epi32(c1, c2), _mm256_packs_epi32(c3, c4)); \
+	dst = _mm256_permutevar8x32_epi32(dst, _mm256_setr_epi32(0, 4, 2, 6, 1, 5, 3, 7)); \
+}
+
+#define READ_UV	\
+	READ_UV_422(u, u_ptr) \
+	READ_UV_422(v, v_ptr) \
+
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+
+#define READ_Y(y_ptr) \
+	y_8 = LOAD_SI256((const __m256i*)(y_ptr)); \
+
+/* Packing the 16-bit values within each lane already gives [0 2 | 1 3] */
+#define READ_UV	\
+{ \
+	__m256i u1, u2, v1, v2; \
+	u1 = _mm256_srli_epi16(_mm256_slli_epi16(LOAD_SI256((const __m256i*)(u_ptr)), 8), 8); \
+	u2 = _mm256_srli_epi16(_mm256_slli_epi16(LOAD_SI256((const __m256i*)(u_ptr+32)), 8), 8); \
+	u = _mm256_packus_epi16(u1, u2); \
+	v1 = _mm256_srli_epi16(_mm256_slli_epi16(LOAD_SI256((const __m256i*)(v_ptr)), 8), 8); \
+	v2 = _mm256_srli_epi16(_mm256_slli_epi16(LOAD_SI256((const __m256i*)(v_ptr+32)), 8), 8); \
+	v = _mm256_packus_epi16(v1, v2); \
+}
+
+#else
+#error READ_UV unimplemented
+#endif
+
+/* Converts 32 pixels of the chroma in u_16/v_16 against the luma at y_ptr */
+#define YUV2RGB_HALF(y_ptr, r_8, g_8, b_8) \
+	r_16_1=r_uv_16_1; g_16_1=g_uv_16_1; b_16_1=b_uv_16_1; \
+	r_16_2=r_uv_16_2; g_16_2=g_uv_16_2; b_16_2=b_uv_16_2; \
+	\
+	READ_Y(y_ptr) \
+	y_16_1 = _mm256_unpacklo_epi8(y_8, _mm256_setzero_si256()); \
+	y_16_2 = _mm256_unpackhi_epi8(y_8, _mm256_setzero_si256()); \
+	\
+	ADD_Y2RGB_32(y_16_1, y_16_2, r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2) \
+	\
+	r_8 = _mm256_packus_epi16(r_16_1, r_16_2); \
+	g_8 = _mm256_packus_epi16(g_16_1, g_16_2); \
+	b_8 = _mm256_packus_epi16(b_16_1, b_16_2); \
+
+#define UV_HALF(unpack) \
+	u_16 = _mm256_add_epi16(unpack(u, _mm256_setzero_si256()), _mm256_set1_epi16(-128)); \
+	v_16 = _mm256_add_epi16(unpack(v, _mm256_setzero_si256()), _mm256_set1_epi16(-128)); \
+	\
+	UV2RGB_32(u_16, v_16, r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2) \
+
+#define YUV2RGB_64 \
+	__m256i r_tmp, g_tmp, b_tmp; \
+	__m256i r_16_1, g_16_1, b_16_1, r_16_2, g_16_2, b_16_2; \
+	__m256i r_uv_16_1, g_uv_16_1, b_uv_16_1, r_uv_16_2, g_uv_16_2, b_uv_16_2; \
+	__m256i y_16_1, y_16_2; \
+	__m256i y_8, u, v, u_16, v_16; \
+	__m256i r_8_11, g_8_11, b_8_11, r_8_21, g_8_21, b_8_21; \
+	__m256i r_8_12, g_8_12, b_8_12, r_8_22, g_8_22, b_8_22; \
+	\
+	READ_UV \
+	\
+	/* first 32 pixels of both lines */\
+	UV_HALF(_mm256_unpacklo_epi8) \
+	YUV2RGB_HALF(y_ptr1, r_8_11, g_8_11, b_8_11) \
+	if (uv_y_sample_interval > 1) { \
+		YUV2RGB_HALF(y_ptr2, r_8_21, g_8_21, b_8_21) \
+	} \
+	\
+	/* last 32 pixels of both lines */\
+	UV_HALF(_mm256_unpackhi_epi8) \
+	YUV2RGB_HALF(y_ptr1+32*y_pixel_stride, r_8_12, g_8_12, b_8_12) \
+	if (uv_y_sample_interval > 1) { \
+		YUV2RGB_HALF(y_ptr2+32*y_pixel_stride, r_8_22, g_8_22, b_8_22) \
+	} \
+
+
+SDL_TARGETING("avx2") void AVX2_FUNCTION_NAME(uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+#if YUV_FORMAT == YUV_FORMAT_420
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 1;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#elif YUV_FORMAT == YUV_FORMAT_422
+	const int y_pixel_stride = 2;
+	const int uv_pixel_stride = 4;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 1;
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 2;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#endif
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+	const int rgb_pixel_stride = 2;
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+	const int rgb_pixel_stride = 3;
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+	const int rgb_pixel_stride = 4;
+#else
+#error Unknown RGB pixel size
+#endif
+	const uint32_t converted = (width & ~63);
+
+	if (width >= 64 && height >= (uint32_t)uv_y_sample_interval) {
+		uint32_t x, y;
+		for(y=0; y<(height-(uv_y_sample_interval-1)); y+=uv_y_sample_interval)
+		{
+			const uint8_t *y_ptr1=Y+y*Y_stride,
+				*y_ptr2=Y+(y+1)*Y_stride,
+				*u_ptr=U+(y/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(y/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+				*rgb_ptr2=RGB+(y+1)*RGB_stride;
+
+			for(x=0; x<converted; x+=64)
+			{
+				YUV2RGB_64
+				PACK_AND_SAVE_LINE(rgb_ptr1, r_8_11, g_8_11, b_8_11, r_8_12, g_8_12, b_8_12)
+				if (uv_y_sample_interval > 1)
+				{
+					PACK_AND_SAVE_LINE(rgb_ptr2, r_8_21, g_8_21, b_8_21, r_8_22, g_8_22, b_8_22)
+				}
+
+				y_ptr1+=64*y_pixel_stride;
+				y_ptr2+=64*y_pixel_stride;
+				u_ptr+=64*uv_pixel_stride/uv_x_sample_interval;
+				v_ptr+=64*uv_pixel_stride/uv_x_sample_interval;
+				rgb_ptr1+=64*rgb_pixel_stride;
+				rgb_ptr2+=64*rgb_pixel_stride;
+			}
+		}
+
+		/* Catch the last line, if needed */
+		if (uv_y_sample_interval == 2 && y == (height-1))
+		{
+			const uint8_t *y_ptr=Y+y*Y_stride,
+				*u_ptr=U+(y/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(y/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr=RGB+y*RGB_stride;
+
+			SSE_FUNCTION_NAME(converted, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+		}
+	}
+
+	/* Catch the right column, if needed */
+	if (converted != width || height < (uint32_t)uv_y_sample_interval)
+	{
+		const uint32_t start = (height < (uint32_t)uv_y_sample_interval) ? 0 : converted;
+		const uint8_t *y_ptr=Y+start*y_pixel_stride,
+			*u_ptr=U+start*uv_pixel_stride/uv_x_sample_interval,
+			*v_ptr=V+start*uv_pixel_stride/uv_x_sample_interval;
+
+		uint8_t *rgb_ptr=RGB+start*rgb_pixel_stride;
+
+		SSE_FUNCTION_NAME(width-start, height, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+	}
+}
+
+#undef AVX2_FUNCTION_NAME
+#undef SSE_FUNCTION_NAME
+#undef YUV_FORMAT
+#undef RGB_FORMAT
+#undef LOAD_SI256
+#undef SAVE_SI256
+#undef UV2RGB_32
+#undef ADD_Y2RGB_32
+#undef PACK_RGB565_64
+#undef PACK_RGBA_64
+#undef PACK_RGB24_32_STEP1
+#undef PACK_RGB24_32_STEP2
+#undef PACK_RGB24_64
+#undef PACK_RGBA_ORDER
+#undef PACK_RGBA_64_EXPAND
+#undef PACK_AND_SAVE_LINE
+#undef READ_Y
+#undef READ_UV_422
+#undef READ_UV
+#undef YUV2RGB_HALF
+#undef UV_HALF
+#undef YUV2RGB_64
@@ -0,0 +1,254 @@
+// Copyright 2016 Adrien Descamps
+// Distributed under BSD 3-Clause License
+
+/* NEON version of yuv_rgb_sse_func.h, converting 16 pixels per iteration.
+   It uses the same 16-bit fixed point math as the SSE2 code, so both give
+   the same results. */
+
+/* You need to define the following macros before including this file:
+	NEON_FUNCTION_NAME
+	STD_FUNCTION_NAME
+	YUV_FORMAT
+	RGB_FORMAT
+*/
+
+#if YUV_FORMAT == YUV_FORMAT_420
+
+#define READ_Y(y_ptr) \
+	y_8 = vld1q_u8(y_ptr); \
+
+#define READ_UV \
+	u = vld1_u8(u_ptr); \
+	v = vld1_u8(v_ptr); \
+
+#elif YUV_FORMAT == YUV_FORMAT_422
+
+#define READ_Y(y_ptr) \
+	y_8 = vld2q_u8(y_ptr).val[0]; \
+
+#define READ_UV \
+	u = vld4_u8(u_ptr).val[0]; \
+	v = vld4_u8(v_ptr).val[0]; \
+
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+
+#define READ_Y(y_ptr) \
+	y_8 = vld1q_u8(y_ptr); \
+
+#define READ_UV \
+	u = vld2_u8(u_ptr).val[0]; \
+	v = vld2_u8(v_ptr).val[0]; \
+
+#else
+#error READ_UV unimplemented
+#endif
+
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+
+#define PACK_AND_SAVE_LINE(rgb_ptr, r, g, b) \
+{ \
+	uint16x8_t lo, hi; \
+	lo = vshll_n_u8(vget_low_u8(r), 8); \
+	lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(g), 8), 5); \
+	lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(b), 8), 11); \
+	hi = vshll_n_u8(vget_high_u8(r), 8); \
+	hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(g), 8), 5); \
+	hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(b), 8), 11); \
+	vst1q_u16((uint16_t *)(rgb_ptr), lo); \
+	vst1q_u16((uint16_t *)(rgb_ptr+16), hi); \
+}
+
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+
+#define PACK_AND_SAVE_LINE(rgb_ptr, r, g, b) \
+{ \
+	uint8x16x3_t pixels; \
+	pixels.val[0] = r; \
+	pixels.val[1] = g; \
+	pixels.val[2] = b; \
+	vst3q_u8(rgb_ptr, pixels); \
+}
+
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+
+/* Bytes in memory order, matching the little endian packed formats */
+#if RGB_FORMAT == RGB_FORMAT_RGBA
+#define PACK_RGBA_ORDER(r, g, b, a) a, b, g, r
+#elif RGB_FORMAT == RGB_FORMAT_BGRA
+#define PACK_RGBA_ORDER(r, g, b, a) a, r, g, b
+#elif RGB_FORMAT == RGB_FORMAT_ARGB
+#define PACK_RGBA_ORDER(r, g, b, a) b, g, r, a
+#elif RGB_FORMAT == RGB_FORMAT_ABGR
+#define PACK_RGBA_ORDER(r, g, b, a) r, g, b, a
+#endif
+
+#define PACK_RGBA_16(c0, c1, c2, c3, rgb_ptr) \
+{ \
+	uint8x16x4_t pixels; \
+	pixels.val[0] = c0; \
+	pixels.val[1] = c1; \
+	pixels.val[2] = c2; \
+	pixels.val[3] = c3; \
+	vst4q_u8(rgb_ptr, pixels); \
+}
+#define PACK_RGBA_16_EXPAND(x) PACK_RGBA_16 x
+
+#define PACK_AND_SAVE_LINE(rgb_ptr, r, g, b) \
+	PACK_RGBA_16_EXPAND((PACK_RGBA_ORDER(r, g, b, vdupq_n_u8(0xFF)), rgb_ptr)) \
+
+#else
+#error PACK_AND_SAVE_LINE unimplemented
+#endif
+
+/* Adds the luma at y_ptr to the chroma terms and narrows to 16 pixels */
+/* Saturating adds, a bright luma plus a strong chroma term does not fit in 16 bits */
+#define ADD_Y2RGB_16(y_ptr, r_8, g_8, b_8) \
+{ \
+	int16x8_t y_16_1, y_16_2; \
+	\
+	READ_Y(y_ptr) \
+	y_16_1 = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y_8))); \
+	y_16_2 = vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y_8))); \
+	y_16_1 = vmulq_s16(vsubq_s16(y_16_1, y_shift), y_factor); \
+	y_16_2 = vmulq_s16(vsubq_s16(y_16_2, y_shift), y_factor); \
+	\
+	r_8 = vcombine_u8(vqmovun_s16(vshrq_n_s16(vqaddq_s16(r_uv.val[0], y_16_1), PRECISION)), \
+	                  vqmovun_s16(vshrq_n_s16(vqaddq_s16(r_uv.val[1], y_16_2), PRECISION))); \
+	g_8 = vcombine_u8(vqmovun_s16(vshrq_n_s16(vqaddq_s16(g_uv.val[0], y_16_1), PRECISION)), \
+	                  vqmovun_s16(vshrq_n_s16(vqaddq_s16(g_uv.val[1], y_16_2), PRECISION))); \
+	b_8 = vcombine_u8(vqmovun_s16(vshrq_n_s16(vqaddq_s16(b_uv.val[0], y_16_1), PRECISION)), \
+	                  vqmovun_s16(vshrq_n_s16(vqaddq_s16(b_uv.val[1], y_16_2), PRECISION))); \
+}
+
+#define YUV2RGB_16 \
+	uint8x16_t y_8; \
+	uint8x8_t u, v; \
+	int16x8_t u_16, v_16; \
+	int16x8x2_t r_uv, g_uv, b_uv; \
+	uint8x16_t r_8_1, g_8_1, b_8_1, r_8_2, g_8_2, b_8_2; \
+	\
+	READ_UV \
+	\
+	u_16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u)), vdupq_n_s16(128)); \
+	v_16 = vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v)), vdupq_n_s16(128)); \
+	\
+	/* each chroma value covers two horizontal pixels */\
+	r_uv = vzipq_s16(vmulq_s16(v_16, v_r_factor), vmulq_s16(v_16, v_r_factor)); \
+	g_uv = vzipq_s16(vaddq_s16(vmulq_s16(u_16, u_g_factor), vmulq_s16(v_16, v_g_factor)), \
+	                 vaddq_s16(vmulq_s16(u_16, u_g_factor), vmulq_s16(v_16, v_g_factor))); \
+	b_uv = vzipq_s16(vmulq_s16(u_16, u_b_factor), vmulq_s16(u_16, u_b_factor)); \
+	\
+	ADD_Y2RGB_16(y_ptr1, r_8_1, g_8_1, b_8_1) \
+	PACK_AND_SAVE_LINE(rgb_ptr1, r_8_1, g_8_1, b_8_1) \
+	if (uv_y_sample_interval > 1) { \
+		ADD_Y2RGB_16(y_ptr2, r_8_2, g_8_2, b_8_2) \
+		PACK_AND_SAVE_LINE(rgb_ptr2, r_8_2, g_8_2, b_8_2) \
+	} \
+
+
+void NEON_FUNCTION_NAME(uint32_t width, uint32_t height,
+	const uint8_t *Y, const uint8_t *U, const uint8_t *V, uint32_t Y_stride, uint32_t UV_stride,
+	uint8_t *RGB, uint32_t RGB_stride,
+	YCbCrType yuv_type)
+{
+	const YUV2RGBParam *const param = &(YUV2RGB[yuv_type]);
+	const int16x8_t y_shift = vdupq_n_s16(param->y_shift);
+	const int16x8_t y_factor = vdupq_n_s16(param->y_factor);
+	const int16x8_t v_r_factor = vdupq_n_s16(param->v_r_factor);
+	const int16x8_t u_g_factor = vdupq_n_s16(param->u_g_factor);
+	const int16x8_t v_g_factor = vdupq_n_s16(param->v_g_factor);
+	const int16x8_t u_b_factor = vdupq_n_s16(param->u_b_factor);
+#if YUV_FORMAT == YUV_FORMAT_420
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 1;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#elif YUV_FORMAT == YUV_FORMAT_422
+	const int y_pixel_stride = 2;
+	const int uv_pixel_stride = 4;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 1;
+#elif YUV_FORMAT == YUV_FORMAT_NV12
+	const int y_pixel_stride = 1;
+	const int uv_pixel_stride = 2;
+	const int uv_x_sample_interval = 2;
+	const int uv_y_sample_interval = 2;
+#endif
+#if RGB_FORMAT == RGB_FORMAT_RGB565
+	const int rgb_pixel_stride = 2;
+#elif RGB_FORMAT == RGB_FORMAT_RGB24
+	const int rgb_pixel_stride = 3;
+#elif RGB_FORMAT == RGB_FORMAT_RGBA || RGB_FORMAT == RGB_FORMAT_BGRA || \
+      RGB_FORMAT == RGB_FORMAT_ARGB || RGB_FORMAT == RGB_FORMAT_ABGR
+	const int rgb_pixel_stride = 4;
+#else
+#error Unknown RGB pixel size
+#endif
+
+	if (width >= 16) {
+		uint32_t x, y;
+		for(y=0; y<(height-(uv_y_sample_interval-1)); y+=uv_y_sample_interval)
+		{
+			const uint8_t *y_ptr1=Y+y*Y_stride,
+				*y_ptr2=Y+(y+1)*Y_stride,
+				*u_ptr=U+(y/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(y/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr1=RGB+y*RGB_stride,
+				*rgb_ptr2=RGB+(y+1)*RGB_stride;
+
+			for(x=0; x<(width-15); x+=16)
+			{
+				YUV2RGB_16
+
+				y_ptr1+=16*y_pixel_stride;
+				y_ptr2+=16*y_pixel_stride;
+				u_ptr+=16*uv_pixel_stride/uv_x_sample_interval;
+				v_ptr+=16*uv_pixel_stride/uv_x_sample_interval;
+				rgb_ptr1+=16*rgb_pixel_stride;
+				rgb_ptr2+=16*rgb_pixel_stride;
+			}
+		}
+
+		/* Catch the last line, if needed */
+		if (uv_y_sample_interval == 2 && y == (height-1))
+		{
+			const uint8_t *y_ptr=Y+y*Y_stride,
+				*u_ptr=U+(y/uv_y_sample_interval)*UV_stride,
+				*v_ptr=V+(y/uv_y_sample_interval)*UV_stride;
+
+			uint8_t *rgb_ptr=RGB+y*RGB_stride;
+
+			STD_FUNCTION_NAME(width, 1, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+		}
+	}
+
+	/* Catch the right column, if needed */
+	{
+		int converted = (width & ~15);
+		if (converted != width)
+		{
+			const uint8_t *y_ptr=Y+converted*y_pixel_stride,
+				*u_ptr=U+converted*uv_pixel_stride/uv_x_sample_interval,
+				*v_ptr=V+converted*uv_pixel_stride/uv_x_sample_interval;
+
+			uint8_t *rgb_ptr=RGB+converted*rgb_pixel_stride;
+
+			STD_FUNCTION_NAME(width-converted, height, y_ptr, u_ptr, v_ptr, Y_stride, UV_stride, rgb_ptr, RGB_stride, yuv_type);
+		}
+	}
+}
+
+#undef NEON_FUNCTION_NAME
+#undef STD_FUNCTION_NAME
+#undef YUV_FORMAT
+#undef RGB_FORMAT
+#undef READ_Y
+#undef READ_UV
+#undef PACK_RGBA_ORDER
+#undef PACK_RGBA_16
+#undef PACK_RGBA_16_EXPAND
+#undef PACK_AND_SAVE_LINE
+#undef ADD_Y2RGB_16
+#undef YUV2RGB_16
@@ -0,0 +1,1078 @@
+/* DO NOT EDIT!  This file is generated by sdlgenblit.pl */
+/**
+ * Generated blitter test suite
+ *
+ * SDL_blit_auto.c has vector versions of some of its blitters, and picks
+ * them whenever the CPU supports them. These tests check that every one of
+ * them gives exactly the same pixels as the C code it was generated from.
+ * Set SDL_BLIT_CPU_FEATURES to test a particular instruction set.
+ */
+
+#include "SDL.h"
+#include "SDL_test.h"
+
+#define SDL_COPY_MODULATE_COLOR     0x00000001
+#define SDL_COPY_MODULATE_ALPHA     0x00000002
+#define SDL_COPY_BLEND              0x00000010
+#define SDL_COPY_ADD                0x00000020
+#define SDL_COPY_MOD                0x00000040
+#define SDL_COPY_NEAREST            0x00000200
+
+typedef struct
+{
+    Uint8 *src;
+    int src_w, src_h;
+    int src_pitch;
+    Uint8 *dst;
+    int dst_w, dst_h;
+    int dst_pitch;
+    int flags;
+    Uint8 r, g, b, a;
+} SDL_BlitInfo;
+
+typedef struct
+{
+    Uint32 src_format;
+    Uint32 dst_format;
+    void (*blit)(SDL_BlitInfo *info);
+    const char *name;
+} BlitReference;
+
+/* ================= Reference blitters ================== */
+
+/* *INDENT-OFF* */
+
+static void SDL_Blit_RGB888_BGR888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            R = (Uint8)(pixel >> 16); G = (Uint8)(pixel >> 8); B = (Uint8)pixel;
+            pixel = ((Uint32)B << 16) | ((Uint32)G << 8) | R;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_RGB888_ARGB8888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B, A;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            R = (Uint8)(pixel >> 16); G = (Uint8)(pixel >> 8); B = (Uint8)pixel; A = 0xFF;
+            pixel = ((Uint32)A << 24) | ((Uint32)R << 16) | ((Uint32)G << 8) | B;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_BGR888_RGB888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            B = (Uint8)(pixel >> 16); G = (Uint8)(pixel >> 8); R = (Uint8)pixel;
+            pixel = ((Uint32)R << 16) | ((Uint32)G << 8) | B;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_BGR888_ARGB8888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B, A;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            B = (Uint8)(pixel >> 16); G = (Uint8)(pixel >> 8); R = (Uint8)pixel; A = 0xFF;
+            pixel = ((Uint32)A << 24) | ((Uint32)R << 16) | ((Uint32)G << 8) | B;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_ARGB8888_RGB888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            R = (Uint8)(pixel >> 16); G = (Uint8)(pixel >> 8); B = (Uint8)pixel;
+            pixel = ((Uint32)R << 16) | ((Uint32)G << 8) | B;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_ARGB8888_BGR888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            R = (Uint8)(pixel >> 16); G = (Uint8)(pixel >> 8); B = (Uint8)pixel;
+            pixel = ((Uint32)B << 16) | ((Uint32)G << 8) | R;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_RGBA8888_RGB888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            R = (Uint8)(pixel >> 24); G = (Uint8)(pixel >> 16); B = (Uint8)(pixel >> 8);
+            pixel = ((Uint32)R << 16) | ((Uint32)G << 8) | B;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_RGBA8888_BGR888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            R = (Uint8)(pixel >> 24); G = (Uint8)(pixel >> 16); B = (Uint8)(pixel >> 8);
+            pixel = ((Uint32)B << 16) | ((Uint32)G << 8) | R;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_RGBA8888_ARGB8888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B, A;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            R = (Uint8)(pixel >> 24); G = (Uint8)(pixel >> 16); B = (Uint8)(pixel >> 8); A = (Uint8)pixel;
+            pixel = ((Uint32)A << 24) | ((Uint32)R << 16) | ((Uint32)G << 8) | B;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_ABGR8888_RGB888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            B = (Uint8)(pixel >> 16); G = (Uint8)(pixel >> 8); R = (Uint8)pixel;
+            pixel = ((Uint32)R << 16) | ((Uint32)G << 8) | B;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_ABGR8888_BGR888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            B = (Uint8)(pixel >> 16); G = (Uint8)(pixel >> 8); R = (Uint8)pixel;
+            pixel = ((Uint32)B << 16) | ((Uint32)G << 8) | R;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_ABGR8888_ARGB8888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B, A;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            B = (Uint8)(pixel >> 16); G = (Uint8)(pixel >> 8); R = (Uint8)pixel; A = (Uint8)(pixel >> 24);
+            pixel = ((Uint32)A << 24) | ((Uint32)R << 16) | ((Uint32)G << 8) | B;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_BGRA8888_RGB888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            B = (Uint8)(pixel >> 24); G = (Uint8)(pixel >> 16); R = (Uint8)(pixel >> 8);
+            pixel = ((Uint32)R << 16) | ((Uint32)G << 8) | B;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_BGRA8888_BGR888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            B = (Uint8)(pixel >> 24); G = (Uint8)(pixel >> 16); R = (Uint8)(pixel >> 8);
+            pixel = ((Uint32)B << 16) | ((Uint32)G << 8) | R;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_BGRA8888_ARGB8888_Scale(SDL_BlitInfo *info)
+{
+    Uint32 pixel;
+    Uint32 R, G, B, A;
+    int srcy, srcx;
+    int posy, posx;
+    int incy, incx;
+
+    srcy = 0;
+    posy = 0;
+    incy = (info->src_h << 16) / info->dst_h;
+    incx = (info->src_w << 16) / info->dst_w;
+
+    while (info->dst_h--) {
+        Uint32 *src = 0;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        srcx = -1;
+        posx = 0x10000L;
+        while (posy >= 0x10000L) {
+            ++srcy;
+            posy -= 0x10000L;
+        }
+        while (n--) {
+            if (posx >= 0x10000L) {
+                while (posx >= 0x10000L) {
+                    ++srcx;
+                    posx -= 0x10000L;
+                }
+                src = (Uint32 *)(info->src + (srcy * info->src_pitch) + (srcx * 4));
+            }
+            pixel = *src;
+            B = (Uint8)(pixel >> 24); G = (Uint8)(pixel >> 16); R = (Uint8)(pixel >> 8); A = (Uint8)pixel;
+            pixel = ((Uint32)A << 24) | ((Uint32)R << 16) | ((Uint32)G << 8) | B;
+            *dst = pixel;
+            posx += incx;
+            ++dst;
+        }
+        posy += incy;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_ARGB8888_ARGB8888_Blend(SDL_BlitInfo *info)
+{
+    const int flags = info->flags;
+    Uint32 srcpixel;
+    Uint32 srcR, srcG, srcB, srcA;
+    Uint32 dstpixel;
+    Uint32 dstR, dstG, dstB, dstA;
+
+    while (info->dst_h--) {
+        Uint32 *src = (Uint32 *)info->src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        while (n--) {
+            srcpixel = *src;
+            srcR = (Uint8)(srcpixel >> 16); srcG = (Uint8)(srcpixel >> 8); srcB = (Uint8)srcpixel; srcA = (Uint8)(srcpixel >> 24);
+            dstpixel = *dst;
+            dstR = (Uint8)(dstpixel >> 16); dstG = (Uint8)(dstpixel >> 8); dstB = (Uint8)dstpixel; dstA = (Uint8)(dstpixel >> 24);
+            if (flags & (SDL_COPY_BLEND|SDL_COPY_ADD)) {
+                /* This goes away if we ever use premultiplied alpha */
+                if (srcA < 255) {
+                    srcR = (srcR * srcA) / 255;
+                    srcG = (srcG * srcA) / 255;
+                    srcB = (srcB * srcA) / 255;
+                }
+            }
+            switch (flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) {
+            case SDL_COPY_BLEND:
+                dstR = srcR + ((255 - srcA) * dstR) / 255;
+                dstG = srcG + ((255 - srcA) * dstG) / 255;
+                dstB = srcB + ((255 - srcA) * dstB) / 255;
+                dstA = srcA + ((255 - srcA) * dstA) / 255;
+                break;
+            case SDL_COPY_ADD:
+                dstR = srcR + dstR; if (dstR > 255) dstR = 255;
+                dstG = srcG + dstG; if (dstG > 255) dstG = 255;
+                dstB = srcB + dstB; if (dstB > 255) dstB = 255;
+                break;
+            case SDL_COPY_MOD:
+                dstR = (srcR * dstR) / 255;
+                dstG = (srcG * dstG) / 255;
+                dstB = (srcB * dstB) / 255;
+                break;
+            }
+            dstpixel = ((Uint32)dstA << 24) | ((Uint32)dstR << 16) | ((Uint32)dstG << 8) | dstB;
+            *dst = dstpixel;
+            ++src;
+            ++dst;
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_ARGB8888_ARGB8888_Modulate_Blend(SDL_BlitInfo *info)
+{
+    const int flags = info->flags;
+    const Uint32 modulateR = info->r;
+    const Uint32 modulateG = info->g;
+    const Uint32 modulateB = info->b;
+    const Uint32 modulateA = info->a;
+    Uint32 srcpixel;
+    Uint32 srcR, srcG, srcB, srcA;
+    Uint32 dstpixel;
+    Uint32 dstR, dstG, dstB, dstA;
+
+    while (info->dst_h--) {
+        Uint32 *src = (Uint32 *)info->src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        while (n--) {
+            srcpixel = *src;
+            srcR = (Uint8)(srcpixel >> 16); srcG = (Uint8)(srcpixel >> 8); srcB = (Uint8)srcpixel; srcA = (Uint8)(srcpixel >> 24);
+            dstpixel = *dst;
+            dstR = (Uint8)(dstpixel >> 16); dstG = (Uint8)(dstpixel >> 8); dstB = (Uint8)dstpixel; dstA = (Uint8)(dstpixel >> 24);
+            if (flags & SDL_COPY_MODULATE_COLOR) {
+                srcR = (srcR * modulateR) / 255;
+                srcG = (srcG * modulateG) / 255;
+                srcB = (srcB * modulateB) / 255;
+            }
+            if (flags & SDL_COPY_MODULATE_ALPHA) {
+                srcA = (srcA * modulateA) / 255;
+            }
+            if (flags & (SDL_COPY_BLEND|SDL_COPY_ADD)) {
+                /* This goes away if we ever use premultiplied alpha */
+                if (srcA < 255) {
+                    srcR = (srcR * srcA) / 255;
+                    srcG = (srcG * srcA) / 255;
+                    srcB = (srcB * srcA) / 255;
+                }
+            }
+            switch (flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) {
+            case SDL_COPY_BLEND:
+                dstR = srcR + ((255 - srcA) * dstR) / 255;
+                dstG = srcG + ((255 - srcA) * dstG) / 255;
+                dstB = srcB + ((255 - srcA) * dstB) / 255;
+                dstA = srcA + ((255 - srcA) * dstA) / 255;
+                break;
+            case SDL_COPY_ADD:
+                dstR = srcR + dstR; if (dstR > 255) dstR = 255;
+                dstG = srcG + dstG; if (dstG > 255) dstG = 255;
+                dstB = srcB + dstB; if (dstB > 255) dstB = 255;
+                break;
+            case SDL_COPY_MOD:
+                dstR = (srcR * dstR) / 255;
+                dstG = (srcG * dstG) / 255;
+                dstB = (srcB * dstB) / 255;
+                break;
+            }
+            dstpixel = ((Uint32)dstA << 24) | ((Uint32)dstR << 16) | ((Uint32)dstG << 8) | dstB;
+            *dst = dstpixel;
+            ++src;
+            ++dst;
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+static void SDL_Blit_ARGB8888_ARGB8888_Modulate(SDL_BlitInfo *info)
+{
+    const int flags = info->flags;
+    const Uint32 modulateR = info->r;
+    const Uint32 modulateG = info->g;
+    const Uint32 modulateB = info->b;
+    const Uint32 modulateA = info->a;
+    Uint32 pixel;
+    Uint32 R, G, B, A;
+
+    while (info->dst_h--) {
+        Uint32 *src = (Uint32 *)info->src;
+        Uint32 *dst = (Uint32 *)info->dst;
+        int n = info->dst_w;
+        while (n--) {
+            pixel = *src;
+            R = (Uint8)(pixel >> 16); G = (Uint8)(pixel >> 8); B = (Uint8)pixel; A = (Uint8)(pixel >> 24);
+            if (flags & SDL_COPY_MODULATE_COLOR) {
+                R = (R * modulateR) / 255;
+                G = (G * modulateG) / 255;
+                B = (B * modulateB) / 255;
+            }
+            if (flags & SDL_COPY_MODULATE_ALPHA) {
+                A = (A * modulateA) / 255;
+            }
+            pixel = ((Uint32)A << 24) | ((Uint32)R << 16) | ((Uint32)G << 8) | B;
+            *dst = pixel;
+            ++src;
+            ++dst;
+        }
+        info->src += info->src_pitch;
+        info->dst += info->dst_pitch;
+    }
+}
+
+/* *INDENT-ON* */
+
+static const BlitReference scaleReferences[] = {
+    { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_BGR888, SDL_Blit_RGB888_BGR888_Scale, "SDL_Blit_RGB888_BGR888_Scale" },
+    { SDL_PIXELFORMAT_RGB888, SDL_PIXELFORMAT_ARGB8888, SDL_Blit_RGB888_ARGB8888_Scale, "SDL_Blit_RGB888_ARGB8888_Scale" },
+    { SDL_PIXELFORMAT_BGR888, SDL_PIXELFORMAT_RGB888, SDL_Blit_BGR888_RGB888_Scale, "SDL_Blit_BGR888_RGB888_Scale" },
+    { SDL_PIXELFORMAT_BGR888, SDL_PIXELFORMAT_ARGB8888, SDL_Blit_BGR888_ARGB8888_Scale, "SDL_Blit_BGR888_ARGB8888_Scale" },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_RGB888, SDL_Blit_ARGB8888_RGB888_Scale, "SDL_Blit_ARGB8888_RGB888_Scale" },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_BGR888, SDL_Blit_ARGB8888_BGR888_Scale, "SDL_Blit_ARGB8888_BGR888_Scale" },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_RGB888, SDL_Blit_RGBA8888_RGB888_Scale, "SDL_Blit_RGBA8888_RGB888_Scale" },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_BGR888, SDL_Blit_RGBA8888_BGR888_Scale, "SDL_Blit_RGBA8888_BGR888_Scale" },
+    { SDL_PIXELFORMAT_RGBA8888, SDL_PIXELFORMAT_ARGB8888, SDL_Blit_RGBA8888_ARGB8888_Scale, "SDL_Blit_RGBA8888_ARGB8888_Scale" },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_RGB888, SDL_Blit_ABGR8888_RGB888_Scale, "SDL_Blit_ABGR8888_RGB888_Scale" },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_BGR888, SDL_Blit_ABGR8888_BGR888_Scale, "SDL_Blit_ABGR8888_BGR888_Scale" },
+    { SDL_PIXELFORMAT_ABGR8888, SDL_PIXELFORMAT_ARGB8888, SDL_Blit_ABGR8888_ARGB8888_Scale, "SDL_Blit_ABGR8888_ARGB8888_Scale" },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_RGB888, SDL_Blit_BGRA8888_RGB888_Scale, "SDL_Blit_BGRA8888_RGB888_Scale" },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_BGR888, SDL_Blit_BGRA8888_BGR888_Scale, "SDL_Blit_BGRA8888_BGR888_Scale" },
+    { SDL_PIXELFORMAT_BGRA8888, SDL_PIXELFORMAT_ARGB8888, SDL_Blit_BGRA8888_ARGB8888_Scale, "SDL_Blit_BGRA8888_ARGB8888_Scale" },
+};
+
+static const BlitReference blendReferences[] = {
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_Blit_ARGB8888_ARGB8888_Blend, "SDL_Blit_ARGB8888_ARGB8888_Blend" },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_Blit_ARGB8888_ARGB8888_Modulate_Blend, "SDL_Blit_ARGB8888_ARGB8888_Modulate_Blend" },
+    { SDL_PIXELFORMAT_ARGB8888, SDL_PIXELFORMAT_ARGB8888, SDL_Blit_ARGB8888_ARGB8888_Modulate, "SDL_Blit_ARGB8888_ARGB8888_Modulate" },
+};
+
+/* ================= Test Case Implementation ================== */
+
+/* Helper functions */
+
+static SDL_Surface *
+_blitCreateRandomSurface(Uint32 format, int w, int h)
+{
+    SDL_Surface *surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, format);
+    int i;
+
+    SDLTest_AssertCheck(surface != NULL, "Verify surface creation, expected: not NULL, got: %s", surface ? "not NULL" : SDL_GetError());
+    if (surface) {
+        for (i = 0; i < surface->h * surface->pitch; ++i) {
+            ((Uint8 *)surface->pixels)[i] = SDLTest_RandomUint8();
+        }
+        SDL_SetSurfaceBlendMode(surface, SDL_BLENDMODE_NONE);
+    }
+    return surface;
+}
+
+/* Runs the reference blitter on a copy of dst and compares it with what SDL did */
+static int
+_blitCompare(const BlitReference *reference, SDL_BlitInfo *info, SDL_Surface *src, SDL_Surface *dst, const Uint8 *original)
+{
+    const int size = dst->h * dst->pitch;
+    Uint8 *expected = (Uint8 *)SDL_malloc(size);
+    int i, mismatches = 0;
+
+    SDLTest_AssertCheck(expected != NULL, "Verify allocation of %d bytes", size);
+    if (!expected) {
+        return 1;
+    }
+    SDL_memcpy(expected, original, size);
+    info->src = (Uint8 *)src->pixels;
+    info->src_w = src->w;
+    info->src_h = src->h;
+    info->src_pitch = src->pitch;
+    info->dst = expected;
+    info->dst_w = dst->w;
+    info->dst_h = dst->h;
+    info->dst_pitch = dst->pitch;
+    reference->blit(info);
+
+    for (i = 0; i < size; ++i) {
+        if (expected[i] != ((Uint8 *)dst->pixels)[i]) {
+            ++mismatches;
+        }
+    }
+    SDL_free(expected);
+
+    SDLTest_AssertCheck(mismatches == 0, "Validate %s %dx%d -> %dx%d flags 0x%x, expected: 0 mismatched bytes, got: %d", reference->name, src->w, src->h, dst->w, dst->h, info->flags, mismatches);
+    return mismatches;
+}
+
+/* Test case functions */
+
+/**
+ * @brief Tests that scaled blits give the same results as the C blitters
+ */
+int
+blit_testScaled(void *arg)
+{
+    static const int sizes[][4] = {
+        { 37, 13, 61, 29 }, { 61, 29, 17, 11 }, { 8, 8, 33, 1 }, { 1, 1, 9, 5 }, { 100, 3, 64, 6 }
+    };
+    int i, j;
+
+    for (i = 0; i < SDL_arraysize(scaleReferences); ++i) {
+        const BlitReference *reference = &scaleReferences[i];
+
+        for (j = 0; j < SDL_arraysize(sizes); ++j) {
+            SDL_Surface *src = _blitCreateRandomSurface(reference->src_format, sizes[j][0], sizes[j][1]);
+            SDL_Surface *dst = _blitCreateRandomSurface(reference->dst_format, sizes[j][2], sizes[j][3]);
+            Uint8 *original = dst ? (Uint8 *)SDL_malloc(dst->h * dst->pitch) : NULL;
+            SDL_BlitInfo info;
+            int ret;
+
+            if (src && dst && original) {
+                SDL_memcpy(original, dst->pixels, dst->h * dst->pitch);
+                ret = SDL_BlitScaled(src, NULL, dst, NULL);
+                SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitScaled, expected: 0, got: %i", ret);
+
+                SDL_zero(info);
+                info.flags = SDL_COPY_NEAREST;
+                _blitCompare(reference, &info, src, dst, original);
+            }
+            SDL_free(original);
+            SDL_FreeSurface(dst);
+            SDL_FreeSurface(src);
+        }
+    }
+
+    return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that blended blits give the same results as the C blitters
+ */
+int
+blit_testBlended(void *arg)
+{
+    /* Blend mode and color/alpha mod, avoiding the cases SDL_blit_A.c handles */
+    static const struct {
+        SDL_BlendMode mode;
+        Uint8 r, g, b, a;
+    } modes[] = {
+        { SDL_BLENDMODE_ADD, 255, 255, 255, 255 },
+        { SDL_BLENDMODE_MOD, 255, 255, 255, 255 },
+        { SDL_BLENDMODE_BLEND, 200, 100, 0, 255 },
+        { SDL_BLENDMODE_BLEND, 17, 255, 128, 99 },
+        { SDL_BLENDMODE_ADD, 255, 255, 255, 128 },
+        { SDL_BLENDMODE_ADD, 1, 254, 77, 200 },
+        { SDL_BLENDMODE_MOD, 33, 66, 99, 255 },
+        { SDL_BLENDMODE_MOD, 255, 255, 255, 0 },
+        { SDL_BLENDMODE_NONE, 200, 100, 50, 255 },
+        { SDL_BLENDMODE_NONE, 255, 255, 255, 128 }
+    };
+    static const int widths[] = { 1, 3, 8, 13, 64, 71 };
+    int i, j, k;
+
+    for (i = 0; i < SDL_arraysize(modes); ++i) {
+        int flags = 0;
+        const BlitReference *reference = NULL;
+
+        switch (modes[i].mode) {
+        case SDL_BLENDMODE_BLEND:
+            flags |= SDL_COPY_BLEND;
+            break;
+        case SDL_BLENDMODE_ADD:
+            flags |= SDL_COPY_ADD;
+            break;
+        case SDL_BLENDMODE_MOD:
+            flags |= SDL_COPY_MOD;
+            break;
+        default:
+            break;
+        }
+        if (modes[i].r != 255 || modes[i].g != 255 || modes[i].b != 255) {
+            flags |= SDL_COPY_MODULATE_COLOR;
+        }
+        if (modes[i].a != 255) {
+            flags |= SDL_COPY_MODULATE_ALPHA;
+        }
+
+        for (j = 0; j < SDL_arraysize(blendReferences); ++j) {
+            const SDL_bool modulated = (SDL_strstr(blendReferences[j].name, "_Modulate") != NULL);
+            const SDL_bool blended = (SDL_strstr(blendReferences[j].name, "_Blend") != NULL);
+            if (modulated == ((flags & (SDL_COPY_MODULATE_COLOR|SDL_COPY_MODULATE_ALPHA)) != 0) &&
+                blended == ((flags & (SDL_COPY_BLEND|SDL_COPY_ADD|SDL_COPY_MOD)) != 0)) {
+                reference = &blendReferences[j];
+            } else {
+                continue;
+            }
+
+            for (k = 0; k < SDL_arraysize(widths); ++k) {
+                SDL_Surface *src = _blitCreateRandomSurface(reference->src_format, widths[k], 5);
+                SDL_Surface *dst = _blitCreateRandomSurface(reference->dst_format, widths[k], 5);
+                Uint8 *original = dst ? (Uint8 *)SDL_malloc(dst->h * dst->pitch) : NULL;
+                SDL_BlitInfo info;
+                int ret;
+
+                if (src && dst && original) {
+                    SDL_memcpy(original, dst->pixels, dst->h * dst->pitch);
+                    SDL_SetSurfaceBlendMode(src, modes[i].mode);
+                    SDL_SetSurfaceColorMod(src, modes[i].r, modes[i].g, modes[i].b);
+                    SDL_SetSurfaceAlphaMod(src, modes[i].a);
+                    ret = SDL_BlitSurface(src, NULL, dst, NULL);
+                    SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+
+                    SDL_zero(info);
+                    info.flags = flags;
+                    info.r = modes[i].r;
+                    info.g = modes[i].g;
+                    info.b = modes[i].b;
+                    info.a = modes[i].a;
+                    _blitCompare(reference, &info, src, dst, original);
+                }
+                SDL_free(original);
+                SDL_FreeSurface(dst);
+                SDL_FreeSurface(src);
+            }
+        }
+    }
+
+    return TEST_COMPLETED;
+}
+
+/* ================= Test References ================== */
+
+/* Blit test cases */
+static const SDLTest_TestCaseReference blitTest1 =
+        { (SDLTest_TestCaseFp)blit_testScaled, "blit_testScaled", "Tests scaled blits against the C blitters.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference blitTest2 =
+        { (SDLTest_TestCaseFp)blit_testBlended, "blit_testBlended", "Tests blended blits against the C blitters.", TEST_ENABLED};
+
+/* Sequence of Blit test cases */
+static const SDLTest_TestCaseReference *blitTests[] =  {
+    &blitTest1, &blitTest2, NULL
+};
+
+/* Blit test suite (global) */
+SDLTest_TestSuiteReference blitTestSuite = {
+    "Blit",
+    NULL,
+    blitTests,
+    NULL
+};
+
+/* vi: set ts=4 sw=4 expandtab: */
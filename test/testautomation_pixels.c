@@ -500,6 +500,193 @@ pixels_calcGammaRamp(void *arg)
   return TEST_COMPLETED;
 }
 
+/* Deterministic sample for a plane (0 = Y, 1 = U, 2 = V) that covers the full byte range */
+static Uint8
+_yuvSample(int plane, int x, int y)
+{
+  Uint32 h = (Uint32)x * 2654435761u ^ (Uint32)y * 2246822519u ^ (Uint32)plane * 3266489917u;
+  h ^= h >> 15;
+  h *= 2654435761u;
+  return (Uint8)(h >> 24);
+}
+
+/* Fills rows [row0, row0 + rows) of a YUV frame of even width and height */
+static void
+_fillYUVRows(Uint32 format, int w, int row0, int rows, Uint8 *frame)
+{
+  const int cw = w / 2;
+  Uint8 *u, *v, *p;
+  int x, y;
+
+  switch (format) {
+    case SDL_PIXELFORMAT_YV12:
+    case SDL_PIXELFORMAT_IYUV:
+      u = frame + w * rows;
+      v = u + cw * (rows / 2);
+      if (format == SDL_PIXELFORMAT_YV12) {
+        p = u;
+        u = v;
+        v = p;
+      }
+      for (y = 0; y < rows; y++) {
+        for (x = 0; x < w; x++) {
+          frame[y * w + x] = _yuvSample(0, x, row0 + y);
+        }
+      }
+      for (y = 0; y < rows / 2; y++) {
+        for (x = 0; x < cw; x++) {
+          u[y * cw + x] = _yuvSample(1, x, row0 / 2 + y);
+          v[y * cw + x] = _yuvSample(2, x, row0 / 2 + y);
+        }
+      }
+      break;
+    case SDL_PIXELFORMAT_NV12:
+    case SDL_PIXELFORMAT_NV21:
+      for (y = 0; y < rows; y++) {
+        for (x = 0; x < w; x++) {
+          frame[y * w + x] = _yuvSample(0, x, row0 + y);
+        }
+      }
+      for (y = 0; y < rows / 2; y++) {
+        p = frame + w * rows + y * w;
+        for (x = 0; x < cw; x++) {
+          p[x * 2 + (format == SDL_PIXELFORMAT_NV12 ? 0 : 1)] = _yuvSample(1, x, row0 / 2 + y);
+          p[x * 2 + (format == SDL_PIXELFORMAT_NV12 ? 1 : 0)] = _yuvSample(2, x, row0 / 2 + y);
+        }
+      }
+      break;
+    default:
+      /* Packed 4:2:2, the byte order of Y0 U Y1 V within each pair of pixels */
+      for (y = 0; y < rows; y++) {
+        for (x = 0; x < cw; x++) {
+          const Uint8 y0 = _yuvSample(0, x * 2, row0 + y);
+          const Uint8 y1 = _yuvSample(0, x * 2 + 1, row0 + y);
+          const Uint8 cu = _yuvSample(1, x, row0 + y);
+          const Uint8 cv = _yuvSample(2, x, row0 + y);
+          p = frame + y * w * 2 + x * 4;
+          if (format == SDL_PIXELFORMAT_YUY2) {
+            p[0] = y0; p[1] = cu; p[2] = y1; p[3] = cv;
+          } else if (format == SDL_PIXELFORMAT_UYVY) {
+            p[0] = cu; p[1] = y0; p[2] = cv; p[3] = y1;
+          } else {
+            p[0] = y0; p[1] = cv; p[2] = y1; p[3] = cu;
+          }
+        }
+      }
+      break;
+  }
+}
+
+/**
+ * @brief Converts the same YUV frame to RGB with each YUV kernel and compares the pixels
+ *
+ * The reference is converted two rows at a time with the C kernel, so it never leaves the
+ * calling thread, while the whole frame is big enough to be split into parallel row bands.
+ *
+ * @sa http://wiki.libsdl.org/moin.fcg/SDL_ConvertPixels
+ */
+int
+pixels_convertYUVKernels(void *arg)
+{
+  /* Not a multiple of the SIMD widths, so the tails are covered too */
+  const int w = 1282;
+  const int h = 722;
+  const char *kernels[] = { "c", "sse2", "neon", "avx2" };
+  const Uint32 rgbFormats[] = {
+    SDL_PIXELFORMAT_RGB565,
+    SDL_PIXELFORMAT_RGB24,
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_RGBA8888,
+    SDL_PIXELFORMAT_BGRA8888
+  };
+  const SDL_YUV_CONVERSION_MODE modes[] = {
+    SDL_YUV_CONVERSION_JPEG,
+    SDL_YUV_CONVERSION_BT601,
+    SDL_YUV_CONVERSION_BT709
+  };
+  SDL_YUV_CONVERSION_MODE originalMode = SDL_GetYUVConversionMode();
+  char *originalHint = SDL_GetHint(SDL_HINT_YUV_CONVERSION_SIMD) ? SDL_strdup(SDL_GetHint(SDL_HINT_YUV_CONVERSION_SIMD)) : NULL;
+  Uint8 *yuv, *strip, *expected, *actual;
+  Uint32 yuvFormat, rgbFormat;
+  int yuvPitch, rgbPitch;
+  int i, j, k, y;
+  int result;
+
+  SDLTest_Log("CPU count: %d, SSE2: %d, AVX2: %d, NEON: %d",
+      SDL_GetCPUCount(), (int)SDL_HasSSE2(), (int)SDL_HasAVX2(), (int)SDL_HasNEON());
+
+  /* Split the frame into bands even on a single core, unless the worker pool is already running */
+  if (SDL_GetHint(SDL_HINT_CPU_WORKER_THREADS) == NULL) {
+    SDL_SetHint(SDL_HINT_CPU_WORKER_THREADS, "4");
+    SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_CPU_WORKER_THREADS, \"4\")");
+  }
+
+  yuv = (Uint8 *)SDL_malloc(w * h * 2);
+  strip = (Uint8 *)SDL_malloc(w * 2 * 2);
+  expected = (Uint8 *)SDL_malloc(w * h * 4);
+  actual = (Uint8 *)SDL_malloc(w * h * 4);
+  SDLTest_AssertCheck(yuv != NULL && strip != NULL && expected != NULL && actual != NULL, "Validate frame buffers could be allocated");
+  if (yuv == NULL || strip == NULL || expected == NULL || actual == NULL) {
+    SDL_free(yuv);
+    SDL_free(strip);
+    SDL_free(expected);
+    SDL_free(actual);
+    SDL_free(originalHint);
+    return TEST_ABORTED;
+  }
+
+  for (i = 0; i < _numNonRGBPixelFormats; i++) {
+    yuvFormat = _nonRGBPixelFormats[i];
+    yuvPitch = (yuvFormat == SDL_PIXELFORMAT_YUY2 || yuvFormat == SDL_PIXELFORMAT_UYVY || yuvFormat == SDL_PIXELFORMAT_YVYU) ? w * 2 : w;
+    _fillYUVRows(yuvFormat, w, 0, h, yuv);
+
+    /* The automatic mode depends on the height, which differs between the strips and the frame */
+    SDL_SetYUVConversionMode(modes[i % SDL_arraysize(modes)]);
+    SDLTest_AssertPass("Call to SDL_SetYUVConversionMode(%d)", (int)modes[i % SDL_arraysize(modes)]);
+
+    for (j = 0; j < SDL_arraysize(rgbFormats); j++) {
+      rgbFormat = rgbFormats[j];
+      rgbPitch = w * SDL_BYTESPERPIXEL(rgbFormat);
+
+      SDL_SetHint(SDL_HINT_YUV_CONVERSION_SIMD, "c");
+      result = 0;
+      for (y = 0; y < h && result == 0; y += 2) {
+        _fillYUVRows(yuvFormat, w, y, 2, strip);
+        result = SDL_ConvertPixels(w, 2, yuvFormat, strip, yuvPitch, rgbFormat, expected + y * rgbPitch, rgbPitch);
+      }
+      SDLTest_AssertCheck(result == 0, "Validate reference conversion from %s to %s, expected: 0, got: %i",
+          _nonRGBPixelFormatsVerbose[i], SDL_GetPixelFormatName(rgbFormat), result);
+      if (result != 0) {
+        continue;
+      }
+
+      for (k = 0; k < SDL_arraysize(kernels); k++) {
+        SDL_SetHint(SDL_HINT_YUV_CONVERSION_SIMD, kernels[k]);
+        SDL_memset(actual, 0xcc, h * rgbPitch);
+        result = SDL_ConvertPixels(w, h, yuvFormat, yuv, yuvPitch, rgbFormat, actual, rgbPitch);
+        for (y = 0; y < h; y++) {
+          if (SDL_memcmp(expected + y * rgbPitch, actual + y * rgbPitch, rgbPitch) != 0) {
+            break;
+          }
+        }
+        SDLTest_AssertCheck(result == 0 && y == h, "Validate %s to %s with the \"%s\" kernel matches the reference, expected: 0, got: %i, first differing row: %d",
+            _nonRGBPixelFormatsVerbose[i], SDL_GetPixelFormatName(rgbFormat), kernels[k], result, y == h ? -1 : y);
+      }
+    }
+  }
+
+  SDL_SetYUVConversionMode(originalMode);
+  SDL_SetHint(SDL_HINT_YUV_CONVERSION_SIMD, originalHint);
+  SDL_free(originalHint);
+  SDL_free(yuv);
+  SDL_free(strip);
+  SDL_free(expected);
+  SDL_free(actual);
+
+  return TEST_COMPLETED;
+}
+
 /* ================= Test References ================== */
 
 /* Pixels test cases */
@@ -515,9 +702,12 @@ static const SDLTest_TestCaseReference pixelsTest3 =
 static const SDLTest_TestCaseReference pixelsTest4 =
         { (SDLTest_TestCaseFp)pixels_getPixelFormatName, "pixels_getPixelFormatName", "Call to SDL_GetPixelFormatName", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference pixelsTest5 =
+        { (SDLTest_TestCaseFp)pixels_convertYUVKernels, "pixels_convertYUVKernels", "Compare YUV to RGB conversions by each kernel and in parallel", TEST_ENABLED };
+
 /* Sequence of Pixels test cases */
 static const SDLTest_TestCaseReference *pixelsTests[] =  {
-    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, NULL
+    &pixelsTest1, &pixelsTest2, &pixelsTest3, &pixelsTest4, &pixelsTest5, NULL
 };
 
 /* Pixels test suite (global) */
@@ -765,6 +765,255 @@ render_testBlitBlend (void *arg)
    return TEST_COMPLETED;
 }
 
+/**
+ * @brief Tests packing and evicting texture atlas entries.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_CreateTextureAtlas
+ * http://wiki.libsdl.org/moin.cgi/SDL_TextureAtlasAdd
+ * http://wiki.libsdl.org/moin.cgi/SDL_TextureAtlasGet
+ */
+int
+render_testTextureAtlas(void *arg)
+{
+   SDL_TextureAtlas *atlas;
+   SDL_Surface *face;
+   SDL_AtlasEntryID ids[8];
+   SDL_Texture *textures[8];
+   SDL_Rect rects[8];
+   int ret, i, j;
+   int overlapCount = 0;
+
+   face = SDLTest_ImageFace();
+   SDLTest_AssertCheck(face != NULL, "Verify SDLTest_ImageFace() result");
+   if (face == NULL) {
+       return TEST_ABORTED;
+   }
+
+   /* Room for four faces per page, and a budget of one page */
+   atlas = SDL_CreateTextureAtlas(renderer, 0, face->w * 2 + 2, face->h * 2 + 2,
+                                  (face->w * 2 + 2) * (face->h * 2 + 2) * 4);
+   SDLTest_AssertPass("Call to SDL_CreateTextureAtlas()");
+   SDLTest_AssertCheck(atlas != NULL, "Verify atlas is not NULL");
+   if (atlas == NULL) {
+       SDL_FreeSurface(face);
+       return TEST_ABORTED;
+   }
+
+   for (i = 0; i < 4; i++) {
+      ids[i] = SDL_TextureAtlasAdd(atlas, face);
+      SDLTest_AssertCheck(ids[i] != 0, "Validate result from SDL_TextureAtlasAdd, expected: !0, got: %u", (unsigned int)ids[i]);
+      ret = SDL_TextureAtlasGet(atlas, ids[i], &textures[i], &rects[i]);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_TextureAtlasGet, expected: 0, got: %i", ret);
+      SDLTest_AssertCheck(rects[i].w == face->w && rects[i].h == face->h, "Validate entry size, expected: %ix%i, got: %ix%i", face->w, face->h, rects[i].w, rects[i].h);
+      SDLTest_AssertCheck(textures[i] == textures[0], "Validate entries share a texture");
+   }
+   for (i = 0; i < 4; i++) {
+      for (j = i + 1; j < 4; j++) {
+         if (SDL_HasIntersection(&rects[i], &rects[j])) overlapCount++;
+      }
+   }
+   SDLTest_AssertCheck(overlapCount == 0, "Validate entries don't overlap, expected: 0, got: %i", overlapCount);
+
+   ret = SDL_RenderCopy(renderer, textures[0], &rects[0], NULL);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderCopy, expected: 0, got: %i", ret);
+
+   /* A removed entry is no longer valid */
+   SDL_TextureAtlasRemove(atlas, ids[3]);
+   ret = SDL_TextureAtlasGet(atlas, ids[3], NULL, NULL);
+   SDLTest_AssertCheck(ret == -1, "Validate removed entry, expected: -1, got: %i", ret);
+
+   /* The page is full, so the next entry evicts it */
+   ids[4] = SDL_TextureAtlasAdd(atlas, face);
+   SDLTest_AssertCheck(ids[4] != 0, "Validate result from SDL_TextureAtlasAdd, expected: !0, got: %u", (unsigned int)ids[4]);
+   ret = SDL_TextureAtlasGet(atlas, ids[0], NULL, NULL);
+   SDLTest_AssertCheck(ret == -1, "Validate evicted entry, expected: -1, got: %i", ret);
+   ret = SDL_TextureAtlasGet(atlas, ids[4], NULL, NULL);
+   SDLTest_AssertCheck(ret == 0, "Validate new entry, expected: 0, got: %i", ret);
+
+   SDL_DestroyTextureAtlas(atlas);
+   SDLTest_AssertPass("Call to SDL_DestroyTextureAtlas()");
+   SDL_FreeSurface(face);
+
+   return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests asynchronous pixel readback against SDL_RenderReadPixels.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_RenderReadPixelsAsync
+ * http://wiki.libsdl.org/moin.cgi/SDL_WaitPixelReadback
+ * http://wiki.libsdl.org/moin.cgi/SDL_FreePixelReadback
+ */
+int
+render_testReadPixelsAsync(void *arg)
+{
+   const Uint32 formats[] = { RENDER_COMPARE_FORMAT, SDL_PIXELFORMAT_ABGR8888 };
+   SDL_PixelReadback *readback;
+   SDL_Texture *tface;
+   SDL_Rect rect, readRect;
+   Uint8 *reference, *expected;
+   void *pixels;
+   int pitch, ret, i, y, mismatchCount;
+
+   _clearScreen();
+
+   tface = _loadTestFace();
+   SDLTest_AssertCheck(tface != NULL,  "Verify _loadTestFace() result");
+   if (tface == NULL) {
+       return TEST_ABORTED;
+   }
+   SDL_RenderCopy(renderer, tface, NULL, NULL);
+   SDL_DestroyTexture(tface);
+
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = TESTRENDER_SCREEN_W;
+   rect.h = TESTRENDER_SCREEN_H;
+   reference = (Uint8 *)SDL_malloc(4*TESTRENDER_SCREEN_W*TESTRENDER_SCREEN_H);
+   expected = (Uint8 *)SDL_malloc(4*TESTRENDER_SCREEN_W*TESTRENDER_SCREEN_H);
+   SDLTest_AssertCheck(reference != NULL && expected != NULL, "Validate allocated temp pixel buffers");
+   if (reference == NULL || expected == NULL) {
+       SDL_free(reference);
+       SDL_free(expected);
+       return TEST_ABORTED;
+   }
+   ret = SDL_RenderReadPixels(renderer, &rect, RENDER_COMPARE_FORMAT, reference, TESTRENDER_SCREEN_W*4);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderReadPixels, expected: 0, got: %i", ret);
+
+   for (i = 0; i < SDL_arraysize(formats); i++) {
+      SDL_ConvertPixels(TESTRENDER_SCREEN_W, TESTRENDER_SCREEN_H,
+                        RENDER_COMPARE_FORMAT, reference, TESTRENDER_SCREEN_W*4,
+                        formats[i], expected, TESTRENDER_SCREEN_W*4);
+
+      readback = SDL_RenderReadPixelsAsync(renderer, &rect, formats[i]);
+      SDLTest_AssertCheck(readback != NULL, "Validate result from SDL_RenderReadPixelsAsync is not NULL");
+      if (readback == NULL) {
+         continue;
+      }
+      SDL_PollPixelReadback(readback);
+      SDLTest_AssertPass("Call to SDL_PollPixelReadback()");
+
+      ret = SDL_WaitPixelReadback(readback, &readRect, &pixels, &pitch);
+      SDLTest_AssertCheck(ret == 0, "Validate result from SDL_WaitPixelReadback, expected: 0, got: %i", ret);
+      SDLTest_AssertCheck(SDL_PollPixelReadback(readback) == SDL_TRUE, "Validate readback is complete after waiting");
+      if (ret == 0) {
+         SDLTest_AssertCheck(SDL_RectEquals(&readRect, &rect), "Validate area read, expected: %ix%i, got: %ix%i", rect.w, rect.h, readRect.w, readRect.h);
+         mismatchCount = 0;
+         for (y = 0; y < readRect.h; y++) {
+            if (SDL_memcmp((Uint8 *)pixels + y * pitch, expected + y * TESTRENDER_SCREEN_W*4, readRect.w*4) != 0) {
+               mismatchCount++;
+            }
+         }
+         SDLTest_AssertCheck(mismatchCount == 0, "Validate pixels in %s, expected: 0 mismatched rows, got: %i", SDL_GetPixelFormatName(formats[i]), mismatchCount);
+      }
+      SDL_FreePixelReadback(readback);
+   }
+
+   /* Several readbacks in flight at once, finished out of order */
+   {
+      SDL_PixelReadback *readbacks[3];
+
+      for (i = 0; i < SDL_arraysize(readbacks); i++) {
+         readbacks[i] = SDL_RenderReadPixelsAsync(renderer, &rect, SDL_PIXELFORMAT_ABGR8888);
+         SDLTest_AssertCheck(readbacks[i] != NULL, "Validate result from SDL_RenderReadPixelsAsync is not NULL [readback %i]", i);
+      }
+      for (i = SDL_arraysize(readbacks) - 1; i >= 0; i--) {
+         if (readbacks[i] == NULL) {
+            continue;
+         }
+         ret = SDL_WaitPixelReadback(readbacks[i], &readRect, &pixels, &pitch);
+         SDLTest_AssertCheck(ret == 0, "Validate result from SDL_WaitPixelReadback, expected: 0, got: %i [readback %i]", ret, i);
+         if (ret == 0) {
+            mismatchCount = 0;
+            for (y = 0; y < readRect.h; y++) {
+               if (SDL_memcmp((Uint8 *)pixels + y * pitch, expected + y * TESTRENDER_SCREEN_W*4, readRect.w*4) != 0) {
+                  mismatchCount++;
+               }
+            }
+            SDLTest_AssertCheck(mismatchCount == 0, "Validate pixels, expected: 0 mismatched rows, got: %i [readback %i]", mismatchCount, i);
+         }
+         SDL_FreePixelReadback(readbacks[i]);
+      }
+   }
+
+   SDL_free(reference);
+   SDL_free(expected);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests the per frame renderer counters and redundant state elision.
+ *
+ * \sa
+ * http://wiki.libsdl.org/moin.cgi/SDL_GetRendererStats
+ */
+int
+render_testRendererStats(void *arg)
+{
+   SDL_RendererStats stats;
+   SDL_Texture *tface;
+   SDL_Rect rect;
+   int ret;
+
+   tface = _loadTestFace();
+   SDLTest_AssertCheck(tface != NULL,  "Verify _loadTestFace() result");
+   if (tface == NULL) {
+       return TEST_ABORTED;
+   }
+
+   /* Start from a known state, then begin a fresh frame */
+   SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+   SDL_SetTextureColorMod(tface, 255, 255, 255);
+   SDL_RenderSetViewport(renderer, NULL);
+   SDL_RenderPresent(renderer);
+
+   /* Only the first change of each kind should count */
+   SDL_SetRenderDrawColor(renderer, 0, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_SetRenderDrawColor(renderer, 255, 0, 0, SDL_ALPHA_OPAQUE);
+   SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+   SDL_SetTextureColorMod(tface, 255, 255, 255);
+   SDL_SetTextureColorMod(tface, 128, 128, 128);
+   SDL_SetTextureColorMod(tface, 128, 128, 128);
+   SDL_RenderSetViewport(renderer, NULL);
+
+   ret = SDL_RenderClear(renderer);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_RenderClear, expected: 0, got: %i", ret);
+   rect.x = 0;
+   rect.y = 0;
+   rect.w = TESTRENDER_SCREEN_W / 2;
+   rect.h = TESTRENDER_SCREEN_H / 2;
+   SDL_RenderFillRect(renderer, &rect);
+   SDL_RenderCopy(renderer, tface, NULL, &rect);
+   SDL_RenderCopy(renderer, tface, NULL, NULL);
+   SDL_RenderPresent(renderer);
+
+   ret = SDL_GetRendererStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_GetRendererStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(stats.state_changes == 2, "Validate state changes, expected: 2, got: %u", stats.state_changes);
+   SDLTest_AssertCheck(stats.draw_calls == 4, "Validate draw calls, expected: 4, got: %u", stats.draw_calls);
+   SDLTest_AssertCheck(stats.texture_binds == 1, "Validate texture binds, expected: 1, got: %u", stats.texture_binds);
+
+   /* An empty frame resets the counters */
+   SDL_RenderPresent(renderer);
+   ret = SDL_GetRendererStats(renderer, &stats);
+   SDLTest_AssertCheck(ret == 0, "Validate result from SDL_GetRendererStats, expected: 0, got: %i", ret);
+   SDLTest_AssertCheck(stats.state_changes == 0 && stats.draw_calls == 0 && stats.texture_binds == 0,
+                       "Validate counters after an empty frame, got: %u, %u, %u",
+                       stats.state_changes, stats.draw_calls, stats.texture_binds);
+
+   ret = SDL_GetRendererStats(renderer, NULL);
+   SDLTest_AssertCheck(ret == -1, "Validate result from SDL_GetRendererStats with NULL stats, expected: -1, got: %i", ret);
+
+   SDL_DestroyTexture(tface);
+
+   return TEST_COMPLETED;
+}
 
 /**
  * @brief Checks to see if functionality is supported. Helper function.
@@ -1085,9 +1334,18 @@ static const SDLTest_TestCaseReference renderTest6 =
 static const SDLTest_TestCaseReference renderTest7 =
         {  (SDLTest_TestCaseFp)render_testBlitBlend, "render_testBlitBlend", "Tests blitting with blending", TEST_DISABLED };
 
+static const SDLTest_TestCaseReference renderTest8 =
+        {  (SDLTest_TestCaseFp)render_testTextureAtlas, "render_testTextureAtlas", "Tests packing textures into an atlas", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest9 =
+        {  (SDLTest_TestCaseFp)render_testReadPixelsAsync, "render_testReadPixelsAsync", "Tests asynchronous pixel readback", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference renderTest10 =
+        {  (SDLTest_TestCaseFp)render_testRendererStats, "render_testRendererStats", "Tests the per frame renderer counters", TEST_ENABLED };
+
 /* Sequence of Render test cases */
 static const SDLTest_TestCaseReference *renderTests[] =  {
-    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, NULL
+    &renderTest1, &renderTest2, &renderTest3, &renderTest4, &renderTest5, &renderTest6, &renderTest7, &renderTest8, &renderTest9, &renderTest10, NULL
 };
 
 /* Render test suite (global) */
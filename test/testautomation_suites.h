@@ -10,6 +10,7 @@
 
 /* Test collections */
 extern SDLTest_TestSuiteReference audioTestSuite;
+extern SDLTest_TestSuiteReference blitTestSuite;
 extern SDLTest_TestSuiteReference clipboardTestSuite;
 extern SDLTest_TestSuiteReference eventsTestSuite;
 extern SDLTest_TestSuiteReference keyboardTestSuite;
@@ -31,6 +32,7 @@ extern SDLTest_TestSuiteReference hintsTestSuite;
 /* All test suites */
 SDLTest_TestSuiteReference *testSuites[] =  {
     &audioTestSuite,
+    &blitTestSuite,
     &clipboardTestSuite,
     &eventsTestSuite,
     &keyboardTestSuite,
@@ -564,6 +564,505 @@ surface_testBlitBlendMod(void *arg)
    return TEST_COMPLETED;
 }
 
+/**
+ * @brief Tests bilinear filtered stretching.
+ */
+int
+surface_testStretchLinear(void *arg)
+{
+   static const Uint8 expected[] = { 0, 64, 191, 255 };
+   SDL_Surface *src, *dst, *other;
+   Uint32 *pixels;
+   int ret, i, mismatches;
+
+   /* A solid color stays exactly the same */
+   src = SDL_CreateRGBSurfaceWithFormat(0, 7, 5, 32, SDL_PIXELFORMAT_ARGB8888);
+   dst = SDL_CreateRGBSurfaceWithFormat(0, 23, 17, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(src != NULL && dst != NULL, "Verify surfaces are not NULL");
+   if (src == NULL || dst == NULL) {
+      SDL_FreeSurface(src);
+      SDL_FreeSurface(dst);
+      return TEST_ABORTED;
+   }
+   SDL_FillRect(src, NULL, 0x80402010);
+   ret = SDL_SoftStretchLinear(src, NULL, dst, NULL);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SoftStretchLinear, expected: 0, got: %i", ret);
+   mismatches = 0;
+   for (i = 0; i < dst->w * dst->h; ++i) {
+      if (((Uint32 *)dst->pixels)[i] != 0x80402010) {
+         ++mismatches;
+      }
+   }
+   SDLTest_AssertCheck(mismatches == 0, "Validate solid color, expected: 0 mismatches, got: %i", mismatches);
+
+   /* Different formats are rejected */
+   other = SDL_CreateRGBSurfaceWithFormat(0, 23, 17, 32, SDL_PIXELFORMAT_ABGR8888);
+   if (other) {
+      ret = SDL_SoftStretchLinear(src, NULL, other, NULL);
+      SDLTest_AssertCheck(ret == -1, "Verify result from SDL_SoftStretchLinear with mismatched formats, expected: -1, got: %i", ret);
+      SDL_FreeSurface(other);
+   }
+   SDL_FreeSurface(src);
+   SDL_FreeSurface(dst);
+
+   /* Black to white, sampled at pixel centers */
+   src = SDL_CreateRGBSurfaceWithFormat(0, 2, 1, 32, SDL_PIXELFORMAT_ARGB8888);
+   dst = SDL_CreateRGBSurfaceWithFormat(0, 4, 1, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(src != NULL && dst != NULL, "Verify surfaces are not NULL");
+   if (src == NULL || dst == NULL) {
+      SDL_FreeSurface(src);
+      SDL_FreeSurface(dst);
+      return TEST_ABORTED;
+   }
+   pixels = (Uint32 *)src->pixels;
+   pixels[0] = 0x00000000;
+   pixels[1] = 0xFFFFFFFF;
+   ret = SDL_SoftStretchLinear(src, NULL, dst, NULL);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_SoftStretchLinear, expected: 0, got: %i", ret);
+   pixels = (Uint32 *)dst->pixels;
+   for (i = 0; i < SDL_arraysize(expected); ++i) {
+      const Uint32 value = expected[i] * 0x01010101;
+      SDLTest_AssertCheck(pixels[i] == value, "Validate pixel %i, expected: 0x%.8x, got: 0x%.8x", i, value, pixels[i]);
+   }
+   SDL_FreeSurface(src);
+   SDL_FreeSurface(dst);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that converting on worker threads gives the same pixels as converting on one thread.
+ */
+int
+surface_testConvertThreads(void *arg)
+{
+   const int w = 640, h = 480;
+   SDL_Surface *src, *serial, *threaded;
+   Uint32 *pixels;
+   Uint8 *serial_pixels, *threaded_pixels;
+   char *original_hint;
+   int ret, i, mismatches;
+
+   src = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(src != NULL, "Verify source surface is not NULL");
+   if (src == NULL) {
+      return TEST_ABORTED;
+   }
+   pixels = (Uint32 *)src->pixels;
+   for (i = 0; i < w * h; ++i) {
+      pixels[i] = (Uint32)i * 2654435761u;
+   }
+
+   /* Setting the hint frees the old value, so keep a copy to restore */
+   original_hint = SDL_GetHint(SDL_HINT_CONVERT_THREADS) ? SDL_strdup(SDL_GetHint(SDL_HINT_CONVERT_THREADS)) : NULL;
+
+   SDL_SetHint(SDL_HINT_CONVERT_THREADS, "0");
+   serial = SDL_ConvertSurfaceFormat(src, SDL_PIXELFORMAT_RGB565, 0);
+   SDL_SetHint(SDL_HINT_CONVERT_THREADS, "1");
+   threaded = SDL_ConvertSurfaceFormat(src, SDL_PIXELFORMAT_RGB565, 0);
+   SDLTest_AssertCheck(serial != NULL && threaded != NULL, "Verify converted surfaces are not NULL");
+   if (serial != NULL && threaded != NULL) {
+      mismatches = 0;
+      for (i = 0; i < h; ++i) {
+         if (SDL_memcmp((Uint8 *)serial->pixels + i * serial->pitch,
+                        (Uint8 *)threaded->pixels + i * threaded->pitch, w * 2) != 0) {
+            ++mismatches;
+         }
+      }
+      SDLTest_AssertCheck(mismatches == 0, "Validate SDL_ConvertSurface rows, expected: 0 mismatches, got: %i", mismatches);
+   }
+   SDL_FreeSurface(serial);
+   SDL_FreeSurface(threaded);
+
+   serial_pixels = (Uint8 *)SDL_malloc(w * h * 3);
+   threaded_pixels = (Uint8 *)SDL_malloc(w * h * 3);
+   if (serial_pixels != NULL && threaded_pixels != NULL) {
+      SDL_SetHint(SDL_HINT_CONVERT_THREADS, "0");
+      ret = SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_ARGB8888, src->pixels, src->pitch, SDL_PIXELFORMAT_BGR24, serial_pixels, w * 3);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_ConvertPixels, expected: 0, got: %i", ret);
+      SDL_SetHint(SDL_HINT_CONVERT_THREADS, "1");
+      ret = SDL_ConvertPixels(w, h, SDL_PIXELFORMAT_ARGB8888, src->pixels, src->pitch, SDL_PIXELFORMAT_BGR24, threaded_pixels, w * 3);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_ConvertPixels, expected: 0, got: %i", ret);
+      ret = SDL_memcmp(serial_pixels, threaded_pixels, w * h * 3);
+      SDLTest_AssertCheck(ret == 0, "Validate SDL_ConvertPixels output matches, expected: 0, got: %i", ret);
+   }
+   SDL_free(serial_pixels);
+   SDL_free(threaded_pixels);
+   SDL_SetHint(SDL_HINT_CONVERT_THREADS, original_hint);
+   SDL_free(original_hint);
+   SDL_FreeSurface(src);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests filling rectangles of all widths and offsets in every pixel size, on one thread and on worker threads.
+ */
+int
+surface_testFillRect(void *arg)
+{
+   const Uint32 formats[] = { SDL_PIXELFORMAT_INDEX8, SDL_PIXELFORMAT_RGB565, SDL_PIXELFORMAT_RGB24, SDL_PIXELFORMAT_ARGB8888 };
+   const Uint8 pixel[] = { 0x12, 0x34, 0x56, 0x78 };
+   SDL_Surface *surface;
+   SDL_Rect rect;
+   Uint32 color;
+   Uint8 *row;
+   char *original_hint;
+   int ret, f, x, y, bpp, mismatches;
+
+   original_hint = SDL_GetHint(SDL_HINT_FILLRECT_THREADS) ? SDL_strdup(SDL_GetHint(SDL_HINT_FILLRECT_THREADS)) : NULL;
+
+   for (f = 0; f < SDL_arraysize(formats); ++f) {
+      surface = SDL_CreateRGBSurfaceWithFormat(0, 1024, 2048, 0, formats[f]);
+      SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+      if (surface == NULL) {
+         SDL_free(original_hint);
+         return TEST_ABORTED;
+      }
+      bpp = surface->format->BytesPerPixel;
+      SDL_memcpy(&color, pixel, sizeof(color));
+#if SDL_BYTEORDER == SDL_BIG_ENDIAN
+      color >>= 8 * (4 - bpp);
+#else
+      color &= (Uint32)(0xFFFFFFFFu >> (8 * (4 - bpp)));
+#endif
+
+      /* Rows of every width from every offset within a cache line */
+      mismatches = 0;
+      for (rect.w = 1; rect.w < 200; ++rect.w) {
+         SDL_memset(surface->pixels, 0, surface->pitch);
+         rect.x = rect.w % 64;
+         rect.y = 0;
+         rect.h = 1;
+         SDL_FillRect(surface, &rect, color);
+         row = (Uint8 *)surface->pixels;
+         for (x = 0; x < surface->w * bpp; ++x) {
+            const int inside = (x >= rect.x * bpp && x < (rect.x + rect.w) * bpp);
+            if (row[x] != (inside ? pixel[(x - rect.x * bpp) % bpp] : 0)) {
+               ++mismatches;
+            }
+         }
+      }
+      SDLTest_AssertCheck(mismatches == 0, "Validate narrow fills of %i byte pixels, expected: 0 mismatches, got: %i", bpp, mismatches);
+
+      /* A big fill, split over the worker threads */
+      SDL_SetHint(SDL_HINT_FILLRECT_THREADS, "1");
+      SDL_memset(surface->pixels, 0, surface->h * surface->pitch);
+      rect.x = 3;
+      rect.y = 5;
+      rect.w = surface->w - 7;
+      rect.h = surface->h - 9;
+      ret = SDL_FillRect(surface, &rect, color);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRect, expected: 0, got: %i", ret);
+      SDL_SetHint(SDL_HINT_FILLRECT_THREADS, original_hint);
+      mismatches = 0;
+      for (y = 0; y < surface->h; ++y) {
+         row = (Uint8 *)surface->pixels + y * surface->pitch;
+         for (x = 0; x < surface->w * bpp; ++x) {
+            const int inside = (y >= rect.y && y < rect.y + rect.h &&
+                                x >= rect.x * bpp && x < (rect.x + rect.w) * bpp);
+            if (row[x] != (inside ? pixel[(x - rect.x * bpp) % bpp] : 0)) {
+               ++mismatches;
+            }
+         }
+      }
+      SDLTest_AssertCheck(mismatches == 0, "Validate big fill of %i byte pixels, expected: 0 mismatches, got: %i", bpp, mismatches);
+
+      SDL_FreeSurface(surface);
+   }
+
+   SDL_free(original_hint);
+
+   return TEST_COMPLETED;
+}
+
+/* Blits src over a gray background in dst */
+static void
+_blitOverBackground(SDL_Surface *src, SDL_Surface *dst)
+{
+   int ret;
+
+   SDL_FillRect(dst, NULL, SDL_MapRGB(dst->format, 0x80, 0x80, 0x80));
+   ret = SDL_BlitSurface(src, NULL, dst, NULL);
+   SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface, expected: 0, got: %i", ret);
+}
+
+/**
+ * @brief Tests that writes to RLE accelerated surfaces show up in later blits.
+ */
+int
+surface_testRLEWrites(void *arg)
+{
+   SDL_Surface *rle, *plain, *surfaces[2], *result, *expected;
+   SDL_Rect rect;
+   Uint32 *row;
+   int ret, mode, i, x, y;
+
+   /* Blitting to the same surfaces keeps the blit maps, and so the encoding */
+   result = SDL_CreateRGBSurfaceWithFormat(0, 64, 32, 32, SDL_PIXELFORMAT_ARGB8888);
+   expected = SDL_CreateRGBSurfaceWithFormat(0, 64, 32, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(result != NULL && expected != NULL, "Verify destination surfaces are not NULL");
+   if (result == NULL || expected == NULL) {
+      SDL_FreeSurface(result);
+      SDL_FreeSurface(expected);
+      return TEST_ABORTED;
+   }
+
+   for (mode = 0; mode < 2; ++mode) {
+      const char *name = mode ? "alpha" : "colorkey";
+
+      /* The same sprite with and without RLE acceleration */
+      for (i = 0; i < 2; ++i) {
+         surfaces[i] = SDL_CreateRGBSurfaceWithFormat(0, 64, 32, 32, SDL_PIXELFORMAT_ARGB8888);
+         SDLTest_AssertCheck(surfaces[i] != NULL, "Verify surface is not NULL");
+         if (surfaces[i] == NULL) {
+            return TEST_ABORTED;
+         }
+         for (y = 0; y < surfaces[i]->h; ++y) {
+            row = (Uint32 *)((Uint8 *)surfaces[i]->pixels + y * surfaces[i]->pitch);
+            for (x = 0; x < surfaces[i]->w; ++x) {
+               if (((x / 8) + (y / 4)) & 1) {
+                  row[x] = 0;
+               } else {
+                  row[x] = ((mode ? (x * 4 + 3) : 0xFF) << 24) | (x << 18) | (y << 11) | 0x40;
+               }
+            }
+         }
+         if (mode) {
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_BLEND);
+         } else {
+            SDL_SetSurfaceBlendMode(surfaces[i], SDL_BLENDMODE_NONE);
+            SDL_SetColorKey(surfaces[i], SDL_TRUE, 0);
+         }
+      }
+      rle = surfaces[0];
+      plain = surfaces[1];
+      SDL_SetSurfaceRLE(rle, 1);
+
+      /* The first blit encodes the surface */
+      _blitOverBackground(rle, result);
+      _blitOverBackground(plain, expected);
+      SDLTest_AssertCheck((rle->flags & SDL_RLEACCEL) != 0, "Validate %s surface is RLE accelerated", name);
+
+      /* Filling without a lock */
+      rect.x = 5;
+      rect.y = 3;
+      rect.w = 20;
+      rect.h = 9;
+      for (i = 0; i < 2; ++i) {
+         ret = SDL_FillRect(surfaces[i], &rect, SDL_MapRGBA(surfaces[i]->format, 0x10, 0xE0, 0x30, 0xC0));
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRect, expected: 0, got: %i", ret);
+      }
+      SDLTest_AssertCheck(rle->locked == 0, "Validate %s surface is unlocked after SDL_FillRect", name);
+      _blitOverBackground(rle, result);
+      _blitOverBackground(plain, expected);
+      ret = SDLTest_CompareSurfaces(result, expected, 0);
+      SDLTest_AssertCheck(ret == 0, "Validate blit after filling the unlocked %s surface, expected: 0, got: %i", name, ret);
+
+      /* Changing single scan lines, which are the only ones encoded again */
+      for (i = 0; i < 2; ++i) {
+         SDL_LockSurface(surfaces[i]);
+         row = (Uint32 *)((Uint8 *)surfaces[i]->pixels + 17 * surfaces[i]->pitch);
+         for (x = 0; x < surfaces[i]->w; ++x) {
+            row[x] = (x % 3) ? 0 : (0xFF000000 | (x << 10));
+         }
+         row = (Uint32 *)((Uint8 *)surfaces[i]->pixels + 31 * surfaces[i]->pitch);
+         row[40] = 0x7F00FF00;
+         SDL_UnlockSurface(surfaces[i]);
+      }
+      SDLTest_AssertCheck((rle->flags & SDL_RLEACCEL) != 0, "Validate %s surface is RLE accelerated after unlocking", name);
+      _blitOverBackground(rle, result);
+      _blitOverBackground(plain, expected);
+      ret = SDLTest_CompareSurfaces(result, expected, 0);
+      SDLTest_AssertCheck(ret == 0, "Validate blit after changing %s scan lines, expected: 0, got: %i", name, ret);
+
+      SDL_FreeSurface(rle);
+      SDL_FreeSurface(plain);
+   }
+
+   SDL_FreeSurface(result);
+   SDL_FreeSurface(expected);
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that surface views share pixels, palettes and lifetime with the surface they view.
+ */
+int
+surface_testSurfaceView(void *arg)
+{
+   SDL_Surface *sheet, *view, *subview, *indexed, *indexed_view;
+   SDL_Rect rect;
+   Uint32 color, pixel;
+   int ret;
+
+   sheet = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(sheet != NULL, "Verify surface is not NULL");
+   if (sheet == NULL) {
+      return TEST_ABORTED;
+   }
+   SDL_SetColorKey(sheet, SDL_TRUE, 0);
+
+   rect.x = 16;
+   rect.y = 8;
+   rect.w = 32;
+   rect.h = 48;
+   view = SDL_CreateSurfaceView(sheet, &rect);
+   SDLTest_AssertCheck(view != NULL, "Verify view is not NULL");
+   if (view == NULL) {
+      SDL_FreeSurface(sheet);
+      return TEST_ABORTED;
+   }
+   SDLTest_AssertCheck(view->w == 32 && view->h == 48, "Validate view size, expected: 32x48, got: %ix%i", view->w, view->h);
+   SDLTest_AssertCheck(view->pitch == sheet->pitch, "Validate view pitch, expected: %i, got: %i", sheet->pitch, view->pitch);
+   SDLTest_AssertCheck(view->pixels == (Uint8 *)sheet->pixels + 8 * sheet->pitch + 16 * 4, "Validate view pixels point into the surface");
+   SDLTest_AssertCheck(view->format == sheet->format, "Validate view shares the pixel format");
+   SDLTest_AssertCheck((view->flags & SDL_SURFACEVIEW) != 0, "Validate view has SDL_SURFACEVIEW set");
+   ret = SDL_GetColorKey(view, &pixel);
+   SDLTest_AssertCheck(ret == 0, "Validate view inherited the color key, expected: 0, got: %i", ret);
+
+   /* Drawing to the view draws to the surface */
+   color = SDL_MapRGB(sheet->format, 0x12, 0x34, 0x56);
+   SDL_FillRect(view, NULL, color);
+   pixel = *(Uint32 *)((Uint8 *)sheet->pixels + 8 * sheet->pitch + 16 * 4);
+   SDLTest_AssertCheck(pixel == color, "Validate first view pixel, expected: 0x%.8x, got: 0x%.8x", color, pixel);
+   pixel = *(Uint32 *)((Uint8 *)sheet->pixels + 8 * sheet->pitch + 15 * 4);
+   SDLTest_AssertCheck(pixel == 0, "Validate pixel left of the view, expected: 0, got: 0x%.8x", pixel);
+
+   /* Views of views are clipped and point into the original pixels */
+   rect.x = 30;
+   rect.y = 40;
+   rect.w = 100;
+   rect.h = 100;
+   subview = SDL_CreateSurfaceView(view, &rect);
+   SDLTest_AssertCheck(subview != NULL, "Verify view of a view is not NULL");
+   if (subview != NULL) {
+      SDLTest_AssertCheck(subview->w == 2 && subview->h == 8, "Validate clipped view size, expected: 2x8, got: %ix%i", subview->w, subview->h);
+      SDLTest_AssertCheck(subview->pixels == (Uint8 *)sheet->pixels + 48 * sheet->pitch + 46 * 4, "Validate view of a view pixels");
+   }
+
+   /* The pixels stay valid until every view is gone */
+   SDL_FreeSurface(sheet);
+   SDL_FreeSurface(view);
+   if (subview != NULL) {
+      color = SDL_MapRGB(subview->format, 0xFF, 0x00, 0x00);
+      ret = SDL_FillRect(subview, NULL, color);
+      SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRect on a view of a freed surface, expected: 0, got: %i", ret);
+      SDL_FreeSurface(subview);
+   }
+
+   /* Indexed views share the palette */
+   indexed = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 8, SDL_PIXELFORMAT_INDEX8);
+   SDLTest_AssertCheck(indexed != NULL, "Verify indexed surface is not NULL");
+   if (indexed != NULL) {
+      indexed_view = SDL_CreateSurfaceView(indexed, NULL);
+      SDLTest_AssertCheck(indexed_view != NULL, "Verify indexed view is not NULL");
+      if (indexed_view != NULL) {
+         SDLTest_AssertCheck(indexed_view->format->palette == indexed->format->palette, "Validate view shares the palette");
+         SDL_FreeSurface(indexed_view);
+      }
+      SDL_FreeSurface(indexed);
+   }
+
+   /* Writes through a view of an RLE surface show up in its blits */
+   sheet = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+   indexed = SDL_CreateRGBSurfaceWithFormat(0, 64, 64, 32, SDL_PIXELFORMAT_ARGB8888);
+   SDLTest_AssertCheck(sheet != NULL && indexed != NULL, "Verify surfaces are not NULL");
+   if (sheet != NULL && indexed != NULL) {
+      SDL_SetColorKey(sheet, SDL_TRUE, 0);
+      SDL_SetSurfaceRLE(sheet, 1);
+      SDL_BlitSurface(sheet, NULL, indexed, NULL);
+      SDLTest_AssertCheck((sheet->flags & SDL_RLEACCEL) != 0, "Validate surface is RLE accelerated");
+
+      rect.x = 10;
+      rect.y = 20;
+      rect.w = 8;
+      rect.h = 8;
+      view = SDL_CreateSurfaceView(sheet, &rect);
+      SDLTest_AssertCheck(view != NULL, "Verify view of an RLE surface is not NULL");
+      if (view != NULL) {
+         SDLTest_AssertCheck(SDL_MUSTLOCK(view), "Validate SDL_MUSTLOCK() is true for a view");
+         color = SDL_MapRGB(sheet->format, 0x12, 0x34, 0x56);
+         ret = SDL_FillRect(view, NULL, color);
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_FillRect on a view, expected: 0, got: %i", ret);
+         SDLTest_AssertCheck(sheet->locked == 0, "Validate surface is unlocked after filling its view");
+         SDL_FillRect(indexed, NULL, 0);
+         SDL_BlitSurface(sheet, NULL, indexed, NULL);
+         pixel = *(Uint32 *)((Uint8 *)indexed->pixels + 20 * indexed->pitch + 10 * 4);
+         SDLTest_AssertCheck(pixel == color, "Validate blit after filling a view of an RLE surface, expected: 0x%.8x, got: 0x%.8x", color, pixel);
+
+         /* Blitting into the view */
+         color = SDL_MapRGB(sheet->format, 0x65, 0x43, 0x21);
+         SDL_FillRect(indexed, NULL, color);
+         ret = SDL_BlitSurface(indexed, &rect, view, NULL);
+         SDLTest_AssertCheck(ret == 0, "Verify result from SDL_BlitSurface to a view, expected: 0, got: %i", ret);
+         SDL_FillRect(indexed, NULL, 0);
+         SDL_BlitSurface(sheet, NULL, indexed, NULL);
+         pixel = *(Uint32 *)((Uint8 *)indexed->pixels + 20 * indexed->pitch + 10 * 4);
+         SDLTest_AssertCheck(pixel == color, "Validate blit after blitting to a view of an RLE surface, expected: 0x%.8x, got: 0x%.8x", color, pixel);
+         SDL_FreeSurface(view);
+      }
+   }
+   SDL_FreeSurface(sheet);
+   SDL_FreeSurface(indexed);
+
+   /* Invalid parameters */
+   view = SDL_CreateSurfaceView(NULL, NULL);
+   SDLTest_AssertCheck(view == NULL, "Verify view of NULL is NULL");
+
+   return TEST_COMPLETED;
+}
+
+/**
+ * @brief Tests that surface pixels are aligned and cleared, including memory reused from freed surfaces.
+ */
+int
+surface_testPixelAlignment(void *arg)
+{
+   const int widths[] = { 1, 7, 63, 64, 65, 100, 640, 1001 };
+   SDL_Surface *surface;
+   Uint8 *pixels;
+   int i, y, x, nonzero;
+
+   for (i = 0; i < SDL_arraysize(widths); ++i) {
+      surface = SDL_CreateRGBSurfaceWithFormat(0, widths[i], 48, 32, SDL_PIXELFORMAT_ARGB8888);
+      SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+      if (surface == NULL) {
+         return TEST_ABORTED;
+      }
+      SDLTest_AssertCheck((surface->flags & SDL_SIMD_ALIGNED) != 0, "Validate SDL_SIMD_ALIGNED is set for width %i", widths[i]);
+      SDLTest_AssertCheck(((uintptr_t)surface->pixels & 63) == 0, "Validate pixels are aligned to 64 bytes for width %i", widths[i]);
+      if (widths[i] * 4 >= 256) {
+         SDLTest_AssertCheck((surface->pitch % 64) == 0, "Validate pitch is a multiple of 64 bytes, got: %i", surface->pitch);
+      }
+      SDLTest_AssertCheck(surface->pitch >= widths[i] * 4, "Validate pitch covers the row, got: %i", surface->pitch);
+
+      /* Dirty the pixels, freed memory may be handed out again */
+      SDL_memset(surface->pixels, 0xFF, surface->h * surface->pitch);
+      SDL_FreeSurface(surface);
+
+      surface = SDL_CreateRGBSurfaceWithFormat(0, widths[i], 48, 32, SDL_PIXELFORMAT_ARGB8888);
+      SDLTest_AssertCheck(surface != NULL, "Verify surface is not NULL");
+      if (surface == NULL) {
+         return TEST_ABORTED;
+      }
+      nonzero = 0;
+      for (y = 0; y < surface->h; ++y) {
+         pixels = (Uint8 *)surface->pixels + y * surface->pitch;
+         for (x = 0; x < surface->w * 4; ++x) {
+            if (pixels[x] != 0) {
+               ++nonzero;
+            }
+         }
+      }
+      SDLTest_AssertCheck(nonzero == 0, "Validate new surface is cleared, expected: 0 nonzero bytes, got: %i", nonzero);
+      SDL_FreeSurface(surface);
+   }
+
+   return TEST_COMPLETED;
+}
+
 /**
  * @brief Tests some more blitting routines with loop
  */
@@ -630,11 +1129,30 @@ static const SDLTest_TestCaseReference surfaceTest11 =
 static const SDLTest_TestCaseReference surfaceTest12 =
         { (SDLTest_TestCaseFp)surface_testBlitBlendMod, "surface_testBlitBlendMod", "Tests blitting routines with mod blending mode.", TEST_ENABLED};
 
+static const SDLTest_TestCaseReference surfaceTest13 =
+        { (SDLTest_TestCaseFp)surface_testStretchLinear, "surface_testStretchLinear", "Tests bilinear filtered stretching.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest14 =
+        { (SDLTest_TestCaseFp)surface_testConvertThreads, "surface_testConvertThreads", "Tests converting surfaces and pixels on worker threads.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest15 =
+        { (SDLTest_TestCaseFp)surface_testFillRect, "surface_testFillRect", "Tests filling rectangles in every pixel size.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest16 =
+        { (SDLTest_TestCaseFp)surface_testSurfaceView, "surface_testSurfaceView", "Tests surface views sharing pixels with another surface.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest17 =
+        { (SDLTest_TestCaseFp)surface_testPixelAlignment, "surface_testPixelAlignment", "Tests surface pixel alignment and clearing.", TEST_ENABLED};
+
+static const SDLTest_TestCaseReference surfaceTest18 =
+        { (SDLTest_TestCaseFp)surface_testRLEWrites, "surface_testRLEWrites", "Tests writing to RLE accelerated surfaces.", TEST_ENABLED};
+
 /* Sequence of Surface test cases */
 static const SDLTest_TestCaseReference *surfaceTests[] =  {
     &surfaceTest1, &surfaceTest2, &surfaceTest3, &surfaceTest4, &surfaceTest5,
     &surfaceTest6, &surfaceTest7, &surfaceTest8, &surfaceTest9, &surfaceTest10,
-    &surfaceTest11, &surfaceTest12, NULL
+    &surfaceTest11, &surfaceTest12, &surfaceTest13, &surfaceTest14, &surfaceTest15,
+    &surfaceTest16, &surfaceTest17, &surfaceTest18, NULL
 };
 
 /* Surface test suite (global) */
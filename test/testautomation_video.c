@@ -1721,6 +1721,307 @@ video_getSetWindowData(void *arg)
 }
 
 
+/**
+ * @brief Tests call to SDL_GetWindowPresentStats
+ *
+ * @sa SDL_GetWindowPresentStats
+ */
+int
+video_getWindowPresentStats(void *arg)
+{
+  const char* title = "video_getWindowPresentStats Test Window";
+  SDL_Window* window;
+  SDL_Surface* surface;
+  SDL_PresentStats stats;
+  SDL_Rect rect;
+  int result;
+  int i;
+
+  /* Call against new test window */
+  window = _createVideoSuiteTestWindow(title);
+  if (window == NULL) return TEST_ABORTED;
+
+  /* Nothing presented yet */
+  result = SDL_GetWindowPresentStats(window, &stats);
+  SDLTest_AssertPass("Call to SDL_GetWindowPresentStats() before presenting");
+  SDLTest_AssertCheck(result == -1, "Validate result value; expected: -1, got: %d", result);
+
+  surface = SDL_GetWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_GetWindowSurface()");
+  if (surface == NULL) {
+    SDLTest_Log("Skipping remaining tests since the window surface couldn't be created (%s)", SDL_GetError());
+    _destroyVideoSuiteTestWindow(window);
+    return TEST_SKIPPED;
+  }
+
+  rect.x = 0;
+  rect.y = 0;
+  rect.w = surface->w / 2;
+  rect.h = surface->h / 2;
+
+  /* Every present is numbered in turn */
+  for (i = 1; i <= 4; i++) {
+    if (i % 2) {
+      result = SDL_UpdateWindowSurface(window);
+      SDLTest_AssertPass("Call to SDL_UpdateWindowSurface() [frame %d]", i);
+    } else {
+      result = SDL_UpdateWindowSurfaceRects(window, &rect, 1);
+      SDLTest_AssertPass("Call to SDL_UpdateWindowSurfaceRects() [frame %d]", i);
+    }
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+
+    SDL_memset(&stats, 0, sizeof(stats));
+    result = SDL_GetWindowPresentStats(window, &stats);
+    SDLTest_AssertPass("Call to SDL_GetWindowPresentStats() [frame %d]", i);
+    SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+    SDLTest_AssertCheck(stats.frame == (Uint64) i, "Validate frame; expected: %d, got: %" SDL_PRIu64, i, stats.frame);
+    SDLTest_AssertCheck(stats.submit_time != 0, "Validate that submit_time is set");
+    SDLTest_AssertCheck(stats.return_time >= stats.submit_time, "Validate that return_time is not before submit_time");
+    if (SDL_strcmp(SDL_GetCurrentVideoDriver(), "dummy") == 0) {
+      /* The dummy driver reports frames as soon as they're written */
+      SDLTest_AssertCheck(stats.present_time >= stats.submit_time && stats.present_time <= stats.return_time,
+                          "Validate that present_time is between submit_time and return_time");
+    }
+  }
+
+  /* Negative tests */
+  SDL_ClearError();
+  SDLTest_AssertPass("Call to SDL_ClearError()");
+
+  result = SDL_GetWindowPresentStats(window, NULL);
+  SDLTest_AssertPass("Call to SDL_GetWindowPresentStats(stats=NULL)");
+  SDLTest_AssertCheck(result == -1, "Validate result value; expected: -1, got: %d", result);
+  _checkInvalidParameterError();
+
+  result = SDL_GetWindowPresentStats(NULL, &stats);
+  SDLTest_AssertPass("Call to SDL_GetWindowPresentStats(window=NULL)");
+  SDLTest_AssertCheck(result == -1, "Validate result value; expected: -1, got: %d", result);
+  _checkInvalidWindowError();
+
+  /* Clean up */
+  _destroyVideoSuiteTestWindow(window);
+
+  return TEST_COMPLETED;
+}
+
+
+/* Records what the window frame callback was given */
+typedef struct
+{
+  int count;
+  SDL_Window *window;
+  Uint64 frame;
+  int numrects;
+  SDL_Rect rect;
+  Uint32 pixel;
+} _frameCallbackData;
+
+static void SDLCALL
+_frameCallback(void *userdata, const SDL_WindowFrame *frame)
+{
+  _frameCallbackData *data = (_frameCallbackData *)userdata;
+
+  data->count++;
+  data->window = frame->window;
+  data->frame = frame->frame;
+  data->numrects = frame->numrects;
+  if (frame->numrects > 0) {
+    data->rect = frame->rects[0];
+    data->pixel = *(Uint32 *)((Uint8 *)frame->surface->pixels +
+                              frame->rects[0].y * frame->surface->pitch +
+                              frame->rects[0].x * 4);
+  }
+}
+
+/**
+ * @brief Tests call to SDL_SetWindowFrameCallback and the frames written by SDL_HINT_VIDEO_DUMMY_OUTPUT
+ *
+ * @sa SDL_SetWindowFrameCallback
+ */
+int
+video_windowFrameCallback(void *arg)
+{
+  const char* title = "video_windowFrameCallback Test Window";
+  const char* path = "video_windowFrameCallback.raw";
+  char output[64];
+  char *originalHint;
+  SDL_Window* window;
+  SDL_Surface* surface;
+  SDL_RWops *rw;
+  _frameCallbackData data;
+  SDL_Rect rect;
+  Uint32 red, blue;
+  Uint32 header[6];
+  Uint64 frameInfo[2];
+  Uint32 *pixels;
+  Uint32 windowId;
+  int w, h;
+  int result;
+  int i;
+
+  if (SDL_strcmp(SDL_GetCurrentVideoDriver(), "dummy") != 0) {
+    SDLTest_Log("Skipping test since frames are only written by the dummy video driver");
+    return TEST_SKIPPED;
+  }
+
+  originalHint = SDL_GetHint(SDL_HINT_VIDEO_DUMMY_OUTPUT) ? SDL_strdup(SDL_GetHint(SDL_HINT_VIDEO_DUMMY_OUTPUT)) : NULL;
+  SDL_snprintf(output, sizeof(output), "file:%s", path);
+  SDL_SetHint(SDL_HINT_VIDEO_DUMMY_OUTPUT, output);
+  SDLTest_AssertPass("Call to SDL_SetHint(SDL_HINT_VIDEO_DUMMY_OUTPUT, \"%s\")", output);
+
+  /* Call against new test window */
+  window = _createVideoSuiteTestWindow(title);
+  if (window == NULL) {
+    SDL_SetHint(SDL_HINT_VIDEO_DUMMY_OUTPUT, originalHint);
+    SDL_free(originalHint);
+    return TEST_ABORTED;
+  }
+  windowId = SDL_GetWindowID(window);
+
+  SDL_zero(data);
+  result = SDL_SetWindowFrameCallback(window, _frameCallback, &data);
+  SDLTest_AssertPass("Call to SDL_SetWindowFrameCallback()");
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+
+  surface = SDL_GetWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_GetWindowSurface()");
+  SDLTest_AssertCheck(surface != NULL, "Validate that the window surface is not NULL");
+  if (surface == NULL) {
+    _destroyVideoSuiteTestWindow(window);
+    SDL_SetHint(SDL_HINT_VIDEO_DUMMY_OUTPUT, originalHint);
+    SDL_free(originalHint);
+    return TEST_ABORTED;
+  }
+  w = surface->w;
+  h = surface->h;
+  red = SDL_MapRGB(surface->format, 255, 0, 0);
+  blue = SDL_MapRGB(surface->format, 0, 0, 255);
+
+  /* Frame 1: the whole window */
+  SDL_FillRect(surface, NULL, red);
+  result = SDL_UpdateWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_UpdateWindowSurface()");
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+  SDLTest_AssertCheck(data.count == 1, "Validate callback count; expected: 1, got: %d", data.count);
+  SDLTest_AssertCheck(data.window == window, "Validate that the callback was given the window");
+  SDLTest_AssertCheck(data.frame == 1, "Validate frame; expected: 1, got: %" SDL_PRIu64, data.frame);
+  SDLTest_AssertCheck(data.numrects == 1, "Validate numrects; expected: 1, got: %d", data.numrects);
+  SDLTest_AssertCheck(data.rect.x == 0 && data.rect.y == 0 && data.rect.w == w && data.rect.h == h,
+                      "Validate rect; expected: 0,0 %dx%d, got: %d,%d %dx%d", w, h, data.rect.x, data.rect.y, data.rect.w, data.rect.h);
+  SDLTest_AssertCheck(data.pixel == red, "Validate pixel; expected: 0x%.8x, got: 0x%.8x", red, data.pixel);
+
+  /* Frame 2: part of it */
+  rect.x = 10;
+  rect.y = 20;
+  rect.w = 30;
+  rect.h = 40;
+  SDL_FillRect(surface, &rect, blue);
+  result = SDL_UpdateWindowSurfaceRects(window, &rect, 1);
+  SDLTest_AssertPass("Call to SDL_UpdateWindowSurfaceRects()");
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+  SDLTest_AssertCheck(data.count == 2, "Validate callback count; expected: 2, got: %d", data.count);
+  SDLTest_AssertCheck(data.frame == 2, "Validate frame; expected: 2, got: %" SDL_PRIu64, data.frame);
+  SDLTest_AssertCheck(data.numrects == 1, "Validate numrects; expected: 1, got: %d", data.numrects);
+  SDLTest_AssertCheck(SDL_RectEquals(&data.rect, &rect),
+                      "Validate rect; expected: 10,20 30x40, got: %d,%d %dx%d", data.rect.x, data.rect.y, data.rect.w, data.rect.h);
+  SDLTest_AssertCheck(data.pixel == blue, "Validate pixel; expected: 0x%.8x, got: 0x%.8x", blue, data.pixel);
+
+  /* Frame 3: without the callback */
+  result = SDL_SetWindowFrameCallback(window, NULL, NULL);
+  SDLTest_AssertPass("Call to SDL_SetWindowFrameCallback(callback=NULL)");
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+  result = SDL_UpdateWindowSurface(window);
+  SDLTest_AssertPass("Call to SDL_UpdateWindowSurface()");
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+  SDLTest_AssertCheck(data.count == 2, "Validate callback count; expected: 2, got: %d", data.count);
+
+  /* Negative test */
+  SDL_ClearError();
+  SDLTest_AssertPass("Call to SDL_ClearError()");
+  result = SDL_SetWindowFrameCallback(NULL, _frameCallback, &data);
+  SDLTest_AssertPass("Call to SDL_SetWindowFrameCallback(window=NULL)");
+  SDLTest_AssertCheck(result == -1, "Validate result value; expected: -1, got: %d", result);
+  _checkInvalidWindowError();
+
+  /* Closes the output file */
+  _destroyVideoSuiteTestWindow(window);
+  SDL_SetHint(SDL_HINT_VIDEO_DUMMY_OUTPUT, originalHint);
+  SDL_free(originalHint);
+
+  /* Check the frames that were written */
+  pixels = (Uint32 *)SDL_malloc(w * h * 4);
+  rw = SDL_RWFromFile(path, "rb");
+  SDLTest_AssertCheck(rw != NULL, "Validate that %s was written", path);
+  if (rw != NULL && pixels != NULL) {
+    for (i = 1; i <= 3; i++) {
+      if (SDL_RWread(rw, header, sizeof(header), 1) != 1 ||
+          SDL_RWread(rw, frameInfo, sizeof(frameInfo), 1) != 1 ||
+          SDL_RWread(rw, pixels, w * h * 4, 1) != 1) {
+        SDLTest_AssertCheck(SDL_FALSE, "Validate that frame %d was written", i);
+        break;
+      }
+      SDLTest_AssertCheck(header[0] == 0x46534453, "Validate frame magic; expected: 0x46534453, got: 0x%.8x", header[0]);
+      SDLTest_AssertCheck(header[1] == windowId, "Validate window id; expected: %u, got: %u", windowId, header[1]);
+      SDLTest_AssertCheck(header[2] == SDL_PIXELFORMAT_RGB888, "Validate pixel format; expected: %s, got: %s",
+                          SDL_GetPixelFormatName(SDL_PIXELFORMAT_RGB888), SDL_GetPixelFormatName(header[2]));
+      SDLTest_AssertCheck(header[3] == (Uint32)w && header[4] == (Uint32)h && header[5] == (Uint32)(w * 4),
+                          "Validate size; expected: %dx%d pitch %d, got: %ux%u pitch %u", w, h, w * 4, header[3], header[4], header[5]);
+      SDLTest_AssertCheck(frameInfo[0] == (Uint64)i, "Validate frame number; expected: %d, got: %" SDL_PRIu64, i, frameInfo[0]);
+      SDLTest_AssertCheck(pixels[0] == red, "Validate pixel 0,0 of frame %d; expected: 0x%.8x, got: 0x%.8x", i, red, pixels[0]);
+      if (i > 1) {
+        const Uint32 pixel = pixels[rect.y * w + rect.x];
+        SDLTest_AssertCheck(pixel == blue, "Validate pixel 10,20 of frame %d; expected: 0x%.8x, got: 0x%.8x", i, blue, pixel);
+      }
+    }
+  }
+  if (rw != NULL) {
+    SDL_RWclose(rw);
+  }
+  SDL_free(pixels);
+  remove(path);
+
+  return TEST_COMPLETED;
+}
+
+
+/**
+ * @brief Tests call to SDL_GetVideoInitTimes
+ *
+ * @sa SDL_GetVideoInitTimes
+ */
+int
+video_getVideoInitTimes(void *arg)
+{
+  SDL_VideoInitTimes times;
+  int result;
+
+  SDL_memset(&times, 0, sizeof(times));
+  result = SDL_GetVideoInitTimes(&times);
+  SDLTest_AssertPass("Call to SDL_GetVideoInitTimes()");
+  SDLTest_AssertCheck(result == 0, "Validate result value; expected: 0, got: %d", result);
+  SDLTest_AssertCheck(times.events > 0, "Validate events time; expected: >0, got: %" SDL_PRIu64, times.events);
+  SDLTest_AssertCheck(times.connect > 0, "Validate connect time; expected: >0, got: %" SDL_PRIu64, times.connect);
+  SDLTest_AssertCheck(times.driver > 0, "Validate driver time; expected: >0, got: %" SDL_PRIu64, times.driver);
+  SDLTest_AssertCheck(times.total > 0, "Validate total time; expected: >0, got: %" SDL_PRIu64, times.total);
+  SDLTest_AssertCheck(times.total >= times.events + times.connect + times.driver,
+                      "Validate total time covers the stages; expected: >=%" SDL_PRIu64 ", got: %" SDL_PRIu64,
+                      times.events + times.connect + times.driver, times.total);
+  SDLTest_AssertCheck(times.driver >= times.displays + times.input,
+                      "Validate driver time covers displays and input; expected: >=%" SDL_PRIu64 ", got: %" SDL_PRIu64,
+                      times.displays + times.input, times.driver);
+
+  /* Negative test */
+  SDL_ClearError();
+  SDLTest_AssertPass("Call to SDL_ClearError()");
+  result = SDL_GetVideoInitTimes(NULL);
+  SDLTest_AssertPass("Call to SDL_GetVideoInitTimes(NULL)");
+  SDLTest_AssertCheck(result == -1, "Validate result value; expected: -1, got: %d", result);
+  _checkInvalidParameterError();
+
+  return TEST_COMPLETED;
+}
+
+
 /* ================= Test References ================== */
 
 /* Video test cases */
@@ -1793,13 +2094,23 @@ static const SDLTest_TestCaseReference videoTest22 =
 static const SDLTest_TestCaseReference videoTest23 =
         { (SDLTest_TestCaseFp)video_getSetWindowData, "video_getSetWindowData",  "Checks SDL_SetWindowData and SDL_GetWindowData positive and negative cases", TEST_ENABLED };
 
+static const SDLTest_TestCaseReference videoTest24 =
+        { (SDLTest_TestCaseFp)video_getWindowPresentStats, "video_getWindowPresentStats",  "Checks SDL_GetWindowPresentStats frame numbering and timing", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference videoTest25 =
+        { (SDLTest_TestCaseFp)video_windowFrameCallback, "video_windowFrameCallback",  "Checks SDL_SetWindowFrameCallback and the frames written by the dummy driver", TEST_ENABLED };
+
+static const SDLTest_TestCaseReference videoTest26 =
+        { (SDLTest_TestCaseFp)video_getVideoInitTimes, "video_getVideoInitTimes",  "Checks SDL_GetVideoInitTimes", TEST_ENABLED };
+
 /* Sequence of Video test cases */
 static const SDLTest_TestCaseReference *videoTests[] =  {
     &videoTest1, &videoTest2, &videoTest3, &videoTest4, &videoTest5, &videoTest6,
     &videoTest7, &videoTest8, &videoTest9, &videoTest10, &videoTest11, &videoTest12,
     &videoTest13, &videoTest14, &videoTest15, &videoTest16, &videoTest17,
     &videoTest18, &videoTest19, &videoTest20, &videoTest21, &videoTest22,
-    &videoTest23, NULL
+    &videoTest23, &videoTest24, &videoTest25,
+    &videoTest26, NULL
 };
 
 /* Video test suite (global) */
@@ -0,0 +1,808 @@
+/*
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Blitter throughput benchmark.
+
+   Runs SDL_BlitSurface() and SDL_BlitScaled() over every combination of
+   source format, destination format, blend mode, color and alpha modulation,
+   color key and scaling, for a range of sizes, with the pixels in cache
+   ("hot") and with every blit touching memory that was evicted ("cold").
+   Results are in destination megapixels per second.
+
+   With --features, every listed SDL_BLIT_CPU_FEATURES level is run in its own
+   process, since SDL picks the level once per process. The output of each
+   blit is hashed, and a hash that differs from the one for the first level
+   is reported as a conformance mismatch.
+
+   Results can be written as JSON with --json, and compared against an older
+   JSON file with --baseline. The exit code is 1 if anything got slower than
+   --threshold percent, or if a conformance check failed. It is 2 on errors,
+   including a baseline that has none of the results that were run.
+
+   The full matrix takes hours, narrow it down with --src, --dst, --flags and
+   --size, for example:
+     testblitbench --src ARGB8888 --dst RGB565 --size 1920x1080 --features all
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#ifdef _WIN32
+#define popen _popen
+#define pclose _pclose
+#endif
+
+#define MAX_FILTERS     32
+#define MAX_LEVELS      8
+
+static const Uint32 formats[] = {
+    SDL_PIXELFORMAT_INDEX8,
+    SDL_PIXELFORMAT_RGB332,
+    SDL_PIXELFORMAT_RGB444,
+    SDL_PIXELFORMAT_RGB555,
+    SDL_PIXELFORMAT_BGR555,
+    SDL_PIXELFORMAT_ARGB4444,
+    SDL_PIXELFORMAT_RGBA4444,
+    SDL_PIXELFORMAT_ABGR4444,
+    SDL_PIXELFORMAT_BGRA4444,
+    SDL_PIXELFORMAT_ARGB1555,
+    SDL_PIXELFORMAT_RGBA5551,
+    SDL_PIXELFORMAT_ABGR1555,
+    SDL_PIXELFORMAT_BGRA5551,
+    SDL_PIXELFORMAT_RGB565,
+    SDL_PIXELFORMAT_BGR565,
+    SDL_PIXELFORMAT_RGB24,
+    SDL_PIXELFORMAT_BGR24,
+    SDL_PIXELFORMAT_RGB888,
+    SDL_PIXELFORMAT_RGBX8888,
+    SDL_PIXELFORMAT_BGR888,
+    SDL_PIXELFORMAT_BGRX8888,
+    SDL_PIXELFORMAT_ARGB8888,
+    SDL_PIXELFORMAT_RGBA8888,
+    SDL_PIXELFORMAT_ABGR8888,
+    SDL_PIXELFORMAT_BGRA8888,
+    SDL_PIXELFORMAT_ARGB2101010
+};
+
+static const SDL_BlendMode blend_modes[] = {
+    SDL_BLENDMODE_NONE, SDL_BLENDMODE_BLEND, SDL_BLENDMODE_ADD, SDL_BLENDMODE_MOD
+};
+static const char *blend_names[] = {
+    "none", "blend", "add", "mod"
+};
+
+#define FLAG_COLORMOD   0x01
+#define FLAG_ALPHAMOD   0x02
+#define FLAG_COLORKEY   0x04
+#define FLAG_SCALED     0x08
+#define NUM_FLAG_SETS   (SDL_arraysize(blend_modes) * 16)
+
+static const struct {
+    int w, h;
+} default_sizes[] = {
+    { 16, 16 }, { 64, 64 }, { 256, 256 }, { 1920, 1080 }, { 3840, 2160 }
+};
+
+typedef struct
+{
+    Uint32 features;
+    char src[32];
+    char dst[32];
+    char flags[64];
+    int w, h;
+    char cache[8];
+    double mpixels;
+    Uint32 hash;
+    char key[160];
+} BenchResult;
+
+typedef struct
+{
+    BenchResult *results;
+    int count;
+    int capacity;
+} BenchResults;
+
+/* Command line settings */
+static const char *src_filters[MAX_FILTERS];
+static int num_src_filters;
+static const char *dst_filters[MAX_FILTERS];
+static int num_dst_filters;
+static const char *flag_filters[MAX_FILTERS];
+static int num_flag_filters;
+static int sizes[MAX_FILTERS][2];
+static int num_sizes;
+static SDL_bool run_hot = SDL_TRUE;
+static SDL_bool run_cold = SDL_TRUE;
+static int min_time_ms = 10;
+static int cold_mb = 128;
+
+/* Memory the surfaces point into, cold runs walk through all of it */
+static Uint8 *src_arena;
+static Uint8 *dst_arena;
+static size_t arena_size;
+
+
+static const char *
+FormatName(Uint32 format)
+{
+    const char *name = SDL_GetPixelFormatName(format);
+
+    if (SDL_strncmp(name, "SDL_PIXELFORMAT_", 16) == 0) {
+        name += 16;
+    }
+    return name;
+}
+
+static void
+FlagSetName(int set, char *name, size_t maxlen)
+{
+    const int blend = set / 16;
+    const int flags = set % 16;
+
+    SDL_strlcpy(name, blend_names[blend], maxlen);
+    if (flags & FLAG_COLORMOD) {
+        SDL_strlcat(name, "+colormod", maxlen);
+    }
+    if (flags & FLAG_ALPHAMOD) {
+        SDL_strlcat(name, "+alphamod", maxlen);
+    }
+    if (flags & FLAG_COLORKEY) {
+        SDL_strlcat(name, "+colorkey", maxlen);
+    }
+    if (flags & FLAG_SCALED) {
+        SDL_strlcat(name, "+scaled", maxlen);
+    }
+}
+
+static SDL_bool
+Matches(const char *name, const char **filters, int num_filters)
+{
+    int i;
+
+    if (num_filters == 0) {
+        return SDL_TRUE;
+    }
+    for (i = 0; i < num_filters; ++i) {
+        if (SDL_strcasecmp(name, filters[i]) == 0) {
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+static void
+FillRandom(Uint8 *data, size_t size, Uint32 seed)
+{
+    Uint32 x = seed;
+    size_t i;
+
+    for (i = 0; i < size; ++i) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        data[i] = (Uint8) (x >> 24);
+    }
+}
+
+static Uint32
+HashRows(const SDL_Surface *surface)
+{
+    const int row_bytes = surface->w * surface->format->BytesPerPixel;
+    Uint32 hash = 2166136261u;
+    int x, y;
+
+    for (y = 0; y < surface->h; ++y) {
+        const Uint8 *row = (const Uint8 *) surface->pixels + y * surface->pitch;
+        for (x = 0; x < row_bytes; ++x) {
+            hash = (hash ^ row[x]) * 16777619u;
+        }
+    }
+    return hash;
+}
+
+static void
+MakeKey(BenchResult *result)
+{
+    SDL_snprintf(result->key, sizeof(result->key), "%u|%s|%s|%s|%dx%d|%s",
+                 (unsigned int) result->features, result->src, result->dst,
+                 result->flags, result->w, result->h, result->cache);
+}
+
+static int
+CompareKeys(const void *a, const void *b)
+{
+    return SDL_strcmp(((const BenchResult *) a)->key, ((const BenchResult *) b)->key);
+}
+
+static void
+AddResult(BenchResults *list, const BenchResult *result)
+{
+    if (list->count == list->capacity) {
+        const int capacity = list->capacity ? list->capacity * 2 : 1024;
+        BenchResult *results = (BenchResult *) SDL_realloc(list->results, capacity * sizeof(*results));
+        if (!results) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+            return;
+        }
+        list->results = results;
+        list->capacity = capacity;
+    }
+    list->results[list->count] = *result;
+    MakeKey(&list->results[list->count]);
+    ++list->count;
+}
+
+static void
+PrintResult(const BenchResult *result)
+{
+    printf("%-8u %-12s -> %-12s %-32s %4dx%-4d %-4s %10.1f MP/s\n",
+           (unsigned int) result->features, result->src, result->dst,
+           result->flags, result->w, result->h, result->cache, result->mpixels);
+    fflush(stdout);
+}
+
+static SDL_Surface *
+CreateSurface(Uint32 format, int w, int h, Uint8 *pixels)
+{
+    SDL_Surface *surface;
+    int pitch = (w * SDL_BYTESPERPIXEL(format) + 3) & ~3;
+
+    surface = SDL_CreateRGBSurfaceWithFormatFrom(pixels, w, h, SDL_BITSPERPIXEL(format), pitch, format);
+    if (surface && surface->format->palette) {
+        /* An RGB 3-3-2 palette, so indexed pixels map to real colors */
+        SDL_Color colors[256];
+        int i;
+
+        for (i = 0; i < 256; ++i) {
+            colors[i].r = (Uint8) ((i >> 5) * 255 / 7);
+            colors[i].g = (Uint8) (((i >> 2) & 7) * 255 / 7);
+            colors[i].b = (Uint8) ((i & 3) * 255 / 3);
+            colors[i].a = SDL_ALPHA_OPAQUE;
+        }
+        SDL_SetPaletteColors(surface->format->palette, colors, 0, 256);
+    }
+    return surface;
+}
+
+static size_t
+SlotSize(Uint32 format, int w, int h)
+{
+    const size_t size = (size_t) ((w * SDL_BYTESPERPIXEL(format) + 3) & ~3) * h;
+    return (size + 63) & ~(size_t) 63;
+}
+
+static int
+Blit(SDL_Surface *src, SDL_Surface *dst, SDL_bool scaled)
+{
+    if (scaled) {
+        return SDL_BlitScaled(src, NULL, dst, NULL);
+    }
+    return SDL_BlitSurface(src, NULL, dst, NULL);
+}
+
+/* Time blits until min_time_ms has passed, returns destination megapixels per second */
+static double
+TimeBlits(SDL_Surface *src, SDL_Surface *dst, SDL_bool scaled, SDL_bool cold,
+          size_t src_slot, size_t dst_slot)
+{
+    const Uint64 frequency = SDL_GetPerformanceFrequency();
+    const Uint64 min_ticks = frequency * min_time_ms / 1000;
+    const size_t src_slots = arena_size / src_slot;
+    const size_t dst_slots = arena_size / dst_slot;
+    Uint64 start, elapsed;
+    size_t slot = 0;
+    int blits = 0;
+
+    if (!cold) {
+        /* Warm up the cache and the blit map */
+        Blit(src, dst, scaled);
+    }
+
+    start = SDL_GetPerformanceCounter();
+    do {
+        if (cold) {
+            src->pixels = src_arena + (slot % src_slots) * src_slot;
+            dst->pixels = dst_arena + (slot % dst_slots) * dst_slot;
+            ++slot;
+        }
+        Blit(src, dst, scaled);
+        ++blits;
+        elapsed = SDL_GetPerformanceCounter() - start;
+    } while (elapsed < min_ticks);
+
+    src->pixels = src_arena;
+    dst->pixels = dst_arena;
+    return ((double) dst->w * dst->h * blits) / ((double) elapsed / frequency) / 1000000.0;
+}
+
+static void
+RunCase(Uint32 features, Uint32 src_format, Uint32 dst_format, int flag_set,
+        int w, int h, BenchResults *list)
+{
+    const int flags = flag_set % 16;
+    const SDL_bool scaled = (flags & FLAG_SCALED) ? SDL_TRUE : SDL_FALSE;
+    const int src_w = scaled ? SDL_max(w / 2, 1) : w;
+    const int src_h = scaled ? SDL_max(h / 2, 1) : h;
+    const size_t src_slot = SlotSize(src_format, src_w, src_h);
+    const size_t dst_slot = SlotSize(dst_format, w, h);
+    SDL_Surface *src, *dst;
+    BenchResult result;
+
+    src = CreateSurface(src_format, src_w, src_h, src_arena);
+    dst = CreateSurface(dst_format, w, h, dst_arena);
+    if (!src || !dst) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create surfaces: %s\n", SDL_GetError());
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(dst);
+        return;
+    }
+
+    SDL_SetSurfaceBlendMode(src, blend_modes[flag_set / 16]);
+    if (flags & FLAG_COLORMOD) {
+        SDL_SetSurfaceColorMod(src, 0xC0, 0x80, 0x40);
+    }
+    if (flags & FLAG_ALPHAMOD) {
+        SDL_SetSurfaceAlphaMod(src, 0x80);
+    }
+    if (flags & FLAG_COLORKEY) {
+        /* Whatever the first pixel is, so some of the random pixels match */
+        SDL_SetColorKey(src, SDL_TRUE, *(Uint32 *) src_arena & (Uint32) (((Uint64) 1 << src->format->BitsPerPixel) - 1));
+    }
+
+    SDL_zero(result);
+    result.features = features;
+    SDL_strlcpy(result.src, FormatName(src_format), sizeof(result.src));
+    SDL_strlcpy(result.dst, FormatName(dst_format), sizeof(result.dst));
+    FlagSetName(flag_set, result.flags, sizeof(result.flags));
+    result.w = w;
+    result.h = h;
+
+    /* Check the blit is supported and hash its output for conformance checks */
+    FillRandom(dst_arena, dst_slot, 0xBADC0DE);
+    if (Blit(src, dst, scaled) < 0) {
+        SDL_FreeSurface(src);
+        SDL_FreeSurface(dst);
+        return;
+    }
+    result.hash = HashRows(dst);
+
+    if (run_hot) {
+        SDL_strlcpy(result.cache, "hot", sizeof(result.cache));
+        result.mpixels = TimeBlits(src, dst, scaled, SDL_FALSE, src_slot, dst_slot);
+        AddResult(list, &result);
+    }
+    if (run_cold) {
+        SDL_strlcpy(result.cache, "cold", sizeof(result.cache));
+        result.mpixels = TimeBlits(src, dst, scaled, SDL_TRUE, src_slot, dst_slot);
+        AddResult(list, &result);
+    }
+
+    SDL_FreeSurface(src);
+    SDL_FreeSurface(dst);
+}
+
+/* Run the whole matrix in this process, at whatever feature level SDL picked */
+static int
+RunMatrix(Uint32 features, SDL_bool child, BenchResults *list)
+{
+    size_t largest = 0;
+    int s, i, j, f;
+    char flag_name[64];
+
+    for (s = 0; s < num_sizes; ++s) {
+        largest = SDL_max(largest, SlotSize(SDL_PIXELFORMAT_ARGB2101010, sizes[s][0], sizes[s][1]));
+    }
+    arena_size = SDL_max((size_t) cold_mb * 1024 * 1024, 2 * largest);
+    src_arena = (Uint8 *) SDL_malloc(arena_size);
+    dst_arena = (Uint8 *) SDL_malloc(arena_size);
+    if (!src_arena || !dst_arena) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't allocate %u MB of pixels\n", (unsigned int) (2 * arena_size / (1024 * 1024)));
+        return -1;
+    }
+    FillRandom(src_arena, arena_size, 0x12345678);
+    FillRandom(dst_arena, arena_size, 0x9ABCDEF0);
+
+    for (i = 0; i < SDL_arraysize(formats); ++i) {
+        if (!Matches(FormatName(formats[i]), src_filters, num_src_filters)) {
+            continue;
+        }
+        for (j = 0; j < SDL_arraysize(formats); ++j) {
+            if (!Matches(FormatName(formats[j]), dst_filters, num_dst_filters)) {
+                continue;
+            }
+            for (f = 0; f < NUM_FLAG_SETS; ++f) {
+                FlagSetName(f, flag_name, sizeof(flag_name));
+                if (!Matches(flag_name, flag_filters, num_flag_filters)) {
+                    continue;
+                }
+                for (s = 0; s < num_sizes; ++s) {
+                    const int first = list->count;
+                    int r;
+
+                    RunCase(features, formats[i], formats[j], f, sizes[s][0], sizes[s][1], list);
+                    for (r = first; r < list->count; ++r) {
+                        const BenchResult *result = &list->results[r];
+                        if (child) {
+                            printf("RESULT %u %s %s %s %d %d %s %f %u\n",
+                                   (unsigned int) result->features, result->src, result->dst,
+                                   result->flags, result->w, result->h, result->cache,
+                                   result->mpixels, (unsigned int) result->hash);
+                            fflush(stdout);
+                        } else {
+                            PrintResult(result);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    SDL_free(src_arena);
+    SDL_free(dst_arena);
+    return 0;
+}
+
+/* Run the matrix in a child process for each feature level */
+static int
+RunLevels(int argc, char **argv, const Uint32 *levels, int num_levels, BenchResults *list)
+{
+    char command[4096];
+    char line[512];
+    char value[32];
+    FILE *child;
+    int i, l;
+
+    for (l = 0; l < num_levels; ++l) {
+        SDL_snprintf(command, sizeof(command), "\"%s\" --child", argv[0]);
+        for (i = 1; i < argc; ++i) {
+            if (SDL_strcmp(argv[i], "--features") == 0 ||
+                SDL_strcmp(argv[i], "--json") == 0 ||
+                SDL_strcmp(argv[i], "--baseline") == 0 ||
+                SDL_strcmp(argv[i], "--threshold") == 0) {
+                ++i;    /* only the parent uses these */
+                continue;
+            }
+            SDL_strlcat(command, " \"", sizeof(command));
+            SDL_strlcat(command, argv[i], sizeof(command));
+            SDL_strlcat(command, "\"", sizeof(command));
+        }
+
+        SDL_snprintf(value, sizeof(value), "%u", (unsigned int) levels[l]);
+        SDL_setenv("SDL_BLIT_CPU_FEATURES", value, 1);
+
+        child = popen(command, "r");
+        if (!child) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't run %s\n", command);
+            return -1;
+        }
+        while (fgets(line, sizeof(line), child)) {
+            BenchResult result;
+            unsigned int features, hash;
+
+            SDL_zero(result);
+            if (sscanf(line, "RESULT %u %31s %31s %63s %d %d %7s %lf %u",
+                       &features, result.src, result.dst, result.flags,
+                       &result.w, &result.h, result.cache, &result.mpixels, &hash) == 9) {
+                result.features = features;
+                result.hash = hash;
+                PrintResult(&result);
+                AddResult(list, &result);
+            }
+        }
+        if (pclose(child) != 0) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Feature level %u failed\n", (unsigned int) levels[l]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Every level should produce the same pixels as the first one */
+static int
+CheckConformance(const BenchResults *list, Uint32 reference)
+{
+    int i, j, mismatches = 0;
+
+    for (i = 0; i < list->count; ++i) {
+        const BenchResult *result = &list->results[i];
+
+        if (result->features == reference || SDL_strcmp(result->cache, "hot") != 0) {
+            continue;
+        }
+        for (j = 0; j < list->count; ++j) {
+            const BenchResult *ref = &list->results[j];
+            if (ref->features == reference && ref->w == result->w && ref->h == result->h &&
+                SDL_strcmp(ref->cache, "hot") == 0 &&
+                SDL_strcmp(ref->src, result->src) == 0 &&
+                SDL_strcmp(ref->dst, result->dst) == 0 &&
+                SDL_strcmp(ref->flags, result->flags) == 0) {
+                if (ref->hash != result->hash) {
+                    printf("MISMATCH %s -> %s %s %dx%d: features %u differs from features %u\n",
+                           result->src, result->dst, result->flags, result->w, result->h,
+                           (unsigned int) result->features, (unsigned int) reference);
+                    ++mismatches;
+                }
+                break;
+            }
+        }
+    }
+    return mismatches;
+}
+
+static int
+WriteJSON(const char *file, const BenchResults *list)
+{
+    FILE *fp = fopen(file, "w");
+    int i;
+
+    if (!fp) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't write %s\n", file);
+        return -1;
+    }
+    fprintf(fp, "{\n  \"benchmark\": \"testblitbench\",\n  \"unit\": \"megapixels_per_second\",\n  \"results\": [\n");
+    for (i = 0; i < list->count; ++i) {
+        const BenchResult *result = &list->results[i];
+        fprintf(fp, "    {\"features\": %u, \"src\": \"%s\", \"dst\": \"%s\", \"flags\": \"%s\", \"w\": %d, \"h\": %d, \"cache\": \"%s\", \"mpixels_per_second\": %.2f, \"hash\": %u}%s\n",
+                (unsigned int) result->features, result->src, result->dst, result->flags,
+                result->w, result->h, result->cache, result->mpixels,
+                (unsigned int) result->hash, (i + 1 < list->count) ? "," : "");
+    }
+    fprintf(fp, "  ]\n}\n");
+    fclose(fp);
+    return 0;
+}
+
+/* Reads back what WriteJSON() wrote, one result per line */
+static int
+ReadJSON(const char *file, BenchResults *list)
+{
+    FILE *fp = fopen(file, "r");
+    char line[512];
+
+    if (!fp) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't read %s\n", file);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp)) {
+        BenchResult result;
+        unsigned int features, hash;
+
+        SDL_zero(result);
+        if (sscanf(line, " {\"features\": %u, \"src\": \"%31[^\"]\", \"dst\": \"%31[^\"]\", \"flags\": \"%63[^\"]\", \"w\": %d, \"h\": %d, \"cache\": \"%7[^\"]\", \"mpixels_per_second\": %lf, \"hash\": %u",
+                   &features, result.src, result.dst, result.flags, &result.w, &result.h,
+                   result.cache, &result.mpixels, &hash) == 9) {
+            result.features = features;
+            result.hash = hash;
+            AddResult(list, &result);
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+static int
+CompareBaseline(const char *file, const BenchResults *list, double threshold)
+{
+    BenchResults baseline;
+    int i, compared = 0, slower = 0, faster = 0;
+
+    SDL_zero(baseline);
+    if (ReadJSON(file, &baseline) < 0) {
+        return -1;
+    }
+    SDL_qsort(baseline.results, baseline.count, sizeof(*baseline.results), CompareKeys);
+
+    for (i = 0; i < list->count; ++i) {
+        const BenchResult *result = &list->results[i];
+        const BenchResult *old = (const BenchResult *) bsearch(result, baseline.results, baseline.count, sizeof(*baseline.results), CompareKeys);
+        double change;
+
+        if (!old || old->mpixels <= 0.0) {
+            continue;
+        }
+        ++compared;
+        change = (result->mpixels - old->mpixels) * 100.0 / old->mpixels;
+        if (change < -threshold) {
+            printf("SLOWER %-12s -> %-12s %-32s %4dx%-4d %-4s features %u: %.1f -> %.1f MP/s (%.1f%%)\n",
+                   result->src, result->dst, result->flags, result->w, result->h, result->cache,
+                   (unsigned int) result->features, old->mpixels, result->mpixels, change);
+            ++slower;
+        } else if (change > threshold) {
+            ++faster;
+        }
+    }
+    SDL_free(baseline.results);
+    if (compared == 0 && list->count > 0) {
+        /* Probably a baseline from another machine or set of options */
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "None of the %d results are in %s\n", list->count, file);
+        return -1;
+    }
+    printf("Compared %d results with %s: %d slower, %d faster by more than %.1f%%\n",
+           compared, file, slower, faster, threshold);
+    return slower;
+}
+
+/* Cumulative feature levels this CPU supports, from plain C up */
+static int
+GetFeatureLevels(Uint32 *levels)
+{
+    Uint32 features = 0;
+    int num_levels = 0;
+
+    levels[num_levels++] = features;
+    if (SDL_HasMMX() || SDL_HasSSE()) {
+        features |= (SDL_HasMMX() ? 0x01 : 0) | (SDL_HasSSE() ? 0x04 : 0);
+        levels[num_levels++] = features;
+    }
+    if (SDL_HasSSE2()) {
+        features |= 0x08;
+        levels[num_levels++] = features;
+    }
+    if (SDL_HasSSE41()) {
+        features |= 0x40;
+        levels[num_levels++] = features;
+    }
+    if (SDL_HasAVX2()) {
+        features |= 0x80;
+        levels[num_levels++] = features;
+    }
+    if (SDL_HasNEON()) {
+        features |= 0x100;
+        levels[num_levels++] = features;
+    }
+    if (SDL_HasAltiVec()) {
+        features |= 0x20;
+        levels[num_levels++] = features;
+    }
+    return num_levels;
+}
+
+int
+main(int argc, char **argv)
+{
+    BenchResults results;
+    Uint32 levels[MAX_LEVELS];
+    int num_levels = 0;
+    const char *json_file = NULL;
+    const char *baseline_file = NULL;
+    double threshold = 10.0;
+    SDL_bool child = SDL_FALSE;
+    Uint32 features = 0;
+    const char *env;
+    int status = 0;
+    int i;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (SDL_strcmp(arg, "--child") == 0) {
+            child = SDL_TRUE;
+            continue;
+        }
+        if (SDL_strcmp(arg, "--hot") == 0) {
+            run_cold = SDL_FALSE;
+            continue;
+        }
+        if (SDL_strcmp(arg, "--cold") == 0) {
+            run_hot = SDL_FALSE;
+            continue;
+        }
+        if (!value) {
+            goto usage;
+        }
+        ++i;
+        if (SDL_strcmp(arg, "--src") == 0 && num_src_filters < MAX_FILTERS) {
+            src_filters[num_src_filters++] = value;
+        } else if (SDL_strcmp(arg, "--dst") == 0 && num_dst_filters < MAX_FILTERS) {
+            dst_filters[num_dst_filters++] = value;
+        } else if (SDL_strcmp(arg, "--flags") == 0 && num_flag_filters < MAX_FILTERS) {
+            flag_filters[num_flag_filters++] = value;
+        } else if (SDL_strcmp(arg, "--size") == 0 && num_sizes < MAX_FILTERS &&
+                   sscanf(value, "%dx%d", &sizes[num_sizes][0], &sizes[num_sizes][1]) == 2 &&
+                   sizes[num_sizes][0] > 0 && sizes[num_sizes][1] > 0) {
+            ++num_sizes;
+        } else if (SDL_strcmp(arg, "--time") == 0) {
+            min_time_ms = SDL_max(SDL_atoi(value), 1);
+        } else if (SDL_strcmp(arg, "--cold-mb") == 0) {
+            cold_mb = SDL_max(SDL_atoi(value), 1);
+        } else if (SDL_strcmp(arg, "--features") == 0) {
+            if (SDL_strcmp(value, "all") == 0) {
+                num_levels = GetFeatureLevels(levels);
+            } else {
+                char *end = (char *) value;
+                while (*end && num_levels < MAX_LEVELS) {
+                    levels[num_levels++] = (Uint32) SDL_strtoul(end, &end, 0);
+                    if (*end == ',') {
+                        ++end;
+                    } else if (*end) {
+                        goto usage;
+                    }
+                }
+            }
+        } else if (SDL_strcmp(arg, "--json") == 0) {
+            json_file = value;
+        } else if (SDL_strcmp(arg, "--baseline") == 0) {
+            baseline_file = value;
+        } else if (SDL_strcmp(arg, "--threshold") == 0) {
+            threshold = SDL_atof(value);
+        } else {
+            goto usage;
+        }
+    }
+    if (num_sizes == 0) {
+        for (i = 0; i < SDL_arraysize(default_sizes); ++i) {
+            sizes[i][0] = default_sizes[i].w;
+            sizes[i][1] = default_sizes[i].h;
+        }
+        num_sizes = SDL_arraysize(default_sizes);
+    }
+
+    SDL_zero(results);
+    if (num_levels > 0 && !child) {
+        if (RunLevels(argc, argv, levels, num_levels, &results) < 0) {
+            return 2;
+        }
+        if (CheckConformance(&results, levels[0]) > 0) {
+            status = 1;
+        }
+    } else {
+        env = SDL_getenv("SDL_BLIT_CPU_FEATURES");
+        if (env) {
+            features = (Uint32) SDL_strtoul(env, NULL, 0);
+        } else {
+            features = 0xFFFFFFFF;  /* whatever SDL detects */
+        }
+        if (RunMatrix(features, child, &results) < 0) {
+            return 2;
+        }
+    }
+
+    if (!child) {
+        if (json_file && WriteJSON(json_file, &results) < 0) {
+            status = 2;
+        }
+        if (baseline_file) {
+            int slower;
+
+            SDL_qsort(results.results, results.count, sizeof(*results.results), CompareKeys);
+            slower = CompareBaseline(baseline_file, &results, threshold);
+            if (slower < 0) {
+                status = 2;
+            } else if (slower > 0) {
+                status = (status == 2) ? 2 : 1;
+            }
+        }
+    }
+    SDL_free(results.results);
+    SDL_Quit();
+    return status;
+
+usage:
+    SDL_Log("Usage: %s [--src FORMAT]... [--dst FORMAT]... [--flags FLAGS]... [--size WxH]...\n"
+            "       [--hot|--cold] [--time MS] [--cold-mb MB] [--features all|N[,N...]]\n"
+            "       [--json FILE] [--baseline FILE] [--threshold PERCENT]\n"
+            "FORMAT is a pixel format name without SDL_PIXELFORMAT_, like ARGB8888.\n"
+            "FLAGS is a blend mode (none, blend, add, mod) followed by any of\n"
+            "+colormod, +alphamod, +colorkey and +scaled, in that order.\n",
+            argv[0]);
+    return 2;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */
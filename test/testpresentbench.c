@@ -0,0 +1,478 @@
+/*
+  Copyright (C) 1997-2017 Sam Lantinga <slouken@libsdl.org>
+
+  This software is provided 'as-is', without any express or implied
+  warranty.  In no event will the authors be held liable for any damages
+  arising from the use of this software.
+
+  Permission is granted to anyone to use this software for any purpose,
+  including commercial applications, and to alter it and redistribute it
+  freely.
+*/
+
+/* Present latency benchmark for the software video path.
+
+   Renders synthetic scenes into a window and times every stage of each
+   frame with SDL_GetPerformanceCounter():
+
+     draw     painting the scene into the application's pixels
+     upload   SDL_UpdateTexture() and SDL_RenderCopy(), with --path render
+     submit   SDL_UpdateWindowSurfaceRects() or SDL_RenderPresent(), which
+              includes the video driver's UpdateWindowFramebuffer
+     display  from submitting a frame until it reached the display, for
+              video drivers that report it (see SDL_GetWindowPresentStats())
+     total    from starting to draw a frame until it was displayed, or until
+              submit returned if the driver doesn't report that
+
+   The scenes are:
+     full     every pixel changes every frame
+     damage   a small box moves around, so two small rects change
+     scroll   the contents move up a few rows and a new strip is drawn
+
+   With --path surface the scene is drawn straight into the window surface.
+   With --path render it is drawn into a surface of its own, uploaded to a
+   streaming texture and presented with the software renderer.
+
+   Frames are sent back to back without waiting for vsync, and the results
+   are percentiles in microseconds. Nothing needs a real display, so it can
+   run on a CI box, for example:
+     SDL_VIDEODRIVER=dummy testpresentbench
+     xvfb-run testpresentbench --size 1920x1080
+
+   For the Wayland wl_shm window surface, use weston's headless backend with
+   the pixman renderer, so the compositor really reads every buffer, and give
+   it a moment to create its socket:
+     weston --backend=headless-backend.so --use-pixman --socket=sdl-bench &
+     sleep 1
+     WAYLAND_DISPLAY=sdl-bench SDL_VIDEODRIVER=wayland testpresentbench
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "SDL.h"
+
+#define MAX_FILTERS     16
+#define WARMUP_FRAMES   10
+#define BOX_SIZE        64
+#define SCROLL_ROWS     8
+
+enum
+{
+    STAGE_DRAW,
+    STAGE_UPLOAD,
+    STAGE_SUBMIT,
+    STAGE_DISPLAY,
+    STAGE_TOTAL,
+    NUM_STAGES
+};
+
+static const char *stage_names[NUM_STAGES] = {
+    "draw", "upload", "submit", "display", "total"
+};
+
+/* Draws frame number 'frame' of a scene into the surface and fills in the
+   rects that changed, returning how many there are */
+typedef int (*DrawSceneFunc)(SDL_Surface *surface, int frame, SDL_Rect *rects);
+
+typedef struct
+{
+    const char *name;
+    DrawSceneFunc draw;
+} Scene;
+
+typedef struct
+{
+    Uint64 *samples;
+    int count;
+} Samples;
+
+static const struct {
+    int w, h;
+} default_sizes[] = {
+    { 640, 480 }, { 1280, 720 }, { 1920, 1080 }
+};
+
+/* Command line settings */
+static const char *scene_filters[MAX_FILTERS];
+static int num_scene_filters;
+static const char *path_filters[MAX_FILTERS];
+static int num_path_filters;
+static int sizes[MAX_FILTERS][2];
+static int num_sizes;
+static int num_frames = 300;
+
+
+static Uint32
+SceneColor(const SDL_Surface *surface, int frame)
+{
+    return SDL_MapRGB(surface->format, (Uint8) (frame * 3), (Uint8) (frame * 5), (Uint8) (frame * 7));
+}
+
+static int
+DrawFull(SDL_Surface *surface, int frame, SDL_Rect *rects)
+{
+    SDL_FillRect(surface, NULL, SceneColor(surface, frame));
+    rects[0].x = 0;
+    rects[0].y = 0;
+    rects[0].w = surface->w;
+    rects[0].h = surface->h;
+    return 1;
+}
+
+static void
+GetBoxRect(const SDL_Surface *surface, int frame, SDL_Rect *rect)
+{
+    rect->w = SDL_min(BOX_SIZE, surface->w);
+    rect->h = SDL_min(BOX_SIZE, surface->h);
+    rect->x = (frame * 7) % (surface->w - rect->w + 1);
+    rect->y = (frame * 5) % (surface->h - rect->h + 1);
+}
+
+static int
+DrawDamage(SDL_Surface *surface, int frame, SDL_Rect *rects)
+{
+    const Uint32 background = SDL_MapRGB(surface->format, 0x20, 0x20, 0x40);
+
+    if (frame == 0) {
+        SDL_FillRect(surface, NULL, background);
+        GetBoxRect(surface, frame, &rects[0]);
+        SDL_FillRect(surface, &rects[0], SceneColor(surface, frame));
+        rects[0].x = 0;
+        rects[0].y = 0;
+        rects[0].w = surface->w;
+        rects[0].h = surface->h;
+        return 1;
+    }
+
+    GetBoxRect(surface, frame - 1, &rects[0]);
+    SDL_FillRect(surface, &rects[0], background);
+    GetBoxRect(surface, frame, &rects[1]);
+    SDL_FillRect(surface, &rects[1], SceneColor(surface, frame));
+    return 2;
+}
+
+static int
+DrawScroll(SDL_Surface *surface, int frame, SDL_Rect *rects)
+{
+    const int rows = SDL_min(SCROLL_ROWS, surface->h);
+    SDL_Rect strip;
+
+    if (frame == 0) {
+        SDL_FillRect(surface, NULL, SceneColor(surface, frame));
+    } else {
+        if (SDL_MUSTLOCK(surface)) {
+            SDL_LockSurface(surface);
+        }
+        SDL_memmove(surface->pixels,
+                    (Uint8 *) surface->pixels + rows * surface->pitch,
+                    (surface->h - rows) * surface->pitch);
+        if (SDL_MUSTLOCK(surface)) {
+            SDL_UnlockSurface(surface);
+        }
+    }
+
+    /* A new strip of stripes at the bottom */
+    strip.x = 0;
+    strip.y = surface->h - rows;
+    strip.w = surface->w;
+    strip.h = rows;
+    SDL_FillRect(surface, &strip, SceneColor(surface, frame));
+    for (strip.x = (frame * 3) % 32; strip.x < surface->w; strip.x += 32) {
+        strip.w = SDL_min(8, surface->w - strip.x);
+        SDL_FillRect(surface, &strip, SceneColor(surface, frame + 128));
+    }
+
+    rects[0].x = 0;
+    rects[0].y = 0;
+    rects[0].w = surface->w;
+    rects[0].h = surface->h;
+    return 1;
+}
+
+static const Scene scenes[] = {
+    { "full", DrawFull },
+    { "damage", DrawDamage },
+    { "scroll", DrawScroll }
+};
+
+static const char *paths[] = {
+    "surface", "render"
+};
+
+
+static SDL_bool
+Matches(const char *name, const char **filters, int num_filters)
+{
+    int i;
+
+    if (num_filters == 0) {
+        return SDL_TRUE;
+    }
+    for (i = 0; i < num_filters; ++i) {
+        if (SDL_strcasecmp(name, filters[i]) == 0) {
+            return SDL_TRUE;
+        }
+    }
+    return SDL_FALSE;
+}
+
+static void
+AddSample(Samples *samples, Uint64 value)
+{
+    samples->samples[samples->count++] = value;
+}
+
+static int SDLCALL
+CompareSamples(const void *a, const void *b)
+{
+    const Uint64 x = *(const Uint64 *) a;
+    const Uint64 y = *(const Uint64 *) b;
+
+    return (x < y) ? -1 : (x > y);
+}
+
+static double
+Percentile(const Samples *samples, int percent)
+{
+    const double frequency = (double) SDL_GetPerformanceFrequency();
+    const int index = (samples->count - 1) * percent / 100;
+
+    return samples->samples[index] * 1000000.0 / frequency;
+}
+
+static void
+PrintSamples(const char *path, const char *scene, int w, int h, int stage, Samples *samples)
+{
+    char size[32];
+
+    if (samples->count == 0) {
+        return;
+    }
+    SDL_qsort(samples->samples, samples->count, sizeof(*samples->samples), CompareSamples);
+    SDL_snprintf(size, sizeof(size), "%dx%d", w, h);
+    printf("%-8s %-7s %-10s %-8s %10.1f %10.1f %10.1f %10.1f\n",
+           path, scene, size, stage_names[stage],
+           Percentile(samples, 50), Percentile(samples, 90),
+           Percentile(samples, 99), Percentile(samples, 100));
+}
+
+static int
+RunScene(const char *path, const Scene *scene, int w, int h)
+{
+    const SDL_bool render = (SDL_strcmp(path, "render") == 0);
+    const int total_frames = WARMUP_FRAMES + num_frames;
+    SDL_Window *window = NULL;
+    SDL_Renderer *renderer = NULL;
+    SDL_Texture *texture = NULL;
+    SDL_Surface *surface = NULL;
+    Samples samples[NUM_STAGES];
+    Samples displayed_total;
+    Uint64 *frame_start;
+    Uint64 last_reported = 0;
+    SDL_Rect rects[2];
+    int status = -1;
+    int frame, stage, i, numrects;
+
+    SDL_zero(samples);
+    SDL_zero(displayed_total);
+    frame_start = (Uint64 *) SDL_calloc(total_frames + 1, sizeof(*frame_start));
+    for (stage = 0; stage < NUM_STAGES; ++stage) {
+        samples[stage].samples = (Uint64 *) SDL_calloc(num_frames, sizeof(Uint64));
+    }
+    displayed_total.samples = (Uint64 *) SDL_calloc(num_frames, sizeof(Uint64));
+    for (stage = 0; stage < NUM_STAGES; ++stage) {
+        if (!samples[stage].samples) {
+            break;
+        }
+    }
+    if (!frame_start || !displayed_total.samples || stage < NUM_STAGES) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Out of memory\n");
+        goto done;
+    }
+
+    window = SDL_CreateWindow("testpresentbench", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, w, h, 0);
+    if (!window) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't create %dx%d window: %s\n", w, h, SDL_GetError());
+        goto done;
+    }
+    if (render) {
+        renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_SOFTWARE);
+        if (renderer) {
+            texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ARGB8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+        }
+        surface = SDL_CreateRGBSurfaceWithFormat(0, w, h, 32, SDL_PIXELFORMAT_ARGB8888);
+        if (!texture || !surface) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't set up the software renderer: %s\n", SDL_GetError());
+            goto done;
+        }
+    } else {
+        surface = SDL_GetWindowSurface(window);
+        if (!surface) {
+            SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't get the window surface: %s\n", SDL_GetError());
+            goto done;
+        }
+    }
+
+    for (frame = 0; frame < total_frames; ++frame) {
+        const SDL_bool measured = (frame >= WARMUP_FRAMES);
+        Uint64 start, drawn, uploaded, submitted;
+        SDL_PresentStats stats;
+
+        if (SDL_QuitRequested()) {
+            goto done;
+        }
+
+        start = SDL_GetPerformanceCounter();
+        frame_start[frame + 1] = start;
+        numrects = scene->draw(surface, frame, rects);
+        drawn = SDL_GetPerformanceCounter();
+
+        if (render) {
+            for (i = 0; i < numrects; ++i) {
+                const Uint8 *pixels = (const Uint8 *) surface->pixels +
+                                      rects[i].y * surface->pitch + rects[i].x * 4;
+                SDL_UpdateTexture(texture, &rects[i], pixels, surface->pitch);
+            }
+            SDL_RenderCopy(renderer, texture, NULL, NULL);
+            uploaded = SDL_GetPerformanceCounter();
+            SDL_RenderPresent(renderer);
+        } else {
+            uploaded = drawn;
+            if (SDL_UpdateWindowSurfaceRects(window, rects, numrects) < 0) {
+                SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't update the window surface: %s\n", SDL_GetError());
+                goto done;
+            }
+        }
+        submitted = SDL_GetPerformanceCounter();
+
+        if (measured) {
+            AddSample(&samples[STAGE_DRAW], drawn - start);
+            if (render) {
+                AddSample(&samples[STAGE_UPLOAD], uploaded - drawn);
+            }
+            AddSample(&samples[STAGE_SUBMIT], submitted - uploaded);
+            AddSample(&samples[STAGE_TOTAL], submitted - start);
+        }
+
+        /* Let the driver hear about frames that reached the display */
+        SDL_PumpEvents();
+        if (SDL_GetWindowPresentStats(window, &stats) == 0 &&
+            stats.present_time && stats.frame > last_reported) {
+            last_reported = stats.frame;
+            if (stats.frame > WARMUP_FRAMES && stats.frame <= (Uint64) total_frames &&
+                displayed_total.count < num_frames) {
+                AddSample(&samples[STAGE_DISPLAY], stats.present_time - stats.submit_time);
+                AddSample(&displayed_total, stats.present_time - frame_start[stats.frame]);
+            }
+        }
+    }
+
+    /* When the driver reports displayed frames, count until then */
+    if (displayed_total.count > 0) {
+        SDL_free(samples[STAGE_TOTAL].samples);
+        samples[STAGE_TOTAL] = displayed_total;
+        SDL_zero(displayed_total);
+    }
+
+    for (stage = 0; stage < NUM_STAGES; ++stage) {
+        PrintSamples(path, scene->name, w, h, stage, &samples[stage]);
+    }
+    status = 0;
+
+done:
+    if (render) {
+        SDL_FreeSurface(surface);
+    }
+    if (renderer) {
+        SDL_DestroyRenderer(renderer);
+    }
+    if (window) {
+        SDL_DestroyWindow(window);
+    }
+    for (stage = 0; stage < NUM_STAGES; ++stage) {
+        SDL_free(samples[stage].samples);
+    }
+    SDL_free(displayed_total.samples);
+    SDL_free(frame_start);
+    return status;
+}
+
+int
+main(int argc, char **argv)
+{
+    int status = 0;
+    int i, p, s;
+
+    /* Enable standard application logging */
+    SDL_LogSetPriority(SDL_LOG_CATEGORY_APPLICATION, SDL_LOG_PRIORITY_INFO);
+
+    for (i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+
+        if (!value) {
+            goto usage;
+        }
+        ++i;
+        if (SDL_strcmp(arg, "--scene") == 0 && num_scene_filters < MAX_FILTERS) {
+            scene_filters[num_scene_filters++] = value;
+        } else if (SDL_strcmp(arg, "--path") == 0 && num_path_filters < MAX_FILTERS) {
+            path_filters[num_path_filters++] = value;
+        } else if (SDL_strcmp(arg, "--size") == 0 && num_sizes < MAX_FILTERS &&
+                   sscanf(value, "%dx%d", &sizes[num_sizes][0], &sizes[num_sizes][1]) == 2 &&
+                   sizes[num_sizes][0] > 0 && sizes[num_sizes][1] > 0) {
+            ++num_sizes;
+        } else if (SDL_strcmp(arg, "--frames") == 0) {
+            num_frames = SDL_max(SDL_atoi(value), 1);
+        } else {
+            goto usage;
+        }
+    }
+    if (num_sizes == 0) {
+        for (i = 0; i < SDL_arraysize(default_sizes); ++i) {
+            sizes[i][0] = default_sizes[i].w;
+            sizes[i][1] = default_sizes[i].h;
+        }
+        num_sizes = SDL_arraysize(default_sizes);
+    }
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        SDL_LogError(SDL_LOG_CATEGORY_APPLICATION, "Couldn't initialize SDL: %s\n", SDL_GetError());
+        return 2;
+    }
+
+    printf("Video driver: %s, %d frames per run after %d warmup frames\n",
+           SDL_GetCurrentVideoDriver(), num_frames, WARMUP_FRAMES);
+    printf("%-8s %-7s %-10s %-8s %10s %10s %10s %10s\n",
+           "path", "scene", "size", "stage", "p50 us", "p90 us", "p99 us", "max us");
+
+    for (p = 0; p < SDL_arraysize(paths); ++p) {
+        if (!Matches(paths[p], path_filters, num_path_filters)) {
+            continue;
+        }
+        for (s = 0; s < SDL_arraysize(scenes); ++s) {
+            if (!Matches(scenes[s].name, scene_filters, num_scene_filters)) {
+                continue;
+            }
+            for (i = 0; i < num_sizes; ++i) {
+                if (RunScene(paths[p], &scenes[s], sizes[i][0], sizes[i][1]) < 0) {
+                    status = 1;
+                }
+            }
+        }
+    }
+
+    SDL_Quit();
+    return status;
+
+usage:
+    SDL_Log("Usage: %s [--path surface|render]... [--scene full|damage|scroll]...\n"
+            "       [--size WxH]... [--frames N]\n"
+            "Set SDL_VIDEODRIVER to pick the video driver to measure.\n",
+            argv[0]);
+    return 2;
+}
+
+/* vi: set ts=4 sw=4 expandtab: */